@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include "Core/vaSTL.h"
+
+#include <type_traits>
+#include <cstddef>
+#include <new>
+
+namespace VertexAsylum
+{
+    // std::function-like callable wrapper that never allocates: the callable is stored in a fixed 'Capacity' bytes inline
+    // buffer and anything that doesn't fit is a compile error (capture less, capture a pointer to a struct, or raise
+    // Capacity). Copyable if the stored callable is; empty state is the default constructed one.
+    template< typename FunctionType, size_t Capacity = 64 >
+    class vaInplaceFunction;
+
+    template< typename ReturnType, typename ... ArgTypes, size_t Capacity >
+    class vaInplaceFunction< ReturnType( ArgTypes ... ), Capacity >
+    {
+        typedef ReturnType                  ( *InvokeType )( void * storage, ArgTypes ... args );
+        typedef void                        ( *CopyType )( void * destination, const void * source );
+        typedef void                        ( *DestroyType )( void * storage );
+
+        alignas( std::max_align_t ) uint8   m_storage[Capacity];
+        InvokeType                          m_invoke            = nullptr;
+        CopyType                            m_copy              = nullptr;
+        DestroyType                         m_destroy           = nullptr;
+
+    public:
+        vaInplaceFunction( )                                        { }
+        vaInplaceFunction( std::nullptr_t )                         { }
+        vaInplaceFunction( const vaInplaceFunction & other )        { CopyFrom( other ); }
+        ~vaInplaceFunction( )                                       { Reset( ); }
+
+        template< typename CallableType, typename = typename std::enable_if< !std::is_same< typename std::decay<CallableType>::type, vaInplaceFunction >::value >::type >
+        vaInplaceFunction( CallableType && callable )               { Assign( std::forward<CallableType>( callable ) ); }
+
+        vaInplaceFunction &                 operator = ( const vaInplaceFunction & other )  { if( this != &other ) { Reset( ); CopyFrom( other ); } return *this; }
+        vaInplaceFunction &                 operator = ( std::nullptr_t )                   { Reset( ); return *this; }
+
+        explicit                            operator bool( ) const                          { return m_invoke != nullptr; }
+
+        ReturnType                          operator( )( ArgTypes ... args ) const
+        {
+            assert( m_invoke != nullptr );
+            return m_invoke( const_cast<uint8 *>( m_storage ), std::forward<ArgTypes>( args )... );
+        }
+
+        void                                Reset( )
+        {
+            if( m_destroy != nullptr )
+                m_destroy( m_storage );
+            m_invoke = nullptr; m_copy = nullptr; m_destroy = nullptr;
+        }
+
+    private:
+        template< typename CallableType >
+        void                                Assign( CallableType && callable )
+        {
+            typedef typename std::decay<CallableType>::type StoredType;
+            static_assert( sizeof( StoredType ) <= Capacity, "vaInplaceFunction: callable too large for the inline buffer" );
+            static_assert( alignof( StoredType ) <= alignof( std::max_align_t ), "vaInplaceFunction: callable over-aligned" );
+
+            new( m_storage ) StoredType( std::forward<CallableType>( callable ) );
+            m_invoke    = [ ]( void * storage, ArgTypes ... args ) -> ReturnType    { return ( *static_cast<StoredType *>( storage ) )( std::forward<ArgTypes>( args )... ); };
+            m_copy      = [ ]( void * destination, const void * source )            { new( destination ) StoredType( *static_cast<const StoredType *>( source ) ); };
+            m_destroy   = [ ]( void * storage )                                     { static_cast<StoredType *>( storage )->~StoredType( ); };
+        }
+
+        void                                CopyFrom( const vaInplaceFunction & other )
+        {
+            if( other.m_invoke == nullptr )
+                return;
+            other.m_copy( m_storage, other.m_storage );
+            m_invoke = other.m_invoke; m_copy = other.m_copy; m_destroy = other.m_destroy;
+        }
+    };
+}
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include <atomic>
+
+namespace VertexAsylum
+{
+    // Bounded lock-free single producer / single consumer ring queue. Exactly one thread may call TryPush and exactly one
+    // (other) thread may call TryPop; neither ever blocks - waiting, if needed, is up to the caller.
+    // Capacity must be a power of two.
+    template< class ElementType, int Capacity >
+    class vaSPSCQueue
+    {
+        static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0, "Capacity must be a power of two" );
+
+        // head and tail on separate cache lines so producer and consumer don't false-share
+        alignas(64) std::atomic<uint32>     m_head          = 0;        // next slot to pop; written by consumer only
+        alignas(64) std::atomic<uint32>     m_tail          = 0;        // next slot to push; written by producer only
+        alignas(64) ElementType             m_elements[Capacity];
+
+    public:
+        vaSPSCQueue( )                                              { }
+        vaSPSCQueue( const vaSPSCQueue & ) = delete;
+        vaSPSCQueue & operator = ( const vaSPSCQueue & ) = delete;
+
+        // producer only; returns false if full
+        bool                                TryPush( const ElementType & element )
+        {
+            uint32 tail = m_tail.load( std::memory_order_relaxed );
+            if( tail - m_head.load( std::memory_order_acquire ) == (uint32)Capacity )
+                return false;
+            m_elements[tail & ( Capacity - 1 )] = element;
+            m_tail.store( tail + 1, std::memory_order_release );
+            return true;
+        }
+
+        // consumer only; returns false if empty
+        bool                                TryPop( ElementType & outElement )
+        {
+            uint32 head = m_head.load( std::memory_order_relaxed );
+            if( head == m_tail.load( std::memory_order_acquire ) )
+                return false;
+            outElement = m_elements[head & ( Capacity - 1 )];
+            m_head.store( head + 1, std::memory_order_release );
+            return true;
+        }
+
+        // approximate when called while the other side is running
+        bool                                IsEmpty( ) const        { return m_head.load( std::memory_order_acquire ) == m_tail.load( std::memory_order_acquire ); }
+    };
+
+}
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include "Core/vaSTL.h"
+
+namespace VertexAsylum
+{
+    // 32bit handle into a vaSlotMap: slot index in the low bits, slot generation in the high bits. Default constructed
+    // (zero) handle is never valid.
+    struct vaSlotMapHandle
+    {
+        static const int                    c_indexBits         = 22;                               // up to 4M live elements
+        static const uint32                 c_indexMask         = ( 1u << c_indexBits ) - 1;
+        static const uint32                 c_generationMax     = ( 1u << ( 32 - c_indexBits ) ) - 1;
+
+        uint32                              Value               = 0;
+
+        vaSlotMapHandle( )                                      { }
+        vaSlotMapHandle( uint32 index, uint32 generation ) : Value( ( generation << c_indexBits ) | index ) { assert( index <= c_indexMask && generation <= c_generationMax ); }
+
+        uint32                              Index( ) const      { return Value & c_indexMask; }
+        uint32                              Generation( ) const { return Value >> c_indexBits; }
+        bool                                IsNull( ) const     { return Value == 0; }
+
+        bool                                operator == ( const vaSlotMapHandle & other ) const     { return Value == other.Value; }
+        bool                                operator != ( const vaSlotMapHandle & other ) const     { return Value != other.Value; }
+    };
+
+    // Generational slot map: a replacement for vaSparseArray. Elements are kept densely packed (so iterating only ever
+    // touches live ones) and are referred to by vaSlotMapHandle, which stays valid until the element is erased and gets
+    // detected as stale afterwards, even once its slot is reused. Insert, Erase and Find are all O(1) and nothing needs
+    // defragmenting.
+    //  - Erase moves the last element into the erased one's place, so element order is not preserved and pointers to
+    //    elements are only valid until the next Insert/Erase; keep handles instead.
+    //  - A slot whose generation reaches c_generationMax gets retired instead of reused, so a stale handle can never
+    //    alias a newer element (costs 8 bytes per ~1k erases on that slot, only in extreme churn).
+    //  - To erase while iterating, iterate backwards over [0, Size( )) with HandleAt( ) / ValueAt( ).
+    //  - Not thread safe.
+    template< class ElementType >
+    class vaSlotMap
+    {
+        struct Slot
+        {
+            uint32                          DenseIndex;         // if in use; otherwise next in the free list
+            uint32                          Generation;         // incremented on every erase; handles with a different one are stale
+        };
+
+        static const uint32                 c_invalidIndex      = 0xFFFFFFFF;
+
+        vector<ElementType>                 m_values;
+        vector<uint32>                      m_denseToSlot;
+        vector<Slot>                        m_slots;
+        uint32                              m_freeListHead      = c_invalidIndex;
+        uint32                              m_freeListTail      = c_invalidIndex;
+
+    public:
+        vaSlotMap( )                                            { }
+        explicit vaSlotMap( int reserveSize )                   { Reserve( reserveSize ); }
+
+        void                                Reserve( int count )                            { m_values.reserve( count ); m_denseToSlot.reserve( count ); m_slots.reserve( count ); }
+
+        template< class... ArgTypes >
+        vaSlotMapHandle                     Emplace( ArgTypes &&... args );
+        vaSlotMapHandle                     Insert( const ElementType & value )             { return Emplace( value ); }
+        vaSlotMapHandle                     Insert( ElementType && value )                  { return Emplace( std::move( value ) ); }
+
+        // returns false (and does nothing) if the handle is stale or null
+        bool                                Erase( vaSlotMapHandle handle );
+        void                                Clear( );
+
+        // nullptr if the handle is stale or null
+        ElementType *                       Find( vaSlotMapHandle handle )                  { uint32 denseIndex = DenseIndexOf( handle ); return ( denseIndex == c_invalidIndex ) ? ( nullptr ) : ( &m_values[denseIndex] ); }
+        const ElementType *                 Find( vaSlotMapHandle handle ) const            { uint32 denseIndex = DenseIndexOf( handle ); return ( denseIndex == c_invalidIndex ) ? ( nullptr ) : ( &m_values[denseIndex] ); }
+        bool                                Contains( vaSlotMapHandle handle ) const        { return DenseIndexOf( handle ) != c_invalidIndex; }
+
+        // handle must be valid
+        ElementType &                       operator [] ( vaSlotMapHandle handle )          { ElementType * value = Find( handle ); assert( value != nullptr ); return *value; }
+        const ElementType &                 operator [] ( vaSlotMapHandle handle ) const    { const ElementType * value = Find( handle ); assert( value != nullptr ); return *value; }
+
+        // dense access to live elements, in no particular order
+        int                                 Size( ) const                                   { return (int)m_values.size( ); }
+        bool                                Empty( ) const                                  { return m_values.empty( ); }
+        ElementType &                       ValueAt( int denseIndex )                       { return m_values[denseIndex]; }
+        const ElementType &                 ValueAt( int denseIndex ) const                 { return m_values[denseIndex]; }
+        vaSlotMapHandle                     HandleAt( int denseIndex ) const                { uint32 slotIndex = m_denseToSlot[denseIndex]; return vaSlotMapHandle( slotIndex, m_slots[slotIndex].Generation ); }
+
+        typename vector<ElementType>::iterator          begin( )                            { return m_values.begin( ); }
+        typename vector<ElementType>::iterator          end( )                              { return m_values.end( ); }
+        typename vector<ElementType>::const_iterator    begin( ) const                      { return m_values.begin( ); }
+        typename vector<ElementType>::const_iterator    end( ) const                        { return m_values.end( ); }
+
+    private:
+        uint32                              DenseIndexOf( vaSlotMapHandle handle ) const
+        {
+            uint32 slotIndex = handle.Index( );
+            if( slotIndex >= (uint32)m_slots.size( ) )
+                return c_invalidIndex;
+            const Slot & slot = m_slots[slotIndex];
+            return ( slot.Generation == handle.Generation( ) ) ? ( slot.DenseIndex ) : ( c_invalidIndex );
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    // Inline
+    //////////////////////////////////////////////////////////////////////////
+
+    template< class ElementType >
+    template< class... ArgTypes >
+    inline vaSlotMapHandle vaSlotMap<ElementType>::Emplace( ArgTypes &&... args )
+    {
+        uint32 slotIndex;
+        if( m_freeListHead != c_invalidIndex )
+        {
+            slotIndex = m_freeListHead;
+            m_freeListHead = m_slots[slotIndex].DenseIndex;
+            if( m_freeListHead == c_invalidIndex )
+                m_freeListTail = c_invalidIndex;
+        }
+        else
+        {
+            slotIndex = (uint32)m_slots.size( );
+            if( slotIndex > vaSlotMapHandle::c_indexMask )
+            {
+                assert( false );    // out of slots
+                return vaSlotMapHandle( );
+            }
+            // generation starts at 1 so that a null handle never matches
+            m_slots.push_back( { c_invalidIndex, 1 } );
+        }
+
+        Slot & slot = m_slots[slotIndex];
+        slot.DenseIndex = (uint32)m_values.size( );
+        m_values.emplace_back( std::forward<ArgTypes>( args )... );
+        m_denseToSlot.push_back( slotIndex );
+        return vaSlotMapHandle( slotIndex, slot.Generation );
+    }
+
+    template< class ElementType >
+    inline bool vaSlotMap<ElementType>::Erase( vaSlotMapHandle handle )
+    {
+        uint32 denseIndex = DenseIndexOf( handle );
+        if( denseIndex == c_invalidIndex )
+            return false;
+
+        // move the last one into the hole
+        uint32 lastDenseIndex = (uint32)m_values.size( ) - 1;
+        if( denseIndex != lastDenseIndex )
+        {
+            m_values[denseIndex]        = std::move( m_values[lastDenseIndex] );
+            m_denseToSlot[denseIndex]   = m_denseToSlot[lastDenseIndex];
+            m_slots[ m_denseToSlot[denseIndex] ].DenseIndex = denseIndex;
+        }
+        m_values.pop_back( );
+        m_denseToSlot.pop_back( );
+
+        Slot & slot = m_slots[handle.Index( )];
+        slot.DenseIndex = c_invalidIndex;
+        slot.Generation++;
+        if( slot.Generation > vaSlotMapHandle::c_generationMax )
+            return true;        // retired, see class comment
+
+        // reuse oldest free slots first - spreads generation increments over all slots
+        if( m_freeListTail == c_invalidIndex )
+            m_freeListHead = handle.Index( );
+        else
+            m_slots[m_freeListTail].DenseIndex = handle.Index( );
+        m_freeListTail = handle.Index( );
+        return true;
+    }
+
+    template< class ElementType >
+    inline void vaSlotMap<ElementType>::Clear( )
+    {
+        // all outstanding handles have to become stale, so slots are kept (with their generations bumped) rather than dropped
+        for( int i = (int)m_values.size( ) - 1; i >= 0; i-- )
+            Erase( HandleAt( i ) );
+        assert( m_values.empty( ) );
+    }
+}
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/Containers/vaSmallVector.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace VertexAsylum
+{
+    // String with 'InlineCapacity' characters (not counting the terminating zero) of inline storage, for short strings
+    // built in hot paths (macro names & values, keys, ...) where std::string's own small-string buffer (15 characters
+    // with MSVC) is too short. Always zero terminated. Only the common part of the std::string interface is here; use
+    // str( ) to get a std::string. Appending a part of the string to itself is not supported.
+    template< size_t InlineCapacity >
+    class vaSmallString
+    {
+        vaSmallVector< char, InlineCapacity + 1 >   m_chars;        // includes the terminating zero
+
+    public:
+        vaSmallString( )                                                { m_chars.push_back( '\0' ); }
+        vaSmallString( const char * text )                              { m_chars.push_back( '\0' ); append( text ); }
+        vaSmallString( const char * text, size_t length )               { m_chars.push_back( '\0' ); append( text, length ); }
+        vaSmallString( const string & text )                            { m_chars.push_back( '\0' ); append( text.c_str( ), text.length( ) ); }
+
+        vaSmallString &                     operator = ( const char * text )                { clear( ); return append( text ); }
+        vaSmallString &                     operator = ( const string & text )              { clear( ); return append( text.c_str( ), text.length( ) ); }
+
+        const char *                        c_str( ) const                                  { return m_chars.data( ); }
+        const char *                        data( ) const                                   { return m_chars.data( ); }
+        size_t                              size( ) const                                   { return m_chars.size( ) - 1; }
+        size_t                              length( ) const                                 { return m_chars.size( ) - 1; }
+        bool                                empty( ) const                                  { return m_chars.size( ) == 1; }
+        bool                                is_inline( ) const                              { return m_chars.is_inline( ); }
+        void                                reserve( size_t length )                        { m_chars.reserve( length + 1 ); }
+        void                                clear( )                                        { m_chars.resize( 1 ); m_chars[0] = '\0'; }
+
+        char &                              operator [] ( size_t index )                    { assert( index < size( ) ); return m_chars[index]; }
+        const char &                        operator [] ( size_t index ) const              { assert( index < size( ) ); return m_chars[index]; }
+        const char *                        begin( ) const                                  { return m_chars.data( ); }
+        const char *                        end( ) const                                    { return m_chars.data( ) + size( ); }
+
+        vaSmallString &                     append( const char * text, size_t length )      { assert( text + length <= begin( ) || text > end( ) ); m_chars.reserve( m_chars.size( ) + length ); m_chars.pop_back( ); m_chars.insert( m_chars.end( ), text, text + length ); m_chars.push_back( '\0' ); return *this; }
+        vaSmallString &                     append( const char * text )                     { return append( text, strlen( text ) ); }
+        vaSmallString &                     append( const string & text )                   { return append( text.c_str( ), text.length( ) ); }
+        vaSmallString &                     append( size_t count, char c )                  { m_chars.back( ) = c; m_chars.resize( m_chars.size( ) + count, c ); m_chars.back( ) = '\0'; return *this; }
+        void                                push_back( char c )                             { m_chars.back( ) = c; m_chars.push_back( '\0' ); }
+
+        vaSmallString &                     operator += ( const char * text )               { return append( text ); }
+        vaSmallString &                     operator += ( const string & text )             { return append( text ); }
+        vaSmallString &                     operator += ( char c )                          { push_back( c ); return *this; }
+        template< size_t OtherCapacity >
+        vaSmallString &                     operator += ( const vaSmallString<OtherCapacity> & text )   { return append( text.c_str( ), text.length( ) ); }
+
+        string                              str( ) const                                    { return string( c_str( ), length( ) ); }
+
+        int                                 compare( const char * text, size_t textLength ) const
+        {
+            int result = memcmp( c_str( ), text, std::min( length( ), textLength ) );
+            if( result != 0 )
+                return result;
+            return ( length( ) < textLength ) ? ( -1 ) : ( ( length( ) > textLength ) ? ( 1 ) : ( 0 ) );
+        }
+        int                                 compare( const char * text ) const              { return compare( text, strlen( text ) ); }
+        int                                 compare( const string & text ) const            { return compare( text.c_str( ), text.length( ) ); }
+        template< size_t OtherCapacity >
+        int                                 compare( const vaSmallString<OtherCapacity> & text ) const  { return compare( text.c_str( ), text.length( ) ); }
+
+        // printf-style; formats straight into the inline buffer when it fits
+        static vaSmallString                Format( const char * format, ... )
+        {
+            char buffer[InlineCapacity + 1];
+            va_list args;
+            va_start( args, format );
+            int length = vsnprintf( buffer, sizeof( buffer ), format, args );
+            va_end( args );
+            assert( length >= 0 );
+            if( length < 0 )
+                return vaSmallString( );
+            if( length <= (int)InlineCapacity )
+                return vaSmallString( buffer, length );
+
+            vaSmallString ret;
+            ret.m_chars.resize( length + 1 );
+            va_start( args, format );
+            vsnprintf( ret.m_chars.data( ), length + 1, format, args );
+            va_end( args );
+            return ret;
+        }
+    };
+
+    template< size_t CapacityA, size_t CapacityB >
+    inline bool operator == ( const vaSmallString<CapacityA> & left, const vaSmallString<CapacityB> & right )  { return left.compare( right ) == 0; }
+    template< size_t CapacityA, size_t CapacityB >
+    inline bool operator != ( const vaSmallString<CapacityA> & left, const vaSmallString<CapacityB> & right )  { return left.compare( right ) != 0; }
+    template< size_t CapacityA, size_t CapacityB >
+    inline bool operator < ( const vaSmallString<CapacityA> & left, const vaSmallString<CapacityB> & right )   { return left.compare( right ) < 0; }
+
+    template< size_t Capacity >
+    inline bool operator == ( const vaSmallString<Capacity> & left, const char * right )          { return left.compare( right ) == 0; }
+    template< size_t Capacity >
+    inline bool operator != ( const vaSmallString<Capacity> & left, const char * right )          { return left.compare( right ) != 0; }
+    template< size_t Capacity >
+    inline bool operator == ( const vaSmallString<Capacity> & left, const string & right )        { return left.compare( right ) == 0; }
+    template< size_t Capacity >
+    inline bool operator != ( const vaSmallString<Capacity> & left, const string & right )        { return left.compare( right ) != 0; }
+    template< size_t Capacity >
+    inline bool operator == ( const string & left, const vaSmallString<Capacity> & right )        { return right.compare( left ) == 0; }
+    template< size_t Capacity >
+    inline bool operator != ( const string & left, const vaSmallString<Capacity> & right )        { return right.compare( left ) != 0; }
+}
@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include "Core/vaSTL.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace VertexAsylum
+{
+    // std::vector replacement that keeps up to 'InlineCapacity' elements inside the object itself and only goes to the
+    // heap (like std::vector would) once it grows beyond that. Meant for short lists that get built per call/per frame or
+    // live in many small objects, where the vector's own allocation (and the cache miss to get to it) dominates.
+    //  - Interface follows std::vector (minus allocators); iterators are plain pointers.
+    //  - Unlike std::vector, moving an inline vaSmallVector moves the elements one by one, so pointers/iterators into
+    //    the source don't survive the move; and swap is O(size) for inline ones.
+    //  - Once spilled to the heap it stays there until shrink_to_fit( ) (or clear( ) + shrink_to_fit( )).
+    //  - Compared to vaStackVector (chromium::StackVector) it's a single type (no .container( )) and doesn't fall back
+    //    to std::allocator bookkeeping, so it can be used as a member.
+    template< class T, size_t InlineCapacity >
+    class vaSmallVector
+    {
+        static_assert( InlineCapacity > 0, "use vector<T> if no inline storage is needed" );
+        static_assert( alignof( T ) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types not supported (heap storage uses plain operator new)" );
+
+    public:
+        typedef T                                       value_type;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+        typedef T &                                     reference;
+        typedef const T &                               const_reference;
+        typedef T *                                     pointer;
+        typedef const T *                               const_pointer;
+        typedef T *                                     iterator;
+        typedef const T *                               const_iterator;
+        typedef std::reverse_iterator<iterator>         reverse_iterator;
+        typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+
+        static const size_t                 c_inlineCapacity    = InlineCapacity;
+
+    private:
+        T *                                 m_data;
+        size_t                              m_size              = 0;
+        size_t                              m_capacity          = InlineCapacity;
+        alignas( T ) uint8                  m_inline[ InlineCapacity * sizeof( T ) ];
+
+    public:
+        vaSmallVector( ) : m_data( InlineData( ) )                                                  { }
+        explicit vaSmallVector( size_t count ) : m_data( InlineData( ) )                            { resize( count ); }
+        vaSmallVector( size_t count, const T & value ) : m_data( InlineData( ) )                    { assign( count, value ); }
+        vaSmallVector( std::initializer_list<T> list ) : m_data( InlineData( ) )                    { assign( list.begin( ), list.end( ) ); }
+        template< class InputIterator, class = typename std::enable_if< !std::is_integral<InputIterator>::value >::type >
+        vaSmallVector( InputIterator first, InputIterator last ) : m_data( InlineData( ) )          { assign( first, last ); }
+        vaSmallVector( const vaSmallVector & other ) : m_data( InlineData( ) )                      { assign( other.begin( ), other.end( ) ); }
+        vaSmallVector( vaSmallVector && other ) : m_data( InlineData( ) )                           { MoveFrom( other ); }
+        ~vaSmallVector( )                                                                           { clear( ); FreeHeap( ); }
+
+        vaSmallVector &                     operator = ( const vaSmallVector & other )              { if( this != &other ) assign( other.begin( ), other.end( ) ); return *this; }
+        vaSmallVector &                     operator = ( vaSmallVector && other )                   { if( this != &other ) { clear( ); MoveFrom( other ); } return *this; }
+        vaSmallVector &                     operator = ( std::initializer_list<T> list )            { assign( list.begin( ), list.end( ) ); return *this; }
+
+        void                                assign( size_t count, const T & value )                 { clear( ); reserve( count ); for( size_t i = 0; i < count; i++ ) new( m_data + i ) T( value ); m_size = count; }
+        template< class InputIterator, class = typename std::enable_if< !std::is_integral<InputIterator>::value >::type >
+        void                                assign( InputIterator first, InputIterator last )       { clear( ); for( ; first != last; ++first ) emplace_back( *first ); }
+        void                                assign( std::initializer_list<T> list )                 { assign( list.begin( ), list.end( ) ); }
+
+        // element access
+        T &                                 operator [] ( size_t index )                            { assert( index < m_size ); return m_data[index]; }
+        const T &                           operator [] ( size_t index ) const                      { assert( index < m_size ); return m_data[index]; }
+        T &                                 at( size_t index )                                      { assert( index < m_size ); return m_data[index]; }
+        const T &                           at( size_t index ) const                                { assert( index < m_size ); return m_data[index]; }
+        T &                                 front( )                                                { assert( m_size > 0 ); return m_data[0]; }
+        const T &                           front( ) const                                          { assert( m_size > 0 ); return m_data[0]; }
+        T &                                 back( )                                                 { assert( m_size > 0 ); return m_data[m_size-1]; }
+        const T &                           back( ) const                                           { assert( m_size > 0 ); return m_data[m_size-1]; }
+        T *                                 data( )                                                 { return m_data; }
+        const T *                           data( ) const                                           { return m_data; }
+
+        // iterators
+        iterator                            begin( )                                                { return m_data; }
+        iterator                            end( )                                                  { return m_data + m_size; }
+        const_iterator                      begin( ) const                                          { return m_data; }
+        const_iterator                      end( ) const                                            { return m_data + m_size; }
+        const_iterator                      cbegin( ) const                                         { return m_data; }
+        const_iterator                      cend( ) const                                           { return m_data + m_size; }
+        reverse_iterator                    rbegin( )                                               { return reverse_iterator( end( ) ); }
+        reverse_iterator                    rend( )                                                 { return reverse_iterator( begin( ) ); }
+        const_reverse_iterator              rbegin( ) const                                         { return const_reverse_iterator( end( ) ); }
+        const_reverse_iterator              rend( ) const                                           { return const_reverse_iterator( begin( ) ); }
+
+        // capacity
+        bool                                empty( ) const                                          { return m_size == 0; }
+        size_t                              size( ) const                                           { return m_size; }
+        size_t                              capacity( ) const                                       { return m_capacity; }
+        size_t                              max_size( ) const                                       { return ( (size_t)-1 ) / sizeof( T ); }
+        bool                                is_inline( ) const                                      { return m_data == InlineData( ); }
+        void                                reserve( size_t count )                                 { if( count > m_capacity ) Reallocate( count ); }
+        void                                shrink_to_fit( )                                        { if( !is_inline( ) && m_size < m_capacity ) Reallocate( m_size ); }
+
+        // modifiers
+        void                                clear( )                                                { DestroyRange( m_data, m_data + m_size ); m_size = 0; }
+        void                                push_back( const T & value )                            { emplace_back( value ); }
+        void                                push_back( T && value )                                 { emplace_back( std::move( value ) ); }
+        void                                pop_back( )                                             { assert( m_size > 0 ); m_data[--m_size].~T( ); }
+
+        template< class... ArgTypes >
+        T &                                 emplace_back( ArgTypes &&... args );
+
+        iterator                            insert( const_iterator position, const T & value )      { return emplace( position, value ); }
+        iterator                            insert( const_iterator position, T && value )           { return emplace( position, std::move( value ) ); }
+        iterator                            insert( const_iterator position, size_t count, const T & value );
+        template< class InputIterator, class = typename std::enable_if< !std::is_integral<InputIterator>::value >::type >
+        iterator                            insert( const_iterator position, InputIterator first, InputIterator last );
+        iterator                            insert( const_iterator position, std::initializer_list<T> list )    { return insert( position, list.begin( ), list.end( ) ); }
+
+        template< class... ArgTypes >
+        iterator                            emplace( const_iterator position, ArgTypes &&... args );
+
+        iterator                            erase( const_iterator position )                        { return erase( position, position + 1 ); }
+        iterator                            erase( const_iterator first, const_iterator last );
+
+        void                                resize( size_t count );
+        void                                resize( size_t count, const T & value );
+
+        void                                swap( vaSmallVector & other )                           { vaSmallVector temp( std::move( other ) ); other = std::move( *this ); *this = std::move( temp ); }
+
+    private:
+        T *                                 InlineData( )                                           { return reinterpret_cast<T *>( m_inline ); }
+        const T *                           InlineData( ) const                                     { return reinterpret_cast<const T *>( m_inline ); }
+
+        static void                         DestroyRange( T * first, T * last )                     { for( ; first != last; ++first ) first->~T( ); }
+        void                                FreeHeap( )                                             { if( !is_inline( ) ) ::operator delete( m_data ); m_data = InlineData( ); m_capacity = InlineCapacity; }
+
+        size_t                              GrownCapacity( size_t minCapacity ) const               { return std::max( minCapacity, m_capacity * 2 ); }
+        void                                Reallocate( size_t newCapacity );
+        void                                MoveFrom( vaSmallVector & other );
+    };
+
+    template< class T, size_t InlineCapacity >
+    inline bool operator == ( const vaSmallVector<T, InlineCapacity> & left, const vaSmallVector<T, InlineCapacity> & right ) { return left.size( ) == right.size( ) && std::equal( left.begin( ), left.end( ), right.begin( ) ); }
+    template< class T, size_t InlineCapacity >
+    inline bool operator != ( const vaSmallVector<T, InlineCapacity> & left, const vaSmallVector<T, InlineCapacity> & right ) { return !( left == right ); }
+    template< class T, size_t InlineCapacity >
+    inline bool operator < ( const vaSmallVector<T, InlineCapacity> & left, const vaSmallVector<T, InlineCapacity> & right )  { return std::lexicographical_compare( left.begin( ), left.end( ), right.begin( ), right.end( ) ); }
+
+    // see vector_find_and_remove in vaSTL.h
+    template< class T, size_t InlineCapacity >
+    inline int vector_find_and_remove( vaSmallVector<T, InlineCapacity> & list, const T & value )
+    {
+        for( int i = 0; i < (int)list.size( ); i++ )
+        {
+            if( list[i] == value )
+            {
+                if( i < ( (int)list.size( ) - 1 ) )
+                    list[i] = std::move( list.back( ) );
+                list.pop_back( );
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Inline
+    //////////////////////////////////////////////////////////////////////////
+
+    template< class T, size_t InlineCapacity >
+    inline void vaSmallVector<T, InlineCapacity>::Reallocate( size_t newCapacity )
+    {
+        assert( newCapacity >= m_size );
+        T * newData;
+        if( newCapacity <= InlineCapacity )
+        {
+            // only from shrink_to_fit
+            if( is_inline( ) )
+                return;
+            newData = InlineData( );
+            newCapacity = InlineCapacity;
+        }
+        else
+            newData = static_cast<T *>( ::operator new( newCapacity * sizeof( T ) ) );
+
+        for( size_t i = 0; i < m_size; i++ )
+            new( newData + i ) T( std::move( m_data[i] ) );
+        DestroyRange( m_data, m_data + m_size );
+        if( !is_inline( ) )
+            ::operator delete( m_data );
+        m_data      = newData;
+        m_capacity  = newCapacity;
+    }
+
+    template< class T, size_t InlineCapacity >
+    inline void vaSmallVector<T, InlineCapacity>::MoveFrom( vaSmallVector & other )
+    {
+        assert( m_size == 0 );
+        if( !other.is_inline( ) )
+        {
+            // steal the heap block
+            FreeHeap( );
+            m_data          = other.m_data;
+            m_size          = other.m_size;
+            m_capacity      = other.m_capacity;
+            other.m_data    = other.InlineData( );
+            other.m_size    = 0;
+            other.m_capacity= InlineCapacity;
+            return;
+        }
+        reserve( other.m_size );
+        for( size_t i = 0; i < other.m_size; i++ )
+            new( m_data + i ) T( std::move( other.m_data[i] ) );
+        m_size = other.m_size;
+        other.clear( );
+    }
+
+    template< class T, size_t InlineCapacity >
+    template< class... ArgTypes >
+    inline T & vaSmallVector<T, InlineCapacity>::emplace_back( ArgTypes &&... args )
+    {
+        if( m_size == m_capacity )
+        {
+            // construct the new one first, 'args' could be referencing an existing element
+            size_t newCapacity = GrownCapacity( m_size + 1 );
+            T * newData = static_cast<T *>( ::operator new( newCapacity * sizeof( T ) ) );
+            new( newData + m_size ) T( std::forward<ArgTypes>( args )... );
+            for( size_t i = 0; i < m_size; i++ )
+                new( newData + i ) T( std::move( m_data[i] ) );
+            DestroyRange( m_data, m_data + m_size );
+            if( !is_inline( ) )
+                ::operator delete( m_data );
+            m_data      = newData;
+            m_capacity  = newCapacity;
+        }
+        else
+            new( m_data + m_size ) T( std::forward<ArgTypes>( args )... );
+        return m_data[m_size++];
+    }
+
+    template< class T, size_t InlineCapacity >
+    template< class... ArgTypes >
+    inline typename vaSmallVector<T, InlineCapacity>::iterator vaSmallVector<T, InlineCapacity>::emplace( const_iterator position, ArgTypes &&... args )
+    {
+        size_t index = position - m_data;
+        assert( index <= m_size );
+        emplace_back( std::forward<ArgTypes>( args )... );
+        std::rotate( m_data + index, m_data + m_size - 1, m_data + m_size );
+        return m_data + index;
+    }
+
+    template< class T, size_t InlineCapacity >
+    inline typename vaSmallVector<T, InlineCapacity>::iterator vaSmallVector<T, InlineCapacity>::insert( const_iterator position, size_t count, const T & value )
+    {
+        size_t index = position - m_data;
+        assert( index <= m_size );
+        size_t oldSize = m_size;
+        if( m_size + count > m_capacity )
+        {
+            T copy( value );    // 'value' could be an element
+            reserve( GrownCapacity( m_size + count ) );
+            for( size_t i = 0; i < count; i++ )
+                new( m_data + m_size + i ) T( copy );
+        }
+        else
+        {
+            for( size_t i = 0; i < count; i++ )
+                new( m_data + m_size + i ) T( value );
+        }
+        m_size += count;
+        std::rotate( m_data + index, m_data + oldSize, m_data + m_size );
+        return m_data + index;
+    }
+
+    template< class T, size_t InlineCapacity >
+    template< class InputIterator, class >
+    inline typename vaSmallVector<T, InlineCapacity>::iterator vaSmallVector<T, InlineCapacity>::insert( const_iterator position, InputIterator first, InputIterator last )
+    {
+        size_t index = position - m_data;
+        assert( index <= m_size );
+        size_t oldSize = m_size;
+        for( ; first != last; ++first )
+            emplace_back( *first );
+        std::rotate( m_data + index, m_data + oldSize, m_data + m_size );
+        return m_data + index;
+    }
+
+    template< class T, size_t InlineCapacity >
+    inline typename vaSmallVector<T, InlineCapacity>::iterator vaSmallVector<T, InlineCapacity>::erase( const_iterator first, const_iterator last )
+    {
+        T * from    = m_data + ( first - m_data );
+        T * to      = m_data + ( last - m_data );
+        assert( from <= to && to <= m_data + m_size );
+        if( from == to )
+            return from;
+        T * newEnd = std::move( to, m_data + m_size, from );
+        DestroyRange( newEnd, m_data + m_size );
+        m_size = newEnd - m_data;
+        return from;
+    }
+
+    template< class T, size_t InlineCapacity >
+    inline void vaSmallVector<T, InlineCapacity>::resize( size_t count )
+    {
+        if( count < m_size )
+        {
+            DestroyRange( m_data + count, m_data + m_size );
+            m_size = count;
+            return;
+        }
+        reserve( count );
+        for( ; m_size < count; m_size++ )
+            new( m_data + m_size ) T( );
+    }
+
+    template< class T, size_t InlineCapacity >
+    inline void vaSmallVector<T, InlineCapacity>::resize( size_t count, const T & value )
+    {
+        if( count <= m_size )
+        {
+            resize( count );
+            return;
+        }
+        insert( end( ), count - m_size, value );
+    }
+}
@@ -22,6 +22,7 @@
 #include "Core/vaCore.h"
 
 #include "Core/vaSTL.h"
+#include "Core/vaMath.h"
 
 
 namespace VertexAsylum
@@ -96,7 +97,7 @@ namespace VertexAsylum
 
 
    template< class ElementType >
-   inline vaSparseArray<ElementType>::vaSparseArray( int reserveSize = 0, ElementType nullValue = 0 ) : m_nullValue( nullValue ) 
+   inline vaSparseArray<ElementType>::vaSparseArray( int reserveSize, ElementType nullValue ) : m_nullValue( nullValue ) 
    { 
       m_elements.reserve( reserveSize ); 
       m_elementCount             = 0;
@@ -0,0 +1,804 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "vaCoreBenchmarks.h"
+
+#include "Core/Containers/vaSparseArray.h"
+#include "Core/Containers/vaSlotMap.h"
+#include "Core/Containers/vaSmallString.h"
+
+#include "Core/Misc/vaPropertyContainer.h"
+#include "Core/Misc/vaLargeBitmapFile.h"
+#include "Core/System/vaMemoryStream.h"
+#include "Core/System/vaFileTools.h"
+
+#include "Core/vaUIDObject.h"
+#include "Core/vaStringID.h"
+#include "Core/vaEvent.h"
+#include "Core/vaMemory.h"
+
+#include "Core/vaRandom.h"
+#include "Core/vaLog.h"
+#include "Core/vaStringTools.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace VertexAsylum;
+
+namespace
+{
+    struct BenchmarkInfo
+    {
+        const char *                        Name;
+        const char *                        Description;
+        void                                (*Function)( );
+    };
+
+    template< class FunctionType >
+    double MeasureMilliseconds( FunctionType && function )
+    {
+        auto start = std::chrono::high_resolution_clock::now( );
+        function( );
+        return std::chrono::duration<double, std::milli>( std::chrono::high_resolution_clock::now( ) - start ).count( );
+    }
+
+    // number of heap allocations made by 'function' (on this thread); -1 if VA_MEMORY_TRACKING_ENABLED is off
+    template< class FunctionType >
+    int64 CountAllocations( FunctionType && function )
+    {
+        vaMemoryTagStats before, after;
+        bool tracked = vaMemory::GetTagStats( vaMemoryTag::Benchmarks, before );
+        {
+            VA_MEMORY_TAG_SCOPE( Benchmarks );
+            function( );
+        }
+        vaMemory::GetTagStats( vaMemoryTag::Benchmarks, after );
+        return ( tracked ) ? ( after.TotalAllocations - before.TotalAllocations ) : ( -1 );
+    }
+
+    // sum of something from every element, logged so that the compiler can't drop the work
+    volatile float                          s_sink;
+}
+
+void vaCoreBenchmarks::Run( const string & nameOrWildcard )
+{
+    static const BenchmarkInfo benchmarks[] =
+    {
+        { "slotmap",    "vaSlotMap vs vaSparseArray under churn",   &vaCoreBenchmarks::SlotMap },
+        { "uidregistry","vaUIDObjectRegistrar vs a single mutex+map, multithreaded", &vaCoreBenchmarks::UIDRegistry },
+        { "event",      "vaEvent dispatch cost per listener",       &vaCoreBenchmarks::Event },
+        { "smallvector","vaSmallVector/vaSmallString vs std containers at hot-path temporaries", &vaCoreBenchmarks::SmallVector },
+        { "stringid",   "vaStringID keyed lookups vs string keyed ones (asset pack load, profiler scopes)", &vaCoreBenchmarks::StringID },
+        { "properties", "vaPropertyContainer preset apply (XML vs binary) and lookups by name", &vaCoreBenchmarks::PropertyContainer },
+        { "largebitmap","vaLargeBitmapFile block cache vs memory mapped backend, streaming and random access", &vaCoreBenchmarks::LargeBitmapFile },
+    };
+
+    bool anyRun = false;
+    for( const BenchmarkInfo & benchmark : benchmarks )
+    {
+        if( nameOrWildcard != "*" && vaStringTools::CompareNoCase( nameOrWildcard, benchmark.Name ) != 0 )
+            continue;
+        VA_LOG( "BENCHMARK_CORE %s: %s", benchmark.Name, benchmark.Description );
+        benchmark.Function( );
+        anyRun = true;
+    }
+
+    if( !anyRun )
+    {
+        VA_LOG( "Usage: BENCHMARK_CORE <name or *>, available:" );
+        for( const BenchmarkInfo & benchmark : benchmarks )
+            VA_LOG( "   %-12s %s", benchmark.Name, benchmark.Description );
+    }
+}
+
+void vaCoreBenchmarks::SlotMap( )
+{
+    struct Item
+    {
+        float                               Position[3];
+        float                               Velocity[3];
+        float                               Age;
+        int                                 SparseIndex;        // vaSparseArray's index back-pointer
+
+        void                                Update( float deltaTime )   { for( int i = 0; i < 3; i++ ) Position[i] += Velocity[i] * deltaTime; Age += deltaTime; }
+    };
+
+    struct Scenario
+    {
+        const char *                        Name;
+        int                                 LiveCount;
+        int                                 ChurnPerFrame;      // removed and added every frame
+        int                                 Frames;
+    };
+    const Scenario scenarios[] =
+    {
+        { "particles",  65536,  8192,   200 },
+        { "lights",     1024,   16,     5000 },
+        { "debug draw", 16384,  16384,  200 },              // everything replaced every frame
+    };
+
+    const float deltaTime = 1.0f / 60.0f;
+
+    for( const Scenario & scenario : scenarios )
+    {
+        float sum = 0.0f;
+
+        // vaSparseArray holds pointers (its null value marks removed ones) and needs a Defragment( ) per frame to keep
+        // iteration from degrading; the items need stable addresses for its index back-pointers
+        double sparseArrayTime = MeasureMilliseconds( [&]( )
+        {
+            vaRandom random( 0 );
+            vaSparseArray<Item *> sparseArray( scenario.LiveCount, nullptr );
+            vector<Item *> live;
+            auto add = [&]( )
+            {
+                Item * item = new Item( );
+                item->SparseIndex = -1;
+                sparseArray.Add( item, &item->SparseIndex );
+                live.push_back( item );
+            };
+            for( int i = 0; i < scenario.LiveCount; i++ )
+                add( );
+
+            for( int frame = 0; frame < scenario.Frames; frame++ )
+            {
+                for( int i = 0; i < scenario.ChurnPerFrame; i++ )
+                {
+                    int index = random.NextIntRange( (int)live.size( ) );
+                    sparseArray.Remove( live[index]->SparseIndex );
+                    delete live[index];
+                    live[index] = live.back( );
+                    live.pop_back( );
+                }
+                for( int i = 0; i < scenario.ChurnPerFrame; i++ )
+                    add( );
+                sparseArray.Defragment( );
+
+                for( int i = 0; i < sparseArray.GetCount( ); i++ )
+                {
+                    Item * item = sparseArray.GetElementAt( i );
+                    if( item == nullptr )
+                        continue;
+                    item->Update( deltaTime );
+                    sum += item->Age;
+                }
+            }
+            for( Item * item : live )
+                delete item;
+        } );
+
+        double slotMapTime = MeasureMilliseconds( [&]( )
+        {
+            vaRandom random( 0 );
+            vaSlotMap<Item> slotMap( scenario.LiveCount );
+            vector<vaSlotMapHandle> live;
+            for( int i = 0; i < scenario.LiveCount; i++ )
+                live.push_back( slotMap.Insert( Item( ) ) );
+
+            for( int frame = 0; frame < scenario.Frames; frame++ )
+            {
+                for( int i = 0; i < scenario.ChurnPerFrame; i++ )
+                {
+                    int index = random.NextIntRange( (int)live.size( ) );
+                    bool erased = slotMap.Erase( live[index] );
+                    assert( erased ); erased;
+                    live[index] = live.back( );
+                    live.pop_back( );
+                }
+                for( int i = 0; i < scenario.ChurnPerFrame; i++ )
+                    live.push_back( slotMap.Insert( Item( ) ) );
+
+                for( Item & item : slotMap )
+                {
+                    item.Update( deltaTime );
+                    sum += item.Age;
+                }
+            }
+        } );
+
+        s_sink = sum;
+        VA_LOG( "   %-12s %6d live, %6d churn/frame, %5d frames:  vaSparseArray %9.2f ms   vaSlotMap %9.2f ms   (%.2fx)", scenario.Name,
+            scenario.LiveCount, scenario.ChurnPerFrame, scenario.Frames, sparseArrayTime, slotMapTime, sparseArrayTime / vaMath::Max( slotMapTime, 0.001 ) );
+    }
+}
+
+void vaCoreBenchmarks::UIDRegistry( )
+{
+    struct Object : vaUIDObject
+    {
+        vaGUID                              UID;                // copy for MapRegistry, UIDObject_GetUID( ) only works while tracked
+        int                                 Payload;
+        explicit Object( const vaGUID & uid ) : vaUIDObject( uid ), UID( uid ), Payload( 1 ) { }
+    };
+
+    // what vaUIDObjectRegistrar used to be
+    struct MapRegistry
+    {
+        map< vaGUID, Object *, vaGUIDComparer > Map;
+        mutex                               Mutex;
+
+        void                                Track( Object * obj )                   { std::unique_lock<mutex> lock( Mutex ); Map.insert( std::make_pair( obj->UID, obj ) ); }
+        void                                Untrack( const vaGUID & uid )           { std::unique_lock<mutex> lock( Mutex ); Map.erase( uid ); }
+        Object *                            Find( const vaGUID & uid )              { std::unique_lock<mutex> lock( Mutex ); auto it = Map.find( uid ); return ( it == Map.end( ) ) ? ( nullptr ) : ( it->second ); }
+    };
+
+    const int   objectCount         = 50000;       // roughly a large scene's worth of assets
+    const int   findsPerThread      = 400000;
+    const int   churnCount          = 2000;        // objects tracked & untracked by the 'loading' thread, per round
+    const int   threadCount         = vaMath::Clamp( (int)std::thread::hardware_concurrency( ), 2, 32 );
+
+    vector< unique_ptr<Object> > objects;
+    vector<vaGUID> uids;
+    for( int i = 0; i < objectCount + churnCount; i++ )
+    {
+        objects.push_back( std::make_unique<Object>( vaCore::GUIDCreate( ) ) );
+        uids.push_back( objects.back( )->UID );
+    }
+    vector<vaUIDObject *> staticObjects, churnObjects;
+    for( int i = 0; i < objectCount; i++ )
+        staticObjects.push_back( objects[i].get( ) );
+    for( int i = objectCount; i < objectCount + churnCount; i++ )
+        churnObjects.push_back( objects[i].get( ) );
+
+    vaUIDObjectRegistrar & registrar = vaUIDObjectRegistrar::GetInstance( );
+
+    // runs 'findFunction' on all threads but one; if 'churn' the last one keeps tracking & untracking churnObjects until they're done
+    auto runThreads = [&]( auto && findFunction, auto && churnFunction, bool churn )
+    {
+        std::atomic_bool findersDone( false );
+        std::atomic_int sum( 0 );
+        vector<std::thread> threads;
+        for( int t = 0; t < threadCount - 1; t++ )
+        {
+            threads.push_back( std::thread( [&, t]( )
+            {
+                vaRandom random( t );
+                int localSum = 0;
+                for( int i = 0; i < findsPerThread; i++ )
+                    localSum += findFunction( uids[ random.NextIntRange( objectCount ) ] );
+                sum += localSum;
+            } ) );
+        }
+        std::thread churnThread;
+        if( churn )
+            churnThread = std::thread( [&]( ) { while( !findersDone ) churnFunction( ); } );
+        for( std::thread & thread : threads )
+            thread.join( );
+        findersDone = true;
+        if( churn )
+            churnThread.join( );
+        s_sink = (float)sum;
+    };
+
+    for( int churn = 0; churn < 2; churn++ )
+    {
+        MapRegistry mapRegistry;
+        for( int i = 0; i < objectCount; i++ )
+            mapRegistry.Track( objects[i].get( ) );
+        registrar.TrackBatch( staticObjects.data( ), (int)staticObjects.size( ) );
+
+        double mapTime = MeasureMilliseconds( [&]( )
+        {
+            runThreads( [&]( const vaGUID & uid ) { Object * obj = mapRegistry.Find( uid ); return ( obj != nullptr ) ? ( obj->Payload ) : ( 0 ); },
+                [&]( ) { for( vaUIDObject * obj : churnObjects ) mapRegistry.Track( static_cast<Object*>( obj ) ); for( vaUIDObject * obj : churnObjects ) mapRegistry.Untrack( static_cast<Object*>( obj )->UID ); }, churn != 0 );
+        } );
+
+        double registrarTime = MeasureMilliseconds( [&]( )
+        {
+            runThreads( [&]( const vaGUID & uid ) { Object * obj = vaUIDObjectRegistrar::Find<Object>( uid ); return ( obj != nullptr ) ? ( obj->Payload ) : ( 0 ); },
+                [&]( ) { for( vaUIDObject * obj : churnObjects ) registrar.Track( obj ); for( vaUIDObject * obj : churnObjects ) registrar.Untrack( obj ); }, churn != 0 );
+        } );
+
+        registrar.UntrackBatch( staticObjects.data( ), (int)staticObjects.size( ) );
+
+        VA_LOG( "   %-12s %d threads x %d finds in %d objects:  mutex+map %9.2f ms   vaUIDObjectRegistrar %9.2f ms   (%.2fx)", ( churn != 0 ) ? ( "with churn" ) : ( "finds only" ),
+            threadCount - 1, findsPerThread, objectCount, mapTime, registrarTime, mapTime / vaMath::Max( registrarTime, 0.001 ) );
+    }
+
+    // pack load/unload sized track & untrack, single threaded: one lock per object vs one per shard
+    {
+        double singleTime = MeasureMilliseconds( [&]( )
+        {
+            for( vaUIDObject * obj : staticObjects ) registrar.Track( obj );
+            for( vaUIDObject * obj : staticObjects ) registrar.Untrack( obj );
+        } );
+        double batchTime = MeasureMilliseconds( [&]( )
+        {
+            registrar.TrackBatch( staticObjects.data( ), (int)staticObjects.size( ) );
+            registrar.UntrackBatch( staticObjects.data( ), (int)staticObjects.size( ) );
+        } );
+        VA_LOG( "   %-12s %d objects tracked & untracked:  one by one %9.2f ms   batched %9.2f ms   (%.2fx)", "batch", objectCount, singleTime, batchTime, singleTime / vaMath::Max( batchTime, 0.001 ) );
+    }
+}
+
+void vaCoreBenchmarks::Event( )
+{
+    // what vaEvent used to be: std::function callbacks, weak_ptr locked for each one on every Invoke, no locking
+    struct OldEvent
+    {
+        struct CallbackItem
+        {
+            weak_ptr<void>                  GuarantorToken;
+            std::function<void( float )>    Callback;
+        };
+        vector<CallbackItem>                Callbacks;
+
+        void                                Invoke( float deltaTime )
+        {
+            for( int i = (int)Callbacks.size( ) - 1; i >= 0; i-- )
+            {
+                shared_ptr<void> lockedToken = Callbacks[i].GuarantorToken.lock( );
+                if( lockedToken != nullptr )
+                    Callbacks[i].Callback( deltaTime );
+            }
+        }
+    };
+
+    struct Listener
+    {
+        float                               Time = 0.0f;
+        void                                OnTick( float deltaTime )   { Time += deltaTime; }
+    };
+
+    const int   totalCalls  = 4 * 1024 * 1024;
+    const int   listenerCounts[] = { 1, 16, 256 };
+
+    for( int listenerCount : listenerCounts )
+    {
+        vector< shared_ptr<Listener> > listeners;
+        for( int i = 0; i < listenerCount; i++ )
+            listeners.push_back( std::make_shared<Listener>( ) );
+
+        const int invokeCount = totalCalls / listenerCount;
+
+        OldEvent oldEvent;
+        vaEvent<void( float )> tokenEvent;
+        vaEvent<void( float )> staticEvent;
+        for( const shared_ptr<Listener> & listener : listeners )
+        {
+            Listener * listenerPtr = listener.get( );
+            oldEvent.Callbacks.push_back( { listener, [listenerPtr]( float deltaTime ) { listenerPtr->OnTick( deltaTime ); } } );
+            tokenEvent.Add( listener, &Listener::OnTick );
+            staticEvent.AddStatic( [listenerPtr]( float deltaTime ) { listenerPtr->OnTick( deltaTime ); } );
+        }
+
+        double oldTime      = MeasureMilliseconds( [&]( ) { for( int i = 0; i < invokeCount; i++ ) oldEvent.Invoke( 1.0f ); } );
+        double tokenTime    = MeasureMilliseconds( [&]( ) { for( int i = 0; i < invokeCount; i++ ) tokenEvent.Invoke( 1.0f ); } );
+        double staticTime   = MeasureMilliseconds( [&]( ) { for( int i = 0; i < invokeCount; i++ ) staticEvent.Invoke( 1.0f ); } );
+
+        float sum = 0.0f;
+        for( const shared_ptr<Listener> & listener : listeners )
+            sum += listener->Time;
+        s_sink = sum;
+
+        // ns per listener call
+        const double toNs = 1e6 / (double)( invokeCount * listenerCount );
+        VA_LOG( "   %4d listeners:  old (std::function + weak_ptr) %6.2f ns   Add (weak_ptr) %6.2f ns   AddStatic %6.2f ns  per listener call",
+            listenerCount, oldTime * toNs, tokenTime * toNs, staticTime * toNs );
+    }
+}
+
+void vaCoreBenchmarks::SmallVector( )
+{
+    if( !vaMemory::IsTrackingEnabled( ) )
+        VA_LOG( "   (allocation counts need VA_MEMORY_TRACKING_ENABLED in vaConfig.h - only timings below)" );
+
+    auto logCase = [ ]( const char * name, double oldTime, int64 oldAllocs, double newTime, int64 newAllocs )
+    {
+        if( oldAllocs >= 0 )
+            VA_LOG( "   %-22s std: %8.2f ms %8lld allocs   small: %8.2f ms %8lld allocs   (%.2fx)", name, oldTime, oldAllocs, newTime, newAllocs, oldTime / vaMath::Max( newTime, 0.001 ) );
+        else
+            VA_LOG( "   %-22s std: %8.2f ms   small: %8.2f ms   (%.2fx)", name, oldTime, newTime, oldTime / vaMath::Max( newTime, 0.001 ) );
+    };
+
+    // 1.) per-frame shader macro list build + compare against the current one (vaPostProcessTonemap::UpdateShaders,
+    // vaASSAOLite::UpdateTextures); same as vaShaderMacroScratchList/vaShaderMacrosUpdate in Rendering/vaShader.h
+    {
+        typedef vector< pair< string, string > >                                        StdMacros;
+        typedef vaSmallVector< pair< vaSmallString<96>, vaSmallString<32> >, 8 >         SmallMacros;
+
+        const int iterations = 200000;
+        StdMacros current = { { "POSTPROCESS_TONEMAP_MSAA_SAMPLE_COUNT", "4" }, { "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR", "" }, { "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_COMPLEXITY_MASK", "" } };
+        int changes = 0;
+
+        auto runStd = [&]( )
+        {
+            for( int i = 0; i < iterations; i++ )
+            {
+                StdMacros newMacros;
+                newMacros.push_back( std::make_pair( string( "POSTPROCESS_TONEMAP_MSAA_SAMPLE_COUNT" ), vaStringTools::Format( "%d", 4 ) ) );
+                newMacros.push_back( std::make_pair( string( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR" ), string( "" ) ) );
+                newMacros.push_back( std::make_pair( string( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_COMPLEXITY_MASK" ), string( "" ) ) );
+                if( newMacros != current )
+                {
+                    current = newMacros;
+                    changes++;
+                }
+            }
+        };
+        auto runSmall = [&]( )
+        {
+            for( int i = 0; i < iterations; i++ )
+            {
+                SmallMacros newMacros;
+                newMacros.emplace_back( "POSTPROCESS_TONEMAP_MSAA_SAMPLE_COUNT", vaSmallString<32>::Format( "%d", 4 ) );
+                newMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR", "" );
+                newMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_COMPLEXITY_MASK", "" );
+                bool same = newMacros.size( ) == current.size( );
+                for( size_t j = 0; same && j < newMacros.size( ); j++ )
+                    same = ( newMacros[j].first == current[j].first ) && ( newMacros[j].second == current[j].second );
+                if( !same )
+                    changes++;
+            }
+        };
+
+        double oldTime = 0.0, newTime = 0.0;
+        int64 oldAllocs = CountAllocations( [&]( ) { oldTime = MeasureMilliseconds( runStd ); } );
+        int64 newAllocs = CountAllocations( [&]( ) { newTime = MeasureMilliseconds( runSmall ); } );
+        assert( changes == 0 );
+        logCase( "shader macro list", oldTime, oldAllocs, newTime, newAllocs );
+    }
+
+    // 2.) per-object child & mesh lists (vaSceneObject): create objects with 0-4 children and 1-2 meshes, then walk them
+    {
+        const int objectCount = 100000;
+        const int walkCount   = 20;
+
+        struct StdObject    { vector<shared_ptr<int>> Children;                vector<vaGUID> Meshes;              };
+        struct SmallObject  { vaSmallVector<shared_ptr<int>, 4> Children;      vaSmallVector<vaGUID, 2> Meshes;    };
+
+        shared_ptr<int> child = std::make_shared<int>( 1 );
+
+        auto build = [&]( auto & objects )
+        {
+            objects.resize( objectCount );
+            for( int i = 0; i < objectCount; i++ )
+            {
+                for( int c = 0; c < i % 5; c++ )
+                    objects[i].Children.push_back( child );
+                objects[i].Meshes.resize( 1 + i % 2 );
+            }
+        };
+        auto walk = [&]( const auto & objects )
+        {
+            int64 sum = 0;
+            for( int w = 0; w < walkCount; w++ )
+                for( const auto & object : objects )
+                {
+                    for( const auto & c : object.Children )
+                        sum += *c;
+                    sum += object.Meshes.size( );
+                }
+            s_sink = (float)sum;
+        };
+
+        vector<StdObject>   stdObjects;
+        vector<SmallObject> smallObjects;
+        stdObjects.reserve( objectCount );
+        smallObjects.reserve( objectCount );
+
+        double oldTime = 0.0, newTime = 0.0;
+        int64 oldAllocs = CountAllocations( [&]( ) { oldTime = MeasureMilliseconds( [&]( ) { build( stdObjects ); } ); } );
+        int64 newAllocs = CountAllocations( [&]( ) { newTime = MeasureMilliseconds( [&]( ) { build( smallObjects ); } ); } );
+        logCase( "object lists: create", oldTime, oldAllocs, newTime, newAllocs );
+
+        oldTime = MeasureMilliseconds( [&]( ) { walk( stdObjects ); } );
+        newTime = MeasureMilliseconds( [&]( ) { walk( smallObjects ); } );
+        logCase( "object lists: walk", oldTime, -1, newTime, -1 );
+    }
+
+    // 3.) short per-call scratch list (gather a handful of items, process, discard)
+    {
+        const int iterations = 1000000;
+        vaRandom random( 42 );
+        vector<int> inputs( 1024 );
+        for( int & input : inputs )
+            input = random.NextINT32( ) & 0xFFFF;
+
+        auto gather = [&]( auto & scratch, int i )
+        {
+            for( int j = 0; j < 1 + ( i % 8 ); j++ )
+                scratch.push_back( inputs[( i + j * 31 ) & 1023] );
+            int sum = 0;
+            for( int value : scratch )
+                sum += value;
+            return sum;
+        };
+
+        int64 sum = 0;
+        double oldTime = 0.0, newTime = 0.0;
+        int64 oldAllocs = CountAllocations( [&]( ) { oldTime = MeasureMilliseconds( [&]( ) { for( int i = 0; i < iterations; i++ ) { vector<int> scratch; sum += gather( scratch, i ); } } ); } );
+        int64 newAllocs = CountAllocations( [&]( ) { newTime = MeasureMilliseconds( [&]( ) { for( int i = 0; i < iterations; i++ ) { vaSmallVector<int, 8> scratch; sum += gather( scratch, i ); } } ); } );
+        s_sink = (float)sum;
+        logCase( "per-call scratch", oldTime, oldAllocs, newTime, newAllocs );
+    }
+}
+
+void vaCoreBenchmarks::StringID( )
+{
+    int     internedBefore  = vaStringInterner::GetInstance( ).GetCount( );
+    size_t  memoryBefore    = vaStringInterner::GetInstance( ).GetMemoryUsage( );
+
+    auto logCase = [ ]( const char * name, double oldTime, double newTime )
+    {
+        VA_LOG( "   %-28s string: %8.2f ms   vaStringID: %8.2f ms   (%.2fx)", name, oldTime, newTime, oldTime / vaMath::Max( newTime, 0.001 ) );
+    };
+
+    // 1.) asset pack load & lookups (vaAssetPack::LoadAPACKTableOfContents, vaAssetPack::Find): names are lowercased
+    // and inserted into the lazy-load table, then each is looked up a few times (material -> texture references etc.)
+    {
+        const int assetCount    = 20000;
+        const int lookupsEach   = 4;
+
+        vector<string> names( assetCount );
+        for( int i = 0; i < assetCount; i++ )
+            names[i] = vaStringTools::Format( "Sponza_Material_%d_Texture_BaseColor_%d", i / 3, i );
+
+        int64 found = 0;
+        double loadOld = MeasureMilliseconds( [&]( )
+        {
+            std::map< string, int > map;
+            for( int i = 0; i < assetCount; i++ )
+                map.insert( std::make_pair( vaStringTools::ToLower( names[i] ), i ) );
+            for( int l = 0; l < lookupsEach; l++ )
+                for( int i = 0; i < assetCount; i++ )
+                    found += map.find( vaStringTools::ToLower( names[( i * 7 + l ) % assetCount] ) ) != map.end( );
+        } );
+        double loadNew = MeasureMilliseconds( [&]( )
+        {
+            std::unordered_map< vaStringID, int, vaStringID::Hasher > map;
+            map.reserve( assetCount );
+            for( int i = 0; i < assetCount; i++ )
+                map.insert( std::make_pair( vaStringID( vaStringTools::ToLower( names[i] ) ), i ) );
+            for( int l = 0; l < lookupsEach; l++ )
+                for( int i = 0; i < assetCount; i++ )
+                    found += map.find( vaStringID::Find( vaStringTools::ToLower( names[( i * 7 + l ) % assetCount] ) ) ) != map.end( );
+        } );
+        s_sink = (float)found;
+        logCase( "asset pack: load + lookups", loadOld, loadNew );
+    }
+
+    // 2.) per-frame profiler scope lookups (vaNestedProfilerNode::StartScope): ~100 named scopes, each one found in its
+    // parent's child map by name every frame; the old path also built a std::string from the literal every time
+    {
+        const int frames = 2000;
+        #define BENCH_SCOPES( X ) X( "WholeFrame" ) X( "Tick" ) X( "Draw" ) X( "DepthPrePass" ) X( "GBuffer" ) X( "ShadowMaps" ) X( "Lighting" ) X( "ASSAO" ) X( "Transparencies" ) X( "PostProcessTonemap" )
+        const char * scopeNames[] = {
+            #define BENCH_SCOPE_NAME( name ) name,
+            BENCH_SCOPES( BENCH_SCOPE_NAME )
+            #undef BENCH_SCOPE_NAME
+        };
+        const int scopeCount = (int)_countof( scopeNames );
+
+        std::map< string, int >                                     oldChildren;
+        std::unordered_map< vaStringID, int, vaStringID::Hasher >   newChildren;
+        for( int i = 0; i < scopeCount; i++ )
+        {
+            oldChildren.insert( std::make_pair( string( scopeNames[i] ), i ) );
+            newChildren.insert( std::make_pair( vaStringID( scopeNames[i] ), i ) );
+        }
+
+        int64 sum = 0;
+        double oldTime = MeasureMilliseconds( [&]( )
+        {
+            for( int f = 0; f < frames * 10; f++ )
+            {
+                #define BENCH_SCOPE_OLD( name ) { const string & n = string( name ); sum += oldChildren.find( n )->second; }
+                BENCH_SCOPES( BENCH_SCOPE_OLD )
+                #undef BENCH_SCOPE_OLD
+            }
+        } );
+        double newTime = MeasureMilliseconds( [&]( )
+        {
+            for( int f = 0; f < frames * 10; f++ )
+            {
+                #define BENCH_SCOPE_NEW( name ) { const vaStringID & n = VA_STRING_ID( name ); sum += newChildren.find( n )->second; }
+                BENCH_SCOPES( BENCH_SCOPE_NEW )
+                #undef BENCH_SCOPE_NEW
+            }
+        } );
+        #undef BENCH_SCOPES
+        s_sink = (float)sum;
+        logCase( "profiler scopes: per frame", oldTime / frames, newTime / frames );
+    }
+
+    VA_LOG( "   interner: %d strings, %.1f KB (this benchmark added %d strings, %.1f KB)", vaStringInterner::GetInstance( ).GetCount( ), vaStringInterner::GetInstance( ).GetMemoryUsage( ) / 1024.0,
+        vaStringInterner::GetInstance( ).GetCount( ) - internedBefore, ( vaStringInterner::GetInstance( ).GetMemoryUsage( ) - memoryBefore ) / 1024.0 );
+}
+
+void vaCoreBenchmarks::PropertyContainer( )
+{
+    // a settings block shaped like the post-process ones (tonemap, CMAA2, ASSAO): a couple dozen mixed properties
+    struct Settings
+    {
+        bool    Bools[6];
+        int32   Ints[6];
+        uint32  UInts[2];
+        float   Floats[10];
+        string  Text;
+    } settings = { };
+
+    vaPropertyContainer container( "BenchmarkSettings" );
+    vector<string> names;
+    for( int i = 0; i < (int)_countof( settings.Bools ); i++ )  { names.push_back( vaStringTools::Format( "EnableFeature%d", i ) );   container.RegisterProperty( names.back( ), settings.Bools[i], false, true ); }
+    for( int i = 0; i < (int)_countof( settings.Ints ); i++ )   { names.push_back( vaStringTools::Format( "QualityLevel%d", i ) );    container.RegisterProperty( names.back( ), settings.Ints[i], 0, true, true, true, 0, 10 ); }
+    for( int i = 0; i < (int)_countof( settings.UInts ); i++ )  { names.push_back( vaStringTools::Format( "SampleCount%d", i ) );     container.RegisterProperty( names.back( ), settings.UInts[i], 1u, true ); }
+    for( int i = 0; i < (int)_countof( settings.Floats ); i++ ) { names.push_back( vaStringTools::Format( "Parameter%d", i ) );       container.RegisterProperty( names.back( ), settings.Floats[i], 1.0f, true, true, true ); }
+    names.push_back( "PresetName" ); container.RegisterProperty( names.back( ), settings.Text, string( "default" ), true );
+
+    // a few presets, each saved both ways
+    const int presetCount = 8;
+    vector<string>                          xmlPresets;
+    vector<shared_ptr<vaMemoryStream>>      binaryPresets;
+    vaRandom random( 42 );
+    for( int p = 0; p < presetCount; p++ )
+    {
+        for( bool & value : settings.Bools )    value = ( random.NextINT32( ) & 1 ) != 0;
+        for( int32 & value : settings.Ints )    value = random.NextINT32( ) & 7;
+        for( uint32 & value : settings.UInts )  value = 1 << ( random.NextINT32( ) & 3 );
+        for( float & value : settings.Floats )  value = random.NextFloat( );
+        settings.Text = vaStringTools::Format( "Preset%d", p );
+
+        vaXMLSerializer writer;
+        writer.Serialize<vaXMLSerializable>( "Settings", container );
+        xmlPresets.push_back( string( writer.GetWritePrinter( ).CStr( ) ) );
+
+        binaryPresets.push_back( std::make_shared<vaMemoryStream>( (int64)0, 1024 ) );
+        container.SaveBinary( *binaryPresets.back( ) );
+    }
+
+    const int applyCount = 10000;
+    int failed = 0;
+    double xmlTime = MeasureMilliseconds( [&]( )
+    {
+        for( int i = 0; i < applyCount; i++ )
+        {
+            const string & xml = xmlPresets[i % presetCount];
+            vaXMLSerializer reader( xml.c_str( ), xml.length( ) + 1 );
+            failed += !reader.Serialize<vaXMLSerializable>( "Settings", container );
+        }
+    } );
+    double binaryTime = MeasureMilliseconds( [&]( )
+    {
+        for( int i = 0; i < applyCount; i++ )
+        {
+            vaMemoryStream & stream = *binaryPresets[i % presetCount];
+            stream.Seek( 0 );
+            failed += !container.LoadBinary( stream );
+        }
+    } );
+    assert( failed == 0 );
+    VA_LOG( "   apply preset (%d props)     XML: %8.2f us   binary: %8.2f us   (%.1fx, %d bytes vs %d bytes)", container.GetPropertyCount( ), xmlTime * 1000.0 / applyCount, binaryTime * 1000.0 / applyCount,
+        xmlTime / vaMath::Max( binaryTime, 0.001 ), (int)xmlPresets[0].length( ), (int)binaryPresets[0]->GetPosition( ) );
+
+    // lookups by name: linear walk with string compares (what finding a property used to cost) vs the hash index
+    const int lookupCount = 1000000;
+    vector<vaStringID> ids;
+    for( const string & name : names )
+        ids.push_back( vaStringID( name ) );
+    int64 sum = 0;
+    double linearTime = MeasureMilliseconds( [&]( )
+    {
+        for( int i = 0; i < lookupCount; i++ )
+        {
+            const string & name = names[( i * 7 ) % names.size( )];
+            for( int j = 0; j < (int)names.size( ); j++ )
+                if( names[j] == name ) { sum += j; break; }
+        }
+    } );
+    double indexedTime = MeasureMilliseconds( [&]( )
+    {
+        for( int i = 0; i < lookupCount; i++ )
+            sum += container.FindProperty( ids[( i * 7 ) % ids.size( )] );
+    } );
+    s_sink = (float)sum;
+    VA_LOG( "   find property by name       linear: %8.2f ns   indexed: %8.2f ns   (%.1fx)", linearTime * 1e6 / lookupCount, indexedTime * 1e6 / lookupCount, linearTime / vaMath::Max( indexedTime, 0.001 ) );
+}
+
+void vaCoreBenchmarks::LargeBitmapFile( )
+{
+    // a 64MB image (4x the cache budget used below) of noise so that the block cache backend can't compress or
+    // constant-fold blocks and both backends end up with the same raw data; the file is just written so reads are
+    // mostly served from the OS file cache - this compares the overhead of the two paths, not the disk
+    const int imageDim      = 4096;
+    const int stripHeight   = 256;
+    const int tileDim       = 64;
+    const int tileCount     = 4096;
+    const int bytesPerPixel = 4;
+
+    vector<uint32> strip( (size_t)imageDim * stripHeight );
+    const int stripPitch = imageDim * bytesPerPixel;
+
+    const int64 oldBudget = vaLargeBitmapFile::GetCacheBudget( );
+    vaLargeBitmapFile::SetCacheBudget( 16 * 1024 * 1024 );
+
+    const struct { const char * Name; vaLargeBitmapFile::Backend Backend; } backends[] =
+    {
+        { "block cache",    vaLargeBitmapFile::Backend::BlockCache },
+        { "mapped",         vaLargeBitmapFile::Backend::Mapped },
+    };
+    for( const auto & backend : backends )
+    {
+        wstring path = vaCore::GetExecutableDirectory( ) + L"benchmark_largebitmap.tmp";
+
+        shared_ptr<vaLargeBitmapFile> bitmap = vaLargeBitmapFile::Create( path, vaLargeBitmapFile::Format32BitRGBA, imageDim, imageDim, backend.Backend );
+        if( bitmap == nullptr )
+        {
+            VA_LOG_ERROR( "   %-12s unable to create '%s'", backend.Name, vaStringTools::SimpleNarrow( path ).c_str( ) );
+            continue;
+        }
+
+        bool ok = true;
+        vaRandom random( 42 );
+        double writeTime = MeasureMilliseconds( [&]( )
+        {
+            for( int y = 0; y < imageDim; y += stripHeight )
+            {
+                for( uint32 & pixel : strip )
+                    pixel = random.NextUINT32( );
+                ok &= bitmap->WriteRect( strip.data( ), stripPitch, 0, y, imageDim, stripHeight );
+            }
+            ok &= bitmap->Flush( );
+        } );
+        bitmap->Close( );
+        bitmap = vaLargeBitmapFile::Open( path, true, backend.Backend );
+        ok &= bitmap != nullptr;
+
+        uint64 sum = 0;
+        double streamTime = 0.0, randomTime = 0.0;
+        if( bitmap != nullptr )
+        {
+            bitmap->SetAccessPattern( vaLargeBitmapFile::AccessPattern::Sequential );
+            streamTime = MeasureMilliseconds( [&]( )
+            {
+                for( int y = 0; y < imageDim; y += stripHeight )
+                {
+                    ok &= bitmap->ReadRect( strip.data( ), stripPitch, (int64)strip.size( ) * bytesPerPixel, 0, y, imageDim, stripHeight );
+                    sum += strip[y];
+                }
+            } );
+
+            bitmap->SetAccessPattern( vaLargeBitmapFile::AccessPattern::Random );
+            vaRandom tileRandom( 7 );
+            randomTime = MeasureMilliseconds( [&]( )
+            {
+                for( int i = 0; i < tileCount; i++ )
+                {
+                    int x = (int)( tileRandom.NextUINT32( ) % ( imageDim - tileDim ) );
+                    int y = (int)( tileRandom.NextUINT32( ) % ( imageDim - tileDim ) );
+                    ok &= bitmap->ReadRect( strip.data( ), tileDim * bytesPerPixel, (int64)strip.size( ) * bytesPerPixel, x, y, tileDim, tileDim );
+                    sum += strip[i % ( tileDim * tileDim )];
+                }
+            } );
+            bitmap->Close( );
+        }
+        bitmap = nullptr;
+        vaFileTools::DeleteFile( path );
+        s_sink = (float)sum;
+
+        if( !ok )
+            VA_LOG_ERROR( "   %-12s failed", backend.Name );
+        VA_LOG( "   %-12s write+flush: %8.2f ms   stream read: %8.2f ms (%.0f MB/s)   random %dx%d reads: %8.2f us each",
+            backend.Name, writeTime, streamTime, ( (double)imageDim * imageDim * bytesPerPixel / ( 1024.0 * 1024.0 ) ) / vaMath::Max( streamTime / 1000.0, 1e-6 ),
+            tileDim, tileDim, randomTime * 1000.0 / tileCount );
+    }
+
+    vaLargeBitmapFile::SetCacheBudget( oldBudget );
+}
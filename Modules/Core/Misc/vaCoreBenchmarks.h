@@ -0,0 +1,44 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+namespace VertexAsylum
+{
+    // CPU micro benchmarks comparing Core containers and systems against the ones they are meant to replace, run from the
+    // BENCHMARK_CORE console command (results go to the log). They use synthetic workloads shaped after the engine's
+    // (particles, lights, debug draw items, ...) so they are a guide for migrating systems, not a substitute for profiling.
+    class vaCoreBenchmarks
+    {
+    public:
+        // 'nameOrWildcard' is one of the names listed by Run( "" ), or '*' for all
+        static void                         Run( const string & nameOrWildcard );
+
+    private:
+        static void                         SlotMap( );
+        static void                         UIDRegistry( );
+        static void                         Event( );
+        static void                         SmallVector( );
+        static void                         StringID( );
+        static void                         PropertyContainer( );
+        static void                         LargeBitmapFile( );
+    };
+}
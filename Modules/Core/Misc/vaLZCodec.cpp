@@ -0,0 +1,228 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "vaLZCodec.h"
+
+#include <memory>
+
+using namespace VertexAsylum;
+
+namespace
+{
+    const int       c_hashLog               = 16;
+    const int       c_minMatch              = 4;
+    const int       c_lastLiterals          = 5;        // last bytes of a block are always literals
+    const int       c_matchSafeDistance     = 12;       // no match can start closer than this to the end of the block
+    const int64     c_maxOffset             = 65535;
+
+    inline uint32   Read32( const uint8 * ptr )         { uint32 val; memcpy( &val, ptr, sizeof( val ) ); return val; }
+    inline uint32   Hash( uint32 sequence )             { return ( sequence * 2654435761u ) >> ( 32 - c_hashLog ); }
+
+    inline uint8 *  WriteLength( uint8 * op, int64 length )
+    {
+        for( ; length >= 255; length -= 255 )
+            *op++ = 255;
+        *op++ = (uint8)length;
+        return op;
+    }
+
+    inline bool     ReadLength( const uint8 * & ip, const uint8 * iend, int64 & inoutLength )
+    {
+        uint32 val;
+        do
+        {
+            if( ip >= iend )
+                return false;
+            val = *ip++;
+            inoutLength += val;
+        } while( val == 255 );
+        return true;
+    }
+}
+
+int64 vaLZCodec::Compress( const void * _src, int64 srcSize, void * _dst, int64 dstCapacity )
+{
+    // requiring worst case capacity up front means no bounds checks are needed below
+    if( srcSize < 0 || dstCapacity < GetMaxCompressedSize( srcSize ) )
+        return -1;
+
+    const uint8 *   src         = (const uint8 *)_src;
+    const uint8 *   ip          = src;
+    const uint8 *   anchor      = src;
+    const uint8 *   iend        = src + srcSize;
+    uint8 *         op          = (uint8 *)_dst;
+
+    if( srcSize > c_matchSafeDistance )
+    {
+        const uint8 * matchLimit    = iend - c_lastLiterals;
+        const uint8 * mflimit       = iend - c_matchSafeDistance;
+
+        // positions relative to src; stale or zero entries are fine as every candidate gets verified
+        std::unique_ptr<uint32[]> hashTable( new uint32[ 1 << c_hashLog ] );
+        memset( hashTable.get( ), 0, sizeof( uint32 ) << c_hashLog );
+
+        ip++;
+        while( ip < mflimit )
+        {
+            uint32 sequence     = Read32( ip );
+            uint32 & entry      = hashTable[ Hash( sequence ) ];
+            const uint8 * ref   = src + entry;
+            entry               = (uint32)( ip - src );
+
+            if( ref >= ip || ( ip - ref ) > c_maxOffset || Read32( ref ) != sequence )
+            {
+                // the longer we go without a match the faster we skip ahead (cheap on incompressible data)
+                ip += 1 + ( ( ip - anchor ) >> 6 );
+                continue;
+            }
+
+            // extend backwards into pending literals
+            while( ip > anchor && ref > src && ip[-1] == ref[-1] )
+            {
+                ip--;
+                ref--;
+            }
+
+            const uint8 * matchEnd  = ip + c_minMatch;
+            const uint8 * refEnd    = ref + c_minMatch;
+            while( matchEnd < matchLimit && *matchEnd == *refEnd )
+            {
+                matchEnd++;
+                refEnd++;
+            }
+
+            int64 literalLength = ip - anchor;
+            int64 matchLength   = ( matchEnd - ip ) - c_minMatch;
+
+            uint8 * token = op++;
+            if( literalLength >= 15 )
+            {
+                *token  = 15 << 4;
+                op      = WriteLength( op, literalLength - 15 );
+            }
+            else
+                *token  = (uint8)( literalLength << 4 );
+            memcpy( op, anchor, (size_t)literalLength );
+            op += literalLength;
+
+            uint32 offset = (uint32)( ip - ref );
+            *op++ = (uint8)( offset & 0xFF );
+            *op++ = (uint8)( offset >> 8 );
+
+            if( matchLength >= 15 )
+            {
+                *token |= 15;
+                op      = WriteLength( op, matchLength - 15 );
+            }
+            else
+                *token |= (uint8)matchLength;
+
+            ip = anchor = matchEnd;
+
+            // the position just before the end of the match is a good candidate for the next one
+            if( ip - 2 > src && ip < mflimit )
+                hashTable[ Hash( Read32( ip - 2 ) ) ] = (uint32)( ip - 2 - src );
+        }
+    }
+
+    // last literals
+    int64 literalLength = iend - anchor;
+    if( literalLength >= 15 )
+    {
+        *op++   = 15 << 4;
+        op      = WriteLength( op, literalLength - 15 );
+    }
+    else
+        *op++   = (uint8)( literalLength << 4 );
+    if( literalLength > 0 )     // src can be null for an empty input and memcpy from null is UB even for 0 bytes
+        memcpy( op, anchor, (size_t)literalLength );
+    op += literalLength;
+
+    return op - (uint8 *)_dst;
+}
+
+bool vaLZCodec::Decompress( const void * _src, int64 srcSize, void * _dst, int64 dstSize )
+{
+    const uint8 *   ip      = (const uint8 *)_src;
+    const uint8 *   iend    = ip + srcSize;
+    uint8 *         dst     = (uint8 *)_dst;
+    uint8 *         op      = dst;
+    uint8 *         oend    = dst + dstSize;
+
+    while( ip < iend )
+    {
+        uint32 token = *ip++;
+
+        // literals
+        int64 literalLength = token >> 4;
+        if( literalLength == 15 && !ReadLength( ip, iend, literalLength ) )
+            return false;
+        if( literalLength > iend - ip || literalLength > oend - op )
+            return false;
+        if( literalLength <= 16 && iend - ip >= 16 && oend - op >= 16 )
+            memcpy( op, ip, 16 );       // fixed size copy is much faster; the overshoot gets overwritten later
+        else if( literalLength > 0 )    // dst can be null for an empty output
+            memcpy( op, ip, (size_t)literalLength );
+        op += literalLength;
+        ip += literalLength;
+
+        // last sequence has no match
+        if( ip == iend )
+            break;
+
+        // match
+        if( iend - ip < 2 )
+            return false;
+        int64 offset = (int64)ip[0] | ( (int64)ip[1] << 8 );
+        ip += 2;
+        if( offset == 0 || offset > op - dst )
+            return false;
+
+        int64 matchLength = token & 15;
+        if( matchLength == 15 && !ReadLength( ip, iend, matchLength ) )
+            return false;
+        matchLength += c_minMatch;
+        if( matchLength > oend - op )
+            return false;
+
+        const uint8 * match = op - offset;
+        uint8 * matchEnd    = op + matchLength;
+        if( offset >= 16 && oend - matchEnd >= 16 )
+        {
+            // chunks never overlap within a single copy so memcpy is fine; may write up to 15 bytes past matchEnd
+            for( ; op < matchEnd; op += 16, match += 16 )
+                memcpy( op, match, 16 );
+        }
+        else if( offset >= 8 && oend - matchEnd >= 8 )
+        {
+            for( ; op < matchEnd; op += 8, match += 8 )
+                memcpy( op, match, 8 );
+        }
+        else
+        {
+            // short offsets are repeating patterns (RLE), must go byte by byte
+            for( ; op < matchEnd; op++, match++ )
+                *op = *match;
+        }
+        op = matchEnd;
+    }
+
+    return op == oend;
+}
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+namespace VertexAsylum
+{
+    // Small byte oriented LZ77 block codec using the LZ4 token format (4bit literal length + 4bit match length token,
+    // 255-continued lengths, 16bit little endian offsets, last 5 bytes always literals). Trades ratio for speed: decode
+    // is a sequence of (mostly 16 byte) memcpys with no entropy stage. Blocks are independent and there is no framing,
+    // the caller has to store the compressed and uncompressed sizes (vaCompressionStream Profile::Fast does that).
+    // Thread safe (no shared state).
+    class vaLZCodec
+    {
+    private:
+        vaLZCodec( )    { }
+        ~vaLZCodec( )   { }
+
+    public:
+        // Worst case compressed size for incompressible input
+        static int64                GetMaxCompressedSize( int64 srcSize )       { return srcSize + srcSize / 255 + 16; }
+
+        // Returns compressed size, or -1 if dstCapacity < GetMaxCompressedSize( srcSize )
+        static int64                Compress( const void * src, int64 srcSize, void * dst, int64 dstCapacity );
+
+        // dstSize must be the exact uncompressed size; returns false on corrupted input (never reads or writes out of bounds)
+        static bool                 Decompress( const void * src, int64 srcSize, void * dst, int64 dstSize );
+    };
+
+}
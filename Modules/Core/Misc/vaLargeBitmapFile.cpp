@@ -20,14 +20,19 @@
 #include "vaLargeBitmapFile.h"
 
 #include "Core/Misc/vaProfiler.h"
+#include "Core/Misc/vaLZCodec.h"
+#include "Core/Misc/vaTracer.h"
+#include "Core/Containers/vaSmallVector.h"
 
-using namespace VertexAsylum;
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
 
-int vaLargeBitmapFile::s_TotalUsedMemory = 0;
+using namespace VertexAsylum;
 
-VA_LBF_THREADSAFE_LINE( mutex vaLargeBitmapFile::s_TotalUsedMemoryMutex; )
+std::atomic<int64> vaLargeBitmapFile::s_CacheBudget( vaLargeBitmapFile::c_DefaultCacheBudget );
 
-#pragma warning ( suppress: 4505 ) // unreferenced local function has been removed
 static bool CreateNewStorageFile( vaFileStream & fileStream, const wstring & filePath, int64 size )
 {
     if( fileStream.IsOpen( ) )
@@ -35,7 +40,7 @@ static bool CreateNewStorageFile( vaFileStream & fileStream, const wstring & fil
         VA_LOG( "vaLargeBitmapFile::CreateNewStorageFile failed, fileStream already open" );
         return false;
     }
-    if( !fileStream.Open( filePath, FileCreationMode::Create, FileAccessMode::ReadWrite, FileShareMode::None ) )
+    if( !fileStream.OpenForConcurrentIO( filePath, FileCreationMode::Create, FileAccessMode::ReadWrite, FileShareMode::None ) )
     {
         VA_LOG( "vaLargeBitmapFile::CreateNewStorageFile failed, file creation filed" );
         return false;
@@ -57,6 +62,246 @@ static bool CreateNewStorageFile( vaFileStream & fileStream, const wstring & fil
     return true;
 }
 
+// Loaded blocks of all open files in one ring, evicted with the CLOCK (second chance) approximation of LRU: access only
+// sets the block's Referenced flag (no locking, no list reordering on the hot path), and the hand skips - and clears -
+// referenced blocks, so a block is only evicted if it wasn't used since the hand last passed it. Blocks that are locked
+// (in use) are skipped too.
+// Also owns the I/O threads serving Prefetch requests. Exists while at least one file is open (Acquire/Release) so that
+// the threads never outlive the blocks or get torn down by static destructors.
+class vaLargeBitmapFile::BlockCache
+{
+public:
+    struct PrefetchRequest
+    {
+        vaLargeBitmapFile *                 File;
+        int                                 Bx;
+        int                                 By;
+    };
+
+private:
+    mutex                                   m_mutex;                // ring, hand & used bytes
+    DataBlock *                             m_hand              = nullptr;
+    int64                                   m_usedBytes         = 0;
+    int                                     m_blockCount        = 0;
+
+    std::mutex                              m_queueMutex;           // queue & each file's m_PrefetchesInFlight; std:: for the condition variables
+    std::condition_variable                 m_queueCV;
+    std::condition_variable                 m_idleCV;
+    std::deque<PrefetchRequest>             m_queue;
+    bool                                    m_stop              = false;
+    std::thread                             m_threads[c_IOThreadCount];
+
+    static mutex                            s_instanceMutex;
+    static BlockCache *                     s_instance;
+    static int                              s_fileCount;
+
+private:
+    BlockCache( )
+    {
+        for( int i = 0; i < c_IOThreadCount; i++ )
+            m_threads[i] = std::thread( [this]( ) { IOThreadProc( ); } );
+    }
+    ~BlockCache( )
+    {
+        {
+            std::unique_lock<std::mutex> lock( m_queueMutex );
+            m_stop = true;
+        }
+        m_queueCV.notify_all( );
+        for( int i = 0; i < c_IOThreadCount; i++ )
+            m_threads[i].join( );
+        assert( m_hand == nullptr && m_usedBytes == 0 && m_blockCount == 0 );
+    }
+
+public:
+    static BlockCache &                     Acquire( );
+    static void                             Release( );
+
+    // mostly for SetCacheBudget/GetCacheUsedBytes; calls 'func' with the instance (if any) and the instance mutex held
+    template< typename FuncType >
+    static void                             WithInstance( FuncType && func )     { std::unique_lock<mutex> lock( s_instanceMutex ); if( s_instance != nullptr ) func( *s_instance ); }
+
+    // block must be locked (unique) by the caller; Insert evicts other blocks if over budget
+    void                                    Insert( DataBlock & block );
+    void                                    Remove( DataBlock & block );
+
+    // evict until under budget (or nothing evictable left); 'keep' is the caller's locked block (if any)
+    void                                    EnforceBudget( const DataBlock * keep );
+
+    int64                                   GetUsedBytes( )                     { std::unique_lock<mutex> lock( m_mutex ); return m_usedBytes; }
+
+    void                                    QueuePrefetch( const PrefetchRequest * requests, int count );
+
+    // drops the file's queued requests and waits for the ones being executed
+    void                                    CancelPrefetches( vaLargeBitmapFile * file );
+
+private:
+    static int64                            BlockSize( const DataBlock & block )  { return (int64)block.Width * block.Height * block.Owner->m_BytesPerPixel; }
+
+    void                                    LinkNoMutexLock( DataBlock & block );
+    void                                    UnlinkNoMutexLock( DataBlock & block );
+
+    void                                    IOThreadProc( );
+};
+
+mutex                                   vaLargeBitmapFile::BlockCache::s_instanceMutex;
+vaLargeBitmapFile::BlockCache *         vaLargeBitmapFile::BlockCache::s_instance   = nullptr;
+int                                     vaLargeBitmapFile::BlockCache::s_fileCount  = 0;
+
+vaLargeBitmapFile::BlockCache & vaLargeBitmapFile::BlockCache::Acquire( )
+{
+    std::unique_lock<mutex> lock( s_instanceMutex );
+    if( s_instance == nullptr )
+        s_instance = new BlockCache( );
+    s_fileCount++;
+    return *s_instance;
+}
+
+void vaLargeBitmapFile::BlockCache::Release( )
+{
+    std::unique_lock<mutex> lock( s_instanceMutex );
+    assert( s_fileCount > 0 && s_instance != nullptr );
+    if( --s_fileCount == 0 )
+    {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+}
+
+void vaLargeBitmapFile::BlockCache::LinkNoMutexLock( DataBlock & block )
+{
+    assert( block.CachePrev == nullptr && block.CacheNext == nullptr );
+    if( m_hand == nullptr )
+    {
+        block.CachePrev = block.CacheNext = &block;
+        m_hand = &block;
+    }
+    else
+    {
+        // just behind the hand, so it's the last one the hand gets to
+        block.CacheNext = m_hand;
+        block.CachePrev = m_hand->CachePrev;
+        m_hand->CachePrev->CacheNext = &block;
+        m_hand->CachePrev = &block;
+    }
+    m_usedBytes += BlockSize( block );
+    m_blockCount++;
+}
+
+void vaLargeBitmapFile::BlockCache::UnlinkNoMutexLock( DataBlock & block )
+{
+    assert( block.CachePrev != nullptr && block.CacheNext != nullptr );
+    if( block.CacheNext == &block )
+        m_hand = nullptr;
+    else
+    {
+        if( m_hand == &block )
+            m_hand = block.CacheNext;
+        block.CachePrev->CacheNext = block.CacheNext;
+        block.CacheNext->CachePrev = block.CachePrev;
+    }
+    block.CachePrev = block.CacheNext = nullptr;
+    m_usedBytes -= BlockSize( block );
+    m_blockCount--;
+}
+
+void vaLargeBitmapFile::BlockCache::Insert( DataBlock & block )
+{
+    {
+        std::unique_lock<mutex> lock( m_mutex );
+        LinkNoMutexLock( block );
+    }
+    EnforceBudget( &block );
+}
+
+void vaLargeBitmapFile::BlockCache::Remove( DataBlock & block )
+{
+    std::unique_lock<mutex> lock( m_mutex );
+    UnlinkNoMutexLock( block );
+}
+
+void vaLargeBitmapFile::BlockCache::EnforceBudget( const DataBlock * keep )
+{
+    for( ;; )
+    {
+        DataBlock * victim = nullptr;
+        std::unique_lock<std::shared_mutex> victimLock;
+        {
+            std::unique_lock<mutex> lock( m_mutex );
+            const int64 budget = s_CacheBudget.load( );
+
+            // two rounds at most: the first one can end up only clearing Referenced flags
+            for( int i = 0; ( m_usedBytes > budget ) && ( i < 2 * m_blockCount ); i++ )
+            {
+                DataBlock * candidate = m_hand;
+                m_hand = m_hand->CacheNext;
+                if( candidate == keep || candidate->Referenced.exchange( false ) )
+                    continue;
+
+                // never wait here - whoever holds it could be waiting for our m_mutex
+                std::unique_lock<std::shared_mutex> candidateLock( candidate->Mutex, std::try_to_lock );
+                if( !candidateLock.owns_lock( ) )
+                    continue;
+
+                UnlinkNoMutexLock( *candidate );
+                victim      = candidate;
+                victimLock  = std::move( candidateLock );
+                break;
+            }
+        }
+        if( victim == nullptr )
+            return;     // under budget, or everything left is in use / recently used
+
+        // saving & freeing is done outside of the cache lock; the block is still locked and no longer in the ring
+        victim->Owner->FreeBlockData( *victim );
+    }
+}
+
+void vaLargeBitmapFile::BlockCache::QueuePrefetch( const PrefetchRequest * requests, int count )
+{
+    if( count == 0 )
+        return;
+    {
+        std::unique_lock<std::mutex> lock( m_queueMutex );
+        m_queue.insert( m_queue.end( ), requests, requests + count );
+    }
+    m_queueCV.notify_all( );
+}
+
+void vaLargeBitmapFile::BlockCache::CancelPrefetches( vaLargeBitmapFile * file )
+{
+    std::unique_lock<std::mutex> lock( m_queueMutex );
+    m_queue.erase( std::remove_if( m_queue.begin( ), m_queue.end( ), [file]( const PrefetchRequest & request ) { return request.File == file; } ), m_queue.end( ) );
+    m_idleCV.wait( lock, [file]( ) { return file->m_PrefetchesInFlight == 0; } );
+}
+
+void vaLargeBitmapFile::BlockCache::IOThreadProc( )
+{
+    vaTracer::SetCurrentThreadName( "vaLargeBitmapFileIO" );
+
+    for( ;; )
+    {
+        PrefetchRequest request;
+        {
+            std::unique_lock<std::mutex> lock( m_queueMutex );
+            m_queueCV.wait( lock, [this]( ) { return m_stop || !m_queue.empty( ); } );
+            if( m_stop )
+                return;
+            request = m_queue.front( );
+            m_queue.pop_front( );
+            request.File->m_PrefetchesInFlight++;
+        }
+
+        request.File->ExecutePrefetch( request.Bx, request.By );
+
+        {
+            std::unique_lock<std::mutex> lock( m_queueMutex );
+            request.File->m_PrefetchesInFlight--;
+        }
+        m_idleCV.notify_all( );
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 // AdVantage Terrain SDK, Copyright (C) 2004 - 2008 Filip Strugar.
 // 
@@ -78,30 +323,6 @@ static bool CreateNewStorageFile( vaFileStream & fileStream, const wstring & fil
 
 #pragma warning( disable : 4996 )
 
-static void WriteInt32( FILE * file, int val )
-{
-    int count = (int)fwrite( &val, 1, sizeof(val), file );
-    assert( count == sizeof(val) );
-    count; // to suppress compiler warning
-    //for( int i = 0; i < 4; i++ )
-    //{
-    //   stream.WriteByte( (byte)( val & 0xFF ) );
-    //   val = val >> 8;
-    //}
-}
-
-static int ReadInt32( FILE * file )
-{
-    int ret;
-    int count = (int)fread( &ret, 1, sizeof(ret), file );
-    assert( count == sizeof(ret) );
-    count; // to suppress compiler warning
-    //for( int i = 0; i < 4; i++ )
-    //   ret |= stream.ReadByte() << ( 8 * i );
-    return ret;
-}
-
-
 int vaLargeBitmapFile::GetPixelFormatBPP( vaLargeBitmapFile::PixelFormat  pixelFormat )
 {
     switch( pixelFormat )
@@ -121,18 +342,20 @@ int vaLargeBitmapFile::GetPixelFormatBPP( vaLargeBitmapFile::PixelFormat  pixelF
 }
 
 
-vaLargeBitmapFile::vaLargeBitmapFile( FILE * file, const wstring & filePath, vaLargeBitmapFile::PixelFormat  pixelFormat, int width, int height, int blockDim, bool readOnly )
+vaLargeBitmapFile::vaLargeBitmapFile( const wstring & filePath, vaLargeBitmapFile::PixelFormat  pixelFormat, int width, int height, int blockDim, int formatVersion, bool readOnly )
 {
     VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> lock( m_GlobalMutex ); )
     m_filePath          = filePath;
-    m_File              = file;
     m_PixelFormat       = pixelFormat;
     m_Width             = width;
     m_Height            = height;
     m_BlockDim          = blockDim;
+    m_FormatVersion     = formatVersion;
+    m_FileEnd           = 0;
+    m_MappedData        = nullptr;
+    m_SweepPrefetch     = true;
     m_ReadOnly          = readOnly;
     m_BytesPerPixel     = vaLargeBitmapFile::GetPixelFormatBPP( pixelFormat );
-    m_UsedMemory        = 0;
 
     m_BlocksX           = ( width - 1 ) / blockDim + 1;
     m_BlocksY           = ( height - 1 ) / blockDim + 1;
@@ -156,16 +379,28 @@ vaLargeBitmapFile::vaLargeBitmapFile( FILE * file, const wstring & filePath, vaL
         m_DataBlocks[x] = &m_BigDataBlocksArray[m_BlocksY * x];
         for( int y = 0; y < m_BlocksY; y++ )
         {
-        m_DataBlocks[x][y].pData = 0;
-        m_DataBlocks[x][y].Width = (unsigned short)( ( x == ( m_BlocksX - 1 ) ) ? ( m_EdgeBlockWidth ) : ( blockDim ) );
-        m_DataBlocks[x][y].Height = (unsigned short)( ( y == ( m_BlocksY - 1 ) ) ? ( m_EdgeBlockHeight ) : ( blockDim ) );
-        m_DataBlocks[x][y].Modified = false;
+        DataBlock & db = m_DataBlocks[x][y];
+        db.pData            = 0;
+        db.Width            = (unsigned short)( ( x == ( m_BlocksX - 1 ) ) ? ( m_EdgeBlockWidth ) : ( blockDim ) );
+        db.Height           = (unsigned short)( ( y == ( m_BlocksY - 1 ) ) ? ( m_EdgeBlockHeight ) : ( blockDim ) );
+        db.Modified         = false;
+        db.Referenced       = false;
+        db.PrefetchQueued   = false;
+        db.Owner            = this;
+        db.CachePrev        = nullptr;
+        db.CacheNext        = nullptr;
         }
     }
-    // tempBuffer = new byte[BytesPerPixel * BlockDim * BlockDim];
 
-    VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> fileAccessMutex( m_fileAccessMutex ); )
-    _fseeki64( m_File, c_TotalHeaderSize, SEEK_SET );
+    static_assert( sizeof( BlockTableEntry ) == 40, "on-disk block table layout changed" );
+    if( m_FormatVersion >= 2 )
+        m_BlockTable.resize( (size_t)m_BlocksX * m_BlocksY, BlockTableEntry( ) );   // zeroed, so all blocks constant zero
+
+    m_PrefetchesInFlight = 0;
+    for( int i = 0; i < (int)_countof( m_LastReadRect ); i++ )
+        m_LastReadRect[i] = 0;
+
+    m_Cache = &BlockCache::Acquire( );
 
     m_AsyncOpRunningCount = 0;
 
@@ -176,7 +411,7 @@ vaLargeBitmapFile::~vaLargeBitmapFile()
     Close();
 }
 
-shared_ptr<vaLargeBitmapFile> vaLargeBitmapFile::Create( const wstring & filePath, vaLargeBitmapFile::PixelFormat  pixelFormat, int width, int height )
+shared_ptr<vaLargeBitmapFile> vaLargeBitmapFile::Create( const wstring & filePath, vaLargeBitmapFile::PixelFormat  pixelFormat, int width, int height, Backend backend )
 {
     int bytesPerPixel = GetPixelFormatBPP( pixelFormat );
     if( bytesPerPixel < 0 || bytesPerPixel > 8 ) 
@@ -186,89 +421,164 @@ shared_ptr<vaLargeBitmapFile> vaLargeBitmapFile::Create( const wstring & filePat
         return nullptr;
     }
 
-    FILE * file = _wfopen( filePath.c_str(), L"w+b" ); // File.Open( path, FileMode.Create, FileAccess.ReadWrite, FileShare.None );
-    if( file == 0 )
+    int blockDim = 256;
+
+    // mapped files need the raw fixed layout of version 1
+    int version = ( backend == Backend::Mapped ) ? ( 1 ) : ( c_FormatVersion );
+
+    shared_ptr<vaLargeBitmapFile> ret( new vaLargeBitmapFile( filePath, pixelFormat, width, height, blockDim, version, false ) );
+    vaFileStream & file = ret->m_File;
+
+    int64 fileSize;
+    if( version >= 2 )
+    {
+        // only the header and the block table; zero-filled table means all blocks are constant zero, and block data gets
+        // appended as blocks are saved
+        fileSize = ret->GetBlockTableEntryPos( (int)ret->m_BlockTable.size( ) );
+        ret->m_FileEnd = fileSize;
+    }
+    else
+    {
+        // pre-allocate file and initialize to zero
+        fileSize = (int64)bytesPerPixel * width * height + c_TotalHeaderSize;
+    }
+    if( !CreateNewStorageFile( file, filePath, fileSize ) )
     {
         VA_LOG( "vaLargeBitmapFile::Create failed, error creating file" );
         return nullptr;
     }
 
-    // pre-allocate file and initialize to zero
-    int64 fileSize = (int64)bytesPerPixel * width * height + c_TotalHeaderSize;
-    int64 remainingSize = fileSize;
-    byte allZeroes[ 1024 * 32 ];
-    memset( allZeroes, 0, sizeof(allZeroes) );
-    while( remainingSize > 0 )
+    file.Seek( 0 );
+    bool ok = file.WriteValue<int32>( (int32)pixelFormat );
+    ok &= file.WriteValue<int32>( width );
+    ok &= file.WriteValue<int32>( height );
+    ok &= file.WriteValue<int32>( version );
+    ok &= file.WriteValue<int32>( blockDim );
+    if( !ok )
     {
-        int toWrite = vaMath::Min( (int)remainingSize, (int)sizeof( allZeroes ) );
-        int count = (int)fwrite( &allZeroes, 1, toWrite, file );
-        if( count != toWrite )
+        VA_LOG( "vaLargeBitmapFile::Create failed, error writing header" );
+        return nullptr;
+    }
+
+    if( backend == Backend::Mapped )
+    {
+        file.Close( );
+        if( !ret->m_Mapped.Open( filePath, true ) )
         {
-            VA_LOG( "vaLargeBitmapFile::CreateNewStorageFile failed, error initializing file" );
-            fclose( file );
+            VA_LOG( "vaLargeBitmapFile::Create failed, error mapping file" );
             return nullptr;
         }
-        remainingSize -= sizeof(allZeroes);
+        ret->m_MappedData = const_cast<uint8 *>( ret->m_Mapped.GetData( ) );
     }
 
-    _fseeki64( file, fileSize-1, SEEK_SET );
-    char dummy = 0;
-    fwrite( &dummy, 1, 1, file );
+    return ret;
+}
 
-    _fseeki64( file, 0, SEEK_SET );
+shared_ptr<vaLargeBitmapFile> vaLargeBitmapFile::Open( const wstring & filePath, bool readOnly, Backend backend )
+{
+    int32 pixelFormat   = FormatUnknown;
+    int32 width         = 0;
+    int32 height        = 0;
+    int32 blockDim      = 128;
+    int32 version       = 0;
 
-    WriteInt32( file, (int)pixelFormat );
-    WriteInt32( file, width );
-    WriteInt32( file, height );
+    // the header is needed to set up the block table, so it's read before the file is (re)opened by the object
+    {
+        vaFileStream headerFile;
+        if( !headerFile.Open( filePath, FileCreationMode::Open, FileAccessMode::Read, FileShareMode::Read ) )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error opening file" );
+            return nullptr;
+        }
 
-    int blockDim = 256;
+        bool ok = headerFile.ReadValue<int32>( pixelFormat );
+        ok &= headerFile.ReadValue<int32>( width );
+        ok &= headerFile.ReadValue<int32>( height );
+        ok &= headerFile.ReadValue<int32>( version );
+        if( ok && version > 0 )
+            ok &= headerFile.ReadValue<int32>( blockDim );
+        if( !ok )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error reading header" );
+            return nullptr;
+        }
 
-    int version = c_FormatVersion;
-    WriteInt32( file, version );
-    WriteInt32( file, blockDim );
+        if( version > c_FormatVersion )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, file format version %d not supported", version );
+            return nullptr;
+        }
 
-    int64 pos = _ftelli64(file);
-    for( ; pos < c_TotalHeaderSize; pos++ )
-        fwrite( &dummy, 1, 1, file );
+        int bytesPerPixel = GetPixelFormatBPP( (PixelFormat)pixelFormat );
+        if( version < 2 && ( (int64)bytesPerPixel * width * height + c_TotalHeaderSize ) != headerFile.GetLength( ) )
+        {
+            // file is probably corrupt; the block cache fails on reads past the end but a mapping would just get accessed
+            // out of bounds, so refuse to map it
+            if( backend == Backend::Mapped )
+            {
+                VA_LOG_ERROR( L"vaLargeBitmapFile::Open failed, '%s' size doesn't match its header - can't be mapped", filePath.c_str( ) );
+                return nullptr;
+            }
+            assert( false );
+        }
+    }
 
-    return shared_ptr<vaLargeBitmapFile>( new vaLargeBitmapFile( file, filePath, pixelFormat, width, height, blockDim, false ) );
-}
+    if( backend == Backend::Mapped && version >= 2 )
+    {
+        VA_LOG_WARNING( L"vaLargeBitmapFile::Open - '%s' is format version %d (compressed blocks), can't be mapped - using the block cache instead", filePath.c_str( ), version );
+        backend = Backend::BlockCache;
+    }
 
-shared_ptr<vaLargeBitmapFile> vaLargeBitmapFile::Open( const wstring & filePath, bool readOnly )
-{
-    FILE * file;
-    if( readOnly )
-        file = _wfopen(filePath.c_str(), L"rb"); // File.Open( path, FileMode.Open, FileAccess.Read, FileShare.Read );
+    shared_ptr<vaLargeBitmapFile> ret( new vaLargeBitmapFile( filePath, (PixelFormat)pixelFormat, width, height, blockDim, version, readOnly ) );
+    if( backend == Backend::Mapped )
+    {
+        if( !ret->m_Mapped.Open( filePath, !readOnly ) )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error mapping file" );
+            return nullptr;
+        }
+        // could have changed since the header was read
+        if( ret->m_Mapped.GetLength( ) < (int64)ret->m_BytesPerPixel * width * height + c_TotalHeaderSize )
+        {
+            VA_LOG_ERROR( L"vaLargeBitmapFile::Open failed, '%s' is smaller than its header says", filePath.c_str( ) );
+            return nullptr;
+        }
+        ret->m_MappedData = const_cast<uint8 *>( ret->m_Mapped.GetData( ) );
+    }
+    else if( readOnly )
+    {
+        if( !ret->m_File.OpenForConcurrentIO( filePath, FileCreationMode::Open, FileAccessMode::Read, FileShareMode::Read ) )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error opening file" );
+            return nullptr;
+        }
+    }
     else
-        file = _wfopen(filePath.c_str(), L"r+b"); // File.Open( path, FileMode.Open, FileAccess.ReadWrite, FileShare.None );
-
-    if( file == 0 )
     {
-        VA_LOG( "vaLargeBitmapFile::Open failed, error opening file" );
-        return nullptr;
+        if( !ret->m_File.OpenForConcurrentIO( filePath, FileCreationMode::Open, FileAccessMode::ReadWrite, FileShareMode::None ) )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error opening file" );
+            return nullptr;
+        }
     }
 
-    vaLargeBitmapFile::PixelFormat  pixelFormat = (vaLargeBitmapFile::PixelFormat )ReadInt32( file );
-    int bytesPerPixel =  GetPixelFormatBPP( pixelFormat );
-    int width         = ReadInt32( file );
-    int height        = ReadInt32( file );
-    int version       = ReadInt32( file );
-
-    int blockDim = 128;
-    if( version > 0 )
-        blockDim = ReadInt32( file );
-
-    int64 current = _ftelli64(file);
-    _fseeki64(file, 0, SEEK_END);
-    int64 filelength = _ftelli64(file);
-    _fseeki64(file, current, SEEK_SET);
-      
-    if( ( (int64)bytesPerPixel * width * height + c_TotalHeaderSize ) != filelength )
+    if( version >= 2 )
     {
-        assert( false ); // file is probably corrupt
+        int64 tableSize = (int64)ret->m_BlockTable.size( ) * sizeof( BlockTableEntry );
+        if( !ret->m_File.ReadAt( c_TotalHeaderSize, ret->m_BlockTable.data( ), tableSize ) )
+        {
+            VA_LOG( "vaLargeBitmapFile::Open failed, error reading block table" );
+            return nullptr;
+        }
+        ret->m_FileEnd = ret->m_File.GetLength( );
+        if( !ret->ValidateBlockTable( ) )
+        {
+            VA_LOG_ERROR( L"vaLargeBitmapFile::Open failed, block table of '%s' is corrupt", filePath.c_str( ) );
+            return nullptr;
+        }
     }
 
-    return shared_ptr<vaLargeBitmapFile>( new vaLargeBitmapFile( file, filePath, pixelFormat, width, height, blockDim, readOnly ) );
+    return ret;
 }
 
 void vaLargeBitmapFile::Close()
@@ -277,69 +587,93 @@ void vaLargeBitmapFile::Close()
 
     VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> lock( m_GlobalMutex ); )
 
-    if( m_File == 0 ) 
+    if( m_DataBlocks == nullptr )
     {
-        assert( m_UsedMemory == 0 );
-        assert( m_DataBlocks == nullptr );
         assert( m_BigDataBlocksArray == nullptr );
+        assert( m_Cache == nullptr );
+        assert( !m_File.IsOpen( ) && !m_Mapped.IsOpen( ) );
         return;
     }
 
-// #define TRACK_BLOCKS
-#ifdef TRACK_BLOCKS
-    int dataBlocksTotal     = 0;
-    int usedMemoryBefore    = 0;
-    int releasedBlocks      = 0;
+    // I/O threads don't take m_GlobalMutex, so this can't deadlock; no new requests can get queued while we hold it
+    m_Cache->CancelPrefetches( this );
+
+    for( int x = 0; x < m_BlocksX; x++ )
     {
-        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> usedMemoryMutexLock( m_UsedMemoryMutex ); )
-        dataBlocksTotal = m_BlocksX * m_BlocksY;
-        usedMemoryBefore = m_UsedMemory;
+        for( int y = 0; y < m_BlocksY; y++ )
+        {
+            DataBlock & db = m_DataBlocks[x][y];
+            VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); )
+            if( db.pData != 0 )
+                ReleaseBlock( x, y );
+        }
     }
-#endif
+    delete[] m_DataBlocks;
+    delete[] m_BigDataBlocksArray;
+    m_DataBlocks = nullptr;
+    m_BigDataBlocksArray = nullptr;
 
-    if( m_DataBlocks )
+    m_File.Close( );
+    m_Mapped.Close( );
+    m_MappedData = nullptr;
+
+    m_Cache = nullptr;
+    BlockCache::Release( );
+}
+
+void vaLargeBitmapFile::SetCacheBudget( int64 bytes )
+{
+    assert( bytes >= 0 );
+    s_CacheBudget.store( bytes );
+    BlockCache::WithInstance( [ ]( BlockCache & cache ) { cache.EnforceBudget( nullptr ); } );
+}
+
+int64 vaLargeBitmapFile::GetCacheUsedBytes( )
+{
+    int64 ret = 0;
+    BlockCache::WithInstance( [&ret]( BlockCache & cache ) { ret = cache.GetUsedBytes( ); } );
+    return ret;
+}
+
+bool vaLargeBitmapFile::Flush( )
+{
+    VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); )
+
+    if( m_DataBlocks == nullptr || m_ReadOnly )
+        return m_DataBlocks != nullptr;
+
+    if( m_MappedData != nullptr )
+        return m_Mapped.Flush( );
+
+    for( int x = 0; x < m_BlocksX; x++ )
     {
-        for( int x = 0; x < m_BlocksX; x++ )
+        for( int y = 0; y < m_BlocksY; y++ )
         {
-            for( int y = 0; y < m_BlocksY; y++ )
-            { 
-                DataBlock & db = m_DataBlocks[x][y];
-                VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); )
-                if( m_DataBlocks[x][y].pData != 0 ) 
-                {
-#ifdef TRACK_BLOCKS
-                    releasedBlocks++;
-#endif
-                    ReleaseBlock( x, y ); 
-                    {
-                        int blockSize = db.Width * db.Height * m_BytesPerPixel;
-                        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> usedMemoryMutexLock( m_UsedMemoryMutex ); )
-                        m_UsedMemory -= blockSize;
-
-                        {
-                            VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> totalUsedMemoryMutexLock( s_TotalUsedMemoryMutex ); )
-                            s_TotalUsedMemory -= blockSize;
-                        }
-                    }
-                }
-            }
+            DataBlock & db = m_DataBlocks[x][y];
+            VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); )
+            if( db.pData != 0 && db.Modified )
+                SaveBlock( x, y );
         }
-        delete[] m_DataBlocks;
-        delete[] m_BigDataBlocksArray;
-        m_DataBlocks = nullptr;
-        m_BigDataBlocksArray = nullptr;
     }
+    m_File.Flush( );
+    return true;
+}
+
+void vaLargeBitmapFile::SetAccessPattern( AccessPattern pattern )
+{
+    VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); )
+
+    m_SweepPrefetch = pattern != AccessPattern::Random;
 
-    VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> fileAccessMutex( m_fileAccessMutex ); )
-    fclose( m_File );
-    m_File = 0;
+    if( m_MappedData != nullptr )
     {
-        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> usedMemoryMutexLock( m_UsedMemoryMutex ); )
-        assert( m_UsedMemory == 0 );
-        m_UsedBlocks.clear();
+        vaMappedFileStream::AccessHint hint = vaMappedFileStream::AccessHint::Normal;
+        if( pattern == AccessPattern::Sequential )
+            hint = vaMappedFileStream::AccessHint::Sequential;
+        else if( pattern == AccessPattern::Random )
+            hint = vaMappedFileStream::AccessHint::Random;
+        m_Mapped.Advise( 0, -1, hint );
     }
-    assert( m_DataBlocks == nullptr );
-    assert( m_BigDataBlocksArray == nullptr );
 }
 
 void vaLargeBitmapFile::ReleaseBlock( int bx, int by )
@@ -351,16 +685,25 @@ void vaLargeBitmapFile::ReleaseBlock( int bx, int by )
         VA_ERROR( "block not loaded" );
     }
 
+    m_Cache->Remove( db );
+    FreeBlockData( db );
+}
+
+void vaLargeBitmapFile::FreeBlockData( DataBlock & db )
+{
+    assert( db.pData != 0 );
+
     if( db.Modified ) 
-        SaveBlock( bx, by );
+    {
+        int index = (int)( &db - m_BigDataBlocksArray );
+        SaveBlock( index / m_BlocksY, index % m_BlocksY );
+    }
 
     free( db.pData );
     db.Modified = false;
     db.pData = 0;
 }
 
-// #include <sstream>
-
 void vaLargeBitmapFile::LoadBlock( int bx, int by, bool skipFileRead )
 {
     DataBlock & db = m_DataBlocks[bx][by];
@@ -370,116 +713,412 @@ void vaLargeBitmapFile::LoadBlock( int bx, int by, bool skipFileRead )
         VA_ERROR( "block already loaded" );
     }
 
-    // std::stringstream ss;
-    // ss << std::this_thread::get_id();
-    // string threadID = ss.str();
-    // VA_LOG( "Loading block %d, %d, this: %llx, thread: %s", bx, by, this, threadID.c_str() );
+    int blockSize = db.Width * db.Height * m_BytesPerPixel;
+
+    assert( db.pData == nullptr );
+    db.pData = (char*)malloc( blockSize );
 
-    //load
+    if( !skipFileRead && m_FormatVersion < 2 )
     {
-        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> usedMemoryMutexLock( m_UsedMemoryMutex ); )
-        int tryCount = 0;
-        while( (m_UsedMemory > c_MemoryLimit) && (m_UsedBlocks.size() > 0) )
+        if( !m_File.ReadAt( GetBlockStartPos( bx, by ), db.pData, blockSize ) )
         {
-            DataBlockID dbid = (DataBlockID)m_UsedBlocks.back();
-            if( tryCount > (int)m_UsedBlocks.size() )
+            assert( false );
+            VA_LOG_ERROR( "vaLargeBitmapFile::LoadBlock - error reading block %d, %d", bx, by );
+        }
+    }
+    else if( !skipFileRead )
+    {
+        // this runs on whichever thread needs the block - ReadRect/WriteRect task set workers or the prefetch I/O
+        // threads - so decompression is spread out the same way reads are
+        const BlockTableEntry & entry = m_BlockTable[ (size_t)bx * m_BlocksY + by ];
+        bool ok = true;
+        switch( entry.Kind )
+        {
+        case( BlockKind::Constant ):
+            FillConstant( db.pData, blockSize, entry.ConstantValue );
+            break;
+        case( BlockKind::Raw ):
+            ok = ( entry.StoredSize == (uint32)blockSize ) && m_File.ReadAt( entry.Offset, db.pData, blockSize );
+            break;
+        case( BlockKind::LZ ):
+        {
+            if( entry.StoredSize > vaLZCodec::GetMaxCompressedSize( blockSize ) )
             {
-                // can't remove any? too small memory limit then, drop out
-                assert( false );
+                ok = false;
                 break;
             }
-        
-            if( (dbid.Bx == bx) && (dbid.By == by) )
+            char * compressed = (char*)malloc( entry.StoredSize );
+            ok = m_File.ReadAt( entry.Offset, compressed, entry.StoredSize ) && vaLZCodec::Decompress( compressed, entry.StoredSize, db.pData, blockSize );
+            free( compressed );
+        } break;
+        default:
+            ok = false;
+            break;
+        }
+        if( !ok )
+        {
+            assert( false );
+            VA_LOG_ERROR( "vaLargeBitmapFile::LoadBlock - error reading block %d, %d", bx, by );
+            memset( db.pData, 0, blockSize );
+        }
+    }
+    db.Modified     = false;
+    db.Referenced   = true;
+
+    // can evict other blocks (of any file) to stay within budget
+    m_Cache->Insert( db );
+}
+
+void vaLargeBitmapFile::SaveBlock( int bx, int by )
+{
+    DataBlock & db = m_DataBlocks[bx][by];
+    if( db.pData == 0 )
+    {
+        assert( false ); // "block not loaded"
+        VA_ERROR( "block not loaded" );
+    }
+
+    int blockSize = db.Width * db.Height * m_BytesPerPixel;
+
+    if( m_FormatVersion < 2 )
+    {
+        if( !m_File.WriteAt( GetBlockStartPos( bx, by ), db.pData, blockSize ) )
+        {
+            assert( false );
+            VA_LOG_ERROR( "vaLargeBitmapFile::SaveBlock - error writing block %d, %d", bx, by );
+        }
+        db.Modified = false;
+        return;
+    }
+
+    int blockIndex = bx * m_BlocksY + by;
+    BlockTableEntry & entry = m_BlockTable[blockIndex];
+
+    bool isConstant = true;
+    for( int i = m_BytesPerPixel; i < blockSize && isConstant; i += m_BytesPerPixel )
+        isConstant = memcmp( db.pData, db.pData + i, m_BytesPerPixel ) == 0;
+
+    int64   releasedOffset      = 0;
+    uint32  releasedCapacity    = 0;
+
+    bool ok = true;
+    if( isConstant )
+    {
+        // no data to write; keeps Offset & Capacity so the slot can be reused
+        entry.Kind          = BlockKind::Constant;
+        entry.StoredSize    = 0;
+        memset( entry.ConstantValue, 0, sizeof( entry.ConstantValue ) );
+        memcpy( entry.ConstantValue, db.pData, m_BytesPerPixel );
+    }
+    else
+    {
+        int64 compressedCapacity = vaLZCodec::GetMaxCompressedSize( blockSize );
+        char * compressed = (char*)malloc( (size_t)compressedCapacity );
+        int64 compressedSize = vaLZCodec::Compress( db.pData, blockSize, compressed, compressedCapacity );
+        assert( compressedSize > 0 );
+
+        // not worth decompressing if it saves less than 1/8th
+        const char * data = compressed;
+        if( compressedSize <= 0 || compressedSize > blockSize - blockSize / 8 )
+        {
+            entry.Kind          = BlockKind::Raw;
+            entry.StoredSize    = (uint32)blockSize;
+            data                = db.pData;
+        }
+        else
+        {
+            entry.Kind          = BlockKind::LZ;
+            entry.StoredSize    = (uint32)compressedSize;
+        }
+
+        if( entry.StoredSize > entry.Capacity )
+        {
+            // the old slot (if any) only becomes free once the new entry is written, so that the entry on disk never
+            // points at space that another block is already reusing
+            releasedOffset      = entry.Offset;
+            releasedCapacity    = entry.Capacity;
+
+            // smallest free slot that fits (split if bigger), otherwise append
+            std::unique_lock<mutex> fileEndLock( m_FileEndMutex );
+            auto freeSlot = m_FreeSlots.lower_bound( entry.StoredSize );
+            if( freeSlot != m_FreeSlots.end( ) )
             {
-                // skip ourselves
-                m_UsedBlocks.pop_back();
-                m_UsedBlocks.push_front( dbid );
-                tryCount++;
-                continue;
+                entry.Offset    = freeSlot->second;
+                entry.Capacity  = entry.StoredSize;
+                if( freeSlot->first > entry.StoredSize )
+                    m_FreeSlots.insert( std::make_pair( freeSlot->first - entry.StoredSize, freeSlot->second + entry.StoredSize ) );
+                m_FreeSlots.erase( freeSlot );
             }
-        
-            DataBlock & blockToRelease = m_DataBlocks[dbid.Bx][dbid.By];
-            #ifdef VA_LBF_THREADSAFE
-            std::unique_lock<std::shared_mutex> uniqueBlockLock( blockToRelease.Mutex, std::defer_lock ); 
-            if( !uniqueBlockLock.try_lock() )
+            else
             {
-                // ok drop it for now and try another
-                m_UsedBlocks.pop_back();
-                m_UsedBlocks.push_front( dbid );
-                tryCount++;
-                continue;
+                entry.Offset    = m_FileEnd;
+                entry.Capacity  = entry.StoredSize;
+                m_FileEnd      += entry.Capacity;
             }
-            #endif
+        }
+        ok = m_File.WriteAt( entry.Offset, data, entry.StoredSize );
+        free( compressed );
+    }
 
-            // VA_LOG( "Releasing block %d, %d, this: %llx, thread: %s", dbid.Bx, dbid.By, this, threadID.c_str() );
-            ReleaseBlock( dbid.Bx, dbid.By );
-            {
-                int removedBlockSize = blockToRelease.Width * blockToRelease.Height * m_BytesPerPixel;
-                m_UsedMemory -= removedBlockSize;
+    ok &= WriteBlockTableEntry( blockIndex );
+    if( !ok )
+    {
+        assert( false );
+        VA_LOG_ERROR( "vaLargeBitmapFile::SaveBlock - error writing block %d, %d", bx, by );
+    }
+    else if( releasedCapacity > 0 )
+    {
+        std::unique_lock<mutex> fileEndLock( m_FileEndMutex );
+        if( releasedOffset + releasedCapacity == m_FileEnd )
+            m_FileEnd = releasedOffset;
+        else
+            m_FreeSlots.insert( std::make_pair( releasedCapacity, releasedOffset ) );
+    }
+    db.Modified = false;
+}
 
-                {
-                    VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> totalUsedMemoryMutexLock( s_TotalUsedMemoryMutex ); )
-                    s_TotalUsedMemory -= removedBlockSize;
-                }
+bool vaLargeBitmapFile::WriteBlockTableEntry( int blockIndex )
+{
+    assert( m_FormatVersion >= 2 );
+    return m_File.WriteAt( GetBlockTableEntryPos( blockIndex ), &m_BlockTable[blockIndex], sizeof( BlockTableEntry ) );
+}
+
+// Checks the block table just read from the file (m_FileEnd being the file length), so that LoadBlock never allocates or
+// reads based on a corrupt size or offset, and collects the space between block slots into m_FreeSlots.
+bool vaLargeBitmapFile::ValidateBlockTable( )
+{
+    assert( m_FormatVersion >= 2 );
+    const int64 dataStart = GetBlockTableEntryPos( (int)m_BlockTable.size( ) );
+
+    vector<pair<int64, uint32>> usedSlots;
+    for( int bx = 0; bx < m_BlocksX; bx++ )
+    {
+        for( int by = 0; by < m_BlocksY; by++ )
+        {
+            const BlockTableEntry & entry = m_BlockTable[ (size_t)bx * m_BlocksY + by ];
+            const DataBlock & db = m_DataBlocks[bx][by];
+            int64 blockSize = (int64)db.Width * db.Height * m_BytesPerPixel;
+
+            bool ok;
+            switch( entry.Kind )
+            {
+            case( BlockKind::Constant ):    ok = entry.StoredSize == 0;                                                                             break;
+            case( BlockKind::Raw ):         ok = entry.StoredSize == blockSize;                                                                     break;
+            case( BlockKind::LZ ):          ok = ( entry.StoredSize > 0 ) && ( entry.StoredSize <= vaLZCodec::GetMaxCompressedSize( blockSize ) );  break;
+            default:                        ok = false;                                                                                             break;
+            }
+            ok &= entry.StoredSize <= entry.Capacity;
+            if( entry.Capacity > 0 )
+                ok &= ( entry.Offset >= dataStart ) && ( entry.Offset + entry.Capacity <= m_FileEnd );
+            if( !ok )
+            {
+                VA_LOG_ERROR( "vaLargeBitmapFile - invalid block table entry for block %d, %d", bx, by );
+                return false;
             }
-            m_UsedBlocks.pop_back();
+            if( entry.Capacity > 0 )
+                usedSlots.push_back( std::make_pair( entry.Offset, entry.Capacity ) );
         }
     }
 
-    int blockSize = db.Width * db.Height * m_BytesPerPixel;
-
-    assert( db.pData == nullptr );
-    db.pData = (char*)malloc( blockSize );
-
-    if( !skipFileRead )
+    // slots can't overlap; gaps between them are free and anything after the last one gets appended over
+    std::sort( usedSlots.begin( ), usedSlots.end( ) );
+    m_FreeSlots.clear( );
+    int64 pos = dataStart;
+    for( const auto & slot : usedSlots )
     {
-        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> fileAccessMutex( m_fileAccessMutex ); )
-      
-        _fseeki64( m_File, GetBlockStartPos( bx, by ), SEEK_SET );
-        if( (int)fread( db.pData, 1, blockSize, m_File ) != blockSize )
+        if( slot.first < pos )
         {
-            assert( false );
+            VA_LOG_ERROR( "vaLargeBitmapFile - overlapping blocks in the block table" );
+            return false;
+        }
+        for( int64 gap = slot.first - pos; gap > 0; )
+        {
+            uint32 capacity = (uint32)std::min( gap, (int64)UINT32_MAX );
+            m_FreeSlots.insert( std::make_pair( capacity, slot.first - gap ) );
+            gap -= capacity;
         }
+        pos = slot.first + slot.second;
     }
-    db.Modified = false;
-    // VA_LOG( "Block %d, %d loaded, this: %llx, thread: %s", bx, by, this, threadID.c_str() );
+    m_FileEnd = pos;
+    return true;
+}
+
+void vaLargeBitmapFile::FillConstant( char * data, int sizeInBytes, const void * pixel )
+{
+    assert( data != nullptr );
+    if( sizeInBytes == 0 )
+        return;
+
+    // fill the first pixel, then keep doubling the filled part
+    memcpy( data, pixel, m_BytesPerPixel );
+    for( int filled = m_BytesPerPixel; filled < sizeInBytes; filled *= 2 )
+        memcpy( data + filled, data, vaMath::Min( filled, sizeInBytes - filled ) );
+}
+
+char * vaLargeBitmapFile::MappedPixel( int x, int y )
+{
+    assert( m_MappedData != nullptr );
+    int bx = x >> m_BlockDimBits;
+    int by = y >> m_BlockDimBits;
+    x -= bx << m_BlockDimBits;
+    y -= by << m_BlockDimBits;
+    const DataBlock & db = m_DataBlocks[bx][by];
+    return (char*)m_MappedData + GetBlockStartPos( bx, by ) + ( db.Width * y + x ) * m_BytesPerPixel;
+}
 
+void vaLargeBitmapFile::MappedCopyBlockRect( int bx, int by, char * buffer, int bufferPitchInBytes, int rectPosX, int rectPosY, int rectSizeX, int rectSizeY, bool toFile )
+{
+    assert( m_MappedData != nullptr );
+    const DataBlock & db = m_DataBlocks[bx][by];
+    char * blockData = (char*)m_MappedData + GetBlockStartPos( bx, by );
+
+    int fromX = vaMath::Max( bx * m_BlockDim, rectPosX );
+    int fromY = vaMath::Max( by * m_BlockDim, rectPosY );
+    int toX = vaMath::Min( bx * m_BlockDim + db.Width, rectPosX + rectSizeX );
+    int toY = vaMath::Min( by * m_BlockDim + db.Height, rectPosY + rectSizeY );
+
+    int bytesCount = (toX-fromX) * m_BytesPerPixel;
+    for( int y = fromY; y < toY; y++ )
+    {
+        char * bufferPtr = buffer + ( (int64)bufferPitchInBytes * ( y - rectPosY ) + ( fromX - rectPosX ) * m_BytesPerPixel );
+        char * filePtr = blockData + ( db.Width * ( y - by * m_BlockDim ) + ( fromX - bx * m_BlockDim ) ) * m_BytesPerPixel;
+        if( toFile )
+            memcpy( filePtr, bufferPtr, bytesCount );
+        else
+            memcpy( bufferPtr, filePtr, bytesCount );
+    }
+}
+
+void vaLargeBitmapFile::FillAllBlocks( const void * pixel )
+{
+    VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); )
+    if( m_ReadOnly )
     {
-        VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> usedMemoryMutexLock( m_UsedMemoryMutex ); )
+        assert( false );    // opened as read-only
+        return;
+    }
 
-        for( int i = 0; i < m_UsedBlocks.size(); i++ )
+    for( int y = 0; y < m_BlocksY; y++ )
+    {
+        for( int x = 0; x < m_BlocksX; x++ )
         {
-            if( (m_UsedBlocks[i].Bx == bx) && (m_UsedBlocks[i].By == by) )
+            DataBlock & db = m_DataBlocks[x][y];
+            int blockSize = db.Width * db.Height * m_BytesPerPixel;
+
+            if( m_MappedData != nullptr )
+            {
+                FillConstant( (char*)m_MappedData + GetBlockStartPos( x, y ), blockSize, pixel );
+                continue;
+            }
+
+            VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); )
+
+            if( m_FormatVersion < 2 )
+            {
+                if( db.pData == 0 )
+                    LoadBlock( x, y, true );
+                db.Touch( );
+                FillConstant( db.pData, blockSize, pixel );
+                db.Modified = true;
+                continue;
+            }
+
+            // version 2: just a constant entry, no block data gets loaded or written
+            int blockIndex = x * m_BlocksY + y;
+            BlockTableEntry & entry = m_BlockTable[blockIndex];
+            entry.Kind          = BlockKind::Constant;
+            entry.StoredSize    = 0;
+            memset( entry.ConstantValue, 0, sizeof( entry.ConstantValue ) );
+            memcpy( entry.ConstantValue, pixel, m_BytesPerPixel );
+            if( !WriteBlockTableEntry( blockIndex ) )
             {
                 assert( false );
+                VA_LOG_ERROR( "vaLargeBitmapFile::SetAllPixels - error writing block table" );
+            }
+
+            if( db.pData != 0 )
+            {
+                FillConstant( db.pData, blockSize, pixel );
+                db.Modified = false;    // matches what's on disk now
             }
         }
+    }
+}
 
-        m_UsedBlocks.push_front( DataBlockID( bx, by ) );
-        m_UsedMemory += blockSize;
-    
+void vaLargeBitmapFile::Prefetch( int rectPosX, int rectPosY, int rectSizeX, int rectSizeY )
+{
+    VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); )
+    PrefetchNoMutexLock( rectPosX, rectPosY, rectSizeX, rectSizeY );
+}
+
+void vaLargeBitmapFile::PrefetchNoMutexLock( int rectPosX, int rectPosY, int rectSizeX, int rectSizeY )
+{
+    if( m_DataBlocks == nullptr )
+        return;
+
+    int fromX   = vaMath::Max( rectPosX, 0 );
+    int fromY   = vaMath::Max( rectPosY, 0 );
+    int toX     = vaMath::Min( rectPosX + rectSizeX, m_Width );
+    int toY     = vaMath::Min( rectPosY + rectSizeY, m_Height );
+    if( toX <= fromX || toY <= fromY )
+        return;
+
+    if( m_MappedData != nullptr )
+    {
+        // blocks of a block row are contiguous in the file, so it's one range per block row
+        int blockXFrom = fromX >> m_BlockDimBits, blockXTo = ( toX - 1 ) >> m_BlockDimBits;
+        for( int by = fromY >> m_BlockDimBits; by <= ( ( toY - 1 ) >> m_BlockDimBits ); by++ )
         {
-            VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> totalUsedMemoryMutexLock( s_TotalUsedMemoryMutex ); )
-            s_TotalUsedMemory += blockSize;
+            const DataBlock & lastBlock = m_DataBlocks[blockXTo][by];
+            int64 rangeFrom = GetBlockStartPos( blockXFrom, by );
+            int64 rangeTo   = GetBlockStartPos( blockXTo, by ) + (int64)lastBlock.Width * lastBlock.Height * m_BytesPerPixel;
+            m_Mapped.Advise( rangeFrom, rangeTo - rangeFrom, vaMappedFileStream::AccessHint::WillNeed );
         }
+        return;
     }
+
+    const int64 byteLimit = s_CacheBudget.load( ) / 2;
+    int64 bytes = 0;
+
+    vaSmallVector<BlockCache::PrefetchRequest, 64> requests;
+    for( int by = fromY >> m_BlockDimBits; by <= ( ( toY - 1 ) >> m_BlockDimBits ) && bytes < byteLimit; by++ )
+    {
+        for( int bx = fromX >> m_BlockDimBits; bx <= ( ( toX - 1 ) >> m_BlockDimBits ) && bytes < byteLimit; bx++ )
+        {
+            DataBlock & db = m_DataBlocks[bx][by];
+            bool loaded;
+            {
+                // only peek - if someone holds it uniquely it's being loaded (or written to) anyway
+                std::shared_lock<std::shared_mutex> peekLock( db.Mutex, std::try_to_lock );
+                if( !peekLock.owns_lock( ) )
+                    continue;
+                loaded = db.pData != nullptr;
+            }
+            if( loaded )
+            {
+                db.Touch( );     // about to be used, keep it around
+                continue;
+            }
+            if( db.PrefetchQueued.exchange( true ) )
+                continue;
+            requests.push_back( { this, bx, by } );
+            bytes += (int64)db.Width * db.Height * m_BytesPerPixel;
+        }
+    }
+    m_Cache->QueuePrefetch( requests.data( ), (int)requests.size( ) );
 }
 
-void vaLargeBitmapFile::SaveBlock( int bx, int by )
+void vaLargeBitmapFile::ExecutePrefetch( int bx, int by )
 {
+    // no m_GlobalMutex: Close waits for this to finish before releasing blocks
     DataBlock & db = m_DataBlocks[bx][by];
-    if( db.pData == 0 )
-    {
-        assert( false ); // "block not loaded"
-        VA_ERROR( "block not loaded" );
-    }
+    db.PrefetchQueued = false;
 
-    int blockSize = db.Width * db.Height * m_BytesPerPixel;
-      
-    VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> fileAccessMutex( m_fileAccessMutex ); )
-    _fseeki64( m_File, GetBlockStartPos( bx, by ), SEEK_SET );
-    fwrite( db.pData, 1, blockSize, m_File );
-    db.Modified = false;
+    std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex, std::try_to_lock );
+    if( !uniqueBlockLock.owns_lock( ) )
+        return;     // in use, so already loaded or being loaded
+    if( db.pData == 0 )
+        LoadBlock( bx, by );
 }
 
 int64 vaLargeBitmapFile::GetBlockStartPos( int bx, int by )
@@ -504,6 +1143,11 @@ void vaLargeBitmapFile::GetPixel( int x, int y, void* pPixel )
 #endif
 
     assert( x >= 0 && x <= m_Width && y >= 0 && y <= m_Height );
+    if( m_MappedData != nullptr )
+    {
+        memcpy( pPixel, MappedPixel( x, y ), m_BytesPerPixel );
+        return;
+    }
     int bx = x >> m_BlockDimBits;
     int by = y >> m_BlockDimBits;
     x -= bx << m_BlockDimBits;
@@ -529,6 +1173,7 @@ void vaLargeBitmapFile::GetPixel( int x, int y, void* pPixel )
 //            dbg++;
 //        }
     }
+    db.Touch( );
     memcpy( pPixel, db.pData + ( ( db.Width * y + x ) * m_BytesPerPixel ), m_BytesPerPixel );
 }
 
@@ -538,9 +1183,19 @@ void vaLargeBitmapFile::SetPixel( int x, int y, void* pPixel )
     std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); 
 #endif
 
-    assert( !m_ReadOnly );
+    if( m_ReadOnly )
+    {
+        assert( false );    // opened as read-only
+        return;
+    }
     assert( x >= 0 && x <= m_Width && y >= 0 && y <= m_Height );
 
+    if( m_MappedData != nullptr )
+    {
+        memcpy( MappedPixel( x, y ), pPixel, m_BytesPerPixel );
+        return;
+    }
+
     int bx = x >> m_BlockDimBits;
     int by = y >> m_BlockDimBits;
     x -= bx << m_BlockDimBits;
@@ -553,6 +1208,7 @@ void vaLargeBitmapFile::SetPixel( int x, int y, void* pPixel )
     {
         LoadBlock( bx, by );
     }
+    db.Touch( );
 
     char* pTo = db.pData + ( ( db.Width * y + x ) * m_BytesPerPixel );
     char* pFrom = (char*)pPixel;
@@ -614,6 +1270,23 @@ bool vaLargeBitmapFile::ReadRect( void * dstBuffer, int dstPitchInBytes, int64 d
     assert( blockXTo < m_BlocksX );
     assert( blockYTo < m_BlocksY );
 
+    // a rect of the same size as the previous one, moved by exactly its size along x or y, is most likely a tiled sweep:
+    // start loading the next rect in the same direction so the next call doesn't wait for the disk
+    {
+        int dx, dy;
+        {
+            VA_LBF_THREADSAFE_LINE( std::unique_lock<mutex> lastReadRectLock( m_LastReadRectMutex ); )
+            dx = rectPosX - m_LastReadRect[0];
+            dy = rectPosY - m_LastReadRect[1];
+            bool sameSize = ( rectSizeX == m_LastReadRect[2] ) && ( rectSizeY == m_LastReadRect[3] );
+            if( !sameSize || !( ( dy == 0 && ( dx == rectSizeX || dx == -rectSizeX ) ) || ( dx == 0 && ( dy == rectSizeY || dy == -rectSizeY ) ) ) )
+                dx = dy = 0;
+            m_LastReadRect[0] = rectPosX; m_LastReadRect[1] = rectPosY; m_LastReadRect[2] = rectSizeX; m_LastReadRect[3] = rectSizeY;
+        }
+        if( ( dx != 0 || dy != 0 ) && m_SweepPrefetch )
+            PrefetchNoMutexLock( rectPosX + dx, rectPosY + dy, rectSizeX, rectSizeY );
+    }
+
 #if 0
     for( int by = blockYFrom; by <= blockYTo; by++ )
     {
@@ -714,6 +1387,13 @@ bool vaLargeBitmapFile::ReadRect( void * dstBuffer, int dstPitchInBytes, int64 d
                 int bw = ( bx == ( _this.m_BlocksX - 1 ) ) ? ( _this.m_EdgeBlockWidth ) : ( _this.m_BlockDim );
                 int bh = ( by == ( _this.m_BlocksY - 1 ) ) ? ( _this.m_EdgeBlockHeight ) : ( _this.m_BlockDim );
 
+                if( _this.m_MappedData != nullptr )
+                {
+                    // nothing to load or lock, the OS pages the data in
+                    _this.MappedCopyBlockRect( bx, by, (char*)dstBuffer, dstPitchInBytes, rectPosX, rectPosY, rectSizeX, rectSizeY, false );
+                    continue;
+                }
+
                 DataBlock & db = _this.m_DataBlocks[bx][by];
                 VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> sharedBlockLock( db.Mutex ); )
                 VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex, std::defer_lock ); )
@@ -736,6 +1416,7 @@ bool vaLargeBitmapFile::ReadRect( void * dstBuffer, int dstPitchInBytes, int64 d
                     }
                     // continue this block with unique lock!
                 }
+                db.Touch( );
                 int fromX = vaMath::Max( bx * _this.m_BlockDim, rectPosX );
                 int fromY = vaMath::Max( by * _this.m_BlockDim, rectPosY );
                 int toX = vaMath::Min( bx * _this.m_BlockDim + bw, rectPosX + rectSizeX );
@@ -797,6 +1478,12 @@ bool vaLargeBitmapFile::WriteRect( void * srcBuffer, int srcPitchInBytes, int re
         return false;
     }
 
+    if( m_ReadOnly )
+    {
+        assert( false );    // opened as read-only
+        return false;
+    }
+
     if( srcPitchInBytes < ( rectSizeX * m_BytesPerPixel ) )
     {
         assert( false );    // source stride looks too small
@@ -908,12 +1595,20 @@ bool vaLargeBitmapFile::WriteRect( void * srcBuffer, int srcPitchInBytes, int re
                 int by = blockOp.by;
                 int bw = ( bx == ( _this.m_BlocksX - 1 ) ) ? ( _this.m_EdgeBlockWidth ) : ( _this.m_BlockDim );
                 int bh = ( by == ( _this.m_BlocksY - 1 ) ) ? ( _this.m_EdgeBlockHeight ) : ( _this.m_BlockDim );
+
+                if( _this.m_MappedData != nullptr )
+                {
+                    _this.MappedCopyBlockRect( bx, by, (char*)srcBuffer, srcPitchInBytes, rectPosX, rectPosY, rectSizeX, rectSizeY, true );
+                    continue;
+                }
+
                 DataBlock & db = _this.m_DataBlocks[bx][by];
                 VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); )
                 if( db.pData == 0 )
                 {
                     _this.LoadBlock( bx, by );
                 }
+                db.Touch( );
 
                 // memcpy( pPixel, db.pData + ( ( db.Width * y + x ) * m_BytesPerPixel ), m_BytesPerPixel );
 
@@ -1138,6 +1833,220 @@ bool vaLargeBitmapFile::ReadRectClampBorders( void * _dstBuffer, int dstPitchInB
 }
 
 
+namespace
+{
+    // 2x2 box filter for formats made of equally sized unsigned channels; plain loops over channels so the compiler
+    // can vectorize them
+    template< typename ChannelType, int ChannelCount >
+    void BoxDownsample( const byte * src, int srcPitch, byte * dst, int dstPitch, int dstSizeX, int dstSizeY )
+    {
+        for( int y = 0; y < dstSizeY; y++ )
+        {
+            const ChannelType * row0 = (const ChannelType *)( src + ( 2 * y + 0 ) * srcPitch );
+            const ChannelType * row1 = (const ChannelType *)( src + ( 2 * y + 1 ) * srcPitch );
+            ChannelType * dstRow = (ChannelType *)( dst + y * dstPitch );
+            for( int x = 0; x < dstSizeX; x++ )
+            {
+                for( int c = 0; c < ChannelCount; c++ )
+                {
+                    uint32 sum = (uint32)row0[ ( 2 * x ) * ChannelCount + c ] + row0[ ( 2 * x + 1 ) * ChannelCount + c ]
+                               + row1[ ( 2 * x ) * ChannelCount + c ] + row1[ ( 2 * x + 1 ) * ChannelCount + c ];
+                    dstRow[ x * ChannelCount + c ] = (ChannelType)( ( sum + 2 ) >> 2 );
+                }
+            }
+        }
+    }
+
+    void BoxDownsampleA4R4G4B4( const byte * src, int srcPitch, byte * dst, int dstPitch, int dstSizeX, int dstSizeY )
+    {
+        for( int y = 0; y < dstSizeY; y++ )
+        {
+            const uint16 * row0 = (const uint16 *)( src + ( 2 * y + 0 ) * srcPitch );
+            const uint16 * row1 = (const uint16 *)( src + ( 2 * y + 1 ) * srcPitch );
+            uint16 * dstRow = (uint16 *)( dst + y * dstPitch );
+            for( int x = 0; x < dstSizeX; x++ )
+            {
+                uint16 a = row0[2 * x], b = row0[2 * x + 1], c = row1[2 * x], d = row1[2 * x + 1];
+                uint16 result = 0;
+                for( int shift = 0; shift < 16; shift += 4 )
+                {
+                    uint32 sum = ( ( a >> shift ) & 0xF ) + ( ( b >> shift ) & 0xF ) + ( ( c >> shift ) & 0xF ) + ( ( d >> shift ) & 0xF );
+                    result |= (uint16)( ( ( sum + 2 ) >> 2 ) << shift );
+                }
+                dstRow[x] = result;
+            }
+        }
+    }
+
+    void PointDownsample( int bytesPerPixel, const byte * src, int srcPitch, byte * dst, int dstPitch, int dstSizeX, int dstSizeY )
+    {
+        for( int y = 0; y < dstSizeY; y++ )
+        {
+            const byte * srcRow = src + ( 2 * y ) * srcPitch;
+            byte * dstRow = dst + y * dstPitch;
+            for( int x = 0; x < dstSizeX; x++ )
+                memcpy( dstRow + x * bytesPerPixel, srcRow + ( 2 * x ) * bytesPerPixel, bytesPerPixel );
+        }
+    }
+
+    void Downsample( vaLargeBitmapFile::PixelFormat format, int bytesPerPixel, const byte * src, int srcPitch, byte * dst, int dstPitch, int dstSizeX, int dstSizeY )
+    {
+        switch( format )
+        {
+        case( vaLargeBitmapFile::Format8BitGrayScale ):     BoxDownsample<uint8, 1>( src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY );   break;
+        case( vaLargeBitmapFile::Format16BitGrayScale ):    BoxDownsample<uint16, 1>( src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY );  break;
+        case( vaLargeBitmapFile::Format24BitRGB ):          BoxDownsample<uint8, 3>( src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY );   break;
+        case( vaLargeBitmapFile::Format32BitRGBA ):         BoxDownsample<uint8, 4>( src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY );   break;
+        case( vaLargeBitmapFile::Format16BitA4R4G4B4 ):     BoxDownsampleA4R4G4B4( src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY );     break;
+        // generic formats (IDs, masks, ...) can't be averaged
+        default:                                            PointDownsample( bytesPerPixel, src, srcPitch, dst, dstPitch, dstSizeX, dstSizeY ); break;
+        }
+    }
+}
+
+bool vaLargeBitmapFile::DownsampleToBlocks( vaLargeBitmapFile & src, vaLargeBitmapFile & dst, int dstRectPosX, int dstRectPosY, int dstRectSizeX, int dstRectSizeY, vaEnkiTS * threadScheduler )
+{
+    assert( dstRectSizeX > 0 && dstRectSizeY > 0 );
+
+    struct DownsampleTaskSet : enki::ITaskSet
+    {
+        vaLargeBitmapFile &                 Src;
+        vaLargeBitmapFile &                 Dst;
+        const int                           BlockXFrom;
+        const int                           BlockYFrom;
+        const int                           BlockCountX;
+        std::atomic_bool                    Failed;
+
+        DownsampleTaskSet( vaLargeBitmapFile & src, vaLargeBitmapFile & dst, int blockXFrom, int blockYFrom, int blockXTo, int blockYTo ) :
+            ITaskSet( (uint32_t) (blockXTo-blockXFrom+1) * (blockYTo-blockYFrom+1) ),
+            Src( src ), Dst( dst ), BlockXFrom( blockXFrom ), BlockYFrom( blockYFrom ), BlockCountX( blockXTo-blockXFrom+1 ), Failed( false )
+        { }
+
+        virtual void            ExecuteRange( enki::TaskSetPartition range, uint32_t threadnum )
+        {
+            VA_SCOPE_CPU_TIMER_AGGREGATE( DownsampleBlock );
+
+            threadnum; // unreferenced
+
+            const int bytesPerPixel = Dst.m_BytesPerPixel;
+            const int blockDim      = Dst.m_BlockDim;
+
+            // one destination block and the 2x2 blocks of source it's made of, per range (not per block)
+            vector<byte> srcBuffer( (size_t)4 * blockDim * blockDim * bytesPerPixel );
+            vector<byte> dstBuffer( (size_t)blockDim * blockDim * bytesPerPixel );
+
+            for( uint32 i = range.start; i < range.end; i++ )
+            {
+                int bx = BlockXFrom + (int)i % BlockCountX;
+                int by = BlockYFrom + (int)i / BlockCountX;
+
+                int dstPosX     = bx * blockDim;
+                int dstPosY     = by * blockDim;
+                int dstSizeX    = vaMath::Min( blockDim, Dst.m_Width - dstPosX );
+                int dstSizeY    = vaMath::Min( blockDim, Dst.m_Height - dstPosY );
+                int srcPitch    = 2 * dstSizeX * bytesPerPixel;
+                int dstPitch    = dstSizeX * bytesPerPixel;
+
+                // with odd source sizes the last source row/column is one short - clamping repeats the edge
+                if( !Src.ReadRectClampBorders( srcBuffer.data( ), srcPitch, (int64)srcBuffer.size( ), 2 * dstPosX, 2 * dstPosY, 2 * dstSizeX, 2 * dstSizeY ) )
+                {
+                    Failed = true;
+                    continue;
+                }
+
+                Downsample( Dst.m_PixelFormat, bytesPerPixel, srcBuffer.data( ), srcPitch, dstBuffer.data( ), dstPitch, dstSizeX, dstSizeY );
+
+                if( !Dst.WriteRect( dstBuffer.data( ), dstPitch, dstPosX, dstPosY, dstSizeX, dstSizeY ) )
+                    Failed = true;
+            }
+        }
+    };
+
+    int blockXFrom  = dstRectPosX / dst.m_BlockDim;
+    int blockYFrom  = dstRectPosY / dst.m_BlockDim;
+    int blockXTo    = ( dstRectPosX + dstRectSizeX - 1 ) / dst.m_BlockDim;
+    int blockYTo    = ( dstRectPosY + dstRectSizeY - 1 ) / dst.m_BlockDim;
+
+    DownsampleTaskSet taskSet( src, dst, blockXFrom, blockYFrom, blockXTo, blockYTo );
+    if( threadScheduler == nullptr )
+        taskSet.ExecuteRange( enki::TaskSetPartition( 0, taskSet.m_SetSize ), 0 );
+    else
+    {
+        threadScheduler->AddTaskSetToPipe( &taskSet );
+        threadScheduler->WaitforTaskSet( &taskSet );
+    }
+    return !taskSet.Failed;
+}
+
+bool vaLargeBitmapFile::UpdateMipChain( const vector<shared_ptr<vaLargeBitmapFile>> & levels, int rectPosX, int rectPosY, int rectSizeX, int rectSizeY, vaEnkiTS * threadScheduler )
+{
+    VA_SCOPE_CPU_TIMER( UpdateMipChain );
+
+    if( ( rectPosX < 0 ) || ( ( rectPosX + rectSizeX ) > m_Width ) || ( rectPosY < 0 ) || ( ( rectPosY + rectSizeY ) > m_Height ) || ( rectSizeX <= 0 ) || ( rectSizeY <= 0 ) )
+    {
+        assert( false );    // invalid region (out of range)
+        return false;
+    }
+
+    // dirty rect as [from, to), in the current source level
+    int fromX = rectPosX, fromY = rectPosY, toX = rectPosX + rectSizeX, toY = rectPosY + rectSizeY;
+
+    vaLargeBitmapFile * src = this;
+    for( const shared_ptr<vaLargeBitmapFile> & level : levels )
+    {
+        if( level == nullptr || level->m_PixelFormat != m_PixelFormat || level->m_ReadOnly
+            || level->m_Width != ( src->m_Width + 1 ) / 2 || level->m_Height != ( src->m_Height + 1 ) / 2 )
+        {
+            assert( false );    // not a mip chain of this image
+            VA_LOG_ERROR( "vaLargeBitmapFile::UpdateMipChain - level doesn't match the source image" );
+            return false;
+        }
+        fromX   = fromX / 2;
+        fromY   = fromY / 2;
+        toX     = ( toX + 1 ) / 2;
+        toY     = ( toY + 1 ) / 2;
+
+        if( !DownsampleToBlocks( *src, *level, fromX, fromY, toX - fromX, toY - fromY, threadScheduler ) )
+        {
+            VA_LOG_ERROR( "vaLargeBitmapFile::UpdateMipChain - error generating level %dx%d", level->m_Width, level->m_Height );
+            return false;
+        }
+        src = level.get( );
+    }
+    return true;
+}
+
+bool vaLargeBitmapFile::GenerateMipChain( vector<shared_ptr<vaLargeBitmapFile>> & outLevels, const wstring & outFilePathBase, int maxLevels, vaEnkiTS * threadScheduler )
+{
+    outLevels.clear( );
+
+    int width = m_Width, height = m_Height;
+    while( ( width > 1 || height > 1 ) && ( maxLevels <= 0 || (int)outLevels.size( ) < maxLevels ) )
+    {
+        width   = ( width + 1 ) / 2;
+        height  = ( height + 1 ) / 2;
+
+        shared_ptr<vaLargeBitmapFile> level = Create( outFilePathBase + L"_mip" + std::to_wstring( outLevels.size( ) + 1 ), m_PixelFormat, width, height );
+        if( level == nullptr )
+        {
+            VA_LOG_ERROR( "vaLargeBitmapFile::GenerateMipChain - error creating level %d file", (int)outLevels.size( ) + 1 );
+            outLevels.clear( );
+            return false;
+        }
+        outLevels.push_back( level );
+    }
+
+    if( outLevels.size( ) == 0 )
+        return true;
+
+    if( !UpdateMipChain( outLevels, 0, 0, m_Width, m_Height, threadScheduler ) )
+    {
+        outLevels.clear( );
+        return false;
+    }
+    return true;
+}
+
 vaLargeBitmapFile::PixelFormat vaLargeBitmapFile::GetMatchingPixelFormat( vaResourceFormat format )
 {
     switch( format )
@@ -1444,6 +2353,9 @@ bool vaLargeBitmapFile::ExportToTiffFile( const wstring & outFilePath )
     int lastLoadedRow = -1;
     int currentStripRowBaseOffset = -stripHeight;
 
+    // ReadRect picks up the strip-by-strip sweep after the first two strips; get those going right away
+    Prefetch( 0, 0, m_Width, 2 * stripHeight );
+
     //Now writing image to the file one strip at a time
     for( int32 row = 0; row < m_Height; row++ )
     {
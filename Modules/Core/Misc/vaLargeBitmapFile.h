@@ -39,6 +39,8 @@
 
 #include "Core/vaCoreIncludes.h"
 #include "Core/Misc/vaResourceFormats.h"
+#include "Core/System/vaFileStream.h"
+#include "Core/System/vaMappedFileStream.h"
 
 #ifdef VA_LIBTIFF_INTEGRATION_ENABLED
 #include "IntegratedExternals/vaLibTIFFIntegration.h"
@@ -61,9 +63,16 @@ namespace VertexAsylum
     /// into tiles to enable fast reads/writes of random image sub-regions.
     /// Access it also thread-safe with per-block granularity so different threads can read&write at the same time 
     /// (although if the operation covers multiple blocks, access order is not guaranteed)
+    /// Loaded blocks of all open files share one memory budget (see SetCacheBudget); blocks can be loaded ahead of
+    /// use on background I/O threads with Prefetch, and sequential ReadRect sweeps prefetch the next rect on their own.
+    /// Alternatively a file can be opened with the Mapped backend (see Backend) - same API, no block cache.
     /// 
-    /// Current file format version is 1 (specified in FormatVersion field): supports reading and writing 
-    /// of versions 0, 1.
+    /// Current file format version is 2 (specified in FormatVersion field): supports reading and writing 
+    /// of versions 0, 1, 2.
+    /// Versions 0 and 1 store all blocks raw at fixed offsets. Version 2 has a block table after the header and stores
+    /// each block either as a single pixel value (constant blocks - all blocks of a new file, or after SetAllPixels),
+    /// LZ compressed (vaLZCodec) or raw if it doesn't compress; block data is appended to the end of the file and
+    /// rewritten in place if it still fits.
     /// </summary>
     class vaLargeBitmapFile
     {
@@ -85,49 +94,99 @@ namespace VertexAsylum
             FormatGeneric128Bit     = 14,
         };
 
+        enum class Backend
+        {
+            // Blocks are loaded into (and evicted from) the block cache shared by all files, with per-block locking;
+            // supports all format versions (so compressed & constant blocks).
+            BlockCache,
+
+            // The whole file is memory mapped and paging is left to the OS: no per-block loading or locking, which is
+            // faster for random access into files that fit the address space comfortably. Raw layout only (format
+            // version 1, no compression) - opening a version 2 file with it falls back to BlockCache. Concurrent writes
+            // to the same pixels are not synchronized.
+            Mapped,
+        };
+
+        enum class AccessPattern
+        {
+            Normal,
+            Sequential,         // mapped: aggressive read-ahead
+            Random,             // mapped: no read-ahead; block cache: no automatic prefetching of ReadRect sweeps
+        };
+
 
     public:
         static int                    GetPixelFormatBPP( PixelFormat pixelFormat );
 
-        static const int              c_FormatVersion       = 1;
-        static const int              c_MemoryLimit         = 32 * 1024 * 1024; // allow xMB of memory usage per instance (this could be upgraded to add a global memory limit as well - see s_TotalUsedMemory)
+        static const int              c_FormatVersion       = 2;
+        static const int64            c_DefaultCacheBudget  = 256 * 1024 * 1024;  // loaded blocks of all open files, see SetCacheBudget
+        static const int              c_IOThreadCount       = 2;                    // background threads serving Prefetch requests
         static const int              c_UserHeaderSize      = 224;
         static const int              c_TotalHeaderSize     = 256;
 
     private:
+        class BlockCache;
+        friend class BlockCache;
+
+        // version 2 block table entry, as stored on disk
+        enum class BlockKind : uint32
+        {
+            Constant                = 0,    // all pixels equal to ConstantValue (so a zero-filled table is an all-zero image)
+            Raw                     = 1,
+            LZ                      = 2,
+        };
+        struct BlockTableEntry
+        {
+            int64               Offset;             // of the stored data (Raw & LZ); the slot is kept for reuse when a block becomes constant
+            uint32              Capacity;           // bytes allocated at Offset
+            uint32              StoredSize;
+            BlockKind           Kind;
+            uint32              Padding;
+            uint8               ConstantValue[16];
+        };
 
         struct DataBlock
         {
-#ifdef VA_LBF_THREADSAFE
-            char *              pData;
-#else
             char *              pData;
-#endif
             unsigned short      Width;
             unsigned short      Height;
             bool                Modified;
+            std::atomic_bool    Referenced;         // set on access, cleared by the cache's clock hand (second chance LRU)
+            std::atomic_bool    PrefetchQueued;
+            vaLargeBitmapFile * Owner;
+            DataBlock *         CachePrev;          // ring of all loaded blocks (of all files) - protected by the BlockCache mutex
+            DataBlock *         CacheNext;
             VA_LBF_THREADSAFE_LINE( std::shared_mutex   Mutex; )
+
+            void                Touch( )            { if( !Referenced.load( std::memory_order_relaxed ) ) Referenced.store( true, std::memory_order_relaxed ); }
         };
 
-        struct DataBlockID
-        {
-            int                 Bx;
-            int                 By;
+        static std::atomic<int64>                   s_CacheBudget;
 
-            DataBlockID( int bx, int by ) { this->Bx = bx; this->By = by; }
-        };
+        BlockCache *                                m_Cache;            // process-wide, held while the file is open
 
-        static int                                  s_TotalUsedMemory;
-        VA_LBF_THREADSAFE_LINE( static mutex        s_TotalUsedMemoryMutex; )
+        // prefetch requests of this file being executed by the I/O threads - protected by the BlockCache queue mutex
+        int                                         m_PrefetchesInFlight;
 
-        int                                         m_UsedMemory;
-        deque<DataBlockID>                          m_UsedBlocks;
-        VA_LBF_THREADSAFE_LINE( mutable mutex       m_UsedMemoryMutex; )
+        // last ReadRect, to detect sweeps - protected by m_LastReadRectMutex
+        int                                         m_LastReadRect[4];
+        mutex                                       m_LastReadRectMutex;
 
-        VA_LBF_THREADSAFE_LINE( mutex               m_fileAccessMutex; )
-        FILE *                                      m_File;
+        vaFileStream                                m_File;             // opened with OpenForConcurrentIO; block I/O uses ReadAt/WriteAt so it doesn't need a lock
         wstring                                     m_filePath;
 
+        // Backend::Mapped only (m_File is closed then)
+        vaMappedFileStream                          m_Mapped;
+        uint8 *                                     m_MappedData;
+
+        std::atomic_bool                            m_SweepPrefetch;
+
+        int                                         m_FormatVersion;
+        vector<BlockTableEntry>                     m_BlockTable;       // version 2 only, same indexing as m_BigDataBlocksArray; an entry is protected by its block's lock
+        int64                                       m_FileEnd;          // version 2 only, where new block data gets appended - protected by m_FileEndMutex
+        std::multimap<uint32, int64>                m_FreeSlots;        // version 2 only, capacity -> offset of space not used by any block (left by blocks that grew) - protected by m_FileEndMutex
+        mutex                                       m_FileEndMutex;
+
         bool                                        m_ReadOnly;
 
         int                                         m_BlockDimBits;
@@ -155,36 +214,83 @@ namespace VertexAsylum
         int                                         GetWidth( ) const           { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return m_Width; }
         int                                         GetHeight( ) const          { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return m_Height; }
         const wstring &                             GetFilePath( ) const        { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return m_filePath; }
-        bool                                        IsOpen( ) const             { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return m_File != 0; }
+        bool                                        IsOpen( ) const             { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return m_File.IsOpen( ) || m_Mapped.IsOpen( ); }
+        Backend                                     GetBackend( ) const         { std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); return ( m_MappedData != nullptr ) ? ( Backend::Mapped ) : ( Backend::BlockCache ); }
 #else
         PixelFormat                                 GetPixelFormat( ) const     { return m_PixelFormat;     }
         int                                         GetBytesPerPixel( ) const   { return m_BytesPerPixel;   }
         int                                         GetWidth( ) const           { return m_Width;           }
         int                                         GetHeight( ) const          { return m_Height;          }
         const wstring &                             GetFilePath( ) const        { return m_filePath;        }
-        bool                                        IsOpen( ) const             { return m_File != 0;       }
+        bool                                        IsOpen( ) const             { return m_File.IsOpen( ) || m_Mapped.IsOpen( ); }
+        Backend                                     GetBackend( ) const         { return ( m_MappedData != nullptr ) ? ( Backend::Mapped ) : ( Backend::BlockCache ); }
 #endif
 
     protected:
-        vaLargeBitmapFile( FILE * file, const wstring & filePath, PixelFormat pixelFormat, int width, int height, int blockDim, bool readOnly );
+        vaLargeBitmapFile( const wstring & filePath, PixelFormat pixelFormat, int width, int height, int blockDim, int formatVersion, bool readOnly );
 
     public:
         ~vaLargeBitmapFile( );
 
     public:
-        static shared_ptr<vaLargeBitmapFile>        Create( const wstring & filePath, PixelFormat pixelFormat, int width, int height );
-        static shared_ptr<vaLargeBitmapFile>        Open( const wstring & filePath, bool readOnly );
+        static shared_ptr<vaLargeBitmapFile>        Create( const wstring & filePath, PixelFormat pixelFormat, int width, int height, Backend backend = Backend::BlockCache );
+        static shared_ptr<vaLargeBitmapFile>        Open( const wstring & filePath, bool readOnly, Backend backend = Backend::BlockCache );
 
         static vaLargeBitmapFile::PixelFormat       GetMatchingPixelFormat( vaResourceFormat format );
 
         void                                        Close( );
 
+        // Writes all modified data to the file (without releasing anything from memory)
+        bool                                        Flush( );
+
+        // Hint for how the file is going to be accessed (see AccessPattern)
+        void                                        SetAccessPattern( AccessPattern pattern );
+
+        // Memory budget for loaded blocks, shared by all open files; when over it, blocks not used recently are saved (if
+        // modified) and released. Blocks in use are never evicted, so actual usage can go over by the blocks being used.
+        static void                                 SetCacheBudget( int64 bytes );
+        static int64                                GetCacheBudget( )           { return s_CacheBudget.load( ); }
+        static int64                                GetCacheUsedBytes( );
+
+        // Queues loading of the blocks under the rect on the background I/O threads and returns immediately, so that a
+        // later ReadRect/WriteRect over it doesn't wait for the disk. Requests bigger than half of the cache budget are
+        // cut short (they would just evict themselves).
+        void                                        Prefetch( int rectPosX, int rectPosY, int rectSizeX, int rectSizeY );
+
     private:
+        // these require the block's unique lock
         void                                        ReleaseBlock( int bx, int by );
         void                                        LoadBlock( int bx, int by, bool skipFileRead = false );
         void                                        SaveBlock( int bx, int by );
+        void                                        FreeBlockData( DataBlock & db );
+
+        // m_GlobalMutex (shared) must be held
+        void                                        PrefetchNoMutexLock( int rectPosX, int rectPosY, int rectSizeX, int rectSizeY );
+
+        // called on the I/O threads
+        void                                        ExecutePrefetch( int bx, int by );
+
+        // versions 0 & 1 only
         int64                                       GetBlockStartPos( int bx, int by );
 
+        // version 2 only
+        int64                                       GetBlockTableEntryPos( int blockIndex ) const   { return c_TotalHeaderSize + (int64)blockIndex * sizeof( BlockTableEntry ); }
+        bool                                        WriteBlockTableEntry( int blockIndex );
+        bool                                        ValidateBlockTable( );
+
+        // fills block data (loaded or mapped) with the pixel value
+        void                                        FillConstant( char * data, int sizeInBytes, const void * pixel );
+
+        // Backend::Mapped: copies the part of the rect inside block bx, by between the mapping and 'buffer' (which holds the whole rect)
+        void                                        MappedCopyBlockRect( int bx, int by, char * buffer, int bufferPitchInBytes, int rectPosX, int rectPosY, int rectSizeX, int rectSizeY, bool toFile );
+        char *                                      MappedPixel( int x, int y );
+
+        // SetAllPixels implementation
+        void                                        FillAllBlocks( const void * pixel );
+
+        // one level of UpdateMipChain: regenerates all blocks of 'dst' overlapping the rect (in dst pixels) from 'src'
+        static bool                                 DownsampleToBlocks( vaLargeBitmapFile & src, vaLargeBitmapFile & dst, int dstRectPosX, int dstRectPosY, int dstRectSizeX, int dstRectSizeY, vaEnkiTS * threadScheduler );
+
     public:
         void                                        GetPixel( int x, int y, void* pPixel );
         void                                        SetPixel( int x, int y, void* pPixel );
@@ -201,6 +307,17 @@ namespace VertexAsylum
 
         bool                                        ReadRectClampBorders( void * _dstBuffer, int dstPitchInBytes, int64 dstSizeInBytes, int dstRectPosX, int dstRectPosY, int dstRectSizeX, int dstRectSizeY, vaEnkiTS * threadScheduler = nullptr );
 
+        // Writes 2x2 box filtered downsampled levels of this image to new files named outFilePathBase + L"_mip1", L"_mip2",
+        // ... (same pixel format, each level half of the previous one rounded up) down to 1x1, or maxLevels levels if > 0.
+        // Each level is built block by block (of the destination) in parallel on threadScheduler if provided, so memory
+        // use is a few blocks per worker on top of the block cache. Generic formats (all sizes) have no known channel
+        // layout and often hold IDs or masks, so they're point sampled.
+        bool                                        GenerateMipChain( vector<shared_ptr<vaLargeBitmapFile>> & outLevels, const wstring & outFilePathBase, int maxLevels = 0, vaEnkiTS * threadScheduler = nullptr );
+
+        // Regenerates only the blocks of 'levels' (from GenerateMipChain: levels[0] is half the size of this) that depend
+        // on the given rect of this image - call after modifying it.
+        bool                                        UpdateMipChain( const vector<shared_ptr<vaLargeBitmapFile>> & levels, int rectPosX, int rectPosY, int rectSizeX, int rectSizeY, vaEnkiTS * threadScheduler = nullptr );
+
 #ifdef VA_LIBTIFF_INTEGRATION_ENABLED
         bool                                        ExportToTiffFile( const wstring & outFilePath );
 #endif
@@ -226,35 +343,12 @@ namespace VertexAsylum
     template< typename T >
     void vaLargeBitmapFile::SetAllPixels( const T & value )
     {
-        VA_LBF_THREADSAFE_LINE( std::shared_lock<std::shared_mutex> lock( m_GlobalMutex ); )
-        if( sizeof( T ) != m_BytesPerPixel )
+        if( sizeof( T ) != GetBytesPerPixel( ) )
         {
             assert( false );       // type size must match - otherwise there will be issues
             return;
         }
-
-        T * oneBlock = new T[m_BlockDim * m_BlockDim];
-        for( int i = 0; i < m_BlockDim * m_BlockDim; i++ )
-            oneBlock[i] = value;
-
-        for( int y = 0; y < m_BlocksY; y++ )
-        {
-            for( int x = 0; x < m_BlocksX; x++ )
-            {
-                DataBlock & db = m_DataBlocks[x][y];
-                VA_LBF_THREADSAFE_LINE( std::unique_lock<std::shared_mutex> uniqueBlockLock( db.Mutex ); ) 
-                if( db.pData == 0 )
-                    LoadBlock( x, y, true );
-
-                int size = db.Width * db.Height * m_BytesPerPixel;
-                assert( size <= (sizeof(T)*m_BlockDim * m_BlockDim) );
-                memcpy( db.pData, oneBlock, size );
-
-                db.Modified = true;
-            }
-        }
-
-        delete[] oneBlock;
+        FillAllBlocks( &value );
     }
 
 
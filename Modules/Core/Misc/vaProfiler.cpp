@@ -28,6 +28,8 @@
 
 #include "Rendering/vaRenderDevice.h"
 
+#include "Core/System/vaFileStream.h"
+
 #ifdef VA_USE_PIX3
 #define USE_PIX
 #endif
@@ -42,13 +44,13 @@ int vaNestedProfilerNode::s_totalNodes = 0;
 
 bool vaScopeTimer::s_disableScopeTimer = false;
 
-vaNestedProfilerNode::vaNestedProfilerNode( vaNestedProfilerNode * parentNode, const string & name, vaRenderDeviceContext * renderDeviceContext, bool aggregateIfSameNameInScope )
+vaNestedProfilerNode::vaNestedProfilerNode( vaNestedProfilerNode * parentNode, const vaStringID & name, vaRenderDeviceContext * renderDeviceContext, bool aggregateIfSameNameInScope )
     : m_name( name ), m_parentNode( parentNode ), m_selected( false ), m_aggregateIfSameNameInScope( aggregateIfSameNameInScope )
 {
     if( renderDeviceContext != nullptr )
     {
         m_GPUProfiler = VA_RENDERING_MODULE_CREATE_SHARED( vaGPUTimer, vaGPUTimerParams( *renderDeviceContext ) );
-        m_GPUProfiler->SetName( name );
+        m_GPUProfiler->SetName( name.ToString( ) );
     }
 
     m_startTimeCPU = 0.0;
@@ -101,6 +103,15 @@ vaNestedProfilerNode::~vaNestedProfilerNode( )
 }
 
 const vaNestedProfilerNode * vaNestedProfilerNode::FindSubNode( const string & name ) const
+{
+    // never interned means no node has it
+    vaStringID nameID = vaStringID::Find( name );
+    if( nameID.Empty( ) && !name.empty( ) )
+        return nullptr;
+    return FindSubNode( nameID );
+}
+
+const vaNestedProfilerNode * vaNestedProfilerNode::FindSubNode( const vaStringID & name ) const
 {
     if( m_name == name )
         return this;
@@ -116,10 +127,10 @@ const vaNestedProfilerNode * vaNestedProfilerNode::FindSubNode( const string & n
     return nullptr;
 }
 
-vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const string & name, double currentTime, int64 profilerFrameIndex, bool aggregateIfSameNameInScope, vaRenderDeviceContext * renderDeviceContext )
+vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const vaStringID & _name, double currentTime, int64 profilerFrameIndex, bool aggregateIfSameNameInScope, vaRenderDeviceContext * renderDeviceContext )
 {
     vaNestedProfilerNode * node = nullptr;
-    auto it = m_childNodes.find( name );
+    auto it = m_childNodes.find( _name );
     if( it != m_childNodes.end( ) )
     {
         if( it->second->m_lastUsedProfilerFrameIndex == profilerFrameIndex )
@@ -134,6 +145,7 @@ vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const string & name, do
             else
             { 
                 // ouch, name already exists, pick another name
+                const string name = _name.ToString( );
                 int counter = 0;
                 int passIDOffset = (int)name.length()-4;
                 if( ( passIDOffset >= 0 ) && (name[passIDOffset] == '_') && (name[passIDOffset+1] == 'p') &&
@@ -151,7 +163,7 @@ vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const string & name, do
                     return nullptr;
                 }
                 else
-                    return StartScope( name.substr( 0, passIDOffset ) + '_' + 'p' + (char)('0'+counter/10) + (char)('0'+counter%10), currentTime, profilerFrameIndex, aggregateIfSameNameInScope, renderDeviceContext );
+                    return StartScope( vaStringID( name.substr( 0, passIDOffset ) + '_' + 'p' + (char)('0'+counter/10) + (char)('0'+counter%10) ), currentTime, profilerFrameIndex, aggregateIfSameNameInScope, renderDeviceContext );
             }
         }
 
@@ -167,8 +179,8 @@ vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const string & name, do
             return nullptr;
         }
 
-        node = new vaNestedProfilerNode( this, name, renderDeviceContext, aggregateIfSameNameInScope );
-        m_childNodes.insert( std::pair<string, vaNestedProfilerNode*>(name, node) );
+        node = new vaNestedProfilerNode( this, _name, renderDeviceContext, aggregateIfSameNameInScope );
+        m_childNodes.insert( std::make_pair( _name, node ) );
     }
 
     node->m_nodeUsageIndex = m_childNodeUsageFrameCounter;
@@ -187,7 +199,7 @@ vaNestedProfilerNode * vaNestedProfilerNode::StartScope( const string & name, do
     else
     {
 #ifdef USE_PIX
-        if( name != "" )
+        if( !_name.Empty( ) )
             PIXBeginEvent( PIX_COLOR_INDEX(0), node->m_name.c_str() );
 #endif
     }
@@ -207,7 +219,7 @@ void vaNestedProfilerNode::StopScope( double currentTime, vaRenderDeviceContext
     else
     {
 #ifdef USE_PIX
-    if( m_name != "" )
+    if( !m_name.Empty( ) )
         PIXEndEvent( );
 #endif
     }
@@ -287,11 +299,15 @@ void vaNestedProfilerNode::Proccess( )
     m_historyTotalTimeGPU[m_historyLastIndex]       = m_totalTimeGPU;
     m_historyExclusiveTimeCPU[m_historyLastIndex]   = m_exclusiveTimeCPU;
     m_historyExclusiveTimeGPU[m_historyLastIndex]   = m_exclusiveTimeGPU;
+    m_historyCountersSum += m_counters;
     m_historyLastIndex++;
     if( m_historyLastIndex >= c_historyFrameCount )
     {
         m_historyLastIndex = 0;
 
+        m_averageCounters           = m_historyCountersSum;
+        m_historyCountersSum        = vaCPUCounterValues( );
+
         m_averageTotalTimeCPU       = 0.0;
         m_averageTotalTimeGPU       = 0.0;
         m_averageExclusiveTimeCPU   = 0.0;
@@ -318,11 +334,11 @@ void vaNestedProfilerNode::Proccess( )
     }
 }
 
-void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu, bool skipInitialNonGPUNodes, vaProfilerTimingsDisplayType displayType )
+void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu, bool skipInitialNonGPUNodes, vaProfilerTimingsDisplayType displayType, bool showCounters )
 {
-    namePath; depth; cpu; displayType;
+    namePath; depth; cpu; displayType; showCounters;
 #ifdef VA_IMGUI_INTEGRATION_ENABLED
-    string newNamePath = m_name;
+    string newNamePath = m_name.ToString( );
 
     if( depth == 0 )
         newNamePath = (cpu)?("CPU"):("GPU");
@@ -333,7 +349,7 @@ void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu
 
     const int indentCharCount = 2;
 
-    string info = m_name;
+    string info = m_name.ToString( );
     if( depth == 0 )
         info = ( cpu ) ? ( "CPU Times" ) : ( "GPU Times" );
 
@@ -405,7 +421,18 @@ void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu
     }
 #else // just show "all"
     if( cpu )
+    {
         info += vaStringTools::Format( "%7.3f", displayTimeTotalCPU*1000.0f );
+        if( showCounters )
+        {
+            const vaCPUCounterValues & counters = ( displayType == vaProfilerTimingsDisplayType::LastFrame ) ? ( m_counters ) : ( m_averageCounters );
+            // m_averageCounters is a sum over the history window
+            double cycles = ( displayType == vaProfilerTimingsDisplayType::LastFrame ) ? ( (double)counters.Cycles ) : ( (double)counters.Cycles / c_historyFrameCount );
+            info += vaStringTools::Format( "  %9.1f kcyc", cycles / 1000.0 );
+            if( vaCPUCounters::IsEventCountingSupported( ) )
+                info += vaStringTools::Format( "  IPC %4.2f  LLC %6.2f  BR %6.2f", counters.GetIPC( ), counters.GetLLCMissesPerKI( ), counters.GetBranchMissesPerKI( ) );
+        }
+    }
     else
     {
         if( m_hasGPUTimings )
@@ -430,7 +457,7 @@ void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu
 
                 for( auto it = m_sortedChildNodes.begin( ); it != m_sortedChildNodes.end( ); it++ )
                     if( (*it) != nullptr )
-                        (*it)->Display( newNamePath, depth + 1, cpu, skipInitialNonGPUNodes, displayType );
+                        (*it)->Display( newNamePath, depth + 1, cpu, skipInitialNonGPUNodes, displayType, showCounters );
 
                 //ImGui::Unindent( );
             }
@@ -439,13 +466,35 @@ void vaNestedProfilerNode::Display( const string & namePath, int depth, bool cpu
 #endif
 }
 
+void vaNestedProfilerNode::WriteReportCSV( string & outText, const string & namePath ) const
+{
+    string newNamePath = ( namePath == "" ) ? ( m_name.ToString( ) ) : ( namePath + "/" + m_name.c_str( ) );
+
+    outText += vaStringTools::Format( "%s, %.4f, %.4f, %.4f, %.4f, %.4f, %.1f, %.1f", newNamePath.c_str(),
+        m_totalTimeCPU * 1000.0, m_averageTotalTimeCPU * 1000.0, m_maxTotalTimeCPU * 1000.0, m_averageExclusiveTimeCPU * 1000.0,
+        m_averageTotalTimeGPU * 1000.0, m_counters.Cycles / 1000.0, m_averageCounters.Cycles / ( 1000.0 * c_historyFrameCount ) );
+    // ratio columns are left empty if there are no event counters
+    if( vaCPUCounters::IsEventCountingSupported( ) )
+        outText += vaStringTools::Format( ", %.3f, %.3f, %.3f, %.3f, %.3f, %.3f\n",
+            m_counters.GetIPC( ), m_counters.GetLLCMissesPerKI( ), m_counters.GetBranchMissesPerKI( ),
+            m_averageCounters.GetIPC( ), m_averageCounters.GetLLCMissesPerKI( ), m_averageCounters.GetBranchMissesPerKI( ) );
+    else
+        outText += ", , , , , , \n";
+
+    for( auto it = m_sortedChildNodes.begin( ); it != m_sortedChildNodes.end( ); it++ )
+        if( (*it) != nullptr )
+            (*it)->WriteReportCSV( outText, newNamePath );
+}
+
 vaProfiler::vaProfiler( )
-    : m_root( nullptr, "groot", nullptr, false )
+    : m_root( nullptr, VA_STRING_ID( "groot" ), nullptr, false )
 {
     m_currentScope = nullptr;
     m_lastScope = nullptr;
     m_displayType = vaProfilerTimingsDisplayType::LastXFramesAverage;
     m_profilerFrameIndex = 0;
+    m_CPUCountersEnabled = false;
+    m_CPUCountersEnableRequested = false;
 
 #ifdef VA_REMOTERY_INTEGRATION_ENABLED
     {
@@ -482,12 +531,15 @@ vaProfiler::~vaProfiler( )
         assert( m_currentScope == nullptr );
     }
 
+    if( m_CPUCountersEnabled )
+        vaCPUCounters::EnableForCurrentThread( false );
+
 #ifdef VA_REMOTERY_INTEGRATION_ENABLED
     rmt_DestroyGlobalInstance( m_remotery );
 #endif
 }
 
-vaNestedProfilerNode * vaProfiler::StartScope( const string & name, bool aggregateIfSameNameInScope, vaRenderDeviceContext * renderDeviceContext )
+vaNestedProfilerNode * vaProfiler::StartScope( const vaStringID & name, bool aggregateIfSameNameInScope, vaRenderDeviceContext * renderDeviceContext )
 {
     assert( vaThreading::IsMainThread( ) );
     if( !vaThreading::IsMainThread( ) )
@@ -503,12 +555,16 @@ vaNestedProfilerNode * vaProfiler::StartScope( const string & name, bool aggrega
         m_currentScope->m_framesUntouched = 0;
         m_currentScope->m_childNodeUsageFrameCounter = 0;
 #ifdef USE_PIX
-        if( m_currentScope->m_name != "" )
+        if( !m_currentScope->m_name.Empty( ) )
             PIXBeginEvent( PIX_COLOR_INDEX(0), m_currentScope->m_name.c_str() );
 #endif
     }
     else
         m_currentScope = m_currentScope->StartScope( name, m_timer.GetCurrentTimeDouble( ), m_profilerFrameIndex, aggregateIfSameNameInScope, renderDeviceContext );
+
+    if( m_CPUCountersEnabled && m_currentScope != nullptr )
+        vaCPUCounters::Sample( m_currentScope->m_startCounters );
+
     return m_currentScope;
 }
 
@@ -519,6 +575,12 @@ void vaProfiler::StopScope( vaNestedProfilerNode * node, vaRenderDeviceContext *
         return;
 
     assert( node == m_currentScope );
+    if( m_CPUCountersEnabled )
+    {
+        vaCPUCounterValues counters;
+        if( vaCPUCounters::Sample( counters ) )
+            node->m_counters = counters - node->m_startCounters;
+    }
     node->StopScope( m_timer.GetCurrentTimeDouble( ), renderDeviceContext );
     m_lastScope = node;
     m_currentScope = node->m_parentNode;
@@ -553,6 +615,13 @@ void vaProfiler::NewFrame( )
     
     m_profilerFrameIndex++;
 
+    if( m_CPUCountersEnableRequested != m_CPUCountersEnabled )
+    {
+        bool success = vaCPUCounters::EnableForCurrentThread( m_CPUCountersEnableRequested );
+        m_CPUCountersEnabled = m_CPUCountersEnableRequested && success;
+        m_CPUCountersEnableRequested = m_CPUCountersEnabled;
+    }
+
     // start root
     m_currentScope = StartScope( m_root.m_name, false, nullptr );
     assert( m_currentScope == &m_root );
@@ -589,9 +658,26 @@ void vaProfiler::InsertImGuiContent( bool showCPU )
     assert( m_currentScope != nullptr );    // have you called vaProfiler::GetInstance().NewFrame() at the beginning of the frame?
     //ImGui::Text( "" );
     if( showCPU )
-        m_root.Display( "", 0, true, false, m_displayType );
+    {
+        if( vaCPUCounters::IsSupported( ) )
+        {
+            if( vaCPUCounters::IsEventCountingSupported( ) )
+                ImGui::Checkbox( "Hardware counters (cycles, IPC, LLC and branch misses per 1000 instr.)", &m_CPUCountersEnableRequested );
+            else
+                ImGui::Checkbox( "Hardware counters (thread cycles only on this platform)", &m_CPUCountersEnableRequested );
+        }
+        else
+        {
+            ImGui::TextDisabled( "Hardware counters not supported on this platform" );
+        }
+        if( ImGui::Button( "Save CSV report" ) )
+            SaveReportCSV( vaCore::GetExecutableDirectory( ) + L"profiler_report.csv" );
+    }
+
+    if( showCPU )
+        m_root.Display( "", 0, true, false, m_displayType, m_CPUCountersEnabled );
     if( showGPU )
-        m_root.Display( "", 0, false, true, m_displayType );
+        m_root.Display( "", 0, false, true, m_displayType, false );
     //ImGui::Text( "" );
 
     ImGui::PopID();
@@ -600,15 +686,34 @@ void vaProfiler::InsertImGuiContent( bool showCPU )
 #endif
 }
 
+bool vaProfiler::SaveReportCSV( const wstring & filePath ) const
+{
+    string text = "Scope, CPU last (ms), CPU avg (ms), CPU max (ms), CPU exclusive avg (ms), GPU avg (ms), kcycles last, kcycles avg, IPC last, LLC MPKI last, Branch MPKI last, IPC avg, LLC MPKI avg, Branch MPKI avg\n";
+    m_root.WriteReportCSV( text, "" );
+
+    vaFileStream outFile;
+    if( !outFile.Open( filePath, FileCreationMode::Create ) || !outFile.WriteTXT( text ) )
+    {
+        VA_LOG_WARNING( L"vaProfiler::SaveReportCSV - unable to write '%s'", filePath.c_str( ) );
+        return false;
+    }
+    VA_LOG( L"vaProfiler: report saved to '%s'", filePath.c_str( ) );
+    return true;
+}
+
 void vaProfiler::EnkiThreadStartCallback( uint32_t threadnum_ )
 {
     string name = vaStringTools::Format( "ThreadPool_%d", threadnum_ );
     VA_NAME_THREAD( name.c_str()  );
 }
 
+static uint32 s_enkiWaitTraceScopeID = vaTracer::RegisterScope( "EnkiWait" );
+
 void vaProfiler::EnkiWaitStartCallback( uint32_t threadnum_ )
 {
     threadnum_;
+    if( vaTracer::IsCapturing( ) )
+        vaTracer::BeginScope( s_enkiWaitTraceScopeID );
 // #if defined(VA_REMOTERY_INTEGRATION_ENABLED)
 //     rmt_BeginCPUSample(IDLE, 0);
 // #endif
@@ -617,13 +722,16 @@ void vaProfiler::EnkiWaitStartCallback( uint32_t threadnum_ )
 void vaProfiler::EnkiWaitStopCallback( uint32_t threadnum_ )
 {
     threadnum_;
+    // capture could have started while waiting, in which case the trace exporter will drop the unmatched 'End'
+    if( vaTracer::IsCapturing( ) )
+        vaTracer::EndScope( s_enkiWaitTraceScopeID );
 // #if defined(VA_REMOTERY_INTEGRATION_ENABLED)
 //     rmt_EndCPUSample();
 // #endif
 }
 
 
-vaScopeTimer::vaScopeTimer( const string & name, vaRenderDeviceContext * renderDeviceContext, bool aggregateIfSameNameInScope )
+vaScopeTimer::vaScopeTimer( const vaStringID & name, vaRenderDeviceContext * renderDeviceContext, bool aggregateIfSameNameInScope )
     : m_node( (!s_disableScopeTimer)?(vaProfiler::GetInstance().StartScope( name, aggregateIfSameNameInScope, renderDeviceContext ) ) : ( nullptr ) ), m_renderDeviceContext( renderDeviceContext )
 { 
 }
@@ -20,9 +20,14 @@
 #pragma once
 
 // WARNING: the CPU side of this profiler is not really useful at all - it only makes sense for measuring CPU side of
-// draw calls. For anything else better to use Remotery or another freely available instrumentation lib.
+// draw calls. For anything else better to use Remotery or another freely available instrumentation lib, or vaTracer
+// (see vaTracer.h) which captures VA_SCOPE_CPU_TIMER / VA_TRACE_SCOPE scopes from all threads at a very low cost.
 
 #include "Core/vaCoreIncludes.h"
+#include "Core/vaStringID.h"
+
+#include "Core/Misc/vaTracer.h"
+#include "Core/System/vaCPUCounters.h"
 
 #ifdef VA_REMOTERY_INTEGRATION_ENABLED
 #include "IntegratedExternals\vaRemoteryIntegration.h"
@@ -47,12 +52,12 @@ namespace VertexAsylum
         static const int                c_historyFrameCount     = 128;
 
     private:
-        string const                    m_name;
+        vaStringID const                m_name;
         bool                            m_selected;
         bool                            m_aggregateIfSameNameInScope;
 
         vaNestedProfilerNode * const    m_parentNode;
-        map< string, vaNestedProfilerNode * >
+        std::unordered_map< vaStringID, vaNestedProfilerNode *, vaStringID::Hasher >
                                         m_childNodes;
         vector< vaNestedProfilerNode* > m_sortedChildNodes;
 
@@ -90,26 +95,34 @@ namespace VertexAsylum
         double                          m_maxTotalTimeGPU;
         double                          m_maxExclusiveTimeCPU;
         double                          m_maxExclusiveTimeGPU;
+
+        // hardware counters (only collected if vaProfiler::IsCPUCountersEnabled( ))
+        vaCPUCounterValues              m_startCounters;
+        vaCPUCounterValues              m_counters;                         // last frame
+        vaCPUCounterValues              m_historyCountersSum;               // sum over the current history window
+        vaCPUCounterValues              m_averageCounters;                  // sum over the last complete history window (ratios are the same as for the average)
             
         static const int                c_untouchedFramesKeep = c_historyFrameCount * 2;
 
     protected:
         friend class vaProfiler;
-        vaNestedProfilerNode( vaNestedProfilerNode * parentNode, const string & name, vaRenderDeviceContext * renderDeviceContext, bool selected );
+        vaNestedProfilerNode( vaNestedProfilerNode * parentNode, const vaStringID & name, vaRenderDeviceContext * renderDeviceContext, bool selected );
         ~vaNestedProfilerNode( );
 
     protected:
-        vaNestedProfilerNode *          StartScope( const string & name, double currentTime, int64 profilerFrameIndex, bool newNodeSelectedDefault, vaRenderDeviceContext * renderDeviceContext );
+        vaNestedProfilerNode *          StartScope( const vaStringID & name, double currentTime, int64 profilerFrameIndex, bool newNodeSelectedDefault, vaRenderDeviceContext * renderDeviceContext );
         void                            StopScope( double currentTime, vaRenderDeviceContext * renderDeviceContext );
         //
     protected:
         void                            RemoveOrphans( );
         void                            Proccess( );
-        void                            Display( const string & namePath, int depth, bool cpu, bool skipInitialNonGPUNodes, vaProfilerTimingsDisplayType displayType );
+        void                            Display( const string & namePath, int depth, bool cpu, bool skipInitialNonGPUNodes, vaProfilerTimingsDisplayType displayType, bool showCounters );
+        void                            WriteReportCSV( string & outText, const string & namePath ) const;
         //
     public:
         // Warning: node returned here is only guaranteed to remain valud until next vaProfiler::NewFrame( ) gets called
         const vaNestedProfilerNode *    FindSubNode( const string & name ) const;
+        const vaNestedProfilerNode *    FindSubNode( const vaStringID & name ) const;
 
         int                             GetFrameHistoryLength( ) const              { return c_historyFrameCount;       }
 
@@ -134,6 +147,9 @@ namespace VertexAsylum
         double                          GetFrameMaxTotalTimeGPU( ) const            { return m_maxTotalTimeGPU;         }
         double                          GetFrameMaxExclusiveTimeCPU( ) const        { return m_maxExclusiveTimeCPU;     }
         double                          GetFrameMaxExclusiveTimeGPU( ) const        { return m_maxExclusiveTimeGPU;     }
+
+        const vaCPUCounterValues &      GetFrameLastCounters( ) const               { return m_counters;                }
+        const vaCPUCounterValues &      GetFrameAverageCounters( ) const            { return m_averageCounters;         }
     };
 
     class vaProfiler : public vaSingletonBase<vaProfiler>
@@ -154,6 +170,9 @@ namespace VertexAsylum
         vaProfilerTimingsDisplayType    m_displayType;
 
         int64                           m_profilerFrameIndex;
+
+        bool                            m_CPUCountersEnabled;
+        bool                            m_CPUCountersEnableRequested;       // applied at NewFrame so that no scope is open during the switch
     
     protected:
         friend class vaRenderDevice;
@@ -161,7 +180,9 @@ namespace VertexAsylum
         ~vaProfiler( );
 
     public:
-        vaNestedProfilerNode *          StartScope( const string & name, bool newNodeSelectedDefault, vaRenderDeviceContext * renderDeviceContext );
+        // scope names are interned (see vaStringID) so that finding the node every frame is a hash & pointer compare
+        vaNestedProfilerNode *          StartScope( const vaStringID & name, bool newNodeSelectedDefault, vaRenderDeviceContext * renderDeviceContext );
+        vaNestedProfilerNode *          StartScope( const string & name, bool newNodeSelectedDefault, vaRenderDeviceContext * renderDeviceContext )  { return StartScope( vaStringID( name ), newNodeSelectedDefault, renderDeviceContext ); }
         void                            StopScope( vaNestedProfilerNode * node, vaRenderDeviceContext * renderDeviceContext );
 
     public:
@@ -171,6 +192,13 @@ namespace VertexAsylum
 
         void                            MakeLastScopeSelected( );
 
+        // Samples hardware counters (see vaCPUCounters) at every CPU scope entry/exit; main thread only, like the rest of the CPU side
+        bool                            IsCPUCountersEnabled( ) const               { return m_CPUCountersEnabled; }
+        void                            SetCPUCountersEnabled( bool enable )        { m_CPUCountersEnableRequested = enable; }
+
+        // Per-scope CPU/GPU timings and counter derived values (IPC, misses per 1000 instructions) for all nodes
+        bool                            SaveReportCSV( const wstring & filePath ) const;
+
     private:
         friend class vaEnkiTS;
         static void                     EnkiThreadStartCallback( uint32_t threadnum_ );
@@ -188,7 +216,8 @@ namespace VertexAsylum
     private:
         //
     public:
-        vaScopeTimer( const string & name, vaRenderDeviceContext * renderDeviceContext = nullptr, bool aggregateIfSameNameInScope = false );
+        vaScopeTimer( const vaStringID & name, vaRenderDeviceContext * renderDeviceContext = nullptr, bool aggregateIfSameNameInScope = false );
+        vaScopeTimer( const string & name, vaRenderDeviceContext * renderDeviceContext = nullptr, bool aggregateIfSameNameInScope = false ) : vaScopeTimer( vaStringID( name ), renderDeviceContext, aggregateIfSameNameInScope ) { }
         virtual ~vaScopeTimer( );
 
         static bool                 IsEnabled( )                { return !s_disableScopeTimer; }
@@ -212,11 +241,11 @@ namespace VertexAsylum
 
     #else
 
-        #define VA_SCOPE_CPU_TIMER( name )                                          vaScopeTimer scope_##name( #name );
+        #define VA_SCOPE_CPU_TIMER( name )                                          VA_TRACE_SCOPE( name ); vaScopeTimer scope_##name( VA_STRING_ID( #name ) );
         #define VA_SCOPE_CPU_TIMER_CUSTOMNAME( nameVar, customName )                vaScopeTimer scope_##name( customName );
-        #define VA_SCOPE_CPU_TIMER_AGGREGATE( name )                                vaScopeTimer scope_##name( #name, nullptr, true );
+        #define VA_SCOPE_CPU_TIMER_AGGREGATE( name )                                VA_TRACE_SCOPE( name ); vaScopeTimer scope_##name( VA_STRING_ID( #name ), nullptr, true );
 
-        #define VA_NAME_THREAD( name )                                              
+        #define VA_NAME_THREAD( name )                                              vaTracer::SetCurrentThreadName( name )
 
     #endif
 
@@ -224,11 +253,11 @@ namespace VertexAsylum
 
 #else
 
-    #define VA_SCOPE_CPU_TIMER( name )                      
+    #define VA_SCOPE_CPU_TIMER( name )                      VA_TRACE_SCOPE( name )
     #define VA_SCOPE_CPU_TIMER_NAMED( nameVar, nameScope )  
-    #define VA_SCOPE_CPU_TIMER_AGGREGATE( name )
+    #define VA_SCOPE_CPU_TIMER_AGGREGATE( name )            VA_TRACE_SCOPE( name )
 
-    #define VA_NAME_THREAD( name )                                              
+    #define VA_NAME_THREAD( name )                          vaTracer::SetCurrentThreadName( name )
 
 #endif
 
@@ -1,154 +1,259 @@
 
 #include "vaPropertyContainer.h"
 
+#include "Core/System/vaStream.h"
+
 #include "IntegratedExternals/vaImguiIntegration.h"
 
 using namespace VertexAsylum;
 
-void vaPropertyContainer::PropertyItemBool::ImGuiEdit( int numDecimals )
+namespace
 {
-    numDecimals; // unreferenced
-
-    if( !m_isUIVisible ) return;
-
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
-
-    if( m_isUIEditable )
-        ImGui::Checkbox( m_name.c_str(), &m_value );
-    else
+    // size of the value in the binary blob; 0 for String (length prefixed, see vaStream::WriteString)
+    int BinaryValueSize( vaPropertyContainer::PropertyType type )
     {
-        ImGui::LabelText( "%s", ((m_value)?"true":"false") );
+        switch( type )
+        {
+        case vaPropertyContainer::PropertyType::Bool:       return 1;
+        case vaPropertyContainer::PropertyType::Int32:      return 4;
+        case vaPropertyContainer::PropertyType::UInt32:     return 4;
+        case vaPropertyContainer::PropertyType::Int64:      return 8;
+        case vaPropertyContainer::PropertyType::Float:      return 4;
+        case vaPropertyContainer::PropertyType::Double:     return 8;
+        case vaPropertyContainer::PropertyType::String:     return 0;
+        default: assert( false ); return -1;
+        }
     }
-#endif
-}
-
-void vaPropertyContainer::PropertyItemInt32::ImGuiEdit( int numDecimals )
-{
-    numDecimals; // unreferenced
-
-    if( !m_isUIVisible ) return;
 
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
+    bool WriteBinaryValue( vaStream & outStream, vaPropertyContainer::PropertyType type, const void * value )
+    {
+        switch( type )
+        {
+        case vaPropertyContainer::PropertyType::Bool:       return outStream.WriteValue<uint8>( ( *static_cast<const bool *>( value ) ) ? ( 1 ) : ( 0 ) );
+        case vaPropertyContainer::PropertyType::String:     return outStream.WriteString( *static_cast<const string *>( value ) );
+        default:                                            return outStream.Write( value, BinaryValueSize( type ) );
+        }
+    }
 
-    if( m_isUIEditable )
+    bool ReadBinaryValue( vaStream & inStream, vaPropertyContainer::PropertyType type, void * value )
     {
-        int32 tmpValue = m_value;
-        if( ImGui::InputInt( m_name.c_str(), &tmpValue, m_editStep, m_editStep * 10, ImGuiInputTextFlags_EnterReturnsTrue ) )
-            m_value = vaMath::Clamp( tmpValue, m_minVal, m_maxVal );
+        switch( type )
+        {
+        case vaPropertyContainer::PropertyType::Bool:
+        {
+            uint8 boolValue;
+            if( !inStream.ReadValue<uint8>( boolValue ) )
+                return false;
+            *static_cast<bool *>( value ) = boolValue != 0;
+            return true;
+        }
+        case vaPropertyContainer::PropertyType::String:     return inStream.ReadString( *static_cast<string *>( value ) );
+        default:                                            return inStream.Read( value, BinaryValueSize( type ) );
+        }
     }
-    else
+
+    bool SkipBinaryValue( vaStream & inStream, vaPropertyContainer::PropertyType type )
     {
-        ImGui::LabelText( "%s", "%d", m_value );
+        if( type == vaPropertyContainer::PropertyType::String )
+        {
+            string dummy;
+            return inStream.ReadString( dummy );
+        }
+        uint8 dummy[8];
+        return inStream.Read( dummy, BinaryValueSize( type ) );
     }
-#endif
 }
 
-void vaPropertyContainer::PropertyItemUInt32::ImGuiEdit( int numDecimals )
+vaPropertyContainer::Property & vaPropertyContainer::AddProperty( const string & name, PropertyType type, void * value, bool hasDefault, bool isUIVisible, bool isEditable )
 {
-    numDecimals; // unreferenced
+    Property property;
+    property.Name           = vaStringID( name );
+    property.Value          = value;
+    property.Type           = type;
+    property.HasDefault     = hasDefault;
+    property.IsUIVisible    = isUIVisible;
+    property.IsUIEditable   = isEditable;
+    property.Default.Int    = 0;
+    property.MinVal.Int     = 0;
+    property.MaxVal.Int     = 0;
+    property.EditStep.Int   = 0;
 
-    if( !m_isUIVisible ) return;
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
+    // the binary format identifies properties by name hash so it has to be unique within the container
+    bool inserted = m_index.insert( std::make_pair( property.Name.Hash( ), (int)m_properties.size( ) ) ).second;
+    assert( inserted ); inserted; // duplicate property name?
 
-    if( m_isUIEditable )
-    {
-        //ImGui::InputInt( m_name.c_str(), &m_value, m_editStep, m_editStep * 10 );
-        //m_value = vaMath::Clamp( m_value, m_minVal, m_maxVal );
-        ImGui::LabelText( "%s (uint32 editing not supported)", "%u", m_value );
-    }
-    else
-    {
-        ImGui::LabelText( "%s", "%u", m_value );
-    }
-#endif
+    m_properties.push_back( property );
+    return m_properties.back( );
 }
 
-void vaPropertyContainer::PropertyItemInt64::ImGuiEdit( int numDecimals )
+void vaPropertyContainer::AddIntegerProperty( const string & name, PropertyType type, void * value, int64 defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, int64 minVal, int64 maxVal, int64 editStep )
 {
-    numDecimals; // unreferenced
-
-    if( !m_isUIVisible ) return;
+    Property & property = AddProperty( name, type, value, hasDefault, isUIVisible, isEditable );
+    property.Default.Int    = defaultValue;
+    property.MinVal.Int     = minVal;
+    property.MaxVal.Int     = maxVal;
+    property.EditStep.Int   = editStep;
+}
 
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
+void vaPropertyContainer::AddFloatProperty( const string & name, PropertyType type, void * value, double defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, double minVal, double maxVal, double editStep )
+{
+    Property & property = AddProperty( name, type, value, hasDefault, isUIVisible, isEditable );
+    property.Default.Float  = defaultValue;
+    property.MinVal.Float   = minVal;
+    property.MaxVal.Float   = maxVal;
+    property.EditStep.Float = editStep;
+}
 
-    if( m_isUIEditable )
-    {
-        //ImGui::InputInt( m_name.c_str(), &m_value, m_editStep, m_editStep * 10 );
-        //m_value = vaMath::Clamp( m_value, m_minVal, m_maxVal );
-        ImGui::LabelText( "%s (int64 editing not supported)", "%lld", m_value );
-    }
-    else
-    {
-        ImGui::LabelText( "%s", "%lld", m_value );
-    }
-#endif
+void vaPropertyContainer::AddStringProperty( const string & name, string * value, const string & defaultValue, bool hasDefault, bool isUIVisible, bool isEditable )
+{
+    Property & property = AddProperty( name, PropertyType::String, value, hasDefault, isUIVisible, isEditable );
+    property.Default.Int    = (int64)m_stringDefaults.size( );
+    m_stringDefaults.push_back( defaultValue );
 }
 
-void vaPropertyContainer::PropertyItemFloat::ImGuiEdit( int numDecimals )
+int vaPropertyContainer::FindProperty( const vaStringID & name ) const
 {
-    if( !m_isUIVisible ) return;
-    numDecimals;
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
+    auto it = m_index.find( name.Hash( ) );
+    if( it == m_index.end( ) || m_properties[it->second].Name != name )
+        return -1;
+    return it->second;
+}
 
-    if( m_isUIEditable )
+void vaPropertyContainer::SetToDefault( Property & property )
+{
+    assert( property.HasDefault );
+    switch( property.Type )
     {
-        float tmpValue = (float)m_value;
-        string fmt = vaStringTools::Format("%%.%df", numDecimals);
-        if( ImGui::InputFloat( m_name.c_str(), &tmpValue, m_editStep, m_editStep * 10, fmt.c_str(), ImGuiInputTextFlags_EnterReturnsTrue ) )
-            m_value = vaMath::Clamp( tmpValue, m_minVal, m_maxVal );
+    case PropertyType::Bool:    *static_cast<bool *>( property.Value )      = property.Default.Int != 0;                        break;
+    case PropertyType::Int32:   *static_cast<int32 *>( property.Value )     = (int32)property.Default.Int;                      break;
+    case PropertyType::UInt32:  *static_cast<uint32 *>( property.Value )    = (uint32)property.Default.Int;                     break;
+    case PropertyType::Int64:   *static_cast<int64 *>( property.Value )     = property.Default.Int;                             break;
+    case PropertyType::Float:   *static_cast<float *>( property.Value )     = (float)property.Default.Float;                    break;
+    case PropertyType::Double:  *static_cast<double *>( property.Value )    = property.Default.Float;                           break;
+    case PropertyType::String:  *static_cast<string *>( property.Value )    = m_stringDefaults[(size_t)property.Default.Int];   break;
+    default: assert( false ); break;
     }
-    else
+}
+
+namespace
+{
+    template< typename T >
+    bool TemplatedNamedSerialize( const char * name, T & value, vaXMLSerializer & serializer )
     {
-        ImGui::LabelText( "%s", "%.4f", m_value );
+        assert( serializer.GetVersion() > 0 );
+        if( serializer.IsReading( ) || serializer.IsWriting( ) )
+            return serializer.Serialize<T>( name, value );
+        assert( false );
+        return false;
     }
-#endif
 }
 
-void vaPropertyContainer::PropertyItemDouble::ImGuiEdit( int numDecimals )
+bool vaPropertyContainer::NamedSerialize( Property & property, vaXMLSerializer & serializer )
 {
-    if( !m_isUIVisible ) return;
-    numDecimals;
-#ifdef VA_IMGUI_INTEGRATION_ENABLED
-    if( m_isUIEditable )
+    const char * name = property.Name.c_str( );
+    bool ret = false;
+    switch( property.Type )
     {
-        float tmpValue = (float)m_value;
-        string fmt = vaStringTools::Format("%%.%df", numDecimals);
-        if( ImGui::InputFloat( m_name.c_str( ), &tmpValue, (float)m_editStep, (float)m_editStep * 10, fmt.c_str() ), ImGuiInputTextFlags_EnterReturnsTrue )
-        {
-            m_value = vaMath::Clamp( (double)tmpValue, m_minVal, m_maxVal );
-        }
+    case PropertyType::Bool:    ret = TemplatedNamedSerialize( name, *static_cast<bool *>( property.Value ), serializer );      break;
+    case PropertyType::Int32:   ret = TemplatedNamedSerialize( name, *static_cast<int32 *>( property.Value ), serializer );     break;
+    case PropertyType::UInt32:  ret = TemplatedNamedSerialize( name, *static_cast<uint32 *>( property.Value ), serializer );    break;
+    case PropertyType::Int64:   ret = TemplatedNamedSerialize( name, *static_cast<int64 *>( property.Value ), serializer );     break;
+    case PropertyType::Float:   ret = TemplatedNamedSerialize( name, *static_cast<float *>( property.Value ), serializer );     break;
+    case PropertyType::Double:  ret = TemplatedNamedSerialize( name, *static_cast<double *>( property.Value ), serializer );    break;
+    case PropertyType::String:  ret = TemplatedNamedSerialize( name, *static_cast<string *>( property.Value ), serializer );    break;
+    default: assert( false ); return false;
     }
-    else
+    if( !ret && serializer.IsReading( ) && property.HasDefault )
     {
-        float tmpValue = (float)m_value;
-        ImGui::LabelText( "%s", "%.4f", tmpValue );
+        SetToDefault( property );
+        return true;
     }
-#endif
+    return ret;
 }
 
-void vaPropertyContainer::PropertyItemString::ImGuiEdit( int numDecimals )
+void vaPropertyContainer::ImGuiEdit( Property & property )
 {
-    numDecimals; // unreferenced
-
-    if( !m_isUIVisible ) return;
+    if( !property.IsUIVisible ) return;
 
 #ifdef VA_IMGUI_INTEGRATION_ENABLED
-
-    if( m_isUIEditable )
+    const char * name = property.Name.c_str( );
+    switch( property.Type )
+    {
+    case PropertyType::Bool:
+    {
+        bool & value = *static_cast<bool *>( property.Value );
+        if( property.IsUIEditable )
+            ImGui::Checkbox( name, &value );
+        else
+            ImGui::LabelText( "%s", ((value)?"true":"false") );
+    } break;
+    case PropertyType::Int32:
     {
-        assert( false ); // never tested
-        const int editBufferSize = 2048;
-        if( m_value.size() < editBufferSize )
+        int32 & value = *static_cast<int32 *>( property.Value );
+        if( property.IsUIEditable )
         {
-            char buffer[editBufferSize];
-            memcpy( buffer, m_value.c_str(), m_value.size() );
-            if( ImGui::InputText( m_name.c_str(), buffer, sizeof(buffer) ) )
-                m_value = buffer;
+            int32 tmpValue = value;
+            if( ImGui::InputInt( name, &tmpValue, (int32)property.EditStep.Int, (int32)property.EditStep.Int * 10, ImGuiInputTextFlags_EnterReturnsTrue ) )
+                value = vaMath::Clamp( tmpValue, (int32)property.MinVal.Int, (int32)property.MaxVal.Int );
         }
-    }
-    else
+        else
+            ImGui::LabelText( "%s", "%d", value );
+    } break;
+    case PropertyType::UInt32:
+    {
+        uint32 & value = *static_cast<uint32 *>( property.Value );
+        if( property.IsUIEditable )
+            ImGui::LabelText( "%s (uint32 editing not supported)", "%u", value );
+        else
+            ImGui::LabelText( "%s", "%u", value );
+    } break;
+    case PropertyType::Int64:
+    {
+        int64 & value = *static_cast<int64 *>( property.Value );
+        if( property.IsUIEditable )
+            ImGui::LabelText( "%s (int64 editing not supported)", "%lld", value );
+        else
+            ImGui::LabelText( "%s", "%lld", value );
+    } break;
+    case PropertyType::Float:
+    case PropertyType::Double:
+    {
+        double value = ( property.Type == PropertyType::Float ) ? ( *static_cast<float *>( property.Value ) ) : ( *static_cast<double *>( property.Value ) );
+        if( property.IsUIEditable )
+        {
+            float tmpValue = (float)value;
+            string fmt = vaStringTools::Format("%%.%df", m_numDecimals);
+            if( ImGui::InputFloat( name, &tmpValue, (float)property.EditStep.Float, (float)property.EditStep.Float * 10, fmt.c_str(), ImGuiInputTextFlags_EnterReturnsTrue ) )
+            {
+                value = vaMath::Clamp( (double)tmpValue, property.MinVal.Float, property.MaxVal.Float );
+                if( property.Type == PropertyType::Float )
+                    *static_cast<float *>( property.Value ) = (float)value;
+                else
+                    *static_cast<double *>( property.Value ) = value;
+            }
+        }
+        else
+            ImGui::LabelText( "%s", "%.4f", (float)value );
+    } break;
+    case PropertyType::String:
     {
-        ImGui::LabelText( "%s", "%s", m_value.c_str() );
+        string & value = *static_cast<string *>( property.Value );
+        if( property.IsUIEditable )
+        {
+            assert( false ); // never tested
+            const int editBufferSize = 2048;
+            if( value.size() < editBufferSize )
+            {
+                char buffer[editBufferSize];
+                memcpy( buffer, value.c_str(), value.size() + 1 );
+                if( ImGui::InputText( name, buffer, sizeof(buffer) ) )
+                    value = buffer;
+            }
+        }
+        else
+            ImGui::LabelText( "%s", "%s", value.c_str() );
+    } break;
+    default: assert( false ); break;
     }
 #endif
 }
@@ -156,29 +261,111 @@ void vaPropertyContainer::PropertyItemString::ImGuiEdit( int numDecimals )
 bool vaPropertyContainer::Serialize( vaXMLSerializer & serializer )
 {
     assert( serializer.GetVersion() > 0 );
-    //if( !serializer.SerializeOpenChildElement( m_name.c_str() ) )
-    //    return false;
 
-    for( auto & p : m_properties )
+    for( Property & property : m_properties )
     {
-        //if( serializer.Serialize( p->Name().c_str(), *p ) )
-        if( !p->NamedSerialize( serializer ) )
+        if( !NamedSerialize( property, serializer ) )
         {
             assert( false );
             return false;
         }
     }
 
-    //if( !serializer.SerializePopToParentElement( m_name.c_str( ) ) )
-    //    { assert( false ); return false; };
+    return true;
+}
+
+bool vaPropertyContainer::SaveBinary( vaStream & outStream ) const
+{
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<uint32>( c_binaryMagic ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<uint32>( c_binaryVersion ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int32>( (int32)m_properties.size( ) ) );
 
+    for( const Property & property : m_properties )
+    {
+        VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<uint64>( property.Name.Hash( ) ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<uint8>( (uint8)property.Type ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( WriteBinaryValue( outStream, property.Type, property.Value ) );
+    }
     return true;
 }
 
-void vaPropertyContainer::UIPropertiesItemDraw( )
+bool vaPropertyContainer::LoadBinary( vaStream & inStream )
 {
-    for( auto & p : m_properties )
+    uint32 magic = 0, version = 0;
+    int32 count = 0;
+    if( !inStream.ReadValue<uint32>( magic ) || !inStream.ReadValue<uint32>( version ) || !inStream.ReadValue<int32>( count ) )
+    {
+        VA_LOG_ERROR( "vaPropertyContainer::LoadBinary ('%s') - error reading header", m_name.c_str() );
+        return false;
+    }
+    if( magic != c_binaryMagic || version != c_binaryVersion || count < 0 )
+    {
+        VA_LOG_ERROR( "vaPropertyContainer::LoadBinary ('%s') - unrecognized data or version", m_name.c_str() );
+        return false;
+    }
+
+    // common case: blob saved from the same layout, every entry is the next property; once that breaks, loaded
+    // properties are tracked with flags instead
+    int             inOrderCount = 0;
+    vector<uint8>   loaded;
+
+    for( int i = 0; i < count; i++ )
     {
-        p->ImGuiEdit( m_numDecimals );
+        uint64 nameHash = 0;
+        uint8 type = 0;
+        if( !inStream.ReadValue<uint64>( nameHash ) || !inStream.ReadValue<uint8>( type ) || type > (uint8)PropertyType::String )
+        {
+            VA_LOG_ERROR( "vaPropertyContainer::LoadBinary ('%s') - error reading property %d", m_name.c_str(), i );
+            return false;
+        }
+
+        int index = -1;
+        if( loaded.empty( ) && inOrderCount < (int)m_properties.size( ) && m_properties[inOrderCount].Name.Hash( ) == nameHash && (uint8)m_properties[inOrderCount].Type == type )
+        {
+            index = inOrderCount;
+            inOrderCount++;
+        }
+        else
+        {
+            auto it = m_index.find( nameHash );
+            if( it != m_index.end( ) && (uint8)m_properties[it->second].Type == type )
+            {
+                index = it->second;
+                if( loaded.empty( ) )
+                {
+                    loaded.resize( m_properties.size( ), 0 );
+                    std::fill( loaded.begin( ), loaded.begin( ) + inOrderCount, (uint8)1 );
+                }
+                loaded[index] = 1;
+            }
+        }
+
+        bool ok = ( index >= 0 ) ? ( ReadBinaryValue( inStream, (PropertyType)type, m_properties[index].Value ) ) : ( SkipBinaryValue( inStream, (PropertyType)type ) );
+        if( !ok )
+        {
+            VA_LOG_ERROR( "vaPropertyContainer::LoadBinary ('%s') - error reading property %d", m_name.c_str(), i );
+            return false;
+        }
+    }
+
+    bool allFound = true;
+    for( int i = 0; i < (int)m_properties.size( ); i++ )
+    {
+        if( ( loaded.empty( ) ) ? ( i < inOrderCount ) : ( loaded[i] != 0 ) )
+            continue;
+        if( m_properties[i].HasDefault )
+            SetToDefault( m_properties[i] );
+        else
+        {
+            VA_LOG_WARNING( "vaPropertyContainer::LoadBinary ('%s') - property '%s' not found", m_name.c_str(), m_properties[i].Name.c_str() );
+            allFound = false;
+        }
     }
-}
\ No newline at end of file
+    return allFound;
+}
+
+void vaPropertyContainer::UIPropertiesItemDraw( )
+{
+    for( Property & property : m_properties )
+        ImGuiEdit( property );
+}
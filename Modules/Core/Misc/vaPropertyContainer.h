@@ -3,168 +3,67 @@
 
 #include "Core/vaCoreIncludes.h"
 #include "Core/vaXMLSerialization.h"
+#include "Core/vaStringID.h"
 
 #include "Core/vaUI.h"
 
+#include <unordered_map>
+
 namespace VertexAsylum
 {
+    class vaStream;
 
-    // help serialize properties from/to XML and optionally provides editing via 
+    // help serialize properties from/to XML (or a compact binary blob, see SaveBinary/LoadBinary) and optionally provides
+    // editing via vaUIPropertiesItem. Properties are references to variables owned by the user, kept in a flat type-tagged
+    // array in registration order (which is also the XML and UI order) with a name hash index for O(1) lookups.
     class vaPropertyContainer : public vaUIPropertiesItem, public vaXMLSerializable
     {
-    private:
-        string const        m_name;
-
-        int                 m_numDecimals;
-
-    private:
-        class PropertyItem
-        {
-        protected:
-            string const        m_name;
-            bool                m_hasDefault;
-            bool                m_isUIVisible;
-            bool                m_isUIEditable;
-
-        protected:
-            PropertyItem( const string & name, bool hasDefault, bool isUIVisible, bool isUIEditable ) : m_name( name ), m_hasDefault( hasDefault ), m_isUIVisible( isUIVisible ), m_isUIEditable( isUIEditable ) { }
-
-        public:
-            virtual ~PropertyItem( )    { }
-
-        public:
-            const string &      Name( ) const                       { return m_name; }
-
-            virtual void        ImGuiEdit( int numDecimals )    = 0;
-
-            template< typename T >
-            bool                TemplatedNamedSerialize( T & value, bool hasDefault, T & defaultValue, vaXMLSerializer & serializer )
-            {
-                assert( serializer.GetVersion() > 0 );
-                if( serializer.IsReading( ) )
-                {
-                    if( serializer.Serialize<T>( m_name.c_str(), value ) )
-                        return true;
-                    if( hasDefault )
-                    {
-                        value = defaultValue; 
-                        return true;
-                    }
-                    return false;
-                }
-                if( serializer.IsWriting( ) )
-                {
-                    return serializer.Serialize<T>( m_name.c_str(), value );
-                }
-                assert( false );
-                return false;
-            }
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) = 0;
-        };
-
-        class PropertyItemBool : public PropertyItem
-        {
-            bool &              m_value;
-            bool                m_defaultValue;
-
-        public:
-            PropertyItemBool( const string & name, bool & value, bool defaultValue, bool hasDefault, bool isUIVisible, bool isEditable )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
-        };
-
-        class PropertyItemInt32 : public PropertyItem
-        {
-            int32 &             m_value;
-            int32               m_defaultValue;
-            int32               m_minVal;
-            int32               m_maxVal;
-            int32               m_editStep;
-
-        public:
-            PropertyItemInt32( const string & name, int32 & value, int32 defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, int32 minVal = INT_MIN, int32 maxVal = INT_MAX, int32 editStep = 1 )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ), m_minVal( minVal ), m_maxVal( maxVal ), m_editStep( editStep ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
-        };
-
-        class PropertyItemUInt32 : public PropertyItem
-        {
-            uint32 &             m_value;
-            uint32               m_defaultValue;
-            uint32               m_minVal;
-            uint32               m_maxVal;
-            uint32               m_editStep;
-
-        public:
-            PropertyItemUInt32( const string & name, uint32 & value, uint32 defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, uint32 minVal = 0, uint32 maxVal = 0xFFFFFFFF, uint32 editStep = 1 )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ), m_minVal( minVal ), m_maxVal( maxVal ), m_editStep( editStep ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
-        };
-
-        class PropertyItemInt64 : public PropertyItem
+    public:
+        enum class PropertyType : uint8
         {
-            int64 &             m_value;
-            int64               m_defaultValue;
-            int64               m_minVal;
-            int64               m_maxVal;
-            int64               m_editStep;
-
-        public:
-            PropertyItemInt64( const string & name, int64 & value, int64 defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, int64 minVal = INT64_MIN, int64 maxVal = INT64_MAX, int64 editStep = 1 )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ), m_minVal( minVal ), m_maxVal( maxVal ), m_editStep( editStep ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
+            Bool,
+            Int32,
+            UInt32,
+            Int64,
+            Float,
+            Double,
+            String,
         };
 
-        class PropertyItemFloat : public PropertyItem
+    private:
+        // bool & integer types use Int, float & double use Float; for String, Default.Int is the m_stringDefaults index
+        union NumericValue
         {
-            float &             m_value;
-            float               m_defaultValue;
-            float               m_minVal;
-            float               m_maxVal;
-            float               m_editStep;
-
-        public:
-            PropertyItemFloat( const string & name, float & value, float defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, float minVal = VA_FLOAT_LOWEST, float maxVal = VA_FLOAT_HIGHEST, float editStep = 0.1f )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ), m_minVal( minVal ), m_maxVal( maxVal ), m_editStep( editStep ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
+            int64               Int;
+            double              Float;
         };
 
-        class PropertyItemDouble : public PropertyItem
+        struct Property
         {
-            double &             m_value;
-            double               m_defaultValue;
-            double               m_minVal;
-            double               m_maxVal;
-            double               m_editStep;
-
-        public:
-            PropertyItemDouble( const string & name, double & value, double defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, double minVal = VA_DOUBLE_LOWEST, double maxVal = VA_DOUBLE_HIGHEST, double editStep = 0.1 )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ), m_minVal( minVal ), m_maxVal( maxVal ), m_editStep( editStep ) { };
-
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
+            vaStringID          Name;                   // interned: property names repeat across every instance of a container type
+            void *              Value;                  // bool *, int32 *, ... string * - see Type
+            PropertyType        Type;
+            bool                HasDefault;
+            bool                IsUIVisible;
+            bool                IsUIEditable;
+            NumericValue        Default;
+            NumericValue        MinVal;
+            NumericValue        MaxVal;
+            NumericValue        EditStep;
         };
 
-        class PropertyItemString : public PropertyItem
-        {
-            string &            m_value;
-            string              m_defaultValue;
-            //bool                m_readOnly;
+        static const uint32     c_binaryMagic           = 0x43504156;   // 'VAPC'
+        static const uint32     c_binaryVersion         = 1;
 
-        public:
-            PropertyItemString( const string & name, string & value, const string & defaultValue, bool hasDefault, bool isUIVisible, bool isEditable )  : PropertyItem( name, hasDefault, isUIVisible, isEditable ), m_value( value ), m_defaultValue( defaultValue ) { };
+    private:
+        string const            m_name;
 
-            virtual bool        NamedSerialize( vaXMLSerializer & serializer ) override { return TemplatedNamedSerialize( m_value, m_hasDefault, m_defaultValue, serializer ); }
-            virtual void        ImGuiEdit( int numDecimals );
-        };
+        int                     m_numDecimals;
 
-        vector< unique_ptr<PropertyItem> >
-                            m_properties;
+        vector< Property >      m_properties;
+        std::unordered_map< uint64, int >
+                                m_index;                // Property::Name hash -> m_properties index
+        vector< string >        m_stringDefaults;
 
     public:
         vaPropertyContainer( const string & name, int numDecimals = 3 ) : m_name( name ), m_numDecimals( numDecimals )     { assert( name != "" ); }
@@ -172,13 +71,33 @@ namespace VertexAsylum
 
         const string &          Name( ) const                       { return m_name; }
 
-        void                    RegisterProperty( const string & name, bool & value, bool defaultValue = false, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false )                                                                                                { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemBool>( name, value, defaultValue, hasDefault, isUIVisible, isEditable ) ); }
-        void                    RegisterProperty( const string & name, int32 & value, int32 defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, int32 minVal = INT_MIN, int32 maxVal = INT_MAX, int32 editStep = 1 )                            { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemInt32>( name, value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ) ); }
-        void                    RegisterProperty( const string & name, uint32 & value, uint32 defaultValue = 0, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, uint32 minVal = 0, uint32 maxVal = 0xFFFFFFFF, uint32 editStep = 1 )                            { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemUInt32>( name, value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ) ); }
-        void                    RegisterProperty( const string & name, int64 & value, int64 defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, int64 minVal = INT64_MIN, int64 maxVal = INT64_MAX, int64 editStep = 1 )                        { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemInt64>( name, value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ) ); }
-        void                    RegisterProperty( const string & name, float & value, float defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, float minVal = VA_FLOAT_LOWEST, float maxVal = VA_FLOAT_HIGHEST, float editStep = 0.1f )        { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemFloat>( name, value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ) ); }
-        void                    RegisterProperty( const string & name, double & value, double defaultValue = 0, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, double minVal = VA_DOUBLE_LOWEST, double maxVal = VA_DOUBLE_HIGHEST, double editStep = 0.1 )    { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemDouble>( name, value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ) ); }
-        void                    RegisterProperty( const string & name, string & value, string defaultValue = 0, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false )                                                                                                { if( hasDefault ) value = defaultValue; m_properties.push_back( std::make_unique< PropertyItemString>( name, value, defaultValue, hasDefault, isUIVisible, isEditable ) ); }
+        void                    RegisterProperty( const string & name, bool & value, bool defaultValue = false, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false )                                                                                                { if( hasDefault ) value = defaultValue; AddIntegerProperty( name, PropertyType::Bool, &value, defaultValue, hasDefault, isUIVisible, isEditable, 0, 1, 1 ); }
+        void                    RegisterProperty( const string & name, int32 & value, int32 defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, int32 minVal = INT_MIN, int32 maxVal = INT_MAX, int32 editStep = 1 )                            { if( hasDefault ) value = defaultValue; AddIntegerProperty( name, PropertyType::Int32, &value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ); }
+        void                    RegisterProperty( const string & name, uint32 & value, uint32 defaultValue = 0, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, uint32 minVal = 0, uint32 maxVal = 0xFFFFFFFF, uint32 editStep = 1 )                            { if( hasDefault ) value = defaultValue; AddIntegerProperty( name, PropertyType::UInt32, &value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ); }
+        void                    RegisterProperty( const string & name, int64 & value, int64 defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, int64 minVal = INT64_MIN, int64 maxVal = INT64_MAX, int64 editStep = 1 )                        { if( hasDefault ) value = defaultValue; AddIntegerProperty( name, PropertyType::Int64, &value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ); }
+        void                    RegisterProperty( const string & name, float & value, float defaultValue = 0,   bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, float minVal = VA_FLOAT_LOWEST, float maxVal = VA_FLOAT_HIGHEST, float editStep = 0.1f )        { if( hasDefault ) value = defaultValue; AddFloatProperty( name, PropertyType::Float, &value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ); }
+        void                    RegisterProperty( const string & name, double & value, double defaultValue = 0, bool hasDefault = false, bool isUIVisible = false, bool isEditable = false, double minVal = VA_DOUBLE_LOWEST, double maxVal = VA_DOUBLE_HIGHEST, double editStep = 0.1 )    { if( hasDefault ) value = defaultValue; AddFloatProperty( name, PropertyType::Double, &value, defaultValue, hasDefault, isUIVisible, isEditable, minVal, maxVal, editStep ); }
+        void                    RegisterProperty( const string & name, string & value, string defaultValue = "", bool hasDefault = false, bool isUIVisible = false, bool isEditable = false )                                                                                               { if( hasDefault ) value = defaultValue; AddStringProperty( name, &value, defaultValue, hasDefault, isUIVisible, isEditable ); }
+
+        int                     GetPropertyCount( ) const           { return (int)m_properties.size( ); }
+
+        // O(1); returns the property index or -1 if there's no property with that name
+        int                     FindProperty( const vaStringID & name ) const;
+        int                     FindProperty( const string & name ) const                   { vaStringID id = vaStringID::Find( name ); return ( id.Empty( ) ) ? ( -1 ) : ( FindProperty( id ) ); }
+
+        // Set/Get by name; false if there's no such property or it's of a different type (no conversions). Set does not
+        // clamp to the registered min/max.
+        template< typename T >
+        bool                    SetValue( const vaStringID & name, const T & value )        { T * dst = FindValue<T>( name ); if( dst == nullptr ) return false; *dst = value; return true; }
+        template< typename T >
+        bool                    GetValue( const vaStringID & name, T & outValue ) const     { T * src = const_cast<vaPropertyContainer *>( this )->FindValue<T>( name ); if( src == nullptr ) return false; outValue = *src; return true; }
+
+        // Compact binary snapshot of all property values - meant for applying presets in bulk (sweeps, automated tests &
+        // benchmarks) where the XML path is too slow. A blob saved from a container with the same properties (names and
+        // types in the same order) loads in order without lookups; otherwise values are matched by name hash, unknown
+        // ones skipped and missing ones handled like in XML (default if registered with one, otherwise LoadBinary fails).
+        bool                    SaveBinary( vaStream & outStream ) const;
+        bool                    LoadBinary( vaStream & inStream );
 
     protected:
         bool                    Serialize( vaXMLSerializer & serializer ) override;
@@ -186,8 +105,38 @@ namespace VertexAsylum
     public:
         virtual string                          UIPropertiesItemGetDisplayName( ) const override { return m_name; }
         virtual void                            UIPropertiesItemDraw( ) override;
+
+    private:
+        Property &              AddProperty( const string & name, PropertyType type, void * value, bool hasDefault, bool isUIVisible, bool isEditable );
+        void                    AddIntegerProperty( const string & name, PropertyType type, void * value, int64 defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, int64 minVal, int64 maxVal, int64 editStep );
+        void                    AddFloatProperty( const string & name, PropertyType type, void * value, double defaultValue, bool hasDefault, bool isUIVisible, bool isEditable, double minVal, double maxVal, double editStep );
+        void                    AddStringProperty( const string & name, string * value, const string & defaultValue, bool hasDefault, bool isUIVisible, bool isEditable );
+
+        template< typename T >
+        T *                     FindValue( const vaStringID & name );
+
+        static PropertyType     TypeOf( const bool * )              { return PropertyType::Bool; }
+        static PropertyType     TypeOf( const int32 * )             { return PropertyType::Int32; }
+        static PropertyType     TypeOf( const uint32 * )            { return PropertyType::UInt32; }
+        static PropertyType     TypeOf( const int64 * )             { return PropertyType::Int64; }
+        static PropertyType     TypeOf( const float * )             { return PropertyType::Float; }
+        static PropertyType     TypeOf( const double * )            { return PropertyType::Double; }
+        static PropertyType     TypeOf( const string * )            { return PropertyType::String; }
+
+        void                    SetToDefault( Property & property );
+        bool                    NamedSerialize( Property & property, vaXMLSerializer & serializer );
+        void                    ImGuiEdit( Property & property );
     };
 
+    template< typename T >
+    inline T * vaPropertyContainer::FindValue( const vaStringID & name )
+    {
+        int index = FindProperty( name );
+        if( index < 0 || m_properties[index].Type != TypeOf( (const T *)nullptr ) )
+            return nullptr;
+        return static_cast<T *>( m_properties[index].Value );
+    }
+
 #define VA_PROPERTYCONTAINER_REGISTER( x, ... )      RegisterProperty( #x, x, __VA_ARGS__ )
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "vaTracer.h"
+
+#include "Core/System/vaFileStream.h"
+#include "Core/vaStringTools.h"
+#include "Core/vaLog.h"
+
+#include <chrono>
+#include <unordered_map>
+
+using namespace VertexAsylum;
+
+std::atomic_bool                    vaTracer::s_capturing       = false;
+thread_local vaTracer::ThreadContext * vaTracer::s_threadContext = nullptr;
+thread_local char                   vaTracer::s_threadName[vaTracer::c_maxThreadNameLength] = { 0 };
+thread_local vaTracer::ThreadExitHook vaTracer::s_threadExitHook;
+
+namespace
+{
+    // all of the global state is kept behind one mutex; none of it is touched on the hot (per-event) path
+    struct vaTracerGlobals
+    {
+        mutex                                       Mutex;
+
+        vector<string>                              ScopeNames;
+        std::unordered_map<string, uint32>          ScopeNameToID;
+
+        // contexts of live threads and of exited ones whose events haven't been exported or discarded yet
+        vector<shared_ptr<vaTracer::ThreadContext>> ThreadContexts;
+        // contexts of exited threads that are free for reuse (never released until shutdown)
+        vector<shared_ptr<vaTracer::ThreadContext>> FreeThreadContexts;
+        int                                         NextThreadIndex     = 0;
+
+        uint64                                      CaptureStartTSC     = 0;
+        uint64                                      CaptureStopTSC      = 0;
+        std::chrono::steady_clock::time_point       CaptureStartTime;
+        std::chrono::steady_clock::time_point       CaptureStopTime;
+    };
+
+    vaTracerGlobals & GetGlobals( )
+    {
+        static vaTracerGlobals globals;
+        return globals;
+    }
+
+    void AppendJSONEscaped( string & outStr, const string & str )
+    {
+        for( char c : str )
+        {
+            if( c == '"' || c == '\\' )
+            {
+                outStr += '\\';
+                outStr += c;
+            }
+            else if( (unsigned char)c < 0x20 )
+                outStr += ' ';
+            else
+                outStr += c;
+        }
+    }
+}
+
+uint32 vaTracer::RegisterScope( const char * name )
+{
+    vaTracerGlobals & globals = GetGlobals( );
+    std::unique_lock<mutex> lock( globals.Mutex );
+
+    auto it = globals.ScopeNameToID.find( name );
+    if( it != globals.ScopeNameToID.end( ) )
+        return it->second;
+
+    uint32 scopeID = (uint32)globals.ScopeNames.size( );
+    globals.ScopeNames.push_back( name );
+    globals.ScopeNameToID.insert( std::make_pair( globals.ScopeNames.back( ), scopeID ) );
+    return scopeID;
+}
+
+string vaTracer::GetScopeName( uint32 scopeID )
+{
+    vaTracerGlobals & globals = GetGlobals( );
+    std::unique_lock<mutex> lock( globals.Mutex );
+    if( scopeID >= (uint32)globals.ScopeNames.size( ) )
+        return "";
+    return globals.ScopeNames[scopeID];
+}
+
+void vaTracer::SetCurrentThreadName( const char * name )
+{
+    strncpy_s( s_threadName, name, _TRUNCATE );
+
+    // already have a context? update the name in it too
+    if( s_threadContext != nullptr )
+    {
+        vaTracerGlobals & globals = GetGlobals( );
+        std::unique_lock<mutex> lock( globals.Mutex );
+        s_threadContext->Name = s_threadName;
+    }
+}
+
+vaTracer::ThreadContext * vaTracer::CreateThreadContext( )
+{
+    assert( s_threadContext == nullptr );
+
+    vaTracerGlobals & globals = GetGlobals( );
+    std::unique_lock<mutex> lock( globals.Mutex );
+
+    int threadIndex = globals.NextThreadIndex++;
+    string name = ( s_threadName[0] != 0 ) ? ( string( s_threadName ) ) : ( vaStringTools::Format( "Thread_%d", threadIndex ) );
+
+    shared_ptr<ThreadContext> context;
+    if( !globals.FreeThreadContexts.empty( ) )
+    {
+        context = globals.FreeThreadContexts.back( );
+        globals.FreeThreadContexts.pop_back( );
+        context->ThreadIndex    = threadIndex;
+        context->Name           = name;
+        context->Exited         = false;
+        // whatever is in the ring belongs to the previous owner
+        context->CaptureStartHead = context->Head.load( std::memory_order_relaxed );
+    }
+    else
+        context = std::make_shared<ThreadContext>( threadIndex, name );
+
+    globals.ThreadContexts.push_back( context );
+    s_threadContext = context.get( );
+    s_threadExitHook.Armed = true;  // first use of the hook registers its destructor for this thread
+    return s_threadContext;
+}
+
+vaTracer::ThreadExitHook::~ThreadExitHook( )
+{
+    ThreadContext * context = s_threadContext;
+    if( !Armed || context == nullptr )
+        return;
+    s_threadContext = nullptr;
+
+    vaTracerGlobals & globals = GetGlobals( );
+    std::unique_lock<mutex> lock( globals.Mutex );
+    context->Exited = true;
+
+    // nothing captured since the last StartCapture means nothing to export - can go back to the free list right away
+    if( context->Head.load( std::memory_order_relaxed ) == context->CaptureStartHead )
+    {
+        for( size_t i = 0; i < globals.ThreadContexts.size( ); i++ )
+        {
+            if( globals.ThreadContexts[i].get( ) == context )
+            {
+                globals.FreeThreadContexts.push_back( globals.ThreadContexts[i] );
+                globals.ThreadContexts[i] = globals.ThreadContexts.back( );
+                globals.ThreadContexts.pop_back( );
+                break;
+            }
+        }
+    }
+}
+
+void vaTracer::RecycleExitedThreadContexts( )
+{
+    vaTracerGlobals & globals = GetGlobals( );
+    for( size_t i = 0; i < globals.ThreadContexts.size( ); )
+    {
+        if( globals.ThreadContexts[i]->Exited )
+        {
+            globals.FreeThreadContexts.push_back( globals.ThreadContexts[i] );
+            globals.ThreadContexts[i] = globals.ThreadContexts.back( );
+            globals.ThreadContexts.pop_back( );
+        }
+        else
+            i++;
+    }
+}
+
+void vaTracer::StartCapture( )
+{
+    vaTracerGlobals & globals = GetGlobals( );
+    {
+        std::unique_lock<mutex> lock( globals.Mutex );
+        assert( !s_capturing );
+        if( s_capturing )
+            return;
+
+        // everything written so far belongs to the previous capture, including what exited threads left behind
+        RecycleExitedThreadContexts( );
+        for( auto & context : globals.ThreadContexts )
+            context->CaptureStartHead = context->Head.load( std::memory_order_acquire );
+
+        globals.CaptureStartTime    = std::chrono::steady_clock::now( );
+        globals.CaptureStartTSC     = ReadTimestamp( );
+    }
+    s_capturing.store( true, std::memory_order_release );
+}
+
+void vaTracer::StopCapture( )
+{
+    vaTracerGlobals & globals = GetGlobals( );
+    s_capturing.store( false, std::memory_order_release );
+    {
+        std::unique_lock<mutex> lock( globals.Mutex );
+        globals.CaptureStopTSC      = ReadTimestamp( );
+        globals.CaptureStopTime     = std::chrono::steady_clock::now( );
+    }
+}
+
+bool vaTracer::SaveChromeTrace( const wstring & filePath )
+{
+    assert( !s_capturing );     // see header comment
+
+    vaTracerGlobals & globals = GetGlobals( );
+    std::unique_lock<mutex> lock( globals.Mutex );
+
+    // calibrate TSC frequency against the steady clock over the duration of the capture
+    double captureSeconds   = std::chrono::duration<double>( globals.CaptureStopTime - globals.CaptureStartTime ).count( );
+    uint64 captureTicks     = globals.CaptureStopTSC - globals.CaptureStartTSC;
+    if( captureSeconds <= 0.0 || captureTicks == 0 )
+    {
+        VA_LOG_WARNING( L"vaTracer::SaveChromeTrace - nothing captured" );
+        return false;
+    }
+    double ticksToMicroseconds = captureSeconds * 1000000.0 / (double)captureTicks;
+
+    vaFileStream outFile;
+    if( !outFile.Open( filePath, FileCreationMode::Create ) )
+    {
+        VA_LOG_WARNING( L"vaTracer::SaveChromeTrace - unable to open '%s'", filePath.c_str( ) );
+        return false;
+    }
+
+    string text;
+    text.reserve( 1024 * 1024 );
+    text += "{\"traceEvents\":[\n";
+    bool firstEntry = true;
+    int64 totalEvents = 0;
+
+    for( auto & context : globals.ThreadContexts )
+    {
+        text += vaStringTools::Format( "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"", (firstEntry)?(""):(",\n"), context->ThreadIndex );
+        AppendJSONEscaped( text, context->Name );
+        text += "\"}}";
+        firstEntry = false;
+
+        uint64 head     = context->Head.load( std::memory_order_acquire );
+        uint64 first    = context->CaptureStartHead;
+        if( head - first > (uint64)c_ringBufferSize )
+            first = head - c_ringBufferSize;
+
+        // ring might have wrapped in the middle of a scope so skip any leading 'End' events with no matching 'Begin'
+        int depth = 0;
+        for( uint64 i = first; i < head; i++ )
+        {
+            const Event & event = context->Events[ i & (c_ringBufferSize-1) ];
+            if( event.Type == EventType::End )
+            {
+                if( depth == 0 )
+                    continue;
+                depth--;
+            }
+            else
+                depth++;
+
+            double timestamp = (double)(int64)( event.Timestamp - globals.CaptureStartTSC ) * ticksToMicroseconds;
+            text += ",\n{\"name\":\"";
+            if( event.ScopeID < (uint32)globals.ScopeNames.size( ) )
+                AppendJSONEscaped( text, globals.ScopeNames[event.ScopeID] );
+            text += vaStringTools::Format( "\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}", (event.Type == EventType::Begin)?("B"):("E"), timestamp, context->ThreadIndex );
+            totalEvents++;
+
+            // flush in chunks to avoid building up huge strings
+            if( text.size( ) > 1024 * 1024 - 1024 )
+            {
+                if( !outFile.WriteTXT( text ) )
+                    return false;
+                text.clear( );
+            }
+        }
+    }
+    text += "\n]}\n";
+    if( !outFile.WriteTXT( text ) )
+        return false;
+
+    VA_LOG( L"vaTracer: saved %d events from %d threads to '%s'", (int)totalEvents, (int)globals.ThreadContexts.size( ), filePath.c_str( ) );
+
+    // events of exited threads are exported now, their contexts can be reused
+    RecycleExitedThreadContexts( );
+    return true;
+}
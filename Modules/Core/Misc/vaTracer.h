@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Low overhead CPU trace capture: each thread writes begin/end events into its own ring buffer (single writer, no
+// locks), timestamps come straight from the TSC and scopes are identified by a 32bit ID registered once per call site.
+// Captured data is exported in the Chrome trace event JSON format (open with chrome://tracing or ui.perfetto.dev).
+//
+// Usage:
+//    void Foo( ) { VA_TRACE_SCOPE( Foo ); ... }
+//    vaTracer::StartCapture( ); ... vaTracer::StopCapture( ); vaTracer::SaveChromeTrace( L"trace.json" );
+//
+// When not capturing the cost of a scope is one relaxed atomic load; when capturing it's two TSC reads and two 16 byte
+// writes into the thread's ring buffer. If the ring buffer wraps around, oldest events are lost.
+//
+// Ring buffers of exited threads are kept until their events are exported (SaveChromeTrace) or discarded (the next
+// StartCapture) and then reused by new threads, so short-lived threads don't add up.
+
+#include "Core/vaCore.h"
+#include "Core/vaSTL.h"
+
+#include <intrin.h>
+
+namespace VertexAsylum
+{
+    class vaTracer
+    {
+    public:
+        static const uint32                 c_invalidScopeID        = 0xFFFFFFFF;
+        static const int                    c_ringBufferSizeLog2    = 16;                               // 64k events (1MB) per thread
+        static const int                    c_ringBufferSize        = 1 << c_ringBufferSizeLog2;
+        static const int                    c_maxThreadNameLength   = 64;
+
+        enum class EventType : uint32
+        {
+            Begin,
+            End,
+        };
+
+        struct Event
+        {
+            uint64                          Timestamp;                                                  // raw TSC
+            uint32                          ScopeID;
+            EventType                       Type;
+        };
+
+        struct ThreadContext
+        {
+            int                             ThreadIndex;                                                // changes when the context gets reused by another thread
+            string                          Name;
+            bool                            Exited                  = false;                            // owning thread has exited, events are still waiting for export
+
+            // only written by the owning thread
+            std::atomic<uint64>             Head                    = 0;
+            // only written by the thread calling StartCapture( ); events before this are from a previous capture
+            uint64                          CaptureStartHead        = 0;
+
+            Event                           Events[c_ringBufferSize];
+
+            ThreadContext( int threadIndex, const string & name ) : ThreadIndex( threadIndex ), Name( name ) { }
+            ThreadContext( const ThreadContext & ) = delete;
+            ThreadContext & operator = ( const ThreadContext & ) = delete;
+        };
+
+    private:
+        // only used for its destructor - returns the thread's context on thread exit; kept separate from s_threadContext
+        // so that the per-event access stays a plain TLS pointer read
+        struct ThreadExitHook
+        {
+            bool                            Armed                   = false;
+            ~ThreadExitHook( );
+        };
+
+        static std::atomic_bool             s_capturing;
+        static thread_local ThreadContext * s_threadContext;
+        static thread_local char            s_threadName[c_maxThreadNameLength];
+        static thread_local ThreadExitHook  s_threadExitHook;
+
+    private:
+        vaTracer( )     { }
+        ~vaTracer( )    { }
+
+    public:
+        // Registers a scope name and returns its ID; same name always returns the same ID. Thread safe but takes a lock
+        // so it's meant to be called once per call site (VA_TRACE_SCOPE caches it in a function-local static).
+        static uint32                       RegisterScope( const char * name );
+        static string                       GetScopeName( uint32 scopeID );
+
+        // Name will be used for the thread in the exported trace; only applies to the calling thread.
+        static void                         SetCurrentThreadName( const char * name );
+
+        static void                         StartCapture( );
+        static void                         StopCapture( );
+        static bool                         IsCapturing( )                          { return s_capturing.load( std::memory_order_relaxed ); }
+
+        // Writes everything captured since the last StartCapture( ) to a Chrome trace event format JSON file; call after
+        // StopCapture( ) - if called during capture, events that get overwritten while writing will be garbage.
+        static bool                         SaveChromeTrace( const wstring & filePath );
+
+        static inline void                  BeginScope( uint32 scopeID )            { Emit( scopeID, EventType::Begin ); }
+        static inline void                  EndScope( uint32 scopeID )              { Emit( scopeID, EventType::End ); }
+
+    private:
+        static inline void                  Emit( uint32 scopeID, EventType type );
+        static ThreadContext *              CreateThreadContext( );
+        static void                         RecycleExitedThreadContexts( );      // expects the globals mutex held
+        static inline uint64                ReadTimestamp( )                        { return __rdtsc( ); }
+    };
+
+    // RAII helper used by VA_TRACE_SCOPE; remembers whether Begin was emitted so that StartCapture/StopCapture in the
+    // middle of a scope never produce unbalanced events from this scope.
+    class vaTraceScope
+    {
+        const uint32                        m_scopeID;
+        const bool                          m_active;
+
+    public:
+        explicit vaTraceScope( uint32 scopeID ) : m_scopeID( scopeID ), m_active( scopeID != vaTracer::c_invalidScopeID && vaTracer::IsCapturing( ) )  { if( m_active ) vaTracer::BeginScope( m_scopeID ); }
+        ~vaTraceScope( )                                                                                        { if( m_active ) vaTracer::EndScope( m_scopeID ); }
+
+        vaTraceScope( const vaTraceScope & ) = delete;
+        vaTraceScope & operator = ( const vaTraceScope & ) = delete;
+    };
+
+    inline void vaTracer::Emit( uint32 scopeID, EventType type )
+    {
+        ThreadContext * context = s_threadContext;
+        if( context == nullptr )
+            context = CreateThreadContext( );
+
+        // single writer, so the only synchronization needed is the release on the Head so the exporter sees complete events
+        uint64 head = context->Head.load( std::memory_order_relaxed );
+        Event & event   = context->Events[ head & ( c_ringBufferSize - 1 ) ];
+        event.Timestamp = ReadTimestamp( );
+        event.ScopeID   = scopeID;
+        event.Type      = type;
+        context->Head.store( head + 1, std::memory_order_release );
+    }
+
+}
+
+// 'name' is an identifier (like with VA_SCOPE_CPU_TIMER), for runtime names use vaTracer::RegisterScope + vaTraceScope
+#define VA_TRACE_SCOPE( name )                                                                                                              \
+    static const VertexAsylum::uint32 VA_COMBINE( __va_trace_scope_id_, __LINE__ ) = VertexAsylum::vaTracer::RegisterScope( #name );       \
+    VertexAsylum::vaTraceScope VA_COMBINE( __va_trace_scope_, __LINE__ )( VA_COMBINE( __va_trace_scope_id_, __LINE__ ) )
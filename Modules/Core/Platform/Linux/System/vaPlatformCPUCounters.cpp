@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Core/System/vaCPUCounters.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+using namespace VertexAsylum;
+
+namespace
+{
+    enum CounterIndex
+    {
+        CI_Cycles,
+        CI_Instructions,
+        CI_LLCMisses,
+        CI_BranchMisses,
+        CI_Count
+    };
+
+    struct CounterGroup
+    {
+        int                             FDs[CI_Count]   = { -1, -1, -1, -1 };
+
+        ~CounterGroup( )                { Close( ); }
+
+        bool                            IsOpen( ) const { return FDs[0] != -1; }
+
+        void                            Close( )
+        {
+            for( int i = CI_Count-1; i >= 0; i-- )
+            {
+                if( FDs[i] != -1 )
+                    close( FDs[i] );
+                FDs[i] = -1;
+            }
+        }
+    };
+
+    // counters are opened for the calling thread only (pid = 0, cpu = -1) so each thread needs its own group
+    thread_local CounterGroup s_threadGroup;
+
+    int OpenCounter( uint64 config, int groupFD )
+    {
+        perf_event_attr attr;
+        memset( &attr, 0, sizeof( attr ) );
+        attr.size           = sizeof( attr );
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config;
+        attr.disabled       = ( groupFD == -1 ) ? 1 : 0;     // leader starts disabled, enabled with the whole group below
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall( __NR_perf_event_open, &attr, 0, -1, groupFD, 0 );
+    }
+}
+
+bool vaCPUCounters::IsSupported( )
+{
+    static int s_supported = -1;
+    if( s_supported == -1 )
+    {
+        int fd = OpenCounter( PERF_COUNT_HW_CPU_CYCLES, -1 );
+        s_supported = ( fd != -1 ) ? 1 : 0;
+        if( fd != -1 )
+            close( fd );
+    }
+    return s_supported == 1;
+}
+
+bool vaCPUCounters::IsEventCountingSupported( )
+{
+    return IsSupported( );
+}
+
+bool vaCPUCounters::EnableForCurrentThread( bool enable )
+{
+    CounterGroup & group = s_threadGroup;
+    if( !enable )
+    {
+        group.Close( );
+        return true;
+    }
+    if( group.IsOpen( ) )
+        return true;
+
+    const uint64 configs[CI_Count] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+    for( int i = 0; i < CI_Count; i++ )
+    {
+        group.FDs[i] = OpenCounter( configs[i], ( i == 0 ) ? ( -1 ) : ( group.FDs[0] ) );
+        if( group.FDs[i] == -1 )
+        {
+            VA_WARN( L"vaCPUCounters - perf_event_open failed for counter %d (errno %d); check /proc/sys/kernel/perf_event_paranoid", i, errno );
+            group.Close( );
+            return false;
+        }
+    }
+
+    ioctl( group.FDs[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+    ioctl( group.FDs[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    return true;
+}
+
+bool vaCPUCounters::IsEnabledForCurrentThread( )
+{
+    return s_threadGroup.IsOpen( );
+}
+
+bool vaCPUCounters::Sample( vaCPUCounterValues & outValues )
+{
+    const CounterGroup & group = s_threadGroup;
+    if( !group.IsOpen( ) )
+        return false;
+
+    // PERF_FORMAT_GROUP layout with both TOTAL_TIME flags: { u64 nr; u64 time_enabled; u64 time_running; u64 values[nr]; } - 
+    // one syscall for the whole group
+    uint64 data[3 + CI_Count];
+    if( read( group.FDs[0], data, sizeof( data ) ) != (ssize_t)sizeof( data ) || data[0] != CI_Count )
+        return false;
+
+    // if there are more events than hardware counters the kernel multiplexes groups and they only count while scheduled
+    // in (time_running < time_enabled); scale to the full enabled time as the interface requires (see vaCPUCounters)
+    const uint64 timeEnabled    = data[1];
+    const uint64 timeRunning    = data[2];
+    if( timeRunning == 0 )
+        return false;
+    const double scale          = ( timeRunning < timeEnabled ) ? ( (double)timeEnabled / (double)timeRunning ) : ( 1.0 );
+
+    outValues.Cycles        = (uint64)( data[3 + CI_Cycles]        * scale );
+    outValues.Instructions  = (uint64)( data[3 + CI_Instructions]  * scale );
+    outValues.LLCMisses     = (uint64)( data[3 + CI_LLCMisses]     * scale );
+    outValues.BranchMisses  = (uint64)( data[3 + CI_BranchMisses]  * scale );
+    return true;
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core/System/vaMappedFileStream.h"
+
+#include "Core/vaStringTools.h"
+#include "Core/vaLog.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace VertexAsylum;
+
+bool vaMappedFileStream::PlatformMap( const wstring & filePath, bool writable, uint8 * & outData, int64 & outSize )
+{
+    outData = nullptr;
+    outSize = 0;
+
+    int fd = open( vaStringTools::SimpleNarrow( filePath ).c_str( ), ( writable ) ? ( O_RDWR ) : ( O_RDONLY ) );
+    if( fd == -1 )
+    {
+        VA_LOG( L"vaMappedFileStream::Open( \"%s\" ): unable to open file", filePath.c_str( ) );
+        return false;
+    }
+
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 )
+    {
+        close( fd );
+        return false;
+    }
+
+    // can't map an empty file but that's still a valid (empty) stream
+    if( fileStat.st_size == 0 )
+    {
+        close( fd );
+        return true;
+    }
+
+    void * view = mmap( nullptr, (size_t)fileStat.st_size, ( writable ) ? ( PROT_READ | PROT_WRITE ) : ( PROT_READ ), MAP_SHARED, fd, 0 );
+
+    // the mapping keeps the file alive, no need to hold on to the descriptor
+    close( fd );
+
+    if( view == MAP_FAILED )
+    {
+        VA_LOG( L"vaMappedFileStream::Open( \"%s\" ): mmap failed", filePath.c_str( ) );
+        return false;
+    }
+
+    outData = (uint8 *)view;
+    outSize = (int64)fileStat.st_size;
+    return true;
+}
+//
+void vaMappedFileStream::PlatformUnmap( uint8 * data, int64 size )
+{
+    int ret = munmap( (void *)data, (size_t)size );
+    assert( ret == 0 ); ret;
+}
+//
+// madvise & msync want a page aligned start
+static void PageAlign( uint8 * & data, int64 & size )
+{
+    uintptr_t pageSize  = (uintptr_t)sysconf( _SC_PAGESIZE );
+    uintptr_t offset    = (uintptr_t)data & ( pageSize - 1 );
+    data -= offset;
+    size += offset;
+}
+//
+void vaMappedFileStream::PlatformAdvise( uint8 * data, int64 size, AccessHint hint )
+{
+    int advice = MADV_NORMAL;
+    switch( hint )
+    {
+    case( AccessHint::Sequential ): advice = MADV_SEQUENTIAL;   break;
+    case( AccessHint::Random ):     advice = MADV_RANDOM;       break;
+    case( AccessHint::WillNeed ):   advice = MADV_WILLNEED;     break;
+    default:                        advice = MADV_NORMAL;       break;
+    }
+    PageAlign( data, size );
+    madvise( data, (size_t)size, advice );
+}
+//
+bool vaMappedFileStream::PlatformFlush( uint8 * data, int64 size )
+{
+    PageAlign( data, size );
+    return msync( data, (size_t)size, MS_SYNC ) == 0;
+}
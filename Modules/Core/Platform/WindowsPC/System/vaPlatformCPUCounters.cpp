@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Core/System/vaCPUCounters.h"
+
+using namespace VertexAsylum;
+
+// There's no user mode API for reading PMU event counters on Windows (it needs a kernel driver, like the one that comes
+// with VTune or PCM), so only cycles are available: QueryThreadCycleTime counts the cycles charged to the thread (user
+// and kernel time, at the TSC rate) and, unlike the TSC, excludes the time the thread was switched out.
+
+namespace
+{
+    thread_local bool s_threadEnabled = false;
+}
+
+bool vaCPUCounters::IsSupported( )
+{
+    return true;
+}
+
+bool vaCPUCounters::IsEventCountingSupported( )
+{
+    return false;
+}
+
+bool vaCPUCounters::EnableForCurrentThread( bool enable )
+{
+    s_threadEnabled = enable;
+    return true;
+}
+
+bool vaCPUCounters::IsEnabledForCurrentThread( )
+{
+    return s_threadEnabled;
+}
+
+bool vaCPUCounters::Sample( vaCPUCounterValues & outValues )
+{
+    outValues = vaCPUCounterValues( );
+    if( !s_threadEnabled )
+        return false;
+
+    ULONG64 cycles = 0;
+    if( !QueryThreadCycleTime( GetCurrentThread( ), &cycles ) )
+        return false;
+    outValues.Cycles = cycles;
+    return true;
+}
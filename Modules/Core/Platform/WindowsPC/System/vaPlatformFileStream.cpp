@@ -34,6 +34,8 @@ vaFileStream::vaFileStream( )
 {
     m_file = 0;
     m_accessMode = FileAccessMode::Default;
+    m_concurrentIO = false;
+    m_position = 0;
 }
 vaFileStream::~vaFileStream( void )
 {
@@ -84,6 +86,18 @@ static std::wstring GetLastErrorAsStringW( )
     return message;
 }
 //
+// manual-reset event for waiting on overlapped ReadAt/WriteAt; one per thread, reused for all of its calls
+static HANDLE GetThreadIOEvent( )
+{
+    struct ThreadIOEvent
+    {
+        HANDLE  Event = ::CreateEventW( NULL, TRUE, FALSE, NULL );
+        ~ThreadIOEvent( )   { if( Event != NULL ) ::CloseHandle( Event ); }
+    };
+    static thread_local ThreadIOEvent s_event;
+    return s_event.Event;
+}
+//
 bool vaFileStream::Open( const wchar_t * filePath, FileCreationMode::Enum creationMode, FileAccessMode::Enum accessMode, FileShareMode::Enum shareMode )
 {
     if( IsOpen( ) ) return false;
@@ -145,7 +159,15 @@ bool vaFileStream::Open( const wchar_t * filePath, FileCreationMode::Enum creati
     dwShareMode |= ( ( shareMode & FileShareMode::Delete ) != 0 ) ? ( FILE_SHARE_DELETE ) : ( 0 );
 
 
-    m_file = ::CreateFileW( filePath, dwDesiredAccess, dwShareMode, NULL, dwCreationDisposition, FILE_ATTRIBUTE_NORMAL, NULL );
+    DWORD dwFlagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+    if( m_concurrentIO )
+    {
+        // without FILE_FLAG_OVERLAPPED all I/O on the file object is serialized, even with explicit offsets
+        assert( creationMode != FileCreationMode::Append );
+        dwFlagsAndAttributes |= FILE_FLAG_OVERLAPPED;
+    }
+
+    m_file = ::CreateFileW( filePath, dwDesiredAccess, dwShareMode, NULL, dwCreationDisposition, dwFlagsAndAttributes, NULL );
 
     if( m_file == INVALID_HANDLE_VALUE )
     {
@@ -156,6 +178,7 @@ bool vaFileStream::Open( const wchar_t * filePath, FileCreationMode::Enum creati
     }
 
     m_accessMode = accessMode;
+    m_position = 0;
 
     if( creationMode == FileCreationMode::Append )
     {
@@ -171,10 +194,29 @@ bool vaFileStream::Open( const char * _filePath, FileCreationMode::Enum creation
     return Open( filePath.c_str( ), creationMode, accessMode, shareMode );
 }
 //
+bool vaFileStream::OpenForConcurrentIO( const wstring & filePath, FileCreationMode::Enum creationMode, FileAccessMode::Enum accessMode, FileShareMode::Enum shareMode )
+{
+    if( IsOpen( ) ) return false;
+
+    m_concurrentIO = true;
+    if( !Open( filePath.c_str( ), creationMode, accessMode, shareMode ) )
+    {
+        m_concurrentIO = false;
+        return false;
+    }
+    return true;
+}
+//
 void vaFileStream::Truncate( )
 {
     VA_ASSERT( ( m_accessMode & FileAccessMode::Write ) != 0, L"File not opened for writing" );
 
+    if( m_concurrentIO )
+    {
+        LARGE_INTEGER pos;
+        pos.QuadPart = (LONGLONG)m_position;
+        ::SetFilePointerEx( m_file, pos, NULL, FILE_BEGIN );
+    }
     ::SetEndOfFile( m_file );
 }
 //
@@ -184,6 +226,17 @@ bool vaFileStream::Read( void * buffer, int64 count, int64 * outCountRead )
     VA_ASSERT( ( m_accessMode & FileAccessMode::Read ) != 0, L"File not opened for reading" );
     VA_ASSERT( count < INT_MAX, L"File system current doesn't support reads bigger than INT_MAX" );
 
+    if( m_concurrentIO )
+    {
+        int64 countRead = 0;
+        bool ok = ReadAt( m_position, buffer, count, &countRead );
+        m_position += countRead;
+        if( outCountRead == NULL )
+            return ok && ( countRead == count );
+        *outCountRead = countRead;
+        return ok;
+    }
+
     DWORD dwRead;
     if( !::ReadFile( m_file, buffer, (DWORD)count, &dwRead, NULL ) )
         return false;
@@ -205,6 +258,17 @@ bool vaFileStream::Write( const void * buffer, int64 count, int64 * outCountWrit
     VA_ASSERT( ( m_accessMode & FileAccessMode::Write ) != 0, L"File not opened for writing" );
     VA_ASSERT( count < INT_MAX, L"File system current doesn't support writes bigger than INT_MAX" );
 
+    if( m_concurrentIO )
+    {
+        int64 countWritten = 0;
+        bool ok = WriteAt( m_position, buffer, count, &countWritten );
+        m_position += countWritten;
+        if( outCountWritten == NULL )
+            return ok && ( countWritten == count );
+        *outCountWritten = countWritten;
+        return ok;
+    }
+
     DWORD dwWritten;
     if( !::WriteFile( m_file, buffer, (DWORD)count, &dwWritten, NULL ) )
         return false;
@@ -220,10 +284,88 @@ bool vaFileStream::Write( const void * buffer, int64 count, int64 * outCountWrit
     }
 }
 //
+bool vaFileStream::ReadAt( int64 position, void * buffer, int64 count, int64 * outCountRead )
+{
+    VA_ASSERT( count > 0, L"count parameter must be > 0" );
+    VA_ASSERT( ( m_accessMode & FileAccessMode::Read ) != 0, L"File not opened for reading" );
+    VA_ASSERT( count < INT_MAX, L"File system current doesn't support reads bigger than INT_MAX" );
+    assert( position >= 0 );
+
+    // with a synchronous handle the offset in OVERLAPPED is used as the position (and moves the file pointer) but the OS
+    // serializes the calls; with an overlapped one (OpenForConcurrentIO) they run at once and we just wait for our own
+    OVERLAPPED overlapped = { };
+    overlapped.Offset       = (DWORD)( (uint64)position & 0xFFFFFFFF );
+    overlapped.OffsetHigh   = (DWORD)( (uint64)position >> 32 );
+
+    DWORD dwRead = 0;
+    BOOL ok;
+    if( m_concurrentIO )
+    {
+        overlapped.hEvent = GetThreadIOEvent( );
+        ok = ::ReadFile( m_file, buffer, (DWORD)count, NULL, &overlapped ) || ( ::GetLastError( ) == ERROR_IO_PENDING );
+        ok = ok && ::GetOverlappedResult( m_file, &overlapped, &dwRead, TRUE );
+    }
+    else
+        ok = ::ReadFile( m_file, buffer, (DWORD)count, &dwRead, &overlapped );
+    if( !ok && ::GetLastError( ) != ERROR_HANDLE_EOF )
+        return false;
+
+    if( outCountRead == NULL )
+    {
+        return count == (int)dwRead;
+    }
+    else
+    {
+        *outCountRead = dwRead;
+        return dwRead > 0;
+    }
+}
+//
+bool vaFileStream::WriteAt( int64 position, const void * buffer, int64 count, int64 * outCountWritten )
+{
+    VA_ASSERT( count > 0, L"count parameter must be > 0" );
+    VA_ASSERT( ( m_accessMode & FileAccessMode::Write ) != 0, L"File not opened for writing" );
+    VA_ASSERT( count < INT_MAX, L"File system current doesn't support writes bigger than INT_MAX" );
+    assert( position >= 0 );
+
+    OVERLAPPED overlapped = { };
+    overlapped.Offset       = (DWORD)( (uint64)position & 0xFFFFFFFF );
+    overlapped.OffsetHigh   = (DWORD)( (uint64)position >> 32 );
+
+    DWORD dwWritten = 0;
+    BOOL ok;
+    if( m_concurrentIO )
+    {
+        overlapped.hEvent = GetThreadIOEvent( );
+        ok = ::WriteFile( m_file, buffer, (DWORD)count, NULL, &overlapped ) || ( ::GetLastError( ) == ERROR_IO_PENDING );
+        ok = ok && ::GetOverlappedResult( m_file, &overlapped, &dwWritten, TRUE );
+    }
+    else
+        ok = ::WriteFile( m_file, buffer, (DWORD)count, &dwWritten, &overlapped );
+    if( !ok )
+        return false;
+
+    if( outCountWritten == NULL )
+    {
+        return (int)dwWritten == count;
+    }
+    else
+    {
+        *outCountWritten = dwWritten;
+        return dwWritten > 0;
+    }
+}
+//
 void vaFileStream::Seek( int64 position )
 {
     assert( position >= 0 );
 
+    if( m_concurrentIO )
+    {
+        m_position = position;
+        return;
+    }
+
     LARGE_INTEGER pos;
     pos.QuadPart = (LONGLONG)position;
     LARGE_INTEGER outPos;
@@ -241,6 +383,8 @@ void vaFileStream::Close( )
     }
     m_file = NULL;
     m_accessMode = FileAccessMode::Default;
+    m_concurrentIO = false;
+    m_position = 0;
 }
 //
 bool vaFileStream::IsOpen( ) const
@@ -258,6 +402,9 @@ int64 vaFileStream::GetLength( )
 //
 int64 vaFileStream::GetPosition( ) const
 {
+    if( m_concurrentIO )
+        return m_position;
+
     LARGE_INTEGER pos;
     pos.QuadPart = 0;
     LARGE_INTEGER outPos;
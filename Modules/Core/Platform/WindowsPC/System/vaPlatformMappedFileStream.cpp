@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core/System/vaMappedFileStream.h"
+
+#include "Core/vaLog.h"
+
+using namespace VertexAsylum;
+
+bool vaMappedFileStream::PlatformMap( const wstring & filePath, bool writable, uint8 * & outData, int64 & outSize )
+{
+    outData = nullptr;
+    outSize = 0;
+
+    DWORD access    = ( writable ) ? ( GENERIC_READ | GENERIC_WRITE ) : ( GENERIC_READ );
+    DWORD share     = ( writable ) ? ( 0 ) : ( FILE_SHARE_READ );
+    HANDLE file = ::CreateFileW( filePath.c_str( ), access, share, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE )
+    {
+        VA_LOG( L"vaMappedFileStream::Open( \"%s\" ): unable to open file", filePath.c_str( ) );
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if( !::GetFileSizeEx( file, &fileSize ) )
+    {
+        ::CloseHandle( file );
+        return false;
+    }
+
+    // can't map an empty file but that's still a valid (empty) stream
+    if( fileSize.QuadPart == 0 )
+    {
+        ::CloseHandle( file );
+        return true;
+    }
+
+    HANDLE mapping = ::CreateFileMappingW( file, NULL, ( writable ) ? ( PAGE_READWRITE ) : ( PAGE_READONLY ), 0, 0, NULL );
+    if( mapping == NULL )
+    {
+        VA_LOG( L"vaMappedFileStream::Open( \"%s\" ): CreateFileMapping failed", filePath.c_str( ) );
+        ::CloseHandle( file );
+        return false;
+    }
+
+    void * view = ::MapViewOfFile( mapping, ( writable ) ? ( FILE_MAP_READ | FILE_MAP_WRITE ) : ( FILE_MAP_READ ), 0, 0, 0 );
+
+    // the view keeps the mapping (and the file) alive, no need to hold on to the handles
+    ::CloseHandle( mapping );
+    ::CloseHandle( file );
+
+    if( view == nullptr )
+    {
+        VA_LOG( L"vaMappedFileStream::Open( \"%s\" ): MapViewOfFile failed", filePath.c_str( ) );
+        return false;
+    }
+
+    outData = (uint8 *)view;
+    outSize = (int64)fileSize.QuadPart;
+    return true;
+}
+//
+void vaMappedFileStream::PlatformUnmap( uint8 * data, int64 size )
+{
+    size;
+    BOOL ok = ::UnmapViewOfFile( data );
+    assert( ok ); ok;
+}
+//
+void vaMappedFileStream::PlatformAdvise( uint8 * data, int64 size, AccessHint hint )
+{
+    // mapped views have no read-ahead policy to change; only WillNeed (PrefetchVirtualMemory, Windows 8+) does anything
+    if( hint != AccessHint::WillNeed )
+        return;
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress    = data;
+    range.NumberOfBytes     = (SIZE_T)size;
+    ::PrefetchVirtualMemory( ::GetCurrentProcess( ), 1, &range, 0 );
+}
+//
+bool vaMappedFileStream::PlatformFlush( uint8 * data, int64 size )
+{
+    // starts writing the dirty pages; the file handle isn't kept around so there's no FlushFileBuffers to wait on
+    return ::FlushViewOfFile( data, (SIZE_T)size ) != 0;
+}
@@ -364,6 +364,7 @@ void vaApplicationWin::Run( )
     while( !m_shouldQuit )
     {
         vaProfiler::GetInstance().NewFrame( );
+        vaMemory::NewFrame( );
 
         VA_SCOPE_CPU_TIMER( RootLoop );
 
@@ -915,8 +916,22 @@ vector<pair<string, string>> vaApplicationWin::EnumerateGraphicsAPIsAndAdapters(
     return ret;
 }
 
-void vaApplicationWin::Run( const vaApplicationWin::Settings & settings, std::function< void( vaApplicationBase & application, bool starting ) > startStopCallback )
+int vaApplicationWin::Run( const vaApplicationWin::Settings & settings, std::function< void( vaApplicationBase & application, bool starting ) > startStopCallback )
 {
+    // "-verifyapack <pack name or *>" just verifies the .apack file(s) and exits (no window or device), for use from scripts; results go to log.txt
+    // "-verifyapacksonload" verifies all payloads of each pack when it gets loaded (see vaAssetPackManager::SetVerifyPacksOnLoad)
+    bool verifyPacksOnLoad = false;
+    for( const auto & param : vaStringTools::SplitCmdLineParams( settings.CmdLine ) )
+    {
+        wstring paramName = vaStringTools::ToLower( param.first );
+        if( paramName == L"verifyapacksonload" )
+            verifyPacksOnLoad = true;
+        if( paramName != L"verifyapack" )
+            continue;
+        string nameOrWildcard = vaStringTools::SimpleNarrow( param.second );
+        return vaAssetPackManager::VerifyPacks( ( nameOrWildcard == "" ) ? ( "*" ) : ( nameOrWildcard ) ) ? ( 0 ) : ( 1 );
+    }
+
     do
     {
         {
@@ -931,10 +946,13 @@ void vaApplicationWin::Run( const vaApplicationWin::Settings & settings, std::fu
             else
             {
                 assert( false );
-                return;
+                return 1;
             }
             //////////////////////////////////////////////////////////////////////////
 
+            if( verifyPacksOnLoad )
+                renderDevice->GetAssetPackManager( ).SetVerifyPacksOnLoad( true );
+
             shared_ptr<vaApplicationWin> application = std::shared_ptr<vaApplicationWin>( new vaApplicationWin( settings, renderDevice ) );
 
             startStopCallback( *application, true );
@@ -945,7 +963,7 @@ void vaApplicationWin::Run( const vaApplicationWin::Settings & settings, std::fu
         }
 
         if( !vaCore::GetAppQuitButRestartingFlag() )
-            return;
+            return 0;
         else
         {
             vaCore::Deinitialize( true );
@@ -119,8 +119,9 @@ namespace VertexAsylum
         bool                                UpdateUserWindowChanges( );
 
     public:
-        // this creates the render device, application and calls initialize and shutdown callbacks - just an example of use, one can do everything manually instead
-        static void                         Run( const vaApplicationWin::Settings & settings, std::function< void( vaApplicationBase & application, bool starting ) > startStopCallback );
+        // this creates the render device, application and calls initialize and shutdown callbacks - just an example of use, one can do everything manually instead;
+        // returns the process exit code (non-zero if '-verifyapack <pack name or *>' was given on the command line and verification failed)
+        static int                          Run( const vaApplicationWin::Settings & settings, std::function< void( vaApplicationBase & application, bool starting ) > startStopCallback );
 
         static vector<pair<string, string>> EnumerateGraphicsAPIsAndAdapters( );
 
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Core\vaCoreIncludes.h"
+
+#include "vaBufferedStream.h"
+
+using namespace VertexAsylum;
+
+vaBufferedStream::vaBufferedStream( shared_ptr<vaStream> innerStream, int64 bufferSize )
+    : m_innerStream( innerStream ), m_innerStreamNakedPtr( nullptr ), m_bufferSize( bufferSize ), m_bufferPos( 0 ), m_bufferFill( 0 ), m_mode( Mode::None )
+{
+    assert( bufferSize > 0 && bufferSize < INT_MAX );
+    m_buffer = new uint8[(size_t)m_bufferSize];
+}
+//
+vaBufferedStream::vaBufferedStream( vaStream * innerStreamNakedPtr, int64 bufferSize )
+    : m_innerStream( nullptr ), m_innerStreamNakedPtr( innerStreamNakedPtr ), m_bufferSize( bufferSize ), m_bufferPos( 0 ), m_bufferFill( 0 ), m_mode( Mode::None )
+{
+    assert( bufferSize > 0 && bufferSize < INT_MAX );
+    m_buffer = new uint8[(size_t)m_bufferSize];
+}
+//
+vaBufferedStream::~vaBufferedStream( void )
+{
+    Close( );
+    delete[] m_buffer;
+}
+//
+void vaBufferedStream::Close( )
+{
+    if( !IsOpen( ) )
+        return;
+
+    bool allOk = Flush( );
+    assert( allOk ); allOk;
+
+    m_innerStream           = nullptr;
+    m_innerStreamNakedPtr   = nullptr;
+}
+//
+bool vaBufferedStream::Flush( )
+{
+    if( !IsOpen( ) )
+        return false;
+
+    bool allOk = true;
+    if( m_mode == Mode::Writing )
+    {
+        if( m_bufferPos > 0 )
+            allOk = GetInnerStream( )->Write( m_buffer, m_bufferPos );
+    }
+    else if( m_mode == Mode::Reading )
+    {
+        int64 readAhead = m_bufferFill - m_bufferPos;
+        if( readAhead > 0 )
+        {
+            // give back what was read ahead but not consumed; on non-seekable streams it's just dropped
+            if( GetInnerStream( )->CanSeek( ) )
+                GetInnerStream( )->Seek( GetInnerStream( )->GetPosition( ) - readAhead );
+        }
+    }
+    m_bufferPos     = 0;
+    m_bufferFill    = 0;
+    m_mode          = Mode::None;
+    return allOk;
+}
+//
+int64 vaBufferedStream::GetPosition( ) const
+{
+    if( !IsOpen( ) )
+        return -1;
+    int64 innerPos = GetInnerStream( )->GetPosition( );
+    if( m_mode == Mode::Writing )
+        return innerPos + m_bufferPos;
+    if( m_mode == Mode::Reading )
+        return innerPos - ( m_bufferFill - m_bufferPos );
+    return innerPos;
+}
+//
+int64 vaBufferedStream::GetLength( )
+{
+    if( !IsOpen( ) )
+        return -1;
+    // pending writes might extend the stream
+    return vaMath::Max( GetInnerStream( )->GetLength( ), GetPosition( ) );
+}
+//
+void vaBufferedStream::Seek( int64 position )
+{
+    assert( CanSeek( ) );
+    if( !CanSeek( ) )
+        return;
+
+    // seeking within what's already buffered for reading is free
+    if( m_mode == Mode::Reading )
+    {
+        int64 bufferStart = GetInnerStream( )->GetPosition( ) - m_bufferFill;
+        if( position >= bufferStart && position <= bufferStart + m_bufferFill )
+        {
+            m_bufferPos = position - bufferStart;
+            return;
+        }
+    }
+
+    bool allOk = Flush( );
+    assert( allOk ); allOk;
+    GetInnerStream( )->Seek( position );
+}
+//
+void vaBufferedStream::Truncate( )
+{
+    if( !IsOpen( ) )
+        return;
+    bool allOk = Flush( );
+    assert( allOk ); allOk;
+    GetInnerStream( )->Truncate( );
+}
+//
+bool vaBufferedStream::Read( void * buffer, int64 count, int64 * outCountRead )
+{
+    if( outCountRead != nullptr )
+        *outCountRead = 0;
+
+    assert( CanRead( ) );
+    if( !CanRead( ) )
+        return false;
+
+    if( m_mode == Mode::Writing )
+    {
+        if( !Flush( ) )
+            return false;
+    }
+    m_mode = Mode::Reading;
+
+    uint8 * dst         = (uint8 *)buffer;
+    int64 totalRead     = 0;
+
+    // first serve whatever we have
+    int64 fromBuffer = vaMath::Min( count, m_bufferFill - m_bufferPos );
+    if( fromBuffer > 0 )
+    {
+        memcpy( dst, m_buffer + m_bufferPos, (size_t)fromBuffer );
+        m_bufferPos += fromBuffer;
+        totalRead   += fromBuffer;
+    }
+
+    int64 remaining = count - totalRead;
+    if( remaining > 0 )
+    {
+        assert( m_bufferPos == m_bufferFill );
+        m_bufferPos     = 0;
+        m_bufferFill    = 0;
+
+        if( remaining >= m_bufferSize )
+        {
+            // big read - no point in going through the buffer
+            int64 innerRead = 0;
+            GetInnerStream( )->Read( dst + totalRead, remaining, &innerRead );
+            totalRead += innerRead;
+        }
+        else
+        {
+            int64 innerRead = 0;
+            GetInnerStream( )->Read( m_buffer, m_bufferSize, &innerRead );      // will usually 'fail' at the end of the stream, that's fine
+            m_bufferFill = innerRead;
+
+            int64 fromRefill = vaMath::Min( remaining, m_bufferFill );
+            if( fromRefill > 0 )
+            {
+                memcpy( dst + totalRead, m_buffer, (size_t)fromRefill );
+                m_bufferPos  = fromRefill;
+                totalRead   += fromRefill;
+            }
+        }
+    }
+
+    if( outCountRead != nullptr )
+        *outCountRead = totalRead;
+    return totalRead == count;
+}
+//
+bool vaBufferedStream::Write( const void * buffer, int64 count, int64 * outCountWritten )
+{
+    if( outCountWritten != nullptr )
+        *outCountWritten = 0;
+
+    assert( CanWrite( ) );
+    if( !CanWrite( ) )
+        return false;
+
+    if( m_mode == Mode::Reading )
+    {
+        if( !Flush( ) )
+            return false;
+    }
+    m_mode = Mode::Writing;
+
+    // doesn't fit? write out what we have first
+    if( m_bufferPos + count > m_bufferSize && m_bufferPos > 0 )
+    {
+        if( !GetInnerStream( )->Write( m_buffer, m_bufferPos ) )
+            return false;
+        m_bufferPos = 0;
+    }
+
+    if( count >= m_bufferSize )
+    {
+        // big write - no point in going through the buffer
+        return GetInnerStream( )->Write( buffer, count, outCountWritten );
+    }
+
+    memcpy( m_buffer + m_bufferPos, buffer, (size_t)count );
+    m_bufferPos += count;
+    if( outCountWritten != nullptr )
+        *outCountWritten = count;
+    return true;
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include "vaStream.h"
+
+namespace VertexAsylum
+{
+    // Buffering decorator around another stream: batches the many small ReadValue/WriteValue/ReadString calls typical
+    // for serialization code into few big Read/Write calls on the inner stream (which might be a file, where every call
+    // is a kernel transition, or a vaCompressionStream where every call goes through zlib). Reads or writes bigger than
+    // the buffer bypass it.
+    // Close( ) (also called on destruction) flushes pending writes and, if the inner stream can seek, moves it back to
+    // the logical position of this stream (read-ahead is otherwise lost); it does not close the inner stream.
+    class vaBufferedStream : public vaStream
+    {
+    public:
+        static const int64      c_defaultBufferSize     = 64 * 1024;
+
+    private:
+        enum class Mode
+        {
+            None,
+            Reading,
+            Writing,
+        };
+
+        shared_ptr<vaStream>    m_innerStream;
+        vaStream *              m_innerStreamNakedPtr;
+
+        uint8 *                 m_buffer;
+        const int64             m_bufferSize;
+        int64                   m_bufferPos;                // read or write cursor in m_buffer
+        int64                   m_bufferFill;               // when reading, number of valid bytes in m_buffer
+        Mode                    m_mode;
+
+    public:
+        vaBufferedStream( shared_ptr<vaStream> innerStream, int64 bufferSize = c_defaultBufferSize );
+        vaBufferedStream( vaStream * innerStreamNakedPtr, int64 bufferSize = c_defaultBufferSize );     // same as above except no smart pointer
+        virtual ~vaBufferedStream( void );
+
+        virtual bool            CanSeek( ) override                 { return IsOpen() && GetInnerStream( )->CanSeek( ); }
+        virtual void            Seek( int64 position ) override;
+        virtual void            Close( ) override;
+        virtual bool            IsOpen( ) const override            { return GetInnerStream() != nullptr; }
+        virtual int64           GetLength( ) override;
+        virtual int64           GetPosition( ) const override;
+        virtual void            Truncate( ) override;
+
+        virtual bool            CanRead( ) const override           { return IsOpen() && GetInnerStream( )->CanRead( ); }
+        virtual bool            CanWrite( ) const override          { return IsOpen() && GetInnerStream( )->CanWrite( ); }
+
+        virtual bool            Read( void * buffer, int64 count, int64 * outCountRead = NULL ) override;
+        virtual bool            Write( const void * buffer, int64 count, int64 * outCountWritten = NULL ) override;
+
+        // Writes out anything pending and drops read-ahead (see Close( ))
+        bool                    Flush( );
+
+    private:
+        vaStream *              GetInnerStream( ) const             { return (m_innerStream!=nullptr)?(m_innerStream.get()):(m_innerStreamNakedPtr); }
+    };
+
+}
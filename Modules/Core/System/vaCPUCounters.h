@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+namespace VertexAsylum
+{
+    // Raw hardware performance counter values; only meaningful as a difference between two samples taken on the same thread.
+    struct vaCPUCounterValues
+    {
+        uint64                          Cycles          = 0;
+        uint64                          Instructions    = 0;
+        uint64                          LLCMisses       = 0;        // last level cache misses
+        uint64                          BranchMisses    = 0;
+
+        vaCPUCounterValues              operator - ( const vaCPUCounterValues & other ) const   { vaCPUCounterValues ret; ret.Cycles = Cycles - other.Cycles; ret.Instructions = Instructions - other.Instructions; ret.LLCMisses = LLCMisses - other.LLCMisses; ret.BranchMisses = BranchMisses - other.BranchMisses; return ret; }
+        vaCPUCounterValues &            operator += ( const vaCPUCounterValues & other )        { Cycles += other.Cycles; Instructions += other.Instructions; LLCMisses += other.LLCMisses; BranchMisses += other.BranchMisses; return *this; }
+
+        // instructions per cycle
+        double                          GetIPC( ) const                     { return ( Cycles > 0 ) ? ( (double)Instructions / (double)Cycles ) : ( 0.0 ); }
+        // misses per 1000 instructions
+        double                          GetLLCMissesPerKI( ) const          { return ( Instructions > 0 ) ? ( (double)LLCMisses * 1000.0 / (double)Instructions ) : ( 0.0 ); }
+        double                          GetBranchMissesPerKI( ) const       { return ( Instructions > 0 ) ? ( (double)BranchMisses * 1000.0 / (double)Instructions ) : ( 0.0 ); }
+    };
+
+    // Per-thread hardware performance counter group (cycles, instructions, LLC misses, branch misses). Optional: on platforms
+    // (or under permissions) where it's not available IsSupported( ) returns false and Sample( ) fails.
+    //  - Windows: cycles only (QueryThreadCycleTime); event counters require a kernel driver for PMU access
+    //  - Linux: all four as a perf_event_open group (subject to /proc/sys/kernel/perf_event_paranoid)
+    // A backend whose counters can get multiplexed by the OS must return counts scaled to the full enabled time, otherwise
+    // the ratios between them are meaningless.
+    class vaCPUCounters
+    {
+    private:
+        vaCPUCounters( )  { }
+        ~vaCPUCounters( ) { }
+
+    public:
+        static bool                     IsSupported( );
+        // Instructions, LLCMisses and BranchMisses are only valid if this is true; Cycles are valid if IsSupported( )
+        static bool                     IsEventCountingSupported( );
+
+        // Opens (or closes) the counter group for the calling thread; returns false if it could not be opened.
+        static bool                     EnableForCurrentThread( bool enable );
+        static bool                     IsEnabledForCurrentThread( );
+
+        // Reads current values of the calling thread's counter group; returns false if not enabled or on error.
+        static bool                     Sample( vaCPUCounterValues & outValues );
+    };
+
+}
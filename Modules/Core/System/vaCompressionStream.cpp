@@ -23,6 +23,12 @@
 
 #include "IntegratedExternals/vaZlibIntegration.h"
 
+#include "Core/System/vaThreading.h"
+#include "Core/Misc/vaLZCodec.h"
+#include "Core/Misc/vaXXHash.h"
+
+#include <thread>
+
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -52,61 +58,196 @@ namespace VertexAsylum
             workingBuffer[0]= 0;
         }
     };
+
+    struct vaCompressionStreamChunkedContext
+    {
+        struct IndexEntry
+        {
+            uint64          Offset;                 // of the chunk's size prefix, relative to the start of the compression stream header
+            uint32          CompressedSize;
+            uint32          UncompressedSize;
+        };
+
+        uint32              ChunkSize;
+        bool                UseLZCodec;             // Profile::Fast; zlib otherwise
+        bool                Checksums;              // each chunk's size prefix is followed by the xxHash64 of its compressed data
+        int                 BatchChunkCount;        // number of chunks (de)compressed in parallel
+        int64               StreamStart;            // inner stream position of the header (0 if inner stream can't seek)
+        int64               InnerBytes;             // bytes read from/written to the inner stream since StreamStart
+        int64               IndexOffset;            // relative to StreamStart; 0 if unknown (index not seekable)
+        int64               UncompressedPosition;
+
+        // uncompressed data of the current batch: when compressing, waiting to be compressed; when decompressing,
+        // waiting to be read; grows with use up to ChunkSize * BatchChunkCount so small streams stay small
+        vector<uint8>       Batch;
+        int64               BatchSize;
+        int64               BatchPos;
+        bool                ReachedEnd;
+
+        vector<vector<uint8>>
+                            CompressedChunks;
+        vector<uint32>      ChunkUncompressedSizes;
+        vector<uint64>      ChunkChecksums;
+        vector<int64>       ChunkOffsets;           // when decompressing, for error reporting only
+
+        // built while compressing; loaded on first Seek/GetLength when decompressing
+        vector<IndexEntry>  Index;
+        bool                IndexLoaded;
+        int64               TotalUncompressedSize;
+
+        vaCompressionStreamChunkedContext( uint32 chunkSize, bool useLZCodec, bool checksums, int64 streamStart ) : ChunkSize( chunkSize ), UseLZCodec( useLZCodec ), Checksums( checksums ), StreamStart( streamStart ), InnerBytes( 0 ), IndexOffset( 0 ), UncompressedPosition( 0 ), BatchSize( 0 ), BatchPos( 0 ), ReachedEnd( false ), IndexLoaded( false ), TotalUncompressedSize( 0 )
+        {
+            BatchChunkCount = vaMath::Max( 2, (int)std::thread::hardware_concurrency( ) ) * 2;
+            CompressedChunks.resize( BatchChunkCount );
+            ChunkUncompressedSizes.resize( BatchChunkCount );
+            ChunkChecksums.resize( BatchChunkCount );
+            ChunkOffsets.resize( BatchChunkCount );
+        }
+
+        int64               GetMaxBatchBytes( ) const   { return (int64)ChunkSize * BatchChunkCount; }
+    };
+}
+//
+namespace
+{
+    // largest valid compressed size of a chunk - anything above it is corrupted data and must not be allocated for
+    uint32 GetMaxCompressedChunkSize( bool useLZCodec, uint32 uncompressedSize )
+    {
+        if( useLZCodec )
+            return (uint32)vaLZCodec::GetMaxCompressedSize( uncompressedSize );
+        return (uint32)compressBound( uncompressedSize );      // same as deflateBound( ) for the default deflateInit( ) settings
+    }
+
+    bool CompressChunk( bool useLZCodec, const uint8 * src, uint32 srcSize, vector<uint8> & outCompressed )
+    {
+        if( useLZCodec )
+        {
+            outCompressed.resize( (size_t)vaLZCodec::GetMaxCompressedSize( srcSize ) );
+            int64 compressedSize = vaLZCodec::Compress( src, srcSize, outCompressed.data( ), (int64)outCompressed.size( ) );
+            if( compressedSize <= 0 )
+                return false;
+            outCompressed.resize( (size_t)compressedSize );
+            return true;
+        }
+
+        z_stream strm;
+        memset( &strm, 0, sizeof( strm ) );
+        if( deflateInit( &strm, Z_DEFAULT_COMPRESSION ) != Z_OK )
+            return false;
+
+        outCompressed.resize( deflateBound( &strm, srcSize ) );
+        strm.next_in    = (z_const Bytef *)src;
+        strm.avail_in   = srcSize;
+        strm.next_out   = outCompressed.data( );
+        strm.avail_out  = (uInt)outCompressed.size( );
+        int ret = deflate( &strm, Z_FINISH );
+        outCompressed.resize( strm.total_out );
+        deflateEnd( &strm );
+        return ret == Z_STREAM_END;
+    }
+
+    bool DecompressChunk( bool useLZCodec, const vector<uint8> & compressed, uint8 * dst, uint32 dstSize )
+    {
+        if( useLZCodec )
+            return vaLZCodec::Decompress( compressed.data( ), (int64)compressed.size( ), dst, dstSize );
+
+        z_stream strm;
+        memset( &strm, 0, sizeof( strm ) );
+        if( inflateInit( &strm ) != Z_OK )
+            return false;
+
+        strm.next_in    = (z_const Bytef *)compressed.data( );
+        strm.avail_in   = (uInt)compressed.size( );
+        strm.next_out   = dst;
+        strm.avail_out  = dstSize;
+        int ret = inflate( &strm, Z_FINISH );
+        bool allOk = ( ret == Z_STREAM_END ) && ( strm.total_out == dstSize );
+        inflateEnd( &strm );
+        return allOk;
+    }
 }
 //
 vaCompressionStream::vaCompressionStream( bool decompressing, shared_ptr<vaStream> inoutStream, Profile profile )
-    : m_decompressing( decompressing ), m_compressedStream( inoutStream ), m_compressedStreamNakedPtr(nullptr), m_compressionProfile( profile ), m_workingContext( nullptr )
+    : m_decompressing( decompressing ), m_compressedStream( inoutStream ), m_compressedStreamNakedPtr(nullptr), m_compressionProfile( profile ), m_workingContext( nullptr ), m_chunkedContext( nullptr )
 {
     Initialize( decompressing );
 }
 //
 vaCompressionStream::vaCompressionStream( bool decompressing, vaStream * inoutStream, Profile profile )
-    : m_decompressing( decompressing ), m_compressedStream( nullptr ), m_compressedStreamNakedPtr(inoutStream), m_compressionProfile( profile ), m_workingContext( nullptr )
+    : m_decompressing( decompressing ), m_compressedStream( nullptr ), m_compressedStreamNakedPtr(inoutStream), m_compressionProfile( profile ), m_workingContext( nullptr ), m_chunkedContext( nullptr )
 {
     Initialize( decompressing );
 }
 //
 void vaCompressionStream::Initialize( bool decompressing )
 {
-    m_workingContext = new vaCompressionStreamWorkingContext( );
-
-    // just to make sure we're actually reading/writing an underlying vaCompressionStream
-    const uint32 c_magicHeader = 0x37EB769C;
+    // just to make sure we're actually reading/writing an underlying vaCompressionStream; chunked profiles used to be
+    // written with the first one, which has no per-chunk checksums
+    const uint32 c_magicHeader              = 0x37EB769C;
+    const uint32 c_magicHeaderChecksummed   = 0x37EB769D;
 
     uint32 magicHeader = 0;
 
-    // nothing else supported
-    assert( m_compressionProfile == vaCompressionStream::Profile::Default );
+    int64 streamStart = ( GetInnerStream( )->CanSeek( ) ) ? ( GetInnerStream( )->GetPosition( ) ) : ( 0 );
 
     int ret;
 
     if( decompressing )
     {
         bool allOk = true;
-        uint32 dummy0; // to expand with something
-        uint64 dummy1; // to expand with something else (possibly packed file size?)
+        uint32 chunkSize;   // unused with Profile::Default
+        uint64 indexOffset; // unused with Profile::Default
         allOk &= GetInnerStream( )->ReadValue<uint32>( magicHeader );
         allOk &= GetInnerStream( )->ReadValue<uint32>( (uint32&)m_compressionProfile );
-        allOk &= GetInnerStream( )->ReadValue<uint32>( dummy0 );
-        allOk &= GetInnerStream( )->ReadValue<uint64>( dummy1 );
-        allOk &= magicHeader == c_magicHeader;
-        allOk &= m_compressionProfile == vaCompressionStream::Profile::Default;
+        allOk &= GetInnerStream( )->ReadValue<uint32>( chunkSize );
+        allOk &= GetInnerStream( )->ReadValue<uint64>( indexOffset );
+        allOk &= m_compressionProfile == vaCompressionStream::Profile::Default || m_compressionProfile == vaCompressionStream::Profile::Chunked || m_compressionProfile == vaCompressionStream::Profile::Fast;
 
-        if( allOk )
+        bool chunked = m_compressionProfile == vaCompressionStream::Profile::Chunked || m_compressionProfile == vaCompressionStream::Profile::Fast;
+        allOk &= magicHeader == c_magicHeader || ( chunked && magicHeader == c_magicHeaderChecksummed );
+        if( allOk && chunked )
+        {
+            allOk &= chunkSize > 0 && chunkSize <= c_maxChunkSize;
+            if( allOk )
+            {
+                m_chunkedContext = new vaCompressionStreamChunkedContext( chunkSize, m_compressionProfile == vaCompressionStream::Profile::Fast, magicHeader == c_magicHeaderChecksummed, streamStart );
+                m_chunkedContext->InnerBytes    = 20;
+                m_chunkedContext->IndexOffset   = (int64)indexOffset;
+            }
+            ret = ( allOk ) ? ( Z_OK ) : ( Z_DATA_ERROR );
+        }
+        else if( allOk )
+        {
+            m_workingContext = new vaCompressionStreamWorkingContext( );
             ret = inflateInit( &m_workingContext->strm );
+        }
         else
             ret = Z_DATA_ERROR;
     }
     else
     {
+        // nothing else supported
+        assert( m_compressionProfile == vaCompressionStream::Profile::Default || m_compressionProfile == vaCompressionStream::Profile::Chunked || m_compressionProfile == vaCompressionStream::Profile::Fast );
+
+        bool chunked = m_compressionProfile == vaCompressionStream::Profile::Chunked || m_compressionProfile == vaCompressionStream::Profile::Fast;
+
         bool allOk = true;
-        allOk &= GetInnerStream( )->WriteValue<uint32>( c_magicHeader );
+        allOk &= GetInnerStream( )->WriteValue<uint32>( (chunked)?(c_magicHeaderChecksummed):(c_magicHeader) );
         allOk &= GetInnerStream( )->WriteValue<uint32>( (uint32)m_compressionProfile );
-        allOk &= GetInnerStream( )->WriteValue<uint32>( 0 );
-        allOk &= GetInnerStream( )->WriteValue<uint64>( 0 );
+        allOk &= GetInnerStream( )->WriteValue<uint32>( (chunked)?(c_defaultChunkSize):(0) );
+        allOk &= GetInnerStream( )->WriteValue<uint64>( 0 );                  // Chunked: index offset, patched on Close( ) if the inner stream can seek
 
-        if( allOk )
+        if( allOk && chunked )
+        {
+            m_chunkedContext = new vaCompressionStreamChunkedContext( c_defaultChunkSize, m_compressionProfile == vaCompressionStream::Profile::Fast, true, streamStart );
+            m_chunkedContext->InnerBytes = 20;
+            ret = Z_OK;
+        }
+        else if( allOk )
+        {
+            m_workingContext = new vaCompressionStreamWorkingContext( );
             ret = deflateInit( &m_workingContext->strm, Z_DEFAULT_COMPRESSION );
+        }
         else
             ret = Z_DATA_ERROR;
     }
@@ -127,6 +268,12 @@ vaCompressionStream::~vaCompressionStream(void)
 //
 void vaCompressionStream::Close( )
 {
+    if( m_chunkedContext != nullptr )
+    {
+        CloseChunked( );
+        return;
+    }
+
     if( !IsOpen() )
         return;
 
@@ -159,6 +306,9 @@ void vaCompressionStream::Close( )
 //
 bool vaCompressionStream::Read( void * buffer, int64 count, int64 * outCountRead )
 { 
+    if( m_chunkedContext != nullptr )
+        return ReadChunked( buffer, count, outCountRead );
+
     if( !m_decompressing || !IsOpen() )
     {
         if( outCountRead != nullptr )
@@ -256,6 +406,9 @@ bool vaCompressionStream::Read( void * buffer, int64 count, int64 * outCountRead
 }
 bool vaCompressionStream::Write( const void * buffer, int64 count, int64 * outCountWritten )
 { 
+    if( m_chunkedContext != nullptr )
+        return WriteChunked( buffer, count, outCountWritten );
+
     if( m_decompressing || !IsOpen())
     {
         assert( false );
@@ -324,6 +477,350 @@ bool vaCompressionStream::Write( const void * buffer, int64 count, int64 * outCo
     return true; 
 }
 //
+bool vaCompressionStream::CanSeek( )
+{
+    if( m_chunkedContext == nullptr || !m_decompressing || !IsOpen( ) )
+        return false;
+    return m_chunkedContext->IndexOffset != 0 && GetInnerStream( )->CanSeek( );
+}
+//
+int64 vaCompressionStream::GetPosition( ) const
+{
+    if( m_chunkedContext == nullptr )
+    {
+        assert( false );
+        return -1;
+    }
+    return m_chunkedContext->UncompressedPosition;
+}
+//
+int64 vaCompressionStream::GetLength( )
+{
+    if( m_chunkedContext == nullptr )
+    {
+        assert( false );
+        return -1;
+    }
+    if( !m_decompressing )
+        return m_chunkedContext->UncompressedPosition;
+    if( !LoadChunkIndex( ) )
+    {
+        assert( false );
+        return -1;
+    }
+    return m_chunkedContext->TotalUncompressedSize;
+}
+//
+void vaCompressionStream::Seek( int64 position )
+{
+    if( !CanSeek( ) || !LoadChunkIndex( ) )
+    {
+        assert( false );
+        return;
+    }
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+    assert( position >= 0 && position <= ctx.TotalUncompressedSize );
+    position = vaMath::Clamp( position, (int64)0, ctx.TotalUncompressedSize );
+
+    // within the current batch? nothing to do except move the cursor
+    int64 batchStart = ctx.UncompressedPosition - ctx.BatchPos;
+    if( position >= batchStart && position < batchStart + ctx.BatchSize )
+    {
+        ctx.BatchPos                = position - batchStart;
+        ctx.UncompressedPosition    = position;
+        return;
+    }
+
+    ctx.BatchSize               = 0;
+    ctx.BatchPos                = 0;
+    ctx.UncompressedPosition    = position;
+
+    int64 chunkIndex = position / ctx.ChunkSize;
+    if( chunkIndex >= (int64)ctx.Index.size( ) )
+    {
+        ctx.ReachedEnd = true;
+        return;
+    }
+    ctx.ReachedEnd  = false;
+    ctx.InnerBytes  = (int64)ctx.Index[chunkIndex].Offset;
+    GetInnerStream( )->Seek( ctx.StreamStart + ctx.InnerBytes );
+
+    if( !ReadAndDecompressBatch( ) )
+        return;
+    ctx.BatchPos = position - chunkIndex * ctx.ChunkSize;
+}
+//
+bool vaCompressionStream::LoadChunkIndex( )
+{
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+    if( ctx.IndexLoaded )
+        return true;
+    if( ctx.IndexOffset == 0 || !GetInnerStream( )->CanSeek( ) )
+        return false;
+
+    vaStream & inner = *GetInnerStream( );
+    int64 prevInnerPos = inner.GetPosition( );
+    inner.Seek( ctx.StreamStart + ctx.IndexOffset );
+
+    bool allOk = true;
+    int64 chunkCount = 0;
+    allOk &= inner.ReadValue<int64>( chunkCount );
+    allOk &= inner.ReadValue<int64>( ctx.TotalUncompressedSize );
+    // the index must fit in what's left of the inner stream
+    allOk &= chunkCount >= 0 && chunkCount <= ( inner.GetLength( ) - inner.GetPosition( ) ) / (int64)sizeof( vaCompressionStreamChunkedContext::IndexEntry );
+    if( allOk && chunkCount > 0 )
+    {
+        ctx.Index.resize( (size_t)chunkCount );
+        allOk &= inner.Read( ctx.Index.data( ), (int64)sizeof( vaCompressionStreamChunkedContext::IndexEntry ) * chunkCount );
+    }
+    inner.Seek( prevInnerPos );
+
+    if( !allOk )
+    {
+        VA_LOG_ERROR( "vaCompressionStream - unable to read chunk index" );
+        ctx.Index.clear( );
+        return false;
+    }
+    ctx.IndexLoaded = true;
+    return true;
+}
+//
+bool vaCompressionStream::ReadAndDecompressBatch( )
+{
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+    vaStream & inner = *GetInnerStream( );
+
+    assert( ctx.BatchPos == ctx.BatchSize );
+    ctx.BatchSize   = 0;
+    ctx.BatchPos    = 0;
+
+    // sizes read below come from the data so they get validated before anything is allocated based on them
+    const int64 innerRemaining = ( inner.CanSeek( ) ) ? ( inner.GetLength( ) - inner.GetPosition( ) ) : ( INT64_MAX );
+
+    // reading the compressed data is sequential...
+    int chunkCount = 0;
+    for( ; chunkCount < ctx.BatchChunkCount; chunkCount++ )
+    {
+        uint32 compressedSize = 0, uncompressedSize = 0;
+        ctx.ChunkOffsets[chunkCount] = ctx.InnerBytes;
+        if( !inner.ReadValue<uint32>( compressedSize ) )
+            return false;
+        ctx.InnerBytes += 4;
+        if( compressedSize == 0 )
+        {
+            ctx.ReachedEnd = true;
+            break;
+        }
+        if( !inner.ReadValue<uint32>( uncompressedSize ) || uncompressedSize > ctx.ChunkSize )
+            return false;
+        ctx.InnerBytes += 4;
+        if( ctx.Checksums )
+        {
+            if( !inner.ReadValue<uint64>( ctx.ChunkChecksums[chunkCount] ) )
+                return false;
+            ctx.InnerBytes += 8;
+        }
+        if( compressedSize > GetMaxCompressedChunkSize( ctx.UseLZCodec, uncompressedSize ) || (int64)compressedSize > innerRemaining - ( ctx.InnerBytes - ctx.ChunkOffsets[0] ) )
+        {
+            VA_LOG_ERROR( "vaCompressionStream - corrupted chunk at offset %lld (invalid compressed size %u)", ctx.ChunkOffsets[chunkCount], compressedSize );
+            return false;
+        }
+        ctx.CompressedChunks[chunkCount].resize( compressedSize );
+        if( !inner.Read( ctx.CompressedChunks[chunkCount].data( ), compressedSize ) )
+            return false;
+        ctx.InnerBytes += compressedSize;
+        ctx.ChunkUncompressedSizes[chunkCount] = uncompressedSize;
+
+        // only the last chunk can be partial
+        if( chunkCount > 0 && ctx.ChunkUncompressedSizes[chunkCount-1] != ctx.ChunkSize )
+            return false;
+    }
+
+    if( chunkCount > 0 )
+        ctx.Batch.resize( vaMath::Max( ctx.Batch.size( ), (size_t)ctx.ChunkSize * ( chunkCount - 1 ) + ctx.ChunkUncompressedSizes[chunkCount-1] ) );
+
+    // ...and verifying & inflating is parallel; checksums get checked first so that the decompressor never sees corrupted data
+    enum ChunkResult : char { Failed = 0, Succeeded, ChecksumMismatch };
+    vector<char> chunkResults( chunkCount, Failed );
+    vaThreading::ParallelFor( chunkCount, [&ctx, &chunkResults]( int i )
+    {
+        const vector<uint8> & compressed = ctx.CompressedChunks[i];
+        if( ctx.Checksums && vaXXHash64::Compute( compressed.data( ), (int64)compressed.size( ) ) != ctx.ChunkChecksums[i] )
+            chunkResults[i] = ChecksumMismatch;
+        else if( DecompressChunk( ctx.UseLZCodec, compressed, ctx.Batch.data( ) + (size_t)i * ctx.ChunkSize, ctx.ChunkUncompressedSizes[i] ) )
+            chunkResults[i] = Succeeded;
+    } );
+
+    for( int i = 0; i < chunkCount; i++ )
+    {
+        if( chunkResults[i] != Succeeded )
+        {
+            VA_LOG_ERROR( "vaCompressionStream - corrupted chunk at offset %lld (%s)", ctx.ChunkOffsets[i], (chunkResults[i] == ChecksumMismatch)?("checksum mismatch"):("unable to decompress") );
+            return false;
+        }
+        ctx.BatchSize += ctx.ChunkUncompressedSizes[i];
+    }
+    return true;
+}
+//
+bool vaCompressionStream::ReadChunked( void * buffer, int64 count, int64 * outCountRead )
+{
+    if( outCountRead != nullptr )
+        *outCountRead = 0;
+    if( !m_decompressing || !IsOpen( ) )
+        return false;
+
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+
+    int64 totalRead = 0;
+    while( totalRead < count )
+    {
+        if( ctx.BatchPos == ctx.BatchSize )
+        {
+            if( ctx.ReachedEnd )
+                break;
+            if( !ReadAndDecompressBatch( ) )
+            {
+                assert( false );
+                ctx.BatchSize = ctx.BatchPos = 0;
+                ctx.ReachedEnd = true;
+                break;
+            }
+            continue;
+        }
+        int64 toCopy = vaMath::Min( count - totalRead, ctx.BatchSize - ctx.BatchPos );
+        memcpy( (uint8 *)buffer + totalRead, ctx.Batch.data( ) + ctx.BatchPos, (size_t)toCopy );
+        ctx.BatchPos                += toCopy;
+        ctx.UncompressedPosition    += toCopy;
+        totalRead                   += toCopy;
+    }
+
+    if( outCountRead != nullptr )
+        *outCountRead = totalRead;
+    return totalRead == count;
+}
+//
+bool vaCompressionStream::CompressAndWriteBatch( )
+{
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+    vaStream & inner = *GetInnerStream( );
+
+    int chunkCount = (int)( ( ctx.BatchSize + ctx.ChunkSize - 1 ) / ctx.ChunkSize );
+    for( int i = 0; i < chunkCount; i++ )
+        ctx.ChunkUncompressedSizes[i] = (uint32)vaMath::Min( (int64)ctx.ChunkSize, ctx.BatchSize - (int64)i * ctx.ChunkSize );
+
+    // deflating is parallel...
+    vector<char> chunkResults( chunkCount, 0 );
+    vaThreading::ParallelFor( chunkCount, [&ctx, &chunkResults]( int i )
+    {
+        chunkResults[i] = CompressChunk( ctx.UseLZCodec, ctx.Batch.data( ) + (size_t)i * ctx.ChunkSize, ctx.ChunkUncompressedSizes[i], ctx.CompressedChunks[i] );
+        if( chunkResults[i] && ctx.Checksums )
+            ctx.ChunkChecksums[i] = vaXXHash64::Compute( ctx.CompressedChunks[i].data( ), (int64)ctx.CompressedChunks[i].size( ) );
+    } );
+
+    // ...and writing out in order is sequential
+    for( int i = 0; i < chunkCount; i++ )
+    {
+        VERIFY_TRUE_RETURN_ON_FALSE( chunkResults[i] );
+        const vector<uint8> & compressed = ctx.CompressedChunks[i];
+
+        vaCompressionStreamChunkedContext::IndexEntry entry;
+        entry.Offset            = (uint64)ctx.InnerBytes;
+        entry.CompressedSize    = (uint32)compressed.size( );
+        entry.UncompressedSize  = ctx.ChunkUncompressedSizes[i];
+        ctx.Index.push_back( entry );
+
+        VERIFY_TRUE_RETURN_ON_FALSE( inner.WriteValue<uint32>( entry.CompressedSize ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inner.WriteValue<uint32>( entry.UncompressedSize ) );
+        ctx.InnerBytes += 8;
+        if( ctx.Checksums )
+        {
+            VERIFY_TRUE_RETURN_ON_FALSE( inner.WriteValue<uint64>( ctx.ChunkChecksums[i] ) );
+            ctx.InnerBytes += 8;
+        }
+        VERIFY_TRUE_RETURN_ON_FALSE( inner.Write( compressed.data( ), compressed.size( ) ) );
+        ctx.InnerBytes += compressed.size( );
+    }
+    ctx.BatchSize = 0;
+    return true;
+}
+//
+bool vaCompressionStream::WriteChunked( const void * buffer, int64 count, int64 * outCountWritten )
+{
+    if( outCountWritten != nullptr )
+        *outCountWritten = 0;
+    if( m_decompressing || !IsOpen( ) )
+    {
+        assert( false );
+        return false;
+    }
+
+    vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+
+    int64 totalWritten = 0;
+    while( totalWritten < count )
+    {
+        // grow the batch storage as needed (at least doubling) so that small streams don't pay for a full batch
+        int64 needed = vaMath::Min( ctx.BatchSize + count - totalWritten, ctx.GetMaxBatchBytes( ) );
+        if( needed > (int64)ctx.Batch.size( ) )
+            ctx.Batch.resize( (size_t)vaMath::Min( ctx.GetMaxBatchBytes( ), vaMath::Max( needed, (int64)ctx.Batch.size( ) * 2 ) ) );
+
+        int64 toCopy = vaMath::Min( count - totalWritten, (int64)ctx.Batch.size( ) - ctx.BatchSize );
+        memcpy( ctx.Batch.data( ) + ctx.BatchSize, (const uint8 *)buffer + totalWritten, (size_t)toCopy );
+        ctx.BatchSize               += toCopy;
+        ctx.UncompressedPosition    += toCopy;
+        totalWritten                += toCopy;
+
+        if( ctx.BatchSize == ctx.GetMaxBatchBytes( ) )
+        {
+            if( !CompressAndWriteBatch( ) )
+                return false;
+        }
+    }
+
+    if( outCountWritten != nullptr )
+        *outCountWritten = totalWritten;
+    return true;
+}
+//
+void vaCompressionStream::CloseChunked( )
+{
+    if( IsOpen( ) && !m_decompressing )
+    {
+        vaCompressionStreamChunkedContext & ctx = *m_chunkedContext;
+        vaStream & inner = *GetInnerStream( );
+
+        bool allOk = true;
+        if( ctx.BatchSize > 0 )
+            allOk &= CompressAndWriteBatch( );
+
+        // terminator, followed by the index
+        allOk &= inner.WriteValue<uint32>( 0 );
+        ctx.InnerBytes += 4;
+
+        int64 indexOffset = ctx.InnerBytes;
+        allOk &= inner.WriteValue<int64>( (int64)ctx.Index.size( ) );
+        allOk &= inner.WriteValue<int64>( ctx.UncompressedPosition );
+        if( ctx.Index.size( ) > 0 )
+            allOk &= inner.Write( ctx.Index.data( ), (int64)sizeof( vaCompressionStreamChunkedContext::IndexEntry ) * ctx.Index.size( ) );
+
+        // patch the index location into the header so that the decompressing side can seek
+        if( allOk && inner.CanSeek( ) )
+        {
+            int64 endPos = inner.GetPosition( );
+            inner.Seek( ctx.StreamStart + 12 );
+            allOk &= inner.WriteValue<uint64>( (uint64)indexOffset );
+            inner.Seek( endPos );
+        }
+        assert( allOk ); allOk;
+    }
+
+    m_compressedStream = nullptr;
+    m_compressedStreamNakedPtr = nullptr;
+    delete m_chunkedContext;
+    m_chunkedContext = nullptr;
+}
+//
 
 // USED FOR TESTING
 /*
@@ -22,6 +22,7 @@
 namespace VertexAsylum
 {
     struct vaCompressionStreamWorkingContext;
+    struct vaCompressionStreamChunkedContext;
 
     class vaCompressionStream : public vaStream
     {
@@ -30,8 +31,19 @@ namespace VertexAsylum
         {
             Default             = 0,
             PassThrough         = 1,
+            // Data split into independent fixed size zlib chunks that are (de)compressed in parallel, followed by a chunk
+            // index. If the inner stream can seek when compressing, the index location is stored in the header and the
+            // decompressing stream then supports Seek / GetLength (given a seekable inner stream). Each chunk carries the 
+            // xxHash64 of its compressed data, checked before decompressing it, so corruption is reported with its location.
+            Chunked             = 2,
+            // Same container as Chunked but each chunk is compressed with vaLZCodec (LZ4 style) instead of zlib: lower
+            // ratio but decompression is many times faster - for caches and data where load time matters most.
+            Fast                = 3,
         };
 
+        static const uint32     c_defaultChunkSize  = 1024 * 1024;
+        static const uint32     c_maxChunkSize      = 4 * 1024 * 1024;  // larger chunk sizes in a header mean corrupted data
+
     private:
         
         Profile                 m_compressionProfile;
@@ -43,18 +55,21 @@ namespace VertexAsylum
 
         vaCompressionStreamWorkingContext *
                                 m_workingContext;
+        vaCompressionStreamChunkedContext *
+                                m_chunkedContext;
 
     public:
         vaCompressionStream( bool decompressing, shared_ptr<vaStream> compressedStream, Profile profile = Profile::Default );
         vaCompressionStream( bool decompressing, vaStream * compressedStreamNakedPtr, Profile profile = Profile::Default );     // same as above except no smart pointer
         virtual ~vaCompressionStream( void );
 
-        virtual bool            CanSeek( ) override                 { return false; }
-        virtual void            Seek( int64 position ) override     { assert( false ); position; }
+        // only the Chunked profile supports these (see Profile::Chunked)
+        virtual bool            CanSeek( ) override;
+        virtual void            Seek( int64 position ) override;
         virtual void            Close( ) override;
         virtual bool            IsOpen( ) const override            { return GetInnerStream() != nullptr; }
-        virtual int64           GetLength( ) override               { assert( false ); return -1; }
-        virtual int64           GetPosition( ) const override       { assert( false ); return -1; }
+        virtual int64           GetLength( ) override;
+        virtual int64           GetPosition( ) const override;
         virtual void            Truncate( ) override                { assert( false ); }
 
         virtual bool            CanRead( ) const override           { return IsOpen() && m_decompressing; }
@@ -63,8 +78,17 @@ namespace VertexAsylum
         virtual bool            Read( void * buffer, int64 count, int64 * outCountRead = NULL );
         virtual bool            Write( const void * buffer, int64 count, int64 * outCountWritten = NULL );
 
+        Profile                 GetProfile( ) const                 { return m_compressionProfile; }
+
     private:
         void                    Initialize( bool decompressing );
+
+        bool                    ReadChunked( void * buffer, int64 count, int64 * outCountRead );
+        bool                    WriteChunked( const void * buffer, int64 count, int64 * outCountWritten );
+        bool                    CompressAndWriteBatch( );
+        bool                    ReadAndDecompressBatch( );
+        bool                    LoadChunkIndex( );
+        void                    CloseChunked( );
         vaStream *              GetInnerStream( ) const             { return (m_compressedStream!=nullptr)?(m_compressedStream.get()):(m_compressedStreamNakedPtr); }
     };
 
@@ -106,6 +106,8 @@ namespace VertexAsylum
    private:
       vaPlatformFileStreamType   m_file;
       FileAccessMode::Enum       m_accessMode;
+      bool                       m_concurrentIO;
+      int64                      m_position;          // only used (instead of the OS file pointer) if m_concurrentIO
 
    public:
       vaFileStream( );
@@ -118,6 +120,11 @@ namespace VertexAsylum
       virtual bool            Open( const wstring & filePath, FileCreationMode::Enum creationMode = FileCreationMode::Open, FileAccessMode::Enum accessMode = FileAccessMode::Default, FileShareMode::Enum shareMode = FileShareMode::Default )    { return Open( filePath.c_str(), creationMode, accessMode, shareMode ); }
       virtual bool            Open( const string & filePath, FileCreationMode::Enum creationMode = FileCreationMode::Open, FileAccessMode::Enum accessMode = FileAccessMode::Default, FileShareMode::Enum shareMode = FileShareMode::Default )     { return Open( filePath.c_str(), creationMode, accessMode, shareMode ); }
 
+      // Open for ReadAt/WriteAt from multiple threads at once: on Windows the handle is opened for overlapped I/O, otherwise the 
+      // OS serializes all I/O on the file object. Read/Write/Seek still work (the position is then kept by the stream) but must 
+      // not be mixed with ReadAt/WriteAt from other threads. FileCreationMode::Append is not supported.
+      bool                    OpenForConcurrentIO( const wstring & filePath, FileCreationMode::Enum creationMode = FileCreationMode::Open, FileAccessMode::Enum accessMode = FileAccessMode::Default, FileShareMode::Enum shareMode = FileShareMode::Default );
+
       virtual bool            CanSeek( )                          { return true; }
       virtual void            Seek( int64 position );
       virtual void            Close( );
@@ -128,6 +135,11 @@ namespace VertexAsylum
       virtual bool            Read( void * buffer, int64 count, int64 * outCountRead = NULL );
       virtual bool            Write( const void * buffer, int64 count, int64 * outCountWritten = NULL );
 
+      // Read/write at an explicit position, without a lock. They don't depend on the current position but can change it, so
+      // don't mix with Seek/Read/Write from other threads. Only actually concurrent if opened with OpenForConcurrentIO.
+      bool                    ReadAt( int64 position, void * buffer, int64 count, int64 * outCountRead = NULL );
+      bool                    WriteAt( int64 position, const void * buffer, int64 count, int64 * outCountWritten = NULL );
+
       virtual void            Flush( );
 
       virtual void            Truncate( );
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "vaMappedFileStream.h"
+
+using namespace VertexAsylum;
+
+vaMappedFileStream::vaMappedFileStream( ) : m_data( nullptr ), m_size( 0 ), m_position( 0 ), m_isOpen( false ), m_writable( false )
+{
+}
+//
+vaMappedFileStream::~vaMappedFileStream( void )
+{
+    Close( );
+}
+//
+bool vaMappedFileStream::Open( const wstring & filePath, bool writable )
+{
+    if( IsOpen( ) ) return false;
+
+    if( !PlatformMap( filePath, writable, m_data, m_size ) )
+    {
+        m_data  = nullptr;
+        m_size  = 0;
+        return false;
+    }
+    m_position  = 0;
+    m_isOpen    = true;
+    m_writable  = writable;
+    return true;
+}
+//
+void vaMappedFileStream::Close( )
+{
+    if( !IsOpen( ) )
+        return;
+
+    if( m_data != nullptr )
+        PlatformUnmap( m_data, m_size );
+    m_data      = nullptr;
+    m_size      = 0;
+    m_position  = 0;
+    m_isOpen    = false;
+    m_writable  = false;
+}
+//
+bool vaMappedFileStream::Read( void * buffer, int64 count, int64 * outCountRead )
+{
+    assert( CanRead( ) );
+    int64 toRead = vaMath::Clamp( m_size - m_position, (int64)0, count );
+    if( toRead > 0 )
+        memcpy( buffer, m_data + m_position, (size_t)toRead );
+    m_position += toRead;
+
+    if( outCountRead != nullptr )
+        *outCountRead = toRead;
+    return toRead == count;
+}
+//
+bool vaMappedFileStream::Write( const void * buffer, int64 count, int64 * outCountWritten )
+{
+    assert( CanWrite( ) );
+    int64 toWrite = ( CanWrite( ) ) ? ( vaMath::Clamp( m_size - m_position, (int64)0, count ) ) : ( 0 );
+    if( toWrite > 0 )
+        memcpy( m_data + m_position, buffer, (size_t)toWrite );
+    m_position += toWrite;
+
+    if( outCountWritten != nullptr )
+        *outCountWritten = toWrite;
+    return toWrite == count;
+}
+//
+const uint8 * vaMappedFileStream::GetView( int64 offset, int64 size ) const
+{
+    if( !IsOpen( ) || offset < 0 || size < 0 || offset + size > m_size )
+        return nullptr;
+    return m_data + offset;
+}
+//
+const uint8 * vaMappedFileStream::ReadView( int64 size )
+{
+    const uint8 * view = GetView( m_position, size );
+    if( view != nullptr )
+        m_position += size;
+    return view;
+}
+//
+uint8 * vaMappedFileStream::GetWritableView( int64 offset, int64 size ) const
+{
+    if( !m_writable )
+        return nullptr;
+    return const_cast<uint8 *>( GetView( offset, size ) );
+}
+//
+void vaMappedFileStream::Advise( int64 offset, int64 size, AccessHint hint )
+{
+    if( size < 0 )
+        size = m_size - offset;
+    if( GetView( offset, size ) == nullptr || size == 0 )
+        return;
+    PlatformAdvise( m_data + offset, size, hint );
+}
+//
+bool vaMappedFileStream::Flush( int64 offset, int64 size )
+{
+    if( size < 0 )
+        size = m_size - offset;
+    if( GetView( offset, size ) == nullptr )
+        return false;
+    if( !m_writable || size == 0 )
+        return true;
+    return PlatformFlush( m_data + offset, size );
+}
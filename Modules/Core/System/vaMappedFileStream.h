@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Core/vaCore.h"
+
+#include "vaStream.h"
+
+namespace VertexAsylum
+{
+    // Stream over a file mapped into memory as a whole, read-only unless opened as writable. Read( ) is a memcpy from
+    // the mapping, and GetView( ) / ReadView( ) hand out pointers straight into it so that data can be consumed with
+    // no intermediate copy (wrap them in vaMemoryBuffer with InitType::View or in a fixed size vaMemoryStream). The
+    // pages come from the OS file cache so they are shared between all processes mapping the same file.
+    // A writable mapping has the fixed size of the file (Write( ) can't grow it); modified pages are written back by
+    // the OS at its own pace, or on Flush( ).
+    // Views are valid only until Close( ) / destruction.
+    //  - Windows: CreateFileMapping + MapViewOfFile
+    //  - Linux: mmap
+    class vaMappedFileStream : public vaStream
+    {
+    public:
+        enum class AccessHint
+        {
+            Normal,
+            Sequential,         // aggressive read-ahead
+            Random,             // no read-ahead
+            WillNeed,           // start reading the range in now
+        };
+
+    private:
+        uint8 *                 m_data;
+        int64                   m_size;
+        int64                   m_position;
+        bool                    m_isOpen;
+        bool                    m_writable;
+
+    public:
+        vaMappedFileStream( );
+        vaMappedFileStream( const vaMappedFileStream & copy ) = delete;
+        vaMappedFileStream & operator = ( const vaMappedFileStream & copy ) = delete;
+        virtual ~vaMappedFileStream( void );
+
+        bool                    Open( const wstring & filePath, bool writable = false );
+
+        virtual bool            CanSeek( ) override                 { return true; }
+        virtual void            Seek( int64 position ) override     { assert( position >= 0 && position <= m_size ); m_position = position; }
+        virtual void            Close( ) override;
+        virtual bool            IsOpen( ) const override            { return m_isOpen; }
+        virtual int64           GetLength( ) override               { return m_size; }
+        virtual int64           GetPosition( ) const override       { return m_position; }
+        virtual void            Truncate( ) override                { assert( false ); }
+
+        virtual bool            CanWrite( ) const override          { return m_isOpen && m_writable; }
+
+        virtual bool            Read( void * buffer, int64 count, int64 * outCountRead = NULL ) override;
+        virtual bool            Write( const void * buffer, int64 count, int64 * outCountWritten = NULL ) override;
+
+        // Pointer into the mapping at [offset, offset+size); nullptr if out of range
+        const uint8 *           GetView( int64 offset, int64 size ) const;
+
+        // Same as GetView( GetPosition( ), size ) but also advances the position, like Read( ) does
+        const uint8 *           ReadView( int64 size );
+
+        const uint8 *           GetData( ) const                    { return m_data; }
+
+        // Same as GetView( ) but writable; nullptr if not opened as writable
+        uint8 *                 GetWritableView( int64 offset, int64 size ) const;
+
+        // Tells the OS how [offset, offset+size) is going to be accessed (size < 0: up to the end); only a hint, and a
+        // no-op where the platform has no equivalent (Windows has no Sequential/Random for mapped views)
+        void                    Advise( int64 offset, int64 size, AccessHint hint );
+
+        // Writes modified pages in [offset, offset+size) (size < 0: up to the end) back to the file
+        bool                    Flush( int64 offset = 0, int64 size = -1 );
+
+    private:
+        // implemented per platform
+        static bool             PlatformMap( const wstring & filePath, bool writable, uint8 * & outData, int64 & outSize );
+        static void             PlatformUnmap( uint8 * data, int64 size );
+        static void             PlatformAdvise( uint8 * data, int64 size, AccessHint hint );
+        static bool             PlatformFlush( uint8 * data, int64 size );
+    };
+
+}
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "vaPrefetchStream.h"
+
+#include "Core/System/vaThreading.h"
+#include "Core/Misc/vaTracer.h"
+
+using namespace VertexAsylum;
+
+vaPrefetchStream::vaPrefetchStream( vaStream * innerStream, int64 bufferSize ) : m_innerStream( innerStream ), m_bufferSize( bufferSize )
+{
+    assert( innerStream != nullptr && innerStream->CanRead( ) );
+    assert( bufferSize > 0 && bufferSize < INT_MAX );
+    if( innerStream == nullptr || !innerStream->CanRead( ) )
+        return;
+
+    if( m_innerStream->CanSeek( ) )
+    {
+        m_startPosition = m_innerStream->GetPosition( );
+        m_length        = m_innerStream->GetLength( );
+    }
+
+    for( int i = 0; i < c_maxBuffersInFlight; i++ )
+    {
+        m_buffers[i].Data = new uint8[(size_t)m_bufferSize];
+        bool ok = m_freeQueue.TryPush( i );
+        assert( ok ); ok;
+    }
+
+    m_isOpen        = true;
+    m_readerThread  = std::thread( [this]( ) { ReaderThreadProc( ); } );
+}
+//
+vaPrefetchStream::~vaPrefetchStream( void )
+{
+    Close( );
+    for( int i = 0; i < c_maxBuffersInFlight; i++ )
+        delete[] m_buffers[i].Data;
+}
+//
+void vaPrefetchStream::Wake( )
+{
+    // taking the lock (even if empty) guarantees the other side is either not yet checking its queue or already waiting
+    { std::unique_lock<std::mutex> lock( m_wakeMutex ); }
+    m_wakeCV.notify_all( );
+}
+//
+void vaPrefetchStream::ReaderThreadProc( )
+{
+    vaTracer::SetCurrentThreadName( "vaPrefetchStream" );
+
+    while( !m_stopReader )
+    {
+        int bufferIndex;
+        if( !m_freeQueue.TryPop( bufferIndex ) )
+        {
+            // consumer is behind - wait for it to give a buffer back
+            std::unique_lock<std::mutex> lock( m_wakeMutex );
+            m_wakeCV.wait( lock, [this]( ) { return m_stopReader || !m_freeQueue.IsEmpty( ); } );
+            continue;
+        }
+
+        Buffer & buffer = m_buffers[bufferIndex];
+        int64 readCount = 0;
+        {
+            VA_TRACE_SCOPE( vaPrefetchStream_Read );
+            m_innerStream->Read( buffer.Data, m_bufferSize, &readCount );
+        }
+        buffer.Size = vaMath::Max( (int64)0, readCount );
+
+        bool ok = m_filledQueue.TryPush( bufferIndex );       // can't fail, there's only c_maxBuffersInFlight buffers
+        assert( ok ); ok;
+
+        // set only after the last push so that the consumer seeing it can trust an empty queue to stay empty
+        bool reachedEnd = buffer.Size < m_bufferSize;
+        if( reachedEnd )
+            m_readerFinished = true;
+        Wake( );
+
+        if( reachedEnd )
+            break;
+    }
+}
+//
+bool vaPrefetchStream::AcquireNextBuffer( )
+{
+    if( m_currentBuffer != -1 )
+    {
+        bool ok = m_freeQueue.TryPush( m_currentBuffer );
+        assert( ok ); ok;
+        m_currentBuffer = -1;
+        Wake( );
+    }
+
+    int bufferIndex;
+    while( !m_filledQueue.TryPop( bufferIndex ) )
+    {
+        // m_readerFinished is set after the last buffer is pushed, so check the queue once more after seeing it
+        if( m_readerFinished && m_filledQueue.IsEmpty( ) )
+            return false;
+
+        // waiting for the disk
+        std::unique_lock<std::mutex> lock( m_wakeMutex );
+        m_wakeCV.wait( lock, [this]( ) { return m_readerFinished || !m_filledQueue.IsEmpty( ); } );
+    }
+    m_currentBuffer     = bufferIndex;
+    m_currentBufferPos  = 0;
+    return true;
+}
+//
+bool vaPrefetchStream::Read( void * buffer, int64 count, int64 * outCountRead )
+{
+    if( outCountRead != nullptr )
+        *outCountRead = 0;
+
+    assert( IsOpen( ) );
+    if( !IsOpen( ) )
+        return false;
+
+    int64 totalRead = 0;
+    while( totalRead < count )
+    {
+        if( m_currentBuffer == -1 || m_currentBufferPos == m_buffers[m_currentBuffer].Size )
+        {
+            // last buffer is always partial (possibly empty)
+            if( m_currentBuffer != -1 && m_buffers[m_currentBuffer].Size < m_bufferSize )
+                break;
+            if( !AcquireNextBuffer( ) )
+                break;
+            continue;
+        }
+
+        const Buffer & current = m_buffers[m_currentBuffer];
+        int64 toCopy = vaMath::Min( count - totalRead, current.Size - m_currentBufferPos );
+        memcpy( (uint8 *)buffer + totalRead, current.Data + m_currentBufferPos, (size_t)toCopy );
+        m_currentBufferPos  += toCopy;
+        totalRead           += toCopy;
+    }
+    m_position += totalRead;
+
+    if( outCountRead != nullptr )
+        *outCountRead = totalRead;
+    return totalRead == count;
+}
+//
+void vaPrefetchStream::Close( )
+{
+    if( !IsOpen( ) )
+        return;
+
+    m_stopReader = true;
+    Wake( );
+    m_readerThread.join( );
+
+    // give back what was read ahead but not consumed
+    if( m_innerStream->CanSeek( ) )
+        m_innerStream->Seek( GetPosition( ) );
+
+    m_innerStream   = nullptr;
+    m_isOpen        = false;
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include "Core/vaCore.h"
+#include "Core/Containers/vaSPSCQueue.h"
+
+#include "vaStream.h"
+
+#include <thread>
+#include <condition_variable>
+
+namespace VertexAsylum
+{
+    // Read-only, forward-only decorator that reads the inner stream on its own background thread, keeping up to
+    // c_maxBuffersInFlight buffers filled ahead of the consumer so that disk I/O overlaps with whatever the consumer does
+    // with the data (decompression, parsing). Filled and recycled buffers are passed between the two threads through
+    // lock-free SPSC queues; the threads only sleep when the consumer catches up with the disk (or the other way around).
+    // Once constructed, the inner stream must not be used by anyone else until Close( ) (also called on destruction),
+    // which stops the reader and, if the inner stream can seek, moves it to the logical position of this stream.
+    class vaPrefetchStream : public vaStream
+    {
+    public:
+        static const int        c_maxBuffersInFlight    = 8;
+        static const int64      c_defaultBufferSize     = 1024 * 1024;
+
+    private:
+        struct Buffer
+        {
+            uint8 *             Data                    = nullptr;
+            int64               Size                    = 0;        // valid bytes; less than buffer size on the last one
+        };
+
+        vaStream *              m_innerStream;
+        const int64             m_bufferSize;
+        Buffer                  m_buffers[c_maxBuffersInFlight];
+
+        vaSPSCQueue<int, c_maxBuffersInFlight>
+                                m_filledQueue;                      // reader thread -> consumer
+        vaSPSCQueue<int, c_maxBuffersInFlight>
+                                m_freeQueue;                        // consumer -> reader thread
+
+        // only used for sleeping when a queue is empty, never for passing data
+        std::mutex              m_wakeMutex;
+        std::condition_variable m_wakeCV;
+
+        std::thread             m_readerThread;
+        std::atomic_bool        m_stopReader            = false;
+        std::atomic_bool        m_readerFinished        = false;    // reached end of the inner stream (or error)
+
+        // consumer side state
+        int                     m_currentBuffer         = -1;
+        int64                   m_currentBufferPos      = 0;
+        int64                   m_startPosition         = 0;        // of the inner stream, if it can seek
+        int64                   m_position              = 0;        // bytes consumed
+        int64                   m_length                = -1;       // of the inner stream, if known
+        bool                    m_isOpen                = false;
+
+    public:
+        vaPrefetchStream( vaStream * innerStream, int64 bufferSize = c_defaultBufferSize );
+        vaPrefetchStream( const vaPrefetchStream & ) = delete;
+        vaPrefetchStream & operator = ( const vaPrefetchStream & ) = delete;
+        virtual ~vaPrefetchStream( void );
+
+        virtual bool            CanSeek( ) override                 { return false; }
+        virtual void            Seek( int64 position ) override     { assert( false ); position; }
+        virtual void            Close( ) override;
+        virtual bool            IsOpen( ) const override            { return m_isOpen; }
+        virtual int64           GetLength( ) override               { assert( m_length >= 0 ); return m_length; }
+        virtual int64           GetPosition( ) const override       { return m_startPosition + m_position; }
+        virtual void            Truncate( ) override                { assert( false ); }
+
+        virtual bool            CanWrite( ) const override          { return false; }
+
+        virtual bool            Read( void * buffer, int64 count, int64 * outCountRead = NULL ) override;
+        virtual bool            Write( const void * buffer, int64 count, int64 * outCountWritten = NULL ) override     { assert( false ); buffer; count; if( outCountWritten != nullptr ) *outCountWritten = 0; return false; }
+
+    private:
+        void                    ReaderThreadProc( );
+        void                    Wake( );
+        // false if the reader has finished and there's nothing left
+        bool                    AcquireNextBuffer( );
+    };
+
+}
@@ -24,6 +24,8 @@
 #include "Core/vaSTL.h"
 #include "../vaMath.h"
 
+#include <type_traits>
+
 namespace VertexAsylum
 {
     class vaStream
@@ -71,6 +73,27 @@ namespace VertexAsylum
         inline bool             WriteTXT( const wstring & str );
         inline bool             WriteTXT( const string & str );
 
+        // element count prefix used by value vectors: int32 if < INT_MAX, otherwise int32 -1 followed by int64 (old files
+        // only ever have the int32 so this is backwards compatible and doesn't grow the file for the common case)
+        inline bool             WriteCount( int64 count );
+        inline bool             ReadCount( int64 & outCount );
+
+        // Read/Write split into blocks no bigger than c_maxBlockSize - not all streams support >INT_MAX in one go
+        inline bool             ReadBlocks( void * buffer, int64 count );
+        inline bool             WriteBlocks( const void * buffer, int64 count );
+
+        static const int64      c_maxBlockSize      = 0x40000000;
+
+    private:
+        // trivially copyable elements go in/out as one contiguous block, everything else element by element
+        template<typename ElementType>
+        inline bool             WriteValueVectorElements( const vector<ElementType> & elements, std::true_type );
+        template<typename ElementType>
+        inline bool             WriteValueVectorElements( const vector<ElementType> & elements, std::false_type );
+        template<typename ElementType>
+        inline bool             ReadValueVectorElements( vector<ElementType> & elements, std::true_type );
+        template<typename ElementType>
+        inline bool             ReadValueVectorElements( vector<ElementType> & elements, std::false_type );
     };
 
 
@@ -131,7 +154,8 @@ namespace VertexAsylum
             return false;
         assert( ( lengthInBytes & ( 1 << 31 ) ) != 0 );                // not reading a unicode string?
         lengthInBytes &= ~( 1 << 31 );
-        assert( lengthInBytes % 2 == 0 );                           // must be an even number!
+        if( lengthInBytes % 2 != 0 )                                // must be an even number (corrupt data otherwise) - the
+            return false;                                           // read below would go past the end of the string storage
 
         // Empty string?
         if( lengthInBytes == 0 )
@@ -140,16 +164,14 @@ namespace VertexAsylum
             return true;
         }
 
-        wchar_t * buffer = new wchar_t[lengthInBytes / 2 + 1];          // TODO: remove dynamic alloc for smaller (most) reads - just use stack memory
-        if( !Read( buffer, lengthInBytes ) )
+        // read straight into the string's storage - no temporary; if outStr already has the capacity (reused strings, or
+        // short strings that fit into the small string buffer) there's no allocation at all
+        outStr.resize( lengthInBytes / 2 );
+        if( !Read( &outStr[0], lengthInBytes ) )
         {
-            delete[] buffer;
+            outStr.clear( );
             return false;
         }
-        buffer[lengthInBytes / 2] = 0;
-
-        outStr = wstring( buffer, lengthInBytes / 2 );
-        delete[] buffer;
         return true;
     }
 
@@ -167,16 +189,13 @@ namespace VertexAsylum
             return true;
         }
 
-        char * buffer = new char[lengthInBytes + 1];          // TODO: remove dynamic alloc for smaller (most) reads - just use stack memory
-        if( !Read( buffer, lengthInBytes ) )
+        // see the wstring version
+        outStr.resize( lengthInBytes );
+        if( !Read( &outStr[0], lengthInBytes ) )
         {
-            delete[] buffer;
+            outStr.clear( );
             return false;
         }
-        buffer[lengthInBytes] = 0;
-
-        outStr = string( buffer, lengthInBytes );
-        delete[] buffer;
         return true;
     }
 
@@ -198,16 +217,12 @@ namespace VertexAsylum
             return true;
         }
 
-        wchar_t * buffer = new wchar_t[count / 2 + 1];          // TODO: remove dynamic alloc for smaller (most) reads - just use stack memory
-        if( !Read( buffer, count ) )
+        outStr.resize( (size_t)( count / 2 ) );
+        if( !ReadBlocks( &outStr[0], count ) )
         {
-            delete[] buffer;
+            outStr.clear( );
             return false;
         }
-        buffer[count / 2] = 0;
-
-        outStr = wstring( buffer, count / 2 );
-        delete[] buffer;
         return true;
     }
 
@@ -227,16 +242,12 @@ namespace VertexAsylum
             return true;
         }
 
-        char * buffer = new char[count + 1];          // TODO: remove dynamic alloc for smaller (most) reads - just use stack memory
-        if( !Read( buffer, count ) )
+        outStr.resize( (size_t)count );
+        if( !ReadBlocks( &outStr[0], count ) )
         {
-            delete[] buffer;
+            outStr.clear( );
             return false;
         }
-        buffer[count] = 0;
-
-        outStr = string( buffer, count );
-        delete[] buffer;
         return true;
     }
 
@@ -262,52 +273,109 @@ namespace VertexAsylum
             return Write( str.c_str( ), lengthInBytes );
     }
 
-#define VASTREAM_ALLOW_WHOLE_VECTOR_BUFFER_READWRITE
+inline bool vaStream::WriteCount( int64 count )
+    {
+        assert( count >= 0 );
+        if( count < INT_MAX )
+            return WriteValue<int32>( (int32)count );
+        return WriteValue<int32>( -1 ) && WriteValue<int64>( count );
+    }
 
+    inline bool vaStream::ReadCount( int64 & outCount )
+    {
+        int32 count32;
+        if( !ReadValue<int32>( count32 ) )
+            return false;
+        if( count32 != -1 )
+        {
+            outCount = count32;
+            return count32 >= 0;
+        }
+        if( !ReadValue<int64>( outCount ) )
+            return false;
+        return outCount >= INT_MAX;
+    }
 
-    template<typename ElementType>
-    inline bool vaStream::WriteValueVector( const vector<ElementType> & elements )
+    inline bool vaStream::ReadBlocks( void * buffer, int64 count )
     {
-        assert( elements.size( ) < INT_MAX ); // not supported; to add support for 64bit size use most significant bit (sign) to indicate that the size is >= INT_MAX; this is backwards compatible and will not unnecessarily increase file size
+        for( int64 offset = 0; offset < count; offset += c_maxBlockSize )
+        {
+            if( !Read( (char *)buffer + offset, vaMath::Min( c_maxBlockSize, count - offset ) ) )
+                return false;
+        }
+        return true;
+    }
 
-        bool ret = WriteValue<int>( (int)elements.size( ) );
-        assert( ret ); if( !ret ) return false;
+    inline bool vaStream::WriteBlocks( const void * buffer, int64 count )
+    {
+        for( int64 offset = 0; offset < count; offset += c_maxBlockSize )
+        {
+            if( !Write( (const char *)buffer + offset, vaMath::Min( c_maxBlockSize, count - offset ) ) )
+                return false;
+        }
+        return true;
+    }
 
-        for( int i = 0; i < (int)elements.size( ); i++ )
+    template<typename ElementType>
+    inline bool vaStream::WriteValueVectorElements( const vector<ElementType> & elements, std::true_type )
+    {
+        return WriteBlocks( elements.data( ), (int64)elements.size( ) * (int64)sizeof( ElementType ) );
+    }
+
+    template<typename ElementType>
+    inline bool vaStream::WriteValueVectorElements( const vector<ElementType> & elements, std::false_type )
+    {
+        for( size_t i = 0; i < elements.size( ); i++ )
         {
-            ret = WriteValue<ElementType>( elements[i] );
+            bool ret = WriteValue<ElementType>( elements[i] );
             assert( ret ); if( !ret ) return false;
         }
+        return true;
+    }
+
+    template<typename ElementType>
+    inline bool vaStream::ReadValueVectorElements( vector<ElementType> & elements, std::true_type )
+    {
+        return ReadBlocks( elements.data( ), (int64)elements.size( ) * (int64)sizeof( ElementType ) );
+    }
 
+    template<typename ElementType>
+    inline bool vaStream::ReadValueVectorElements( vector<ElementType> & elements, std::false_type )
+    {
+        for( size_t i = 0; i < elements.size( ); i++ )
+        {
+            bool ret = ReadValue<ElementType>( elements[i] );
+            assert( ret ); if( !ret ) return false;
+        }
         return true;
     }
 
+    template<typename ElementType>
+    inline bool vaStream::WriteValueVector( const vector<ElementType> & elements )
+    {
+        bool ret = WriteCount( (int64)elements.size( ) );
+        assert( ret ); if( !ret ) return false;
+
+        if( elements.size( ) == 0 ) return true;
+
+        ret = WriteValueVectorElements( elements, std::is_trivially_copyable<ElementType>( ) );
+        assert( ret );
+        return ret;
+    }
+
     template<typename ElementType>
     inline bool vaStream::ReadValueVector( vector<ElementType> & elements )
     {
         assert( elements.size( ) == 0 ); // must be empty at the moment
 
-        int count;
-        if( !ReadValue<int>( count, -1 ) )
+        int64 count;
+        if( !ReadCount( count ) )
             return false;
-        assert( count >= 0 ); if( count < 0 ) return false;
 
         if( count == 0 ) return true;
 
-        elements.resize( count );
-
-#ifdef VASTREAM_ALLOW_WHOLE_VECTOR_BUFFER_READWRITE
-        int64 sizeToRead = count * sizeof( ElementType );
-        if( !Read( elements.data(), sizeToRead ) )
-            return false;
-#else
-        for( int i = 0; i < count; i++ )
-        {
-            bool ret = ReadValue<ElementType>( elements[i] );
-            assert( ret ); if( !ret ) return false;
-        }
-#endif
+        elements.resize( (size_t)count );
 
-        return true;
+        return ReadValueVectorElements( elements, std::is_trivially_copyable<ElementType>( ) );
     }
-}
\ No newline at end of file
+}
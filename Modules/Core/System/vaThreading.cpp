@@ -25,12 +25,119 @@
 
 #include "Core/Misc/vaProfiler.h"
 
+#include "IntegratedExternals/vaEnkiTSIntegration.h"
+
 #ifdef VA_IMGUI_INTEGRATION_ENABLED
 #include "IntegratedExternals/vaImguiIntegration.h"
 #endif
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+
 using namespace VertexAsylum;
 
+namespace
+{
+    // Persistent workers for ParallelFor calls made outside of the main thread (enkiTS can't take tasks from there); created
+    // on first use. The calling thread works on its own job too, so nested or concurrent calls always make progress.
+    class ParallelForWorkerPool
+    {
+        struct Job
+        {
+            const std::function<void( int )> &  Func;
+            const int                           Count;
+            std::atomic_int                     NextIndex   = 0;
+            int                                 Workers     = 0;        // pool threads holding a pointer to this; protected by m_mutex
+
+            Job( const std::function<void( int )> & func, int count ) : Func( func ), Count( count ) { }
+
+            // returns false once all indices have been picked up
+            bool                                RunOne( )               { int index = NextIndex++; if( index >= Count ) return false; Func( index ); return true; }
+        };
+
+        std::mutex                              m_mutex;
+        std::condition_variable                 m_workAvailableCV;
+        std::condition_variable                 m_jobReleasedCV;
+        std::deque<Job *>                       m_jobs;
+        vector<std::thread>                     m_threads;
+        bool                                    m_stop              = false;
+
+    public:
+        ParallelForWorkerPool( )
+        {
+            int threadCount = vaMath::Max( 1, (int)std::thread::hardware_concurrency( ) - 1 );
+            for( int i = 0; i < threadCount; i++ )
+                m_threads.push_back( std::thread( [this]( ) { WorkerLoop( ); } ) );
+        }
+        ~ParallelForWorkerPool( )
+        {
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_stop = true;
+            }
+            m_workAvailableCV.notify_all( );
+            for( auto & thread : m_threads )
+                thread.join( );
+        }
+
+        void                                    Run( int count, const std::function<void( int )> & func )
+        {
+            Job job( func, count );
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_jobs.push_back( &job );
+            }
+            m_workAvailableCV.notify_all( );
+
+            while( job.RunOne( ) ) { }
+
+            // all indices are picked up; wait for the workers still running ones (they let go of the job once done)
+            std::unique_lock<std::mutex> lock( m_mutex );
+            RemoveNoMutexLock( &job );
+            m_jobReleasedCV.wait( lock, [&job]( ) { return job.Workers == 0; } );
+        }
+
+    private:
+        void                                    RemoveNoMutexLock( Job * job )
+        {
+            auto it = std::find( m_jobs.begin( ), m_jobs.end( ), job );
+            if( it != m_jobs.end( ) )
+                m_jobs.erase( it );
+        }
+
+        void                                    WorkerLoop( )
+        {
+            VA_NAME_THREAD( "ParallelFor" );
+
+            std::unique_lock<std::mutex> lock( m_mutex );
+            while( true )
+            {
+                m_workAvailableCV.wait( lock, [this]( ) { return m_stop || !m_jobs.empty( ); } );
+                if( m_stop )
+                    return;
+
+                Job * job = m_jobs.front( );
+                job->Workers++;
+                lock.unlock( );
+
+                while( job->RunOne( ) ) { }
+
+                lock.lock( );
+                RemoveNoMutexLock( job );
+                if( --job->Workers == 0 )
+                    m_jobReleasedCV.notify_all( );
+            }
+        }
+    };
+
+    ParallelForWorkerPool & GetParallelForWorkerPool( )
+    {
+        static ParallelForWorkerPool pool;
+        return pool;
+    }
+}
+
 std::atomic<std::thread::id> vaThreading::s_mainThreadID;
 
 void vaThreading::SetMainThread( )
@@ -51,6 +158,38 @@ bool vaThreading::IsMainThread( )
     return s_mainThreadID == std::this_thread::get_id();
 }
 
+void vaThreading::ParallelFor( int count, const std::function<void( int index )> & func )
+{
+    if( count <= 1 )
+    {
+        if( count == 1 )
+            func( 0 );
+        return;
+    }
+
+    if( IsMainThread( ) && vaEnkiTS::GetInstancePtr( ) != nullptr )
+    {
+        struct ParallelForTaskSet : enki::ITaskSet
+        {
+            const std::function<void( int )> &  Func;
+            ParallelForTaskSet( uint32_t count, const std::function<void( int )> & func ) : ITaskSet( count ), Func( func ) { }
+            virtual void        ExecuteRange( enki::TaskSetPartition range, uint32_t threadnum ) override
+            {
+                threadnum; // unreferenced
+                for( uint32_t i = range.start; i < range.end; i++ )
+                    Func( (int)i );
+            }
+        };
+        ParallelForTaskSet taskSet( (uint32_t)count, func );
+        vaEnkiTS::GetInstance( ).AddTaskSetToPipe( &taskSet );
+        vaEnkiTS::GetInstance( ).WaitforTaskSet( &taskSet );
+    }
+    else
+    {
+        GetParallelForWorkerPool( ).Run( count, func );
+    }
+}
+
 vaBackgroundTaskManager::vaBackgroundTaskManager( )  
 {
     int physicalPackages, physicalCores, logicalCores;
@@ -106,6 +245,8 @@ void vaBackgroundTaskManager::Run( const shared_ptr<TaskInternal> & _task )
     assert( !_task->IsFinished );
     std::thread thread( [this, _task]() 
     {
+        VA_NAME_THREAD( "BackgroundTask" );
+
         shared_ptr<TaskInternal> task = _task;
 
         bool loopDone = true;
@@ -113,7 +254,12 @@ void vaBackgroundTaskManager::Run( const shared_ptr<TaskInternal> & _task )
         {
             assert( !task->IsFinished );
             // if( !task->Context.ForceStop ) // <- not sure if we want this
+            {
+                // task names are often dynamic ("Loading 'x.apack'") so they only get registered as scope names while capturing
+                uint32 traceScopeID = ( vaTracer::IsCapturing( ) ) ? ( vaTracer::RegisterScope( task->Name.c_str( ) ) ) : ( vaTracer::c_invalidScopeID );
+                vaTraceScope traceScope( traceScopeID );
                 task->Result = task->UserFunction( task->Context );
+            }
             assert( !task->IsFinished );
             task->Context.Progress = 1.0f;
 
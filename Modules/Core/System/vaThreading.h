@@ -26,6 +26,8 @@
 #include "Core/vaCore.h"
 #include "Core/vaSingleton.h"
 
+#include "Core/Misc/vaTracer.h"
+
 #include <functional>
 
 namespace VertexAsylum
@@ -42,6 +44,11 @@ namespace VertexAsylum
         static void                         GetCPUCoreCountInfo( int & physicalPackages, int & physicalCores, int & logicalCores );
         static bool                         IsMainThread( );
 
+        // Calls func( 0 ) ... func( count-1 ) in parallel and returns once all are done. Uses vaEnkiTS workers when called from the
+        // main thread; enkiTS (the version we have) only accepts tasks from there or from within its own tasks, so from anywhere
+        // else (such as vaBackgroundTaskManager tasks) it uses a persistent pool of worker threads instead (created on first use).
+        static void                         ParallelFor( int count, const std::function<void( int index )> & func );
+
     private:
         friend class vaCore;
         static std::atomic<std::thread::id> s_mainThreadID;
@@ -435,6 +435,22 @@ void vaApplicationBase::UIPanelDraw( )
                     }
                 }
 #endif
+
+                if( !vaTracer::IsCapturing( ) )
+                {
+                    if( ImGui::Button( "Start CPU trace capture" ) )
+                        vaTracer::StartCapture( );
+                }
+                else
+                {
+                    if( ImGui::Button( "Stop CPU trace capture and save" ) )
+                    {
+                        vaTracer::StopCapture( );
+                        vaTracer::SaveChromeTrace( vaCore::GetExecutableDirectory( ) + L"cputrace.json" );
+                    }
+                }
+                if( ImGui::IsItemHovered( ) )
+                    ImGui::SetTooltip( "Captures all VA_SCOPE_CPU_TIMER / VA_TRACE_SCOPE scopes on all threads and saves them\nin Chrome trace format (open with chrome://tracing or ui.perfetto.dev)" );
             }
         }
 
@@ -449,15 +465,22 @@ void vaApplicationBase::UIPanelDraw( )
             }
         }
         //if( (int)HelperUIFlags::ShowCPUProfiling & (int)uiFlags )
-        //
-        //{
-        //    ImGui::Separator( );
-        //
-        //    if( ImGui::CollapsingHeader( "CPU Profiling", ImGuiTreeNodeFlags_Framed | ((/*m_helperUISettings.CPUProfilerDefaultOpen*/false)?(ImGuiTreeNodeFlags_DefaultOpen):(0)) ) )
-        //    {
-        //        vaProfiler::GetInstance( ).InsertImGuiContent( true );
-        //    }
-        //}
+        {
+            ImGui::Separator( );
+
+            if( ImGui::CollapsingHeader( "CPU Profiling", ImGuiTreeNodeFlags_Framed | ((/*m_helperUISettings.CPUProfilerDefaultOpen*/false)?(ImGuiTreeNodeFlags_DefaultOpen):(0)) ) )
+            {
+                vaProfiler::GetInstance( ).InsertImGuiContent( true );
+            }
+        }
+        {
+            ImGui::Separator( );
+
+            if( ImGui::CollapsingHeader( "Memory", ImGuiTreeNodeFlags_Framed ) )
+            {
+                vaMemory::InsertImGuiContent( );
+            }
+        }
     }
 
 #endif
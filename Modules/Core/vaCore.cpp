@@ -22,6 +22,7 @@
 #include "vaCore.h"
 
 #include "Core/Misc/vaBenchmarkTool.h"
+#include "Core/Misc/vaCoreBenchmarks.h"
 
 #include "Misc/vaProfiler.h"
 
@@ -32,6 +33,7 @@
 #include "Core/vaUI.h"
 
 #include "Core/vaUIDObject.h"
+#include "Core/vaStringID.h"
 
 #include "Rendering/vaRendering.h"
 
@@ -74,6 +76,8 @@ void vaCore::Initialize( bool liveRestart )
 
         new vaUIDObjectRegistrar( );
 
+        new vaStringInterner( );
+
         vaMath::Initialize( );
 
         vaPlatformBase::Initialize( );
@@ -87,6 +91,7 @@ void vaCore::Initialize( bool liveRestart )
 
     new vaUIManager( );
     new vaUIConsole( );
+    vaUIConsole::GetInstance( ).AddCommand( "BENCHMARK_CORE", [ ]( const string & arguments ) { vaCoreBenchmarks::Run( arguments ); } );
 
     // VA_SCOPE_CPU_TIMER( Initialize );
 
@@ -145,6 +150,8 @@ void vaCore::Deinitialize( bool liveRestart )
 
         delete vaUIDObjectRegistrar::GetInstancePtr( );
 
+        delete vaStringInterner::GetInstancePtr( );
+
         vaMemory::Deinitialize( );
     }
 
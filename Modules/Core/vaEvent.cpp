@@ -37,6 +37,23 @@ namespace VertexAsylum
             assert( *aNumberInMemory == 42 );
         }
         testEvent.Invoke( 1 );
+
+        // removing from within a callback: the removed one must not get called even by the Invoke in progress
+        {
+            int staticCount = 0;
+            testEvent.AddStatic( [&staticCount]( int p ) { staticCount += p; } );
+            shared_ptr< int > second = std::make_shared<int>( 0 );
+            shared_ptr< int > first = std::make_shared<int>( 0 );
+            testEvent.AddWithToken( weak_ptr<void>(second), [second]( int p ) { *second += p; } );
+            testEvent.AddWithToken( weak_ptr<void>(first), [&testEvent, first, second]( int p ) { *first += p; testEvent.Remove( weak_ptr<void>(second) ); } );
+            testEvent.Invoke( 1 );
+            assert( *first == 1 && *second == 0 && staticCount == 1 );
+            testEvent.Remove( weak_ptr<void>(first) );
+            testEvent.Invoke( 1 );
+            assert( *first == 1 && staticCount == 2 );
+            testEvent.RemoveAll( );
+            assert( testEvent.IsEmpty( ) );
+        }
     }
 
 }
\ No newline at end of file
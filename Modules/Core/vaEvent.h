@@ -24,39 +24,56 @@
 
 #include "vaCore.h"
 
+#include "Core/Containers/vaInplaceFunction.h"
+
 // notes/todos:
 // * inspiration: http://nercury.github.io/c++/interesting/2016/02/22/weak_ptr-and-event-cleanup.html
 // * void weak_ptr for the guarantor token - is this ok? basically we don't care about the type of the thing the weak_ptr is pointing to, we
 //   only use it as a 'guarantor' of the callback being alive - obviously if we mess it up at call time and the 'guarantor' token doesn't really guarantee callback lifetime then we have an issue?
 // * variadic templates - Invoke, cool - not cool?
-// * best way to make it thread-safe?
+// * thread safety: the callback list is copy-on-write - Invoke takes a reference to the current (immutable) list and walks it
+//   without any locks held, Add/Remove build a new list under m_mutex; so they can all be called from any thread, and from
+//   within a callback (changes apply from the next Invoke, except that removed callbacks are never called again)
 // * exceptions? yay nay? nay for now
-// * callback invoke order - should it be deterministic (at the moment it's reverse of add but can change as a result of removal)
+// * callback invoke order - reverse of add, deterministic
 // * function naming - does something else make more sense?
-// * AddWithToken - what to do during recursion?
-// * Remove - is current thing to do during recursion ok?
 // * deleted copy/assignment operators so we can just make event variables publically accessible without someone messing them up - kool/not kool?
 
 
 namespace VertexAsylum
 {
-    // Event dispatcher with lazy removal
+    // Event dispatcher with lazy removal; Invoke doesn't allocate (callbacks are stored in vaInplaceFunction, and only Add,
+    // Remove and cleanup of expired callbacks build a new list)
     template< typename FunctionType >
     class vaEvent final 
     {
+    public:
+        // enough for a std::function or a lambda capturing a handful of pointers
+        static const size_t                 c_callbackCapacity  = 64;
+        typedef vaInplaceFunction< FunctionType, c_callbackCapacity >   CallbackType;
+
     private:
         struct CallbackItem
         {
-            weak_ptr<void>              GuarantorToken;
-            std::function<FunctionType> Callback;
+            weak_ptr<void>                  GuarantorToken;
+            bool                            HasToken;           // false for AddStatic ones, which skip the weak_ptr lock
+            atomic_bool                     Removed;            // set by Remove so that lists still being invoked skip it
+            CallbackType                    Callback;
+
+            CallbackItem( const weak_ptr<void> & guarantorToken, bool hasToken, CallbackType && callback ) : GuarantorToken( guarantorToken ), HasToken( hasToken ), Removed( false ), Callback( std::move( callback ) ) { }
         };
-        std::vector<CallbackItem>   m_callbacks;
+        typedef vector< shared_ptr<CallbackItem> >  CallbackList;
+
+        // null when empty; never modified once published
+        shared_ptr<const CallbackList>      m_callbacks;
+        mutable mutex                       m_mutex;
 
-        int32                       m_recursionDepth    = 0;
+        atomic_bool                         m_expiredFound      { false };
+        atomic_int32                        m_activeInvokes     { 0 };
 
     public:
         vaEvent( )                  { }
-        ~vaEvent( )                 { assert( m_recursionDepth == 0 ); }
+        ~vaEvent( )                 { assert( m_activeInvokes == 0 ); }
 
         vaEvent( const vaEvent & )                  = delete;
         vaEvent & operator = ( const vaEvent & )    = delete;
@@ -65,58 +82,48 @@ namespace VertexAsylum
         template <typename ... ArgsType >
         void Invoke( ArgsType && ... args )
         {
-            // recursive mutex here?
+            shared_ptr<const CallbackList> callbacks = GetCallbacks( );
+            if( callbacks == nullptr )
+                return;
 
-            m_recursionDepth++;
+            m_activeInvokes++;
 
-            bool removalNeeded = false;
-
-            for( int i = (int)m_callbacks.size( )-1; i >= 0 ; i-- )
+            bool expiredFound = false;
+            for( int i = (int)callbacks->size( )-1; i >= 0 ; i-- )
             {
-                shared_ptr<void> lockedToken = m_callbacks[i].GuarantorToken.lock();
-                if( lockedToken != nullptr )
+                const CallbackItem & item = *(*callbacks)[i];
+                if( item.Removed )
+                    continue;
+                if( !item.HasToken )
                 {
-                     m_callbacks[i].Callback(std::forward<ArgsType>(args)...);
+                    item.Callback( args... );
+                    continue;
                 }
+                shared_ptr<void> lockedToken = item.GuarantorToken.lock();
+                if( lockedToken != nullptr )
+                    item.Callback( args... );
                 else
-                    removalNeeded = true;
+                    expiredFound = true;
             }
 
-            // only allow removal if we're not being called recursively (rec depth is 1)
-            if( removalNeeded && (m_recursionDepth == 1) )
+            m_activeInvokes--;
+            assert( m_activeInvokes >= 0 );
+
+            // drop expired ones now rather than on every later Invoke; only the first invoker to notice does it
+            if( expiredFound && !m_expiredFound.exchange( true ) )
             {
-                assert( m_recursionDepth == 1 );
-                for( int i = (int)m_callbacks.size( )-1; i >= 0 ; i-- )
-                {
-                    shared_ptr<void> lockedToken = m_callbacks[i].GuarantorToken.lock();
-                    
-                    if( lockedToken == nullptr )
-                    {
-                        // if this bit is slow, we could 'if-last-erase, if-not-last-swap-with-last-and-erase' but this would reshuffle
-                        // the call order which otherwise is deterministic and same reverse of the 'Add' order. do we want to do this? 
-                        // not sure, maybe if needed.
-                        // also, instead of 'removalNeeded' - we could collect indices of that need removing in a stack buffer but
-                        // I honestly doubt this will ever be a performance bottleneck.
-
-                        // just erase it
-                        m_callbacks.erase( m_callbacks.begin() + i );
-                    }
-                }
+                std::unique_lock<mutex> lock( m_mutex );
+                m_expiredFound = false;
+                RemoveIfNoLock( [ ]( const CallbackItem & item ) { return item.HasToken && item.GuarantorToken.expired( ); } );
             }
-
-            m_recursionDepth--;
-            assert( m_recursionDepth >= 0 );
         }
 
         // 'Naked' add callback; caller ensures that the guarantorToken guarantees callback validity (can be weak_ptr to this->shared_from_this() or a member variable, etc.)
         // Generic add example with automatic parameters (could be made into a macro?):
         //      Event_Something.Add( myObject.m_tokenSharedPtr, [](auto && ...params) {myObject->OnTick(params...);} );
-        void AddWithToken( const weak_ptr<void> & guarantorToken, const std::function<FunctionType> & callback )
+        void AddWithToken( const weak_ptr<void> & guarantorToken, CallbackType callback )
         { 
-            // adding while in recursion? might actually not be bad because we're reverse-iterating but since we haven't thought it through, let's assert here
-            assert( m_recursionDepth == 0 );
-
-            m_callbacks.push_back( { guarantorToken, callback } ); 
+            AddInternal( guarantorToken, true, std::move( callback ) );
         }
 
         // Automatic 'Naked' version for member-to-objects (if guarantor is not the shared_ptr to object itself)
@@ -137,40 +144,83 @@ namespace VertexAsylum
             AddWithToken( objectSharedPtr, objectSharedPtr.get(), objectMemberCallback );
         }
 
+        // For listeners that outlive the event (free functions, globals, singletons created before and destroyed after it):
+        // no guarantor token, so no weak_ptr lock per Invoke. Only removed by RemoveAll.
+        void AddStatic( CallbackType callback )
+        {
+            AddInternal( weak_ptr<void>( ), false, std::move( callback ) );
+        }
+
         // will also remove all items with <null> tokens so use the empty pointer for preemptive removal if needed for any reason (clearing of lambda storage & references?)
         void Remove( const weak_ptr<void> & tokenToRemove )
         { 
-            // removing while in recursion? the below should be handling it OK but I'm not 100% sure it's ok, so step through it and verify before removing assert
-            assert( m_recursionDepth == 0 );
-
-            for( int i = (int)m_callbacks.size( )-1; i >= 0 ; i-- )
-            {
-                shared_ptr<void> lockedToken = m_callbacks[i].GuarantorToken.lock();
-                if( lockedToken == nullptr || lockedToken == tokenToRemove.lock() )
-                {
-                    if( m_recursionDepth == 0 )
-                        m_callbacks.erase( m_callbacks.begin() + i );   // remove right now
-                    else
-                        m_callbacks[i].GuarantorToken.reset();                   // just make sure it's never invoked again
+            shared_ptr<void> lockedTokenToRemove = tokenToRemove.lock();
 
-                    // don't break though, let it loop and clear all in case of multiple callbacks with the same token, which should be legal
-                }
-            }
+            std::unique_lock<mutex> lock( m_mutex );
+            // don't stop at the first one, clear all in case of multiple callbacks with the same token, which should be legal
+            RemoveIfNoLock( [ &lockedTokenToRemove ]( const CallbackItem & item ) 
+            { 
+                if( !item.HasToken )
+                    return false;
+                shared_ptr<void> lockedToken = item.GuarantorToken.lock();
+                return lockedToken == nullptr || lockedToken == lockedTokenToRemove;
+            } );
         }
 
         void RemoveAll( )
         { 
-            // removing while in recursion? the below should be handling it OK but I'm not 100% sure it's ok, so step through it and verify before removing assert
-            assert( m_recursionDepth == 0 );
+            std::unique_lock<mutex> lock( m_mutex );
+            RemoveIfNoLock( [ ]( const CallbackItem & ) { return true; } );
+        }
+
+        bool IsEmpty( ) const
+        {
+            return GetCallbacks( ) == nullptr;
+        }
+
+    private:
+        shared_ptr<const CallbackList> GetCallbacks( ) const
+        {
+            // only held for the reference count increment
+            std::unique_lock<mutex> lock( m_mutex );
+            return m_callbacks;
+        }
+
+        void AddInternal( const weak_ptr<void> & guarantorToken, bool hasToken, CallbackType && callback )
+        {
+            shared_ptr<CallbackItem> newItem = std::make_shared<CallbackItem>( guarantorToken, hasToken, std::move( callback ) );
+
+            std::unique_lock<mutex> lock( m_mutex );
+            shared_ptr<CallbackList> newCallbacks = std::make_shared<CallbackList>( );
+            newCallbacks->reserve( ( ( m_callbacks != nullptr ) ? ( m_callbacks->size( ) ) : ( 0 ) ) + 1 );
+            if( m_callbacks != nullptr )
+                newCallbacks->insert( newCallbacks->end( ), m_callbacks->begin( ), m_callbacks->end( ) );
+            newCallbacks->push_back( newItem );
+            m_callbacks = newCallbacks;
+        }
+
+        template< typename PredicateType >
+        void RemoveIfNoLock( PredicateType && predicate )
+        {
+            m_mutex.assert_locked_by_caller( );
+            if( m_callbacks == nullptr )
+                return;
 
-            for( int i = (int)m_callbacks.size( )-1; i >= 0 ; i-- )
+            shared_ptr<CallbackList> newCallbacks = std::make_shared<CallbackList>( );
+            for( const shared_ptr<CallbackItem> & item : *m_callbacks )
             {
-                if( m_recursionDepth == 0 )
-                    m_callbacks.erase( m_callbacks.begin() + i );   // remove right now
+                if( predicate( *item ) )
+                    item->Removed = true;       // in case it's in the middle of being invoked (by this or another thread)
                 else
-                    m_callbacks[i].GuarantorToken.reset();                   // just make sure it's never invoked again
+                    newCallbacks->push_back( item );
             }
+            if( newCallbacks->size( ) == m_callbacks->size( ) )
+                return;
+            if( newCallbacks->empty( ) )
+                m_callbacks = nullptr;
+            else
+                m_callbacks = newCallbacks;
         }
     };
 
-}
\ No newline at end of file
+}
@@ -25,8 +25,131 @@ using namespace VertexAsylum;
 
 #include "IntegratedExternals/vaAssimpIntegration.h"
 
+#include "IntegratedExternals/vaImguiIntegration.h"
+
+#include "Core/System/vaFileStream.h"
+#include "Core/vaStringTools.h"
+#include "Core/vaLog.h"
+#include "Core/vaMath.h"
+
+#include <new>
+
 _CrtMemState s_memStateStart;
 
+#ifdef VA_MEMORY_TRACKING_ENABLED
+
+thread_local vaMemoryTag vaMemory::s_currentTag = vaMemoryTag::Untagged;
+
+namespace
+{
+    // all counters are plain atomics with constant initialization so they're usable by allocations made during static init
+    struct vaMemoryTagCounters
+    {
+        std::atomic<int64>      LiveBytes;
+        std::atomic<int64>      PeakBytes;
+        std::atomic<int64>      LiveAllocations;
+        std::atomic<int64>      TotalAllocations;
+        std::atomic<int64>      FrameAllocations;
+        std::atomic<int64>      FrameAllocatedBytes;
+        std::atomic<int64>      LastFrameAllocations;
+        std::atomic<int64>      LastFrameAllocatedBytes;
+    };
+    vaMemoryTagCounters         s_tagCounters[(int)vaMemoryTag::MaxValue];
+
+    // Prepended to every tracked allocation; 16 bytes so the returned pointer keeps malloc's alignment. All non-aligned
+    // operator new versions are replaced below (including the CRT debug 'new( _NORMAL_BLOCK, ... )' ones), so every
+    // pointer that reaches the matching operator delete has this header; the marker is only there to catch bugs.
+    struct vaAllocationHeader
+    {
+        uint64                  Size;
+        uint32                  Marker;
+        vaMemoryTag             Tag;
+        uint8                   Padding[3];
+    };
+    static_assert( sizeof(vaAllocationHeader) == 16, "header must preserve malloc alignment" );
+    const uint32                c_allocationMarker          = 0x6D656D76;   // 'vmem'
+
+    inline void * TrackedAlloc( size_t size )
+    {
+        vaAllocationHeader * header = (vaAllocationHeader *)malloc( size + sizeof(vaAllocationHeader) );
+        if( header == nullptr )
+            return nullptr;
+
+        vaMemoryTag tag     = vaMemory::GetCurrentTag( );
+        header->Size        = size;
+        header->Marker      = c_allocationMarker;
+        header->Tag         = tag;
+
+        vaMemoryTagCounters & counters = s_tagCounters[(int)tag];
+        int64 liveBytes = counters.LiveBytes.fetch_add( (int64)size, std::memory_order_relaxed ) + (int64)size;
+        int64 peakBytes = counters.PeakBytes.load( std::memory_order_relaxed );
+        while( liveBytes > peakBytes && !counters.PeakBytes.compare_exchange_weak( peakBytes, liveBytes, std::memory_order_relaxed ) ) { }
+        counters.LiveAllocations.fetch_add( 1, std::memory_order_relaxed );
+        counters.TotalAllocations.fetch_add( 1, std::memory_order_relaxed );
+        counters.FrameAllocations.fetch_add( 1, std::memory_order_relaxed );
+        counters.FrameAllocatedBytes.fetch_add( (int64)size, std::memory_order_relaxed );
+
+        return header + 1;
+    }
+
+    inline void TrackedFree( void * ptr )
+    {
+        if( ptr == nullptr )
+            return;
+
+        vaAllocationHeader * header = ((vaAllocationHeader *)ptr) - 1;
+        if( header->Marker != c_allocationMarker )
+        {
+            // not from TrackedAlloc (or freed twice): a mismatched new/delete pair, or an allocator we don't replace;
+            // leaking is the only safe option as there's no way to tell how it was allocated
+            assert( false );
+            return;
+        }
+        header->Marker = 0;
+
+        vaMemoryTagCounters & counters = s_tagCounters[(int)header->Tag];
+        counters.LiveBytes.fetch_sub( (int64)header->Size, std::memory_order_relaxed );
+        counters.LiveAllocations.fetch_sub( 1, std::memory_order_relaxed );
+
+        free( header );
+    }
+
+    inline void * TrackedAllocOrThrow( size_t size )
+    {
+        void * ptr = TrackedAlloc( size );
+        if( ptr == nullptr )
+            throw std::bad_alloc( );
+        return ptr;
+    }
+}
+
+// Global allocation hooks; over-aligned (std::align_val_t) versions are left to the CRT and are not tracked (their deletes
+// are separate overloads too, so those pointers never reach TrackedFree).
+#pragma push_macro( "new" )
+#undef new
+void * operator new( size_t size )                                          { return TrackedAllocOrThrow( size ); }
+void * operator new[]( size_t size )                                        { return TrackedAllocOrThrow( size ); }
+void * operator new( size_t size, const std::nothrow_t & ) noexcept         { return TrackedAlloc( size ); }
+void * operator new[]( size_t size, const std::nothrow_t & ) noexcept       { return TrackedAlloc( size ); }
+void operator delete( void * ptr ) noexcept                                 { TrackedFree( ptr ); }
+void operator delete[]( void * ptr ) noexcept                               { TrackedFree( ptr ); }
+void operator delete( void * ptr, size_t ) noexcept                         { TrackedFree( ptr ); }
+void operator delete[]( void * ptr, size_t ) noexcept                       { TrackedFree( ptr ); }
+void operator delete( void * ptr, const std::nothrow_t & ) noexcept         { TrackedFree( ptr ); }
+void operator delete[]( void * ptr, const std::nothrow_t & ) noexcept       { TrackedFree( ptr ); }
+
+#if defined(DEBUG) || defined(_DEBUG)
+// _CRTDBG_MAP_ALLOC_NEW versions (see vaCore.h); the CRT's own would allocate with _malloc_dbg and without our header
+void * operator new( size_t size, int, const char *, int )                  { return TrackedAllocOrThrow( size ); }
+void * operator new[]( size_t size, int, const char *, int )                { return TrackedAllocOrThrow( size ); }
+void operator delete( void * ptr, int, const char *, int ) noexcept         { TrackedFree( ptr ); }
+void operator delete[]( void * ptr, int, const char *, int ) noexcept       { TrackedFree( ptr ); }
+#endif
+
+#pragma pop_macro( "new" )
+
+#endif // VA_MEMORY_TRACKING_ENABLED
+
 void vaMemory::Initialize( )
 {
 
@@ -93,4 +216,261 @@ void vaMemory::Deinitialize()
 #endif
 }
 
+const char * vaMemory::GetTagName( vaMemoryTag tag )
+{
+    switch( tag )
+    {
+    case vaMemoryTag::Untagged:     return "Untagged";
+    case vaMemoryTag::AssetPack:    return "AssetPack";
+    case vaMemoryTag::Scene:        return "Scene";
+    case vaMemoryTag::Rendering:    return "Rendering";
+    case vaMemoryTag::CMAA2:        return "CMAA2";
+    case vaMemoryTag::UI:           return "UI";
+    case vaMemoryTag::Benchmarks:   return "Benchmarks";
+    default: assert( false );       return "Unknown";
+    }
+}
+
+bool vaMemory::GetTagStats( vaMemoryTag tag, vaMemoryTagStats & outStats )
+{
+    outStats = vaMemoryTagStats( );
+    assert( (int)tag >= 0 && tag < vaMemoryTag::MaxValue );
+#ifdef VA_MEMORY_TRACKING_ENABLED
+    const vaMemoryTagCounters & counters = s_tagCounters[(int)tag];
+    outStats.LiveBytes                  = counters.LiveBytes.load( std::memory_order_relaxed );
+    outStats.PeakBytes                  = counters.PeakBytes.load( std::memory_order_relaxed );
+    outStats.LiveAllocations            = counters.LiveAllocations.load( std::memory_order_relaxed );
+    outStats.TotalAllocations           = counters.TotalAllocations.load( std::memory_order_relaxed );
+    outStats.LastFrameAllocations       = counters.LastFrameAllocations.load( std::memory_order_relaxed );
+    outStats.LastFrameAllocatedBytes    = counters.LastFrameAllocatedBytes.load( std::memory_order_relaxed );
+    return true;
+#else
+    return false;
+#endif
+}
+
+void vaMemory::NewFrame( )
+{
+    vaFrameArena::NewFrame( );
+
+#ifdef VA_MEMORY_TRACKING_ENABLED
+    for( vaMemoryTagCounters & counters : s_tagCounters )
+    {
+        counters.LastFrameAllocations.store( counters.FrameAllocations.exchange( 0, std::memory_order_relaxed ), std::memory_order_relaxed );
+        counters.LastFrameAllocatedBytes.store( counters.FrameAllocatedBytes.exchange( 0, std::memory_order_relaxed ), std::memory_order_relaxed );
+    }
+#endif
+}
+
+void vaMemory::InsertImGuiContent( )
+{
+#ifdef VA_IMGUI_INTEGRATION_ENABLED
+    if( !IsTrackingEnabled( ) )
+    {
+        ImGui::TextWrapped( "Allocation tracking disabled; enable with VA_MEMORY_TRACKING_ENABLED in vaConfig.h" );
+        return;
+    }
+
+    ImGui::Columns( 5, "vaMemoryStats", true );
+    ImGui::Text( "Tag" );               ImGui::NextColumn( );
+    ImGui::Text( "Live (KB)" );         ImGui::NextColumn( );
+    ImGui::Text( "Peak (KB)" );         ImGui::NextColumn( );
+    ImGui::Text( "Live allocs" );       ImGui::NextColumn( );
+    ImGui::Text( "Allocs/frame" );      ImGui::NextColumn( );
+    ImGui::Separator( );
+    for( int i = 0; i < (int)vaMemoryTag::MaxValue; i++ )
+    {
+        vaMemoryTagStats stats;
+        GetTagStats( (vaMemoryTag)i, stats );
+        ImGui::Text( "%s", GetTagName( (vaMemoryTag)i ) );                  ImGui::NextColumn( );
+        ImGui::Text( "%.1f", stats.LiveBytes / 1024.0 );                    ImGui::NextColumn( );
+        ImGui::Text( "%.1f", stats.PeakBytes / 1024.0 );                    ImGui::NextColumn( );
+        ImGui::Text( "%lld", stats.LiveAllocations );                       ImGui::NextColumn( );
+        ImGui::Text( "%lld", stats.LastFrameAllocations );                  ImGui::NextColumn( );
+    }
+    ImGui::Columns( 1 );
+
+    if( ImGui::Button( "Save memory stats CSV" ) )
+        SaveStatsCSV( vaCore::GetExecutableDirectory( ) + L"memory_stats.csv" );
+#endif
+}
+
+bool vaMemory::SaveStatsCSV( const wstring & filePath )
+{
+    if( !IsTrackingEnabled( ) )
+    {
+        VA_LOG_WARNING( L"vaMemory::SaveStatsCSV - allocation tracking not enabled (VA_MEMORY_TRACKING_ENABLED)" );
+        return false;
+    }
 
+    string text = "Tag, Live bytes, Peak bytes, Live allocations, Total allocations, Last frame allocations, Last frame allocated bytes\n";
+    for( int i = 0; i < (int)vaMemoryTag::MaxValue; i++ )
+    {
+        vaMemoryTagStats stats;
+        GetTagStats( (vaMemoryTag)i, stats );
+        text += vaStringTools::Format( "%s, %lld, %lld, %lld, %lld, %lld, %lld\n", GetTagName( (vaMemoryTag)i ), stats.LiveBytes, stats.PeakBytes, 
+            stats.LiveAllocations, stats.TotalAllocations, stats.LastFrameAllocations, stats.LastFrameAllocatedBytes );
+    }
+
+    vaFileStream outFile;
+    if( !outFile.Open( filePath, FileCreationMode::Create ) || !outFile.WriteTXT( text ) )
+    {
+        VA_LOG_WARNING( L"vaMemory::SaveStatsCSV - unable to write '%s'", filePath.c_str( ) );
+        return false;
+    }
+    VA_LOG( L"vaMemory: stats saved to '%s'", filePath.c_str( ) );
+    return true;
+}
+
+vaLinearArena::~vaLinearArena( )
+{
+    while( m_currentBlock != nullptr )
+    {
+        BlockHeader * previous = m_currentBlock->Previous;
+        ::operator delete( m_currentBlock );
+        m_currentBlock = previous;
+    }
+}
+
+void * vaLinearArena::AllocateSlow( size_t size, size_t alignment )
+{
+    // 'size + alignment' guarantees the aligned allocation fits regardless of where the block data starts
+    size_t blockSize = vaMath::Max( m_minBlockSize, size + alignment );
+    if( m_currentBlock != nullptr )
+    {
+        blockSize = vaMath::Max( blockSize, m_currentBlock->Size * 2 );
+        m_usedInPreviousBlocks += m_top - (uintptr_t)( m_currentBlock + 1 );
+    }
+
+    BlockHeader * block = (BlockHeader *)::operator new( sizeof(BlockHeader) + blockSize );
+    block->Previous     = m_currentBlock;
+    block->Size         = blockSize;
+    m_currentBlock      = block;
+    m_top               = (uintptr_t)( block + 1 );
+    m_end               = m_top + blockSize;
+
+    return Allocate( size, alignment );
+}
+
+void vaLinearArena::Reset( )
+{
+    m_peakUsage = vaMath::Max( m_peakUsage, GetUsedBytes( ) );
+
+    // more than one block used since the last reset? replace them all with one that fits everything
+    if( m_currentBlock != nullptr && m_currentBlock->Previous != nullptr )
+    {
+        size_t totalSize = 0;
+        while( m_currentBlock != nullptr )
+        {
+            BlockHeader * previous = m_currentBlock->Previous;
+            totalSize += m_currentBlock->Size;
+            ::operator delete( m_currentBlock );
+            m_currentBlock = previous;
+        }
+
+        BlockHeader * block = (BlockHeader *)::operator new( sizeof(BlockHeader) + totalSize );
+        block->Previous     = nullptr;
+        block->Size         = totalSize;
+        m_currentBlock      = block;
+    }
+
+    m_usedInPreviousBlocks  = 0;
+    m_lastAllocation        = 0;
+    m_top                   = ( m_currentBlock != nullptr ) ? ( (uintptr_t)( m_currentBlock + 1 ) ) : ( 0 );
+    m_end                   = ( m_currentBlock != nullptr ) ? ( m_top + m_currentBlock->Size ) : ( 0 );
+}
+
+atomic_uint64 vaFrameArena::s_frameIndex = 0;
+
+namespace
+{
+    struct vaFrameArenaThreadContext
+    {
+        vaLinearArena           Arenas[vaFrameArena::c_framesInFlight];
+        uint64                  ArenaFrameIndices[vaFrameArena::c_framesInFlight];
+
+        vaFrameArenaThreadContext( )
+        {
+            for( uint64 & frameIndex : ArenaFrameIndices )
+                frameIndex = ~uint64(0);
+        }
+    };
+}
+
+void * vaFrameArena::Allocate( size_t size, size_t alignment )
+{
+    thread_local vaFrameArenaThreadContext context;
+
+    uint64 frameIndex   = GetFrameIndex( );
+    int arenaIndex      = (int)( frameIndex % c_framesInFlight );
+    vaLinearArena & arena = context.Arenas[arenaIndex];
+    if( context.ArenaFrameIndices[arenaIndex] != frameIndex )
+    {
+        // last used c_framesInFlight (or more) frames ago, so nothing in it can be alive anymore
+        arena.Reset( );
+        context.ArenaFrameIndices[arenaIndex] = frameIndex;
+    }
+    return arena.Allocate( size, alignment );
+}
+
+vaFixedSizePool::~vaFixedSizePool( )
+{
+    assert( m_liveBlocks == 0 );    // can't really happen with vaPoolAllocator since it keeps the pool alive
+    for( void * slab : m_slabs )
+        ::operator delete( slab );
+}
+
+void * vaFixedSizePool::Allocate( size_t size, size_t alignment )
+{
+    std::unique_lock<mutex> lock( m_mutex );
+
+    if( m_blockSize == 0 )
+    {
+        m_blockSize         = ( vaMath::Max( size, sizeof(FreeBlock) ) + alignof(std::max_align_t) - 1 ) & ~( alignof(std::max_align_t) - 1 );
+        m_blockAlignment    = alignof(std::max_align_t);
+    }
+    if( !Fits( size, alignment ) )
+    {
+        assert( false );    // pool used for different types? it'll work but there's no point
+        lock.unlock( );
+        return ::operator new( size );
+    }
+
+    if( m_freeList == nullptr )
+    {
+        uint8 * slab = (uint8 *)::operator new( m_blockSize * c_blocksPerSlab );
+        m_slabs.push_back( slab );
+        // link in reverse so that blocks get handed out in address order
+        for( int i = c_blocksPerSlab - 1; i >= 0; i-- )
+        {
+            FreeBlock * block   = (FreeBlock *)( slab + i * m_blockSize );
+            block->Next         = m_freeList;
+            m_freeList          = block;
+        }
+    }
+
+    FreeBlock * block = m_freeList;
+    m_freeList = block->Next;
+    m_liveBlocks++;
+    return block;
+}
+
+void vaFixedSizePool::Free( void * ptr, size_t size )
+{
+    if( ptr == nullptr )
+        return;
+
+    std::unique_lock<mutex> lock( m_mutex );
+    if( !Fits( size, 0 ) )
+    {
+        lock.unlock( );
+        ::operator delete( ptr );
+        return;
+    }
+
+    FreeBlock * block   = (FreeBlock *)ptr;
+    block->Next         = m_freeList;
+    m_freeList          = block;
+    m_liveBlocks--;
+    assert( m_liveBlocks >= 0 );
+}
@@ -21,18 +21,91 @@
 
 #include "vaCore.h"
 
+#include <cstddef>
+
 
 namespace VertexAsylum
 {
+    // Subsystem tags used for allocation accounting (see VA_MEMORY_TRACKING_ENABLED in vaConfig.h); allocations are
+    // attributed to the tag of the innermost VA_MEMORY_TAG_SCOPE on the allocating thread, and frees go back to the
+    // tag the allocation was made with, regardless of which thread/scope frees it.
+    enum class vaMemoryTag : uint8
+    {
+        Untagged,
+        AssetPack,
+        Scene,
+        Rendering,
+        CMAA2,
+        UI,
+        Benchmarks,             // vaCoreBenchmarks, for counting allocations of the measured code
+
+        MaxValue
+    };
+
+    struct vaMemoryTagStats
+    {
+        int64                   LiveBytes                   = 0;
+        int64                   PeakBytes                   = 0;
+        int64                   LiveAllocations             = 0;
+        int64                   TotalAllocations            = 0;
+        int64                   LastFrameAllocations        = 0;        // number of allocations made during the last complete frame
+        int64                   LastFrameAllocatedBytes     = 0;
+    };
+
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // vaMemory
     class vaMemory
     {
+#ifdef VA_MEMORY_TRACKING_ENABLED
+        static thread_local vaMemoryTag s_currentTag;
+#endif
+
     private:
        friend class vaCore;
 
        static void						Initialize( );
        static void						Deinitialize( );
+
+    public:
+        static constexpr bool           IsTrackingEnabled( )
+        {
+#ifdef VA_MEMORY_TRACKING_ENABLED
+            return true;
+#else
+            return false;
+#endif
+        }
+
+#ifdef VA_MEMORY_TRACKING_ENABLED
+        static vaMemoryTag              GetCurrentTag( )                        { return s_currentTag; }
+        static void                     SetCurrentTag( vaMemoryTag tag )        { s_currentTag = tag; }
+#else
+        static vaMemoryTag              GetCurrentTag( )                        { return vaMemoryTag::Untagged; }
+        static void                     SetCurrentTag( vaMemoryTag tag )        { tag; }
+#endif
+
+        static const char *             GetTagName( vaMemoryTag tag );
+
+        // returns false (and zeroed stats) if tracking is not enabled
+        static bool                     GetTagStats( vaMemoryTag tag, vaMemoryTagStats & outStats );
+
+        // closes per-frame allocation counters and advances vaFrameArena; called once per frame from the main loop
+        static void                     NewFrame( );
+
+        static void                     InsertImGuiContent( );
+        static bool                     SaveStatsCSV( const wstring & filePath );
+    };
+
+    // RAII helper used by VA_MEMORY_TAG_SCOPE
+    class vaMemoryTagScope
+    {
+        const vaMemoryTag       m_previousTag;
+    public:
+        explicit vaMemoryTagScope( vaMemoryTag tag ) : m_previousTag( vaMemory::GetCurrentTag( ) )  { vaMemory::SetCurrentTag( tag ); }
+        ~vaMemoryTagScope( )                                                                        { vaMemory::SetCurrentTag( m_previousTag ); }
+
+        vaMemoryTagScope( const vaMemoryTagScope & ) = delete;
+        vaMemoryTagScope & operator = ( const vaMemoryTagScope & ) = delete;
     };
 
     // Just a simple generic self-contained memory buffer helper class, for passing data as argument, etc.
@@ -106,4 +179,254 @@ namespace VertexAsylum
         int64       GetSize( ) const        { return m_bufferSize; }
     };
 
-}
\ No newline at end of file
+    // Linear (bump) allocator: allocations are just a pointer increment, individual frees are no-ops (except for the
+    // most recent allocation, which gets rolled back so that growing containers don't waste space) and everything is
+    // released at once with Reset( ). Reset( ) keeps the memory (merging multiple blocks into one) so after warm-up
+    // there are no heap allocations. Not thread safe.
+    class vaLinearArena
+    {
+        struct BlockHeader
+        {
+            BlockHeader *           Previous;
+            size_t                  Size;           // usable size, not including the header
+        };
+        static_assert( sizeof(BlockHeader) == 16, "block data must keep malloc alignment" );
+
+        BlockHeader *               m_currentBlock          = nullptr;
+        uintptr_t                   m_top                   = 0;
+        uintptr_t                   m_end                   = 0;
+        uintptr_t                   m_lastAllocation        = 0;
+        size_t                      m_usedInPreviousBlocks  = 0;
+        size_t                      m_peakUsage             = 0;
+        const size_t                m_minBlockSize;
+
+    public:
+        explicit vaLinearArena( size_t minBlockSize = 64 * 1024 ) : m_minBlockSize( minBlockSize ) { }
+        ~vaLinearArena( );
+
+        vaLinearArena( const vaLinearArena & ) = delete;
+        vaLinearArena & operator = ( const vaLinearArena & ) = delete;
+
+    public:
+        inline void *               Allocate( size_t size, size_t alignment = alignof(std::max_align_t) );
+        inline void                 Free( void * ptr, size_t size );
+
+        // all memory allocated so far becomes invalid
+        void                        Reset( );
+
+        size_t                      GetUsedBytes( ) const       { return m_usedInPreviousBlocks + ( ( m_currentBlock != nullptr ) ? ( m_top - (uintptr_t)( m_currentBlock + 1 ) ) : ( 0 ) ); }
+        size_t                      GetPeakUsedBytes( ) const   { size_t used = GetUsedBytes( ); return ( used > m_peakUsage ) ? ( used ) : ( m_peakUsage ); }
+
+    private:
+        void *                      AllocateSlow( size_t size, size_t alignment );
+    };
+
+    inline void * vaLinearArena::Allocate( size_t size, size_t alignment )
+    {
+        assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+        uintptr_t ptr = ( m_top + ( alignment - 1 ) ) & ~(uintptr_t)( alignment - 1 );
+        if( m_currentBlock == nullptr || ptr + size > m_end )
+            return AllocateSlow( size, alignment );
+        m_lastAllocation    = ptr;
+        m_top               = ptr + size;
+        return (void*)ptr;
+    }
+
+    inline void vaLinearArena::Free( void * ptr, size_t size )
+    {
+        // only the last allocation can be given back
+        if( ptr != nullptr && (uintptr_t)ptr == m_lastAllocation && m_lastAllocation + size == m_top )
+        {
+            m_top           = m_lastAllocation;
+            m_lastAllocation= 0;
+        }
+    }
+
+#if defined(_MSC_VER) && ( _ITERATOR_DEBUG_LEVEL != 0 )
+    // MSVC's checked iterators allocate a small 'container proxy' through the container's allocator on construction and
+    // only free it on destruction, so it has to outlive any arena reset - arena allocators send it to the regular heap
+    template< typename T > struct vaIsContainerProxy : std::is_same< T, std::_Container_proxy > { };
+#else
+    template< typename T > struct vaIsContainerProxy : std::false_type { };
+#endif
+
+    // std compatible allocator adapter for vaLinearArena; the arena must outlive the container and the container must
+    // be emptied (or destroyed) before the arena is Reset( ).
+    template< typename T >
+    class vaArenaAllocator
+    {
+        vaLinearArena *             m_arena;
+
+        template< typename U > friend class vaArenaAllocator;
+
+    public:
+        typedef T                   value_type;
+
+        explicit vaArenaAllocator( vaLinearArena & arena ) noexcept                 : m_arena( &arena ) { }
+        template< typename U >
+        vaArenaAllocator( const vaArenaAllocator<U> & other ) noexcept              : m_arena( other.m_arena ) { }
+
+        T *                         allocate( size_t count )
+        {
+            if( vaIsContainerProxy<T>::value )
+                return (T*)::operator new( count * sizeof(T) );
+            return (T*)m_arena->Allocate( count * sizeof(T), alignof(T) );
+        }
+        void                        deallocate( T * ptr, size_t count ) noexcept
+        {
+            if( vaIsContainerProxy<T>::value )
+                ::operator delete( ptr );
+            else
+                m_arena->Free( ptr, count * sizeof(T) );
+        }
+
+        vaLinearArena &             GetArena( ) const                               { return *m_arena; }
+
+        template< typename U >
+        bool                        operator == ( const vaArenaAllocator<U> & other ) const    { return m_arena == other.m_arena; }
+        template< typename U >
+        bool                        operator != ( const vaArenaAllocator<U> & other ) const    { return m_arena != other.m_arena; }
+    };
+
+    // Per-thread transient memory that is valid until the end of the frame after the one it was allocated in: each
+    // thread has c_framesInFlight arenas and recycles the oldest one on its first allocation in a new frame. Frames are
+    // advanced by vaMemory::NewFrame( ) from the main loop. Meant for data that gets rebuilt every frame (draw lists,
+    // render selections, etc.) - never keep anything allocated from here for longer.
+    class vaFrameArena
+    {
+    public:
+        static const int            c_framesInFlight    = 2;
+
+    private:
+        static atomic_uint64        s_frameIndex;
+
+        friend class vaMemory;
+
+    private:
+        vaFrameArena( )     { }
+        ~vaFrameArena( )    { }
+
+    public:
+        static void *               Allocate( size_t size, size_t alignment = alignof(std::max_align_t) );
+
+        static uint64               GetFrameIndex( )                                { return s_frameIndex.load( std::memory_order_relaxed ); }
+        // is memory that was allocated during 'frameIndex' still valid?
+        static bool                 IsFrameAlive( uint64 frameIndex )               { return ( GetFrameIndex( ) - frameIndex ) < (uint64)c_framesInFlight; }
+
+    private:
+        static void                 NewFrame( )                                     { s_frameIndex.fetch_add( 1, std::memory_order_relaxed ); }
+    };
+
+    // std compatible (stateless) allocator adapter for vaFrameArena; deallocation is a no-op. The container object itself
+    // can live longer than its storage (see vaRenderMeshDrawList) but must be emptied within a frame of being filled.
+    template< typename T >
+    class vaFrameAllocator
+    {
+    public:
+        typedef T                   value_type;
+
+        vaFrameAllocator( ) noexcept                                                { }
+        template< typename U >
+        vaFrameAllocator( const vaFrameAllocator<U> & ) noexcept                    { }
+
+        T *                         allocate( size_t count )
+        {
+            if( vaIsContainerProxy<T>::value )
+                return (T*)::operator new( count * sizeof(T) );
+            return (T*)vaFrameArena::Allocate( count * sizeof(T), alignof(T) );
+        }
+        void                        deallocate( T * ptr, size_t ) noexcept
+        {
+            if( vaIsContainerProxy<T>::value )
+                ::operator delete( ptr );
+        }
+
+        template< typename U >
+        bool                        operator == ( const vaFrameAllocator<U> & ) const   { return true; }
+        template< typename U >
+        bool                        operator != ( const vaFrameAllocator<U> & ) const   { return false; }
+    };
+
+    // Fixed size block pool: blocks are carved out of slabs of c_blocksPerSlab so objects allocated from the same pool end
+    // up next to each other in memory (in allocation order, until blocks start getting recycled). Block size is taken from
+    // the first allocation so that it can be used with std::allocate_shared, where the actual allocated type (object +
+    // control block) is only known after the allocator is rebound; bigger requests fall back to the heap. Thread safe.
+    class vaFixedSizePool
+    {
+    public:
+        static const int            c_blocksPerSlab         = 256;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *             Next;
+        };
+
+        mutable mutex               m_mutex;
+        size_t                      m_blockSize             = 0;
+        size_t                      m_blockAlignment        = 0;
+        FreeBlock *                 m_freeList              = nullptr;
+        vector<void *>              m_slabs;
+        int64                       m_liveBlocks            = 0;
+
+    public:
+        vaFixedSizePool( )          { }
+        ~vaFixedSizePool( );
+
+        vaFixedSizePool( const vaFixedSizePool & ) = delete;
+        vaFixedSizePool & operator = ( const vaFixedSizePool & ) = delete;
+
+    public:
+        void *                      Allocate( size_t size, size_t alignment );
+        void                        Free( void * ptr, size_t size );
+
+        int64                       GetLiveBlockCount( ) const          { std::unique_lock<mutex> lock( m_mutex ); return m_liveBlocks; }
+        size_t                      GetReservedBytes( ) const           { std::unique_lock<mutex> lock( m_mutex ); return m_slabs.size( ) * m_blockSize * c_blocksPerSlab; }
+
+    private:
+        bool                        Fits( size_t size, size_t alignment ) const     { return size <= m_blockSize && alignment <= m_blockAlignment; }
+    };
+
+    // std compatible allocator adapter for vaFixedSizePool, for use with std::allocate_shared; every copy (including the
+    // one stored in the shared_ptr control block) keeps the pool alive so objects can safely outlive their creator.
+    template< typename T >
+    class vaPoolAllocator
+    {
+        shared_ptr<vaFixedSizePool> m_pool;
+
+        template< typename U > friend class vaPoolAllocator;
+
+    public:
+        typedef T                   value_type;
+
+        explicit vaPoolAllocator( const shared_ptr<vaFixedSizePool> & pool ) noexcept  : m_pool( pool ) { assert( pool != nullptr ); }
+        template< typename U >
+        vaPoolAllocator( const vaPoolAllocator<U> & other ) noexcept                    : m_pool( other.m_pool ) { }
+
+        T *                         allocate( size_t count )
+        {
+            if( vaIsContainerProxy<T>::value )
+                return (T*)::operator new( count * sizeof(T) );
+            return (T*)m_pool->Allocate( count * sizeof(T), alignof(T) );
+        }
+        void                        deallocate( T * ptr, size_t count ) noexcept
+        {
+            if( vaIsContainerProxy<T>::value )
+                ::operator delete( ptr );
+            else
+                m_pool->Free( ptr, count * sizeof(T) );
+        }
+
+        template< typename U >
+        bool                        operator == ( const vaPoolAllocator<U> & other ) const     { return m_pool == other.m_pool; }
+        template< typename U >
+        bool                        operator != ( const vaPoolAllocator<U> & other ) const     { return m_pool != other.m_pool; }
+    };
+
+}
+
+#ifdef VA_MEMORY_TRACKING_ENABLED
+#define VA_MEMORY_TAG_SCOPE( tag )          VertexAsylum::vaMemoryTagScope VA_COMBINE( __va_memory_tag_scope_, __LINE__ )( VertexAsylum::vaMemoryTag::tag )
+#else
+#define VA_MEMORY_TAG_SCOPE( tag )
+#endif
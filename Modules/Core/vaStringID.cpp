@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "vaStringID.h"
+
+#include <cstddef>
+
+using namespace VertexAsylum;
+
+vaStringInterner::~vaStringInterner( )
+{
+    for( Shard & shard : m_shards )
+    {
+        std::unique_lock<std::shared_mutex> lock( shard.Mutex );
+        for( uint8 * block : shard.ArenaBlocks )
+            delete[] block;
+        shard.ArenaBlocks.clear( );
+        shard.Slots.clear( );
+        shard.Count = 0;
+    }
+}
+
+const vaStringID::Entry * vaStringInterner::FindNoMutexLock( const Shard & shard, const char * text, size_t length, uint64 hash )
+{
+    if( shard.Slots.size( ) == 0 )
+        return nullptr;
+    size_t mask = shard.Slots.size( ) - 1;
+    for( size_t i = SlotIndex( hash ) & mask; shard.Slots[i] != nullptr; i = ( i + 1 ) & mask )
+    {
+        const vaStringID::Entry * entry = shard.Slots[i];
+        if( entry->Hash == hash && entry->Length == length && memcmp( entry->Text, text, length ) == 0 )
+            return entry;
+    }
+    return nullptr;
+}
+
+void vaStringInterner::GrowNoMutexLock( Shard & shard )
+{
+    vector<const vaStringID::Entry *> oldSlots;
+    oldSlots.swap( shard.Slots );
+    shard.Slots.resize( vaMath::Max( (size_t)64, oldSlots.size( ) * 2 ), nullptr );
+
+    size_t mask = shard.Slots.size( ) - 1;
+    for( const vaStringID::Entry * entry : oldSlots )
+    {
+        if( entry == nullptr )
+            continue;
+        size_t i = SlotIndex( entry->Hash ) & mask;
+        while( shard.Slots[i] != nullptr )
+            i = ( i + 1 ) & mask;
+        shard.Slots[i] = entry;
+    }
+}
+
+vaStringID::Entry * vaStringInterner::AllocateNoMutexLock( Shard & shard, size_t length )
+{
+    const size_t alignment  = alignof( vaStringID::Entry );
+    const size_t size       = ( offsetof( vaStringID::Entry, Text ) + length + 1 + alignment - 1 ) & ~( alignment - 1 );
+
+    uint8 * memory;
+    if( size > c_arenaBlockSize / 4 )
+    {
+        // long strings get their own block so they don't waste the rest of the current one
+        memory = new uint8[size];
+        shard.ArenaBlocks.insert( shard.ArenaBlocks.end( ) - ( ( shard.ArenaBlocks.size( ) > 0 ) ? ( 1 ) : ( 0 ) ), memory );
+    }
+    else
+    {
+        if( shard.ArenaBlockUsed + size > c_arenaBlockSize )
+        {
+            shard.ArenaBlocks.push_back( new uint8[c_arenaBlockSize] );
+            shard.ArenaBlockUsed = 0;
+        }
+        memory = shard.ArenaBlocks.back( ) + shard.ArenaBlockUsed;
+        shard.ArenaBlockUsed += size;
+    }
+    shard.ArenaBytes += size;
+    return reinterpret_cast<vaStringID::Entry *>( memory );
+}
+
+vaStringID vaStringInterner::Find( const char * text, size_t length, uint64 hash ) const
+{
+    if( length == 0 )
+        return vaStringID( );
+    const Shard & shard = m_shards[ ShardIndex( hash ) ];
+    std::shared_lock<std::shared_mutex> lock( shard.Mutex );
+    return vaStringID( FindNoMutexLock( shard, text, length, hash ) );
+}
+
+vaStringID vaStringInterner::Intern( const char * text, size_t length, uint64 hash )
+{
+    if( length == 0 )
+        return vaStringID( );
+    assert( length <= 0xFFFFFFFF );
+
+    Shard & shard = m_shards[ ShardIndex( hash ) ];
+    {
+        std::shared_lock<std::shared_mutex> lock( shard.Mutex );
+        const vaStringID::Entry * entry = FindNoMutexLock( shard, text, length, hash );
+        if( entry != nullptr )
+            return vaStringID( entry );
+    }
+
+    std::unique_lock<std::shared_mutex> lock( shard.Mutex );
+    // someone could have added it between the locks
+    const vaStringID::Entry * existing = FindNoMutexLock( shard, text, length, hash );
+    if( existing != nullptr )
+        return vaStringID( existing );
+
+    if( ( shard.Count + 1 ) * 4 > (int)shard.Slots.size( ) * 3 )
+        GrowNoMutexLock( shard );
+
+    vaStringID::Entry * entry = AllocateNoMutexLock( shard, length );
+    entry->Hash     = hash;
+    entry->Length   = (uint32)length;
+    memcpy( entry->Text, text, length );
+    entry->Text[length] = 0;
+
+    size_t mask = shard.Slots.size( ) - 1;
+    size_t i = SlotIndex( hash ) & mask;
+    while( shard.Slots[i] != nullptr )
+        i = ( i + 1 ) & mask;
+    shard.Slots[i] = entry;
+    shard.Count++;
+
+    return vaStringID( entry );
+}
+
+int vaStringInterner::GetCount( ) const
+{
+    int count = 0;
+    for( const Shard & shard : m_shards )
+    {
+        std::shared_lock<std::shared_mutex> lock( shard.Mutex );
+        count += shard.Count;
+    }
+    return count;
+}
+
+size_t vaStringInterner::GetMemoryUsage( ) const
+{
+    size_t bytes = 0;
+    for( const Shard & shard : m_shards )
+    {
+        std::shared_lock<std::shared_mutex> lock( shard.Mutex );
+        bytes += shard.ArenaBytes + shard.Slots.capacity( ) * sizeof( shard.Slots[0] );
+    }
+    return bytes;
+}
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019, Intel Corporation
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated 
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation 
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to the following conditions:
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of 
+// the Software.
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+// SOFTWARE.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Author(s):  Filip Strugar (filip.strugar@intel.com)
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "vaCoreIncludes.h"
+#include "vaSingleton.h"
+
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace VertexAsylum
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // vaStringID is a handle to an interned (stored once, never freed until shutdown) string: copying is a pointer copy,
+    // equality is a pointer compare and the hash is precomputed, so it's a cheap key for maps & lookups of names that
+    // are compared a lot but rarely created (asset names, property names, profiler scope names, ...).
+    //  - IDs are only equal if the strings are equal (case sensitive); default constructed ID is the empty string.
+    //  - The text is pointer-stable and zero terminated for the lifetime of the vaStringInterner (created in
+    //    vaCore::Initialize, destroyed in vaCore::Deinitialize).
+    //  - operator < compares the pointers, not the text: fine for map keys but not for sorting by name (use CompareText).
+    //  - Use VA_STRING_ID( "literal" ) for literals - hashed at compile time and interned once per call site.
+    class vaStringID
+    {
+    public:
+        struct Entry
+        {
+            uint64                                  Hash;
+            uint32                                  Length;
+            char                                    Text[1];                        // actually Length+1, zero terminated
+        };
+
+    private:
+        const Entry *                               m_entry             = nullptr;  // nullptr for empty string
+
+        explicit vaStringID( const Entry * entry ) : m_entry( entry )   { }
+        friend class vaStringInterner;
+
+    public:
+        vaStringID( )                                                   { }
+        explicit vaStringID( const char * text );
+        vaStringID( const char * text, size_t length );
+        explicit vaStringID( const string & text );
+
+        // Returns the ID if the string was already interned, or an empty ID if it wasn't (without interning it) - for
+        // lookups with runtime strings where a never seen string can't be in the map anyway.
+        static vaStringID                           Find( const char * text, size_t length );
+        static vaStringID                           Find( const string & text )                     { return Find( text.c_str( ), text.length( ) ); }
+
+        // Interning a literal with its hash precomputed (see VA_STRING_ID)
+        static vaStringID                           FromHashedLiteral( const char * text, size_t length, uint64 hash );
+
+        bool                                        Empty( ) const                                  { return m_entry == nullptr; }
+        const char *                                c_str( ) const                                  { return ( m_entry != nullptr ) ? ( m_entry->Text ) : ( "" ); }
+        size_t                                      Length( ) const                                 { return ( m_entry != nullptr ) ? ( m_entry->Length ) : ( 0 ); }
+        uint64                                      Hash( ) const                                   { return ( m_entry != nullptr ) ? ( m_entry->Hash ) : ( HashText( "", 0 ) ); }
+        string                                      ToString( ) const                               { return string( c_str( ), Length( ) ); }
+
+        bool                                        operator == ( const vaStringID & other ) const  { return m_entry == other.m_entry; }
+        bool                                        operator != ( const vaStringID & other ) const  { return m_entry != other.m_entry; }
+        bool                                        operator < ( const vaStringID & other ) const   { return m_entry < other.m_entry; }
+
+        // alphabetical (strcmp) order
+        static int                                  CompareText( const vaStringID & left, const vaStringID & right )    { return ( left == right ) ? ( 0 ) : ( strcmp( left.c_str( ), right.c_str( ) ) ); }
+
+        // 64bit FNV-1a; constexpr so that literals can be hashed at compile time
+        static constexpr uint64                     HashText( const char * text, size_t length )
+        {
+            uint64 hash = 0xCBF29CE484222325ull;
+            for( size_t i = 0; i < length; i++ )
+            {
+                hash ^= (uint8)text[i];
+                hash *= 0x00000100000001B3ull;
+            }
+            return hash;
+        }
+        template< size_t LiteralSize >
+        static constexpr uint64                     HashLiteral( const char ( & text )[LiteralSize] )  { return HashText( text, LiteralSize - 1 ); }
+
+        struct Hasher
+        {
+            size_t                                  operator( )( const vaStringID & id ) const      { return (size_t)id.Hash( ); }
+        };
+    };
+
+    // Owns all interned strings. Split into c_shardCount shards by hash (like vaUIDObjectRegistrar), each an open
+    // addressing hash table behind a reader/writer lock with its strings in a bump allocated arena; the common case
+    // (string already interned) only takes a shared lock.
+    class vaStringInterner : public vaSingletonBase< vaStringInterner >
+    {
+        static const int                            c_shardCount        = 16;                       // power of 2
+        static const size_t                         c_arenaBlockSize    = 16 * 1024;
+
+        struct alignas( 64 ) Shard
+        {
+            mutable std::shared_mutex               Mutex;
+            vector<const vaStringID::Entry *>       Slots;                                          // size is 0 or a power of 2, kept at most 3/4 full
+            int                                     Count               = 0;
+
+            vector<uint8 *>                         ArenaBlocks;
+            size_t                                  ArenaBlockUsed      = c_arenaBlockSize;         // in the last block
+            size_t                                  ArenaBytes          = 0;
+        };
+
+        Shard                                       m_shards[c_shardCount];
+
+    private:
+        friend class vaCore;
+        vaStringInterner( )                         { }
+        ~vaStringInterner( );
+
+    public:
+        vaStringID                                  Intern( const char * text, size_t length, uint64 hash );
+        vaStringID                                  Find( const char * text, size_t length, uint64 hash ) const;
+
+        int                                         GetCount( ) const;
+        size_t                                      GetMemoryUsage( ) const;
+
+    private:
+        static int                                  ShardIndex( uint64 hash )                       { return (int)( hash >> 60 ) & ( c_shardCount - 1 ); }
+        static size_t                               SlotIndex( uint64 hash )                        { return (size_t)( hash ^ ( hash >> 29 ) ); }
+
+        // shard lock (shared or exclusive) must be held
+        static const vaStringID::Entry *            FindNoMutexLock( const Shard & shard, const char * text, size_t length, uint64 hash );
+        static void                                 GrowNoMutexLock( Shard & shard );
+        static vaStringID::Entry *                  AllocateNoMutexLock( Shard & shard, size_t length );
+    };
+
+    inline vaStringID::vaStringID( const char * text, size_t length )    { *this = vaStringInterner::GetInstance( ).Intern( text, length, HashText( text, length ) ); }
+    inline vaStringID::vaStringID( const char * text )                   : vaStringID( text, strlen( text ) ) { }
+    inline vaStringID::vaStringID( const string & text )                 : vaStringID( text.c_str( ), text.length( ) ) { }
+
+    inline vaStringID vaStringID::Find( const char * text, size_t length )                           { return vaStringInterner::GetInstance( ).Find( text, length, HashText( text, length ) ); }
+    inline vaStringID vaStringID::FromHashedLiteral( const char * text, size_t length, uint64 hash ) { assert( hash == HashText( text, length ) ); return vaStringInterner::GetInstance( ).Intern( text, length, hash ); }
+}
+
+// Interns the literal once per call site (function-local static), with the hash computed at compile time; evaluates
+// to a const vaStringID &.
+#define VA_STRING_ID( literal )                                                                                                             \
+    ( [ ]( ) -> const VertexAsylum::vaStringID &                                                                                            \
+    {                                                                                                                                       \
+        static const VertexAsylum::vaStringID id = VertexAsylum::vaStringID::FromHashedLiteral( literal, sizeof( literal ) - 1,             \
+            std::integral_constant< VertexAsylum::uint64, VertexAsylum::vaStringID::HashLiteral( literal ) >::value );                      \
+        return id;                                                                                                                          \
+    }( ) )
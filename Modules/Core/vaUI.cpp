@@ -383,6 +383,8 @@ void vaUIManager::UpdateUI( bool appHasFocus )
 
 void vaUIManager::DrawUI( )
 {
+    VA_MEMORY_TAG_SCOPE( UI );
+
 #ifdef VA_IMGUI_INTEGRATION_ENABLED
     bool visible = m_visible;
     bool menuVisible = m_menuVisible;
@@ -1155,7 +1157,41 @@ void vaUIConsole::ExecuteCommand( const string & commandLine )
     }
     else
     {
-        vaLog::GetInstance().Add( LOG_COLORS_ERROR, "Unknown command: '%s'\n", commandLine.c_str() );
+        size_t nameEnd = commandLine.find( ' ' );
+        string name = commandLine.substr( 0, nameEnd );
+        string arguments = ( nameEnd == string::npos ) ? ( "" ) : ( vaStringTools::Trim( commandLine.substr( nameEnd ).c_str(), " \t" ) );
+
+        bool found = false;
+        for( int i = 0; i < (int)m_commands.size(); i++ )
+            if( m_commands[i].Callback && vaStringTools::CompareNoCase( m_commands[i].Name, name ) == 0 )
+            {
+                m_commands[i].Callback( arguments );
+                found = true;
+                break;
+            }
+        if( !found )
+            vaLog::GetInstance().Add( LOG_COLORS_ERROR, "Unknown command: '%s'\n", commandLine.c_str() );
     }
     m_scrollToBottom = true;
 }
+
+void vaUIConsole::AddCommand( const string & name, const std::function<void( const string & arguments )> & callback )
+{
+    assert( vaThreading::IsMainThread() );
+    assert( callback && name.find( ' ' ) == string::npos );
+    for( int i = 0; i < (int)m_commands.size(); i++ )
+        if( vaStringTools::CompareNoCase( m_commands[i].Name, name ) == 0 )
+        {
+            assert( false ); // already registered
+            return;
+        }
+    m_commands.push_back( CommandInfo( name, callback ) );
+}
+
+void vaUIConsole::RemoveCommand( const string & name )
+{
+    assert( vaThreading::IsMainThread() );
+    for( int i = (int)m_commands.size()-1; i >= 0; i-- )
+        if( m_commands[i].Callback && vaStringTools::CompareNoCase( m_commands[i].Name, name ) == 0 )
+            m_commands.erase( m_commands.begin() + i );
+}
@@ -208,10 +208,12 @@ namespace VertexAsylum
         struct CommandInfo
         {
             string      Name;
-            //some-kindo-of-callback
+            std::function<void( const string & arguments )>
+                        Callback;           // not set for built-in commands
 
             CommandInfo( ) { }
             explicit CommandInfo( const string & name ) : Name(name) { }
+            CommandInfo( const string & name, const std::function<void( const string & arguments )> & callback ) : Name(name), Callback(callback) { }
         };
 
     private:
@@ -241,9 +243,9 @@ namespace VertexAsylum
 
         bool                    IsVisible( ) const                  { return vaUIManager::GetInstance().IsConsoleVisible(); }
         void                    SetVisible( bool visible    )       { vaUIManager::GetInstance().SetConsoleVisible( visible ); }
-        // Todo:
-        //void                    AddCommand( const string & name ... )
-        //void                    RemoveCommand( const string & name )
+        // Custom commands: 'arguments' is the rest of the command line after the name (trimmed); names are case insensitive.
+        void                    AddCommand( const string & name, const std::function<void( const string & arguments )> & callback );
+        void                    RemoveCommand( const string & name );
 
         void                    Draw( int windowWidth, int windowHeight );
 
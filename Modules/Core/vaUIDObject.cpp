@@ -41,7 +41,46 @@ vaUIDObjectRegistrar::vaUIDObjectRegistrar()
     assert( vaThreading::IsMainThread() );
 }
 
-bool vaUIDObjectRegistrar::TrackNoMutexLock( vaUIDObject * obj )
+vaUIDObjectRegistrar::~vaUIDObjectRegistrar( )
+{
+    // not 0? memory leak or not all objects deleted before the registrar was deleted (bug)
+    assert( GetTrackedCount( ) == 0 );
+}
+
+int vaUIDObjectRegistrar::GetTrackedCount( ) const
+{
+    int count = 0;
+    for( const Shard & shard : m_shards )
+    {
+        std::shared_lock<std::shared_mutex> shardLock( shard.Mutex );
+        count += shard.Count;
+    }
+    return count;
+}
+
+void vaUIDObjectRegistrar::GrowNoMutexLock( Shard & shard, int minCount )
+{
+    size_t newSize = vaMath::Max( (size_t)16, shard.Entries.size( ) );
+    while( (size_t)minCount * 4 > newSize * 3 )
+        newSize *= 2;
+    if( newSize == shard.Entries.size( ) )
+        return;
+
+    vector<Entry> oldEntries( newSize, Entry{ vaGUID::Null, nullptr } );
+    shard.Entries.swap( oldEntries );
+    size_t mask = newSize - 1;
+    for( const Entry & entry : oldEntries )
+    {
+        if( entry.Object == nullptr )
+            continue;
+        size_t i = (size_t)HashUID( entry.UID ) & mask;
+        while( shard.Entries[i].Object != nullptr )
+            i = ( i + 1 ) & mask;
+        shard.Entries[i] = entry;
+    }
+}
+
+bool vaUIDObjectRegistrar::TrackNoMutexLock( Shard & shard, vaUIDObject * obj, uint64 hash )
 {
     if( obj->m_tracked )
     {
@@ -49,91 +88,190 @@ bool vaUIDObjectRegistrar::TrackNoMutexLock( vaUIDObject * obj )
         return false;
     }
 
-    auto it = m_objectsMap.find( obj->m_uid );
-    if( it != m_objectsMap.end( ) )
+    if( FindNoMutexLock( shard, obj->m_uid, hash ) != nullptr )
     {
         VA_LOG_ERROR( "vaUIDObjectRegistrar::Track() - object with the same UID already exists: this is a potential bug, the new object will not be tracked and will not be searchable by vaUIDObjectRegistrar::Find" );
         return false;
     }
-    else
-    {
-        m_objectsMap.insert( std::make_pair( obj->m_uid, obj ) );
-        obj->m_tracked = true;
-        return true;
-    }
+
+    GrowNoMutexLock( shard, shard.Count + 1 );
+
+    size_t mask = shard.Entries.size( ) - 1;
+    size_t i = (size_t)hash & mask;
+    while( shard.Entries[i].Object != nullptr )
+        i = ( i + 1 ) & mask;
+    shard.Entries[i] = Entry{ obj->m_uid, obj };
+    shard.Count++;
+    obj->m_tracked = true;
+    return true;
 }
 
-bool vaUIDObjectRegistrar::UntrackNoMutexLock( vaUIDObject * obj )
+bool vaUIDObjectRegistrar::UntrackNoMutexLock( Shard & shard, vaUIDObject * obj, uint64 hash )
 {
     // if not tracked just ignore it, it's probably fine, no reason we can allow untrack multiple times
     if( !obj->m_tracked )
         return false;
 
-    auto it = m_objectsMap.find( obj->m_uid );
-    if( it == m_objectsMap.end( ) )
+    size_t mask = ( shard.Count == 0 ) ? ( 0 ) : ( shard.Entries.size( ) - 1 );
+    size_t i = (size_t)hash & mask;
+    while( shard.Count != 0 && shard.Entries[i].Object != nullptr && !( shard.Entries[i].UID == obj->m_uid ) )
+        i = ( i + 1 ) & mask;
+
+    if( shard.Count == 0 || shard.Entries[i].Object == nullptr )
     {
         VA_ERROR( "vaUIDObjectRegistrar::Untrack() - A tracked vaUIDObject couldn't be found: this is an indicator of a more serious error such as an algorithm bug or a memory overwrite. Don't ignore it." );
         return false;
     }
-    else
+
+    // if this isn't correct, we're removing wrong object - this is a serious error, don't ignore it!
+    if( obj != shard.Entries[i].Object )
     {
-        // if this isn't correct, we're removing wrong object - this is a serious error, don't ignore it!
-        if( obj != it->second )
+        VA_ERROR( "vaUIDObjectRegistrar::Untrack() - A tracked vaUIDObject could be found in the map but the pointers don't match: this is an indicator of a more serious error such as an algorithm bug or a memory overwrite. Don't ignore it." );
+        return false;
+    }
+
+    // backward shift deletion: pull following entries of the same probe run into the hole so no tombstones are needed
+    size_t hole = i;
+    for( size_t j = ( i + 1 ) & mask; shard.Entries[j].Object != nullptr; j = ( j + 1 ) & mask )
+    {
+        size_t home = (size_t)HashUID( shard.Entries[j].UID ) & mask;
+        // can entry j move to the hole, i.e. is its home not in the cyclic range (hole, j]?
+        bool homeInRange = ( hole <= j ) ? ( hole < home && home <= j ) : ( hole < home || home <= j );
+        if( !homeInRange )
         {
-            VA_ERROR( "vaUIDObjectRegistrar::Untrack() - A tracked vaUIDObject could be found in the map but the pointers don't match: this is an indicator of a more serious error such as an algorithm bug or a memory overwrite. Don't ignore it." );
-            return false;
+            shard.Entries[hole] = shard.Entries[j];
+            hole = j;
         }
-        else
+    }
+    shard.Entries[hole] = Entry{ vaGUID::Null, nullptr };
+    shard.Count--;
+    obj->m_tracked = false;
+    return true;
+}
+
+bool vaUIDObjectRegistrar::Track( vaUIDObject * obj )
+{
+    uint64 hash = HashUID( obj->m_uid );
+    Shard & shard = ShardOf( hash );
+    std::unique_lock<std::shared_mutex> shardLock( shard.Mutex );
+    return TrackNoMutexLock( shard, obj, hash );
+}
+
+bool vaUIDObjectRegistrar::Untrack( vaUIDObject * obj )
+{
+    uint64 hash = HashUID( obj->m_uid );
+    Shard & shard = ShardOf( hash );
+    std::unique_lock<std::shared_mutex> shardLock( shard.Mutex );
+    return UntrackNoMutexLock( shard, obj, hash );
+}
+
+template< class ProcessType >
+int vaUIDObjectRegistrar::ProcessBatch( vaUIDObject * const * objects, int count, ProcessType && process )
+{
+    // bucket by shard (counting sort) so that each shard is locked once
+    vector<uint64>  hashes( count );
+    int             shardStarts[c_shardCount+1] = { };
+    for( int i = 0; i < count; i++ )
+    {
+        if( objects[i] == nullptr )
+            continue;
+        hashes[i] = HashUID( objects[i]->m_uid );
+        shardStarts[ ShardIndex( hashes[i] ) + 1 ]++;
+    }
+    for( int s = 0; s < c_shardCount; s++ )
+        shardStarts[s+1] += shardStarts[s];
+
+    vector<int>     order( shardStarts[c_shardCount] );
+    int             shardFill[c_shardCount];
+    memcpy( shardFill, shardStarts, sizeof( shardFill ) );
+    for( int i = 0; i < count; i++ )
+        if( objects[i] != nullptr )
+            order[ shardFill[ ShardIndex( hashes[i] ) ]++ ] = i;
+
+    int changed = 0;
+    for( int s = 0; s < c_shardCount; s++ )
+    {
+        if( shardStarts[s] == shardStarts[s+1] )
+            continue;
+        Shard & shard = m_shards[s];
+        std::unique_lock<std::shared_mutex> shardLock( shard.Mutex );
+        for( int k = shardStarts[s]; k < shardStarts[s+1]; k++ )
+            if( process( shard, objects[ order[k] ], hashes[ order[k] ], shardStarts[s+1] - shardStarts[s] ) )
+                changed++;
+    }
+    return changed;
+}
+
+int vaUIDObjectRegistrar::TrackBatch( vaUIDObject * const * objects, int count )
+{
+    int shardIndex = -1;
+    return ProcessBatch( objects, count, [ this, &shardIndex ]( Shard & shard, vaUIDObject * obj, uint64 hash, int shardBatchCount )
+    {
+        // reserve for the whole batch on the first object of each shard instead of growing step by step
+        if( shardIndex != ShardIndex( hash ) )
         {
-            obj->m_tracked = false;
-            m_objectsMap.erase( it );
-            return true;
+            shardIndex = ShardIndex( hash );
+            GrowNoMutexLock( shard, shard.Count + shardBatchCount );
         }
-    }
+        return TrackNoMutexLock( shard, obj, hash );
+    } );
 }
 
+int vaUIDObjectRegistrar::UntrackBatch( vaUIDObject * const * objects, int count )
+{
+    return ProcessBatch( objects, count, [ this ]( Shard & shard, vaUIDObject * obj, uint64 hash, int )
+    {
+        return UntrackNoMutexLock( shard, obj, hash );
+    } );
+}
+
+void vaUIDObjectRegistrar::SetMissResolver( const MissResolverType & resolver )
+{
+    std::unique_lock<mutex> resolverLock( m_missResolverMutex );
+    assert( resolver == nullptr || m_missResolver == nullptr );    // only one supported at the moment
+    m_missResolver = resolver;
+}
+
+bool vaUIDObjectRegistrar::TryResolveMiss( const vaGUID & uid )
+{
+    MissResolverType resolver;
+    {
+        std::unique_lock<mutex> resolverLock( m_missResolverMutex );
+        if( m_missResolver == nullptr )
+            return false;
+        resolver = m_missResolver;
+    }
+    // no lock held here - the resolver will want to Track( ) whatever it creates
+    return resolver( uid );
+}
 
 void vaUIDObjectRegistrar::SwapIDs( vaUIDObject & a, vaUIDObject & b )
 {
-    std::unique_lock<mutex> mapLock( m_objectsMapMutex );
+    uint64 hashA = HashUID( a.m_uid );
+    uint64 hashB = HashUID( b.m_uid );
+
+    // both shards are locked for the whole swap (in index order, to avoid deadlocking with another SwapIDs) so that
+    // there's no window in which either UID can't be found
+    int shardIndexA = ShardIndex( hashA );
+    int shardIndexB = ShardIndex( hashB );
+    std::unique_lock<std::shared_mutex> firstLock( m_shards[ vaMath::Min( shardIndexA, shardIndexB ) ].Mutex );
+    std::unique_lock<std::shared_mutex> secondLock;
+    if( shardIndexA != shardIndexB )
+        secondLock = std::unique_lock<std::shared_mutex>( m_shards[ vaMath::Max( shardIndexA, shardIndexB ) ].Mutex );
 
     bool aWasTracked = a.m_tracked;
-    if( a.m_tracked )
-        UntrackNoMutexLock( &a );
-    bool bWasTracked = a.m_tracked;
-    if( b.m_tracked )
-        UntrackNoMutexLock( &b );
+    if( aWasTracked )
+        UntrackNoMutexLock( m_shards[shardIndexA], &a, hashA );
+    bool bWasTracked = b.m_tracked;
+    if( bWasTracked )
+        UntrackNoMutexLock( m_shards[shardIndexB], &b, hashB );
 
     // swap UIDs in objects
     std::swap( a.m_uid, b.m_uid );
 
     // swap tracking as well - I think this is what we want, the UID that was in to stay in
     if( bWasTracked )
-        TrackNoMutexLock( &a );
+        TrackNoMutexLock( m_shards[shardIndexB], &a, hashB );
     if( aWasTracked )
-        TrackNoMutexLock( &b );
-
-    // probably faster
-/*
-        assert( a.m_tracked );
-        assert( b.m_tracked );
-        assert( &a != &b );
-
-        auto itA = m_objectsMap.find( a.UIDObject_GetUID( ) );
-        auto itB = m_objectsMap.find( b.UIDObject_GetUID( ) );
-
-        if( itA == m_objectsMap.end( ) || itB == m_objectsMap.end( ) )
-        {
-            VA_ERROR( "Error while swapping vaUIDObject IDs - something went wrong." );
-            assert( false );
-        }
-        else
-        {
-            assert( itA->second == &a );
-            assert( itB->second == &b );
-
-            // swap values in the map
-            std::swap( itA->second, itB->second );
-        }
-        */
-}
\ No newline at end of file
+        TrackNoMutexLock( m_shards[shardIndexA], &b, hashA );
+}
@@ -41,7 +41,7 @@ namespace VertexAsylum
     private:
         friend class vaUIDObjectRegistrar;
         vaGUID /*const*/                             m_uid;                                 // removed const to be able to have SwapIDs but no one else anywhere should ever be modifying this!!
-        bool                                         m_tracked;                            // will be false on startup and become true on UIDObject_MakeOrphan()
+        std::atomic_bool                             m_tracked;                             // will be false on startup and become true on UIDObject_Track(); only changed with the object's registrar shard locked
 
     protected:
         explicit vaUIDObject( const vaGUID & uid );
@@ -55,29 +55,56 @@ namespace VertexAsylum
         bool                                         UIDObject_Untrack( );
     };
 
+    // The registry is split into c_shardCount shards by GUID hash, each an open addressing (linear probing) hash table
+    // behind its own reader/writer lock, so that Find/FindCached from many threads don't serialize on one mutex and
+    // tracking from one thread (asset loading) only blocks the lookups that land in the same shard.
     class vaUIDObjectRegistrar : public vaSingletonBase< vaUIDObjectRegistrar >
     {
     protected:
         friend class vaUIDObject;
 
-        map< vaGUID, vaUIDObject*, vaGUIDComparer >  m_objectsMap;
-        mutex                                       m_objectsMapMutex;
+        static const int                             c_shardCount       = 32;              // power of 2
+
+        struct Entry
+        {
+            vaGUID                                   UID;
+            vaUIDObject *                            Object;                                // nullptr for empty
+        };
+
+        struct alignas( 64 ) Shard
+        {
+            mutable std::shared_mutex                Mutex;
+            vector<Entry>                            Entries;                               // size is 0 or a power of 2, kept at most 3/4 full
+            int                                      Count          = 0;
+        };
+
+        Shard                                        m_shards[c_shardCount];
+
+    public:
+        // Called with no registrar locks held when Find/FindCached can't find an object; it gets a chance to create & track
+        // it (for ex. an asset from a lazily loaded asset pack that wasn't needed until now) and should return true if it did.
+        typedef std::function< bool( const vaGUID & uid ) > MissResolverType;
+
+    protected:
+        MissResolverType                            m_missResolver;
+        mutex                                       m_missResolverMutex;
 
     private:
         friend class vaCore;
         vaUIDObjectRegistrar( );
-        ~vaUIDObjectRegistrar( )
-        {
-            std::unique_lock<mutex> mapLock( m_objectsMapMutex );
-            // not 0? memory leak or not all objects deleted before the registrar was deleted (bug)
-            assert( m_objectsMap.size( ) == 0 );
-        }
+        ~vaUIDObjectRegistrar( );
 
     public:
-        bool                                         IsTracked( const vaUIDObject * obj ) const;
-        bool                                         Track( vaUIDObject * obj )                     { std::unique_lock<mutex> mapLock( m_objectsMapMutex ); return TrackNoMutexLock(obj);      }
-        bool                                         Untrack( vaUIDObject * obj )                   { std::unique_lock<mutex> mapLock( m_objectsMapMutex ); return UntrackNoMutexLock(obj);    }
+        bool                                         IsTracked( const vaUIDObject * obj ) const     { return obj->m_tracked; }
+        bool                                         Track( vaUIDObject * obj );
+        bool                                         Untrack( vaUIDObject * obj );
+
+        // Same as calling Track/Untrack on each object but every shard only gets locked once; meant for adding or removing
+        // a whole asset pack. Null pointers are skipped. Returns the number of objects that changed state.
+        int                                          TrackBatch( vaUIDObject * const * objects, int count );
+        int                                          UntrackBatch( vaUIDObject * const * objects, int count );
 
+        int                                          GetTrackedCount( ) const;
 
     public:
         template< class T >
@@ -94,22 +121,38 @@ namespace VertexAsylum
         // Exchange two object IDs
         void                                         SwapIDs( vaUIDObject & a, vaUIDObject & b );
 
+        // Only one can be set at a time; set to nullptr to remove
+        void                                         SetMissResolver( const MissResolverType & resolver );
+
     private:
-        // perhaps make these public? one could use it to track/untrack a bunch of objects at once or similar
-        mutex &                                     GetMutex( ) { return m_objectsMapMutex; }
-        bool                                         TrackNoMutexLock( vaUIDObject * obj );
-        bool                                         UntrackNoMutexLock( vaUIDObject * obj );
+        static uint64                                HashUID( const vaGUID & uid );
+        static int                                   ShardIndex( uint64 hash )                      { return (int)( hash >> 59 ) & ( c_shardCount - 1 ); }
+        Shard &                                      ShardOf( uint64 hash )                         { return m_shards[ ShardIndex( hash ) ]; }
+
+        // shard lock (shared or exclusive) must be held for these
+        static vaUIDObject *                         FindNoMutexLock( const Shard & shard, const vaGUID & uid, uint64 hash );
+        bool                                         TrackNoMutexLock( Shard & shard, vaUIDObject * obj, uint64 hash );
+        bool                                         UntrackNoMutexLock( Shard & shard, vaUIDObject * obj, uint64 hash );
+        static void                                  GrowNoMutexLock( Shard & shard, int minCount );
+
+        // checks & casts the object found in the map
         template< class T >
-        static T *                                   FindNoMutexLock( const vaGUID & uid );
+        static T *                                   CastFound( vaUIDObject * obj, const vaGUID & uid );
 
-        void                                         UntrackIfTracked( vaUIDObject * obj )                   { std::unique_lock<mutex> mapLock( m_objectsMapMutex ); if( obj->m_tracked ) UntrackNoMutexLock(obj);    }
+        void                                         UntrackIfTracked( vaUIDObject * obj )          { if( obj->m_tracked ) Untrack( obj ); }
+
+        template< class ProcessType >
+        int                                          ProcessBatch( vaUIDObject * const * objects, int count, ProcessType && process );
+
+        // returns true if the miss resolver created the object so the lookup should be repeated
+        bool                                         TryResolveMiss( const vaGUID & uid );
     };
 
     // inline 
 
     inline bool vaUIDObject::UIDObject_IsTracked( ) const
     {
-        return vaUIDObjectRegistrar::GetInstance( ).IsTracked( this );
+        return m_tracked;
     }
 
     inline bool vaUIDObject::UIDObject_Track( )
@@ -122,46 +165,79 @@ namespace VertexAsylum
         return vaUIDObjectRegistrar::GetInstance( ).Untrack( this );
     }
 
-    inline bool vaUIDObjectRegistrar::IsTracked( const vaUIDObject * obj ) const
+    inline uint64 vaUIDObjectRegistrar::HashUID( const vaGUID & uid )
     {
-        std::unique_lock<mutex> mapLock( vaUIDObjectRegistrar::GetInstance( ).m_objectsMapMutex );
-        return obj->m_tracked;
+        // GUIDs are mostly random already but not all of them come from GUIDCreate, so fold the halves and finalize
+        // (murmur3 fmix64); the top bits pick the shard, the bottom ones the bucket
+        uint64 halves[2];
+        static_assert( sizeof( halves ) == sizeof( GUID ), "unexpected GUID size" );
+        memcpy( halves, &uid, sizeof( halves ) );
+        uint64 h = halves[0] ^ ( halves[1] * 0x9E3779B97F4A7C15ull );
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
     }
 
-    template< class T>
-    inline T * vaUIDObjectRegistrar::Find( const vaGUID & uid )
+    inline vaUIDObject * vaUIDObjectRegistrar::FindNoMutexLock( const Shard & shard, const vaGUID & uid, uint64 hash )
     {
-        std::unique_lock<mutex> mapLock( vaUIDObjectRegistrar::GetInstance( ).m_objectsMapMutex );
-        return FindNoMutexLock<T>( uid );
+        if( shard.Count == 0 )
+            return nullptr;
+
+        size_t mask = shard.Entries.size( ) - 1;
+        for( size_t i = (size_t)hash & mask; ; i = ( i + 1 ) & mask )
+        {
+            const Entry & entry = shard.Entries[i];
+            if( entry.Object == nullptr )
+                return nullptr;
+            if( entry.UID == uid )
+                return entry.Object;
+        }
     }
 
-    template< class T>
-    inline T * vaUIDObjectRegistrar::FindNoMutexLock( const vaGUID & uid )
+    template< class T >
+    inline T * vaUIDObjectRegistrar::CastFound( vaUIDObject * obj, const vaGUID & uid )
     {
-        if( uid == vaCore::GUIDNull( ) )
+        if( obj == nullptr )
             return nullptr;
 
-        auto it = vaUIDObjectRegistrar::GetInstance( ).m_objectsMap.find( uid );
-        if( it == vaUIDObjectRegistrar::GetInstance( ).m_objectsMap.end( ) )
+        if( !obj->m_tracked )
         {
+            VA_ERROR( "vaUIDObjectRegistrar::CastFound() - Something has gone really bad here - object is not marked as tracked but was found in the map. Don't ignore it." );
             return nullptr;
         }
-        else
-        {
-            if( !it->second->m_tracked )
-            {
-                VA_ERROR( "vaUIDObjectRegistrar::FindNoMutexLock() - Something has gone really bad here - object is not marked as tracked but was found in the map. Don't ignore it." );
-                return nullptr;
-            }
 #ifdef _DEBUG
-            assert( it->second->m_uid == uid );
-            T * ret = dynamic_cast<T*>( it->second );
-            assert( ret != NULL );
-            return ret;
+        assert( obj->m_uid == uid );
+        T * ret = dynamic_cast<T*>( obj );
+        assert( ret != NULL );
+        return ret;
 #else
-            return static_cast<T*>( it->second );
+        uid;
+        return static_cast<T*>( obj );
 #endif
+    }
+
+    template< class T>
+    inline T * vaUIDObjectRegistrar::Find( const vaGUID & uid )
+    {
+        if( uid == vaCore::GUIDNull( ) )
+            return nullptr;
+
+        vaUIDObjectRegistrar & registrar = vaUIDObjectRegistrar::GetInstance( );
+        uint64 hash = HashUID( uid );
+        const Shard & shard = registrar.ShardOf( hash );
+        {
+            std::shared_lock<std::shared_mutex> shardLock( shard.Mutex );
+            T * ret = CastFound<T>( FindNoMutexLock( shard, uid, hash ), uid );
+            if( ret != nullptr )
+                return ret;
         }
+        if( !registrar.TryResolveMiss( uid ) )
+            return nullptr;
+        std::shared_lock<std::shared_mutex> shardLock( shard.Mutex );
+        return CastFound<T>( FindNoMutexLock( shard, uid, hash ), uid );
     }
 
     template< class T >
@@ -177,8 +253,20 @@ namespace VertexAsylum
 
         if( object == nullptr || object->m_uid != uid )
         {
-            std::unique_lock<mutex> mapLock( vaUIDObjectRegistrar::GetInstance( ).m_objectsMapMutex );
-            T * objPtr = FindNoMutexLock<T>( uid );
+            uint64 hash = HashUID( uid );
+            const Shard & shard = ShardOf( hash );
+
+            // the lock is held until we've got a shared_ptr so the object can't get untracked & deleted in between
+            std::shared_lock<std::shared_mutex> shardLock( shard.Mutex );
+            T * objPtr = CastFound<T>( FindNoMutexLock( shard, uid, hash ), uid );
+            if( objPtr == nullptr )
+            {
+                shardLock.unlock( );
+                bool resolved = TryResolveMiss( uid );
+                shardLock.lock( );
+                if( resolved )
+                    objPtr = CastFound<T>( FindNoMutexLock( shard, uid, hash ), uid );
+            }
             if( objPtr != nullptr )
             {
                 object = std::static_pointer_cast<T>( objPtr->shared_from_this( ) );
@@ -695,7 +695,7 @@ void vaRenderDeviceDX11::BeginFrame( float deltaTime )
     vaGPUTimerDX11::OnFrameStart( );
 
     assert( m_frameProfilingNode == nullptr );
-    m_frameProfilingNode = vaProfiler::GetInstance( ).StartScope( "WholeFrame", false, GetMainContext( ) );
+    m_frameProfilingNode = vaProfiler::GetInstance( ).StartScope( VA_STRING_ID( "WholeFrame" ), false, GetMainContext( ) );
 
     // execute begin frame callbacks - mostly initialization stuff that requires a command list (main context)
     if( m_beginFrameCallbacks.size() > 0 )
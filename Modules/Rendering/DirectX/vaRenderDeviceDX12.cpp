@@ -983,7 +983,7 @@ void vaRenderDeviceDX12::BeginFrame( float deltaTime )
     if( vaProfiler::GetInstancePtr( ) != nullptr )
     {
         assert( m_frameProfilingNode == nullptr );
-        m_frameProfilingNode = vaProfiler::GetInstance( ).StartScope( "WholeFrame", false, m_mainDeviceContext.get() );
+        m_frameProfilingNode = vaProfiler::GetInstance( ).StartScope( VA_STRING_ID( "WholeFrame" ), false, m_mainDeviceContext.get() );
     }
 
     // execute begin frame callbacks - mostly initialization stuff that requires a command list (main context)
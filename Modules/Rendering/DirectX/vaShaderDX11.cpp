@@ -37,6 +37,8 @@
 // #include "Core/Misc/vaCRC64.h"
 
 #include "Core/System/vaFileTools.h"
+#include "Core/System/vaMappedFileStream.h"
+#include "Core/System/vaCompressionStream.h"
 
 
 using namespace VertexAsylum;
@@ -986,30 +988,39 @@ namespace VertexAsylum
 
             ClearCacheInternal( );
 
-            vaFileStream inFile;
-            if( inFile.Open( fullFileName.c_str( ), FileCreationMode::Open, FileAccessMode::Read ) )
+            // lots of small reads - mapping the file turns them into memcpys and shares the pages with other instances
+            vaMappedFileStream inFile;
+            if( inFile.Open( fullFileName ) )
             {
                 int version = -1;
                 inFile.ReadValue<int32>( version );
 
-                assert( version == 0 );
+                // version 0: raw, version 1: everything after the version is compressed with vaCompressionStream::Profile::Fast
+                assert( version == 0 || version == 1 );
+                if( version != 0 && version != 1 )
+                    return false;
+
+                std::unique_ptr<vaCompressionStream> decompressor;
+                if( version == 1 )
+                    decompressor = std::make_unique<vaCompressionStream>( true, &inFile );
+                vaStream & inStream = ( decompressor != nullptr ) ? ( static_cast<vaStream&>( *decompressor ) ) : ( static_cast<vaStream&>( inFile ) );
 
                 int32 entryCount = 0;
-                inFile.ReadValue<int32>( entryCount );
+                inStream.ReadValue<int32>( entryCount );
 
                 for( int i = 0; i < entryCount; i++ )
                 {
                     context.Progress = float(i)/float(entryCount-1);
 
                     vaShaderCacheKey11 key;
-                    key.Load( inFile );
-                    vaShaderCacheEntry11 * entry = new vaShaderCacheEntry11( inFile );
+                    key.Load( inStream );
+                    vaShaderCacheEntry11 * entry = new vaShaderCacheEntry11( inStream );
 
                     m_cache.insert( std::pair<vaShaderCacheKey11, vaShaderCacheEntry11 *>( key, entry ) );
                 }
 
                 int32 terminator;
-                inFile.ReadValue<int32>( terminator );
+                inStream.ReadValue<int32>( terminator );
                 assert( terminator == 0xFF );
             }
             return true;
@@ -1047,20 +1058,23 @@ namespace VertexAsylum
         vaFileStream outFile;
         outFile.Open( fullFileName.c_str( ), FileCreationMode::Create );
 
-        outFile.WriteValue<int32>( 0 );                 // version;
+        outFile.WriteValue<int32>( 1 );                 // version; see LoadCacheInternal
+
+        // the cache is all about startup time so use the codec that's fastest to decompress
+        vaCompressionStream outStream( false, &outFile, vaCompressionStream::Profile::Fast );
 
-        outFile.WriteValue<int32>( (int32)m_cache.size( ) );    // number of entries
+        outStream.WriteValue<int32>( (int32)m_cache.size( ) );    // number of entries
 
         for( std::map<vaShaderCacheKey11, vaShaderCacheEntry11 *>::const_iterator it = m_cache.cbegin( ); it != m_cache.cend( ); ++it )
         {
             // Save key
-            ( *it ).first.Save( outFile );
+            ( *it ).first.Save( outStream );
 
             // Save data
-            ( *it ).second->Save( outFile );
+            ( *it ).second->Save( outStream );
         }
 
-        outFile.WriteValue<int32>( 0xFF );  // EOF;
+        outStream.WriteValue<int32>( 0xFF );  // EOF;
     }
     //
     void vaDirectX11ShaderManager::ClearCacheInternal( )
@@ -1303,7 +1303,7 @@ bool vaTextureDX11::InternalCreate3D( vaResourceFormat format, int width, int he
     }
 }
 
-shared_ptr<vaTexture> vaTextureDX11::CreateViewInternal( const shared_ptr<vaTexture> & thisTexture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount )
+shared_ptr<vaTexture> vaTextureDX11::CreateViewInternal( const shared_ptr<vaTexture> & thisTexture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount, const vaGUID & uid )
 {
     assert( thisTexture.get() == static_cast<vaTexture*>(this) );
     vaTextureDX11 * origDX11Texture = this->SafeCast<vaTextureDX11*>( );
@@ -1334,7 +1334,7 @@ shared_ptr<vaTexture> vaTextureDX11::CreateViewInternal( const shared_ptr<vaText
     assert( ((~origFlags) & bindFlags) == 0 );
     origFlags; // unreferenced in Release
 
-    shared_ptr<vaTexture> newTexture = VA_RENDERING_MODULE_CREATE_SHARED( vaTexture, vaTextureConstructorParams( GetRenderDevice(), vaCore::GUIDCreate( ) ) );
+    shared_ptr<vaTexture> newTexture = VA_RENDERING_MODULE_CREATE_SHARED( vaTexture, vaTextureConstructorParams( GetRenderDevice(), uid ) );
     AsDX11( *newTexture ).Initialize( bindFlags, this->GetAccessFlags(), this->GetResourceFormat(), srvFormat, rtvFormat, dsvFormat, uavFormat, this->GetFlags(), viewedMipSliceMin, viewedMipSliceCount, viewedArraySliceMin, viewedArraySliceCount, this->GetContentsType() );
     
     // track the original & keep it alive (not needed in DX since DX resources have reference counting and will stay alive, but it might be useful for other API implementations and/or debugging purposes)
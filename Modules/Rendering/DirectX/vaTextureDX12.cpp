@@ -1580,7 +1580,7 @@ bool vaTextureDX12::InternalCreate3D( vaResourceFormat format, int width, int he
     }
 }
 
-shared_ptr<vaTexture> vaTextureDX12::CreateViewInternal( const shared_ptr<vaTexture> & thisTexture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount )
+shared_ptr<vaTexture> vaTextureDX12::CreateViewInternal( const shared_ptr<vaTexture> & thisTexture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount, const vaGUID & uid )
 {
     assert( thisTexture.get() == static_cast<vaTexture*>(this) );
     vaTextureDX12 * origDX12Texture = this->SafeCast<vaTextureDX12*>( );
@@ -1611,7 +1611,7 @@ shared_ptr<vaTexture> vaTextureDX12::CreateViewInternal( const shared_ptr<vaText
     assert( ((~origFlags) & bindFlags) == 0 );
     origFlags; // unreferenced in Release
 
-    shared_ptr<vaTexture> newTexture = VA_RENDERING_MODULE_CREATE_SHARED( vaTexture, vaTextureConstructorParams( GetRenderDevice(), vaCore::GUIDCreate( ) ) );
+    shared_ptr<vaTexture> newTexture = VA_RENDERING_MODULE_CREATE_SHARED( vaTexture, vaTextureConstructorParams( GetRenderDevice(), uid ) );
     AsDX12( *newTexture ).Initialize( bindFlags, this->GetAccessFlags(), this->GetResourceFormat(), srvFormat, rtvFormat, dsvFormat, uavFormat, this->GetFlags(), viewedMipSliceMin, viewedMipSliceCount, viewedArraySliceMin, viewedArraySliceCount, this->GetContentsType() );
     
     // track the original & keep it alive (not needed in DX since DX resources have reference counting and will stay alive, but it might be useful for other API implementations and/or debugging purposes)
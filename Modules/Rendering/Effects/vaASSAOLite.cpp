@@ -215,21 +215,18 @@ bool vaASSAOLite::ReCreateIfNeeded( shared_ptr<vaTexture> & inoutTex, vaVector2i
 
 void vaASSAOLite::UpdateTextures( vaSceneDrawContext & drawContext, int width, int height, bool generateNormals, const vaVector4i & scissorRect )
 {
-    vector< pair< string, string > > newShaderMacros;
+    vaShaderMacroScratchList newShaderMacros;
     
     if( m_debugShowNormals )
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "SSAO_DEBUG_SHOWNORMALS", "" ) );
+        newShaderMacros.emplace_back( "SSAO_DEBUG_SHOWNORMALS", "" );
     if( m_debugShowEdges )
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "SSAO_DEBUG_SHOWEDGES", "" ) );
+        newShaderMacros.emplace_back( "SSAO_DEBUG_SHOWEDGES", "" );
 
-    if( m_specialShaderMacro != pair<string, string>(std::make_pair( "", "" )) )
-        newShaderMacros.push_back( m_specialShaderMacro );
+    if( !m_specialShaderMacro.first.empty( ) || !m_specialShaderMacro.second.empty( ) )
+        newShaderMacros.emplace_back( m_specialShaderMacro.first, m_specialShaderMacro.second );
 
-    if( newShaderMacros != m_staticShaderMacros )
-    {
-        m_staticShaderMacros = newShaderMacros;
+    if( vaShaderMacrosUpdate( m_staticShaderMacros, newShaderMacros ) )
         m_shadersDirty = true;
-    }
 
     if( m_shadersDirty )
     {
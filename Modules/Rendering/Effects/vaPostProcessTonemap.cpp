@@ -121,36 +121,33 @@ void vaPostProcessTonemap::UpdateConstants( vaRenderDeviceContext & renderContex
 
 void vaPostProcessTonemap::UpdateShaders( int msaaSampleCount, const std::shared_ptr<vaTexture> & outMSTonemappedColor, const std::shared_ptr<vaTexture> & outMSTonemappedColorComplexityMask, const std::shared_ptr<vaTexture> & outExportLuma, bool waitCompileShaders )
 {
-    vector< pair< string, string > > newShaderMacros;
+    vaShaderMacroScratchList newShaderMacros;
     if( msaaSampleCount > 1 )
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_MSAA_SAMPLE_COUNT", vaStringTools::Format("%d", msaaSampleCount ) ) );
+        newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_MSAA_SAMPLE_COUNT", vaSmallString<32>::Format( "%d", msaaSampleCount ) );
 
     if( outMSTonemappedColor != nullptr )
     {
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR", "" ) );
+        newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR", "" );
 
         if( outMSTonemappedColor->GetUAVFormat() == vaResourceFormat::R8G8B8A8_UNORM )
-            newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_FMT_UNORM", "" ) );
+            newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_FMT_UNORM", "" );
         if( outMSTonemappedColor->GetSRVFormat() == vaResourceFormat::R8G8B8A8_UNORM_SRGB )
-            newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_FMT_REQUIRES_SRGB_CONVERSION", "" ) );
+            newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_FMT_REQUIRES_SRGB_CONVERSION", "" );
     }
     if( outMSTonemappedColorComplexityMask != nullptr )
     {
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_COMPLEXITY_MASK", "" ) );
+        newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_MS_TONEMAPPED_COLOR_COMPLEXITY_MASK", "" );
     }
     if( outExportLuma != nullptr )
     {
-        newShaderMacros.push_back( std::pair<std::string, std::string>( "POSTPROCESS_TONEMAP_OUTPUT_LUMA", "" ) );
+        newShaderMacros.emplace_back( "POSTPROCESS_TONEMAP_OUTPUT_LUMA", "" );
 
         // exporting luma not supported in MSAA scenario - not needed for now
         assert( msaaSampleCount == 1 );
     }
 
-    if( newShaderMacros != m_staticShaderMacros )
-    {
-        m_staticShaderMacros = newShaderMacros;
+    if( vaShaderMacrosUpdate( m_staticShaderMacros, newShaderMacros ) )
         m_shadersDirty = true;
-    }
 
     if( m_shadersDirty )
     {
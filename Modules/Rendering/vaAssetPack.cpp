@@ -26,11 +26,21 @@
 #include "Rendering/Misc/vaTextureReductionTestTool.h"
 
 #include "Core/System/vaCompressionStream.h"
+#include "Core/System/vaBufferedStream.h"
+#include "Core/System/vaPrefetchStream.h"
+#include "Core/System/vaMemoryStream.h"
+
+#include "Core/Misc/vaLZCodec.h"
+#include "Core/Misc/vaXXHash.h"
+
+#include "Core/Containers/vaSmallString.h"
 
 #include "Core/System/vaFileTools.h"
 
 #include "IntegratedExternals/vaImguiIntegration.h"
 
+#include <set>
+
 using namespace VertexAsylum;
 
 vaAssetTexture::vaAssetTexture( vaAssetPack & pack, const shared_ptr<vaTexture> & texture, const string & name ) 
@@ -58,11 +68,12 @@ vaAssetPack::~vaAssetPack( )
     RemoveAll( true );
 }
 
-void vaAssetPack::InsertAndTrackMe( shared_ptr<vaAsset> newAsset, bool lockMutex )
+void vaAssetPack::InsertAndTrackMe( shared_ptr<vaAsset> newAsset, bool lockMutex, bool track )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
-    m_assetMap.insert( std::pair< string, shared_ptr<vaAsset> >( vaStringTools::ToLower( newAsset->Name() ), newAsset ) );
+    newAsset->m_lookupName = LookupName( newAsset->Name(), true );
+    m_assetMap.insert( std::make_pair( newAsset->m_lookupName, newAsset ) );
     //    if( storagePath != L"" )
     //        m_assetMapByStoragePath.insert( std::pair< wstring, shared_ptr<vaAsset> >( vaStringTools::ToLower(newAsset->storagePath), newAsset ) );
 
@@ -72,24 +83,36 @@ void vaAssetPack::InsertAndTrackMe( shared_ptr<vaAsset> newAsset, bool lockMutex
 
     // it's ok if it's already tracked - for ex. render meshes are always tracked
     //if( !
+    if( track )
         newAsset->GetResource()->UIDObject_Track( ); // )
     //    VA_LOG_ERROR_STACKINFO( "Error registering asset '%s' - UID already used; this means there's another asset somewhere with the same UID", newAsset->Name().c_str() );
 }
 
+void vaAssetPack::TrackAssets( const vector< shared_ptr<vaAsset> > & assets )
+{
+    // one registrar lock per shard instead of one per asset
+    vector<vaUIDObject *> resources;
+    resources.reserve( assets.size() );
+    for( const shared_ptr<vaAsset> & asset : assets )
+        if( asset != nullptr )
+            resources.push_back( asset->GetResource().get() );
+    vaUIDObjectRegistrar::GetInstance( ).TrackBatch( resources.data(), (int)resources.size() );
+}
+
 string vaAssetPack::FindSuitableAssetName( const string & _nameSuggestion, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     const string & nameSuggestion = _nameSuggestion;
 
-    if( Find( nameSuggestion, false ) == nullptr )
+    if( !IsNameInUseNoLock( nameSuggestion ) )
         return nameSuggestion;
 
     int index = 0;
     do 
     {
         string newSuggestion = vaStringTools::Format( "%s_%d", nameSuggestion.c_str(), index );
-        if( Find( newSuggestion, false ) == nullptr )
+        if( !IsNameInUseNoLock( newSuggestion ) )
             return newSuggestion;
 
         index++;
@@ -99,9 +122,9 @@ string vaAssetPack::FindSuitableAssetName( const string & _nameSuggestion, bool
 
 shared_ptr<vaAssetTexture> vaAssetPack::Add( const std::shared_ptr<vaTexture> & texture, const string & name, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
-    if( Find( name, false ) != nullptr )
+    if( IsNameInUseNoLock( name ) )
     {
         assert( false );
         VA_LOG_ERROR( "Unable to add asset '%s' to the asset pack '%s' because the name already exists", name.c_str( ), m_name.c_str( ) );
@@ -118,9 +141,9 @@ shared_ptr<vaAssetTexture> vaAssetPack::Add( const std::shared_ptr<vaTexture> &
 
 shared_ptr<vaAssetRenderMesh> vaAssetPack::Add( const std::shared_ptr<vaRenderMesh> & mesh, const string & name, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
-    if( Find( name, false ) != nullptr )
+    if( IsNameInUseNoLock( name ) )
     {
         assert( false );
         VA_LOG_ERROR( "Unable to add asset '%s' to the asset pack '%s' because the name already exists", name.c_str( ), m_name.c_str( ) );
@@ -137,9 +160,9 @@ shared_ptr<vaAssetRenderMesh> vaAssetPack::Add( const std::shared_ptr<vaRenderMe
 
 shared_ptr<vaAssetRenderMaterial> vaAssetPack::Add( const std::shared_ptr<vaRenderMaterial> & material, const string & name, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
-    if( Find( name, false ) != nullptr )
+    if( IsNameInUseNoLock( name ) )
     {
         assert( false );
         VA_LOG_ERROR( "Unable to add asset '%s' to the asset pack '%s' because the name already exists", name.c_str(), m_name.c_str() );
@@ -172,7 +195,7 @@ bool vaAsset::Rename( const string & newName )
 
 bool vaAssetPack::RenameAsset( vaAsset & asset, const string & newName, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     if( &asset.m_parentPack != this )
     {
@@ -184,14 +207,14 @@ bool vaAssetPack::RenameAsset( vaAsset & asset, const string & newName, bool loc
         VA_LOG( "Changing asset name from '%s' to '%s' in asset pack '%s' - same name requested? Nothing changed.", asset.Name().c_str(), newName.c_str(), this->m_name.c_str()  );
         return true;
     }
-    if( Find( newName, false ) != nullptr )
+    if( IsNameInUseNoLock( newName ) )
     {
         VA_LOG_ERROR( "Unable to change asset name from '%s' to '%s' in asset pack '%s' - name already used by another asset!", asset.Name().c_str(), newName.c_str(), this->m_name.c_str()  );
         return false;
     }
 
     {
-        auto it = m_assetMap.find( vaStringTools::ToLower( asset.Name() ) );
+        auto it = m_assetMap.find( asset.m_lookupName );
 
         shared_ptr<vaAsset> assetSharedPtr;
 
@@ -208,8 +231,9 @@ bool vaAssetPack::RenameAsset( vaAsset & asset, const string & newName, bool loc
         }
 
         assetSharedPtr->m_name = newName;
+        assetSharedPtr->m_lookupName = LookupName( newName, true );
 
-        m_assetMap.insert( std::pair< string, shared_ptr<vaAsset> >( vaStringTools::ToLower( assetSharedPtr->Name() ), assetSharedPtr ) );
+        m_assetMap.insert( std::make_pair( assetSharedPtr->m_lookupName, assetSharedPtr ) );
     }
 
     VA_LOG( "Changing asset name from '%s' to '%s' in asset pack '%s' - success!", asset.Name().c_str(), newName.c_str(), this->m_name.c_str() );
@@ -218,7 +242,7 @@ bool vaAssetPack::RenameAsset( vaAsset & asset, const string & newName, bool loc
 
 void vaAssetPack::Remove( const shared_ptr<vaAsset> & asset, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     if( asset == nullptr )
         return;
@@ -236,7 +260,7 @@ void vaAssetPack::Remove( const shared_ptr<vaAsset> & asset, bool lockMutex )
     m_assetList.pop_back();
 
     {
-        auto it = m_assetMap.find( vaStringTools::ToLower(asset->Name()) );
+        auto it = m_assetMap.find( asset->m_lookupName );
 
         // possible memory leak! does the asset belong to another asset pack?
         assert( it != m_assetMap.end() );
@@ -262,16 +286,27 @@ void vaAssetPack::Remove( const shared_ptr<vaAsset> & asset, bool lockMutex )
 
 void vaAssetPack::RemoveAll( bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     assert( m_ioTask == nullptr || vaBackgroundTaskManager::GetInstance().IsFinished(m_ioTask) );
     m_storageMode = vaAssetPack::StorageMode::Unknown;
 
     // untrack the asset resources so no one can find them anymore using vaUIDObjectRegistrar
-    for( int i = 0; i < m_assetList.size( ); i++ )
     {
-        if( !m_assetList[i]->GetResource()->UIDObject_Untrack( ) )
-            VA_LOG_ERROR_STACKINFO( "Error untracking asset '%s' - not sure why it wasn't properly tracked", m_assetList[i]->Name().c_str() );
+        vector<vaUIDObject *> resources( m_assetList.size( ) );
+        bool allTracked = true;
+        for( int i = 0; i < m_assetList.size( ); i++ )
+        {
+            resources[i] = m_assetList[i]->GetResource().get();
+            allTracked &= resources[i]->UIDObject_IsTracked( );
+        }
+        if( !allTracked )
+        {
+            for( int i = 0; i < m_assetList.size( ); i++ )
+                if( !resources[i]->UIDObject_IsTracked( ) )
+                    VA_LOG_ERROR_STACKINFO( "Error untracking asset '%s' - not sure why it wasn't properly tracked", m_assetList[i]->Name().c_str() );
+        }
+        vaUIDObjectRegistrar::GetInstance( ).UntrackBatch( resources.data(), (int)resources.size() );
     }
 
     m_assetList.clear( );
@@ -283,9 +318,19 @@ void vaAssetPack::RemoveAll( bool lockMutex )
         assert( it->second.unique() );
     }
     m_assetMap.clear();
+
+    ReleaseLazyStorageNoLock( );
+
+    m_apackFilePath = L"";
+    m_apackFileEnd  = 0;
 }
 
-const int c_packFileVersion = 3;
+// 1-3: all assets in one (optionally whole-file compressed) stream, everything loaded up front
+// 4:   table of contents followed by independently compressed asset payloads, loaded on first use
+// 5:   UIDs only in the table of contents so identical payloads can be (and are) stored once
+// 6:   table of contents at the end, pointed to from the header, so that changed payloads can be appended (incremental save)
+// 7:   checksums of the payloads as stored and of the table of contents, so that files can be verified (see VerifyAPACK)
+const int c_packFileVersion = 7;
 
 bool vaAssetPack::IsBackgroundTaskActive( ) const
 {
@@ -312,147 +357,680 @@ void vaAssetPack::WaitUntilIOTaskFinished( bool breakIfSafe )
     }
 }
 
-bool vaAssetPack::SaveAPACK( const wstring & fileName, bool lockMutex )
+bool vaAssetPack::WriteAPACKHeader( vaStream & outStream, int64 size, int32 numberOfAssets, int64 posOfTOC, uint64 tocHash )
+{
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int64>( size ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int32>( c_packFileVersion ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int32>( numberOfAssets ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int64>( posOfTOC ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<uint64>( tocHash ) );
+    return true;
+}
+
+bool vaAssetPack::WriteAPACKPayload( vaStream & outStream, const void * payload, LazyEntry & entry, BlobMap & writtenBlobs )
+{
+    // entry.UncompressedSize and entry.Hash are expected to be filled in by the caller
+    auto blobKey = std::make_tuple( entry.Type, entry.Hash, entry.UncompressedSize );
+    auto blobIt = writtenBlobs.find( blobKey );
+    if( blobIt != writtenBlobs.end( ) )
+    {
+        static_cast<vaAsset::StoredPayload &>( entry ) = blobIt->second;
+        return true;
+    }
+
+    entry.Offset = outStream.GetPosition( );
+
+    vector<uint8> compressedBuffer( (size_t)vaLZCodec::GetMaxCompressedSize( entry.UncompressedSize ) );
+    int64 compressedSize = vaLZCodec::Compress( payload, entry.UncompressedSize, compressedBuffer.data( ), (int64)compressedBuffer.size( ) );
+
+    // store as is if it doesn't compress (already block compressed textures, etc.) - that's also what tells the loader it's not compressed
+    if( compressedSize < 0 || compressedSize >= entry.UncompressedSize )
+    {
+        entry.CompressedSize    = entry.UncompressedSize;
+        entry.StoredHash        = entry.Hash;
+        VERIFY_TRUE_RETURN_ON_FALSE( outStream.Write( payload, entry.UncompressedSize ) );
+    }
+    else
+    {
+        entry.CompressedSize    = compressedSize;
+        entry.StoredHash        = vaXXHash64::Compute( compressedBuffer.data( ), compressedSize );
+        VERIFY_TRUE_RETURN_ON_FALSE( outStream.Write( compressedBuffer.data( ), compressedSize ) );
+    }
+
+    writtenBlobs.insert( std::make_pair( blobKey, static_cast<const vaAsset::StoredPayload &>( entry ) ) );
+    return true;
+}
+
+bool vaAssetPack::FinishAPACK( vaStream & outStream, const vector<LazyEntry> & toc )
+{
+    // table of contents goes after the payloads; until the header gets rewritten to point to it, the file (when appending to
+    // an existing one) is still valid and refers to the previous one
+    int64 posOfTOC = outStream.GetPosition( );
+
+    // built in memory first so that it can be hashed
+    vaMemoryStream tocStream( (int64)0, 64 * (int64)toc.size( ) );
+    for( const LazyEntry & entry : toc )
+    {
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<vaGUID>( entry.UID ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<int32>( (int32)entry.Type ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteString( entry.Name ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<int64>( entry.Offset ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<int64>( entry.CompressedSize ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<int64>( entry.UncompressedSize ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<uint64>( entry.Hash ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( tocStream.WriteValue<uint64>( entry.StoredHash ) );
+    }
+    uint64 tocHash = vaXXHash64::Compute( tocStream.GetBuffer( ), tocStream.GetLength( ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.Write( tocStream.GetBuffer( ), tocStream.GetLength( ) ) );
+    int64 posOfEnd = outStream.GetPosition( );
+
+    outStream.Seek( 0 );
+    VERIFY_TRUE_RETURN_ON_FALSE( WriteAPACKHeader( outStream, posOfEnd, (int32)toc.size(), posOfTOC, tocHash ) );
+    outStream.Seek( posOfEnd );
+    return true;
+}
+
+bool vaAssetPack::SaveAPACK( const wstring & fileName, bool incremental, bool lockMutex )
 {
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
     WaitUntilIOTaskFinished( );
 
     std::unique_lock<mutex> apackStorageLock(m_apackStorageMutex);
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+
+    if( incremental )
+    {
+        if( CanSaveIncrementalNoLock( fileName ) )
+            return SaveAPACKIncrementalNoLock( fileName );
+        VA_LOG( L"vaAssetPack::SaveAPACK(%s) - not the file this pack was loaded from or saved to (or it was changed since), saving everything", fileName.c_str() );
+    }
+
+    // everything has to be in memory before saving - and the file we're writing to might be the one that's still mapped
+    MaterializeAllNoLock( );
+
     if( !m_apackStorage.Open( fileName, FileCreationMode::Create ) )
     {
         VA_LOG_ERROR( L"vaAssetPack::SaveAPACK(%s) - unable to create file for saving", fileName.c_str() );
         return false;
     }
 
-    vaStream & outStream = m_apackStorage;
-
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    // all small writes (the table of contents) go through the buffer, large payloads bypass it
+    vaBufferedStream outStream( &m_apackStorage );
 
     VERIFY_TRUE_RETURN_ON_FALSE( outStream.CanSeek( ) );
 
-    int64 posOfSize = outStream.GetPosition( );
-    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int64>( 0 ) );
+    // placeholder, FinishAPACK writes the real one
+    VERIFY_TRUE_RETURN_ON_FALSE( WriteAPACKHeader( outStream, 0, 0, 0, 0 ) );
 
-    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int32>( c_packFileVersion ) );
+    // identical payloads (same type, hash & size) get written only once, see LazyEntry
+    BlobMap writtenBlobs;
+
+    const vector< shared_ptr<vaAsset> > assets = GetAssetsSortedByNameNoLock( );
 
-    bool useWholeFileCompression = true;
-    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<bool>( useWholeFileCompression ) );
+    vector<LazyEntry> toc;
+    toc.reserve( assets.size() );
+    for( const shared_ptr<vaAsset> & assetPtr : assets )
+    {
+        vaAsset & asset = *assetPtr;
 
-    // If compressing, have to write into memory buffer for later compression because seeking while
-    // writing directly to a compression stream is not supported, and it's used here.
-    vaMemoryStream memStream( (int64)0, (useWholeFileCompression)?( 16*1024 ): (0) );
-    vaStream & outStreamInner = (useWholeFileCompression)?( memStream ):( outStream );
+        LazyEntry entry;
+        entry.UID   = asset.GetResourceObjectUID();
+        entry.Type  = asset.Type;
+        entry.Name  = asset.Name();
 
-    VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteValue<int32>( (int)m_assetMap.size() ) );
+        vaMemoryStream assetStream( (int64)0, 16 * 1024 );
+        VERIFY_TRUE_RETURN_ON_FALSE( asset.SaveAPACK( assetStream ) );
 
-    for( auto it = m_assetMap.begin( ); it != m_assetMap.end( ); it++ )
+        entry.UncompressedSize  = assetStream.GetLength( );
+        entry.Hash              = vaXXHash64::Compute( assetStream.GetBuffer( ), entry.UncompressedSize );
+        VERIFY_TRUE_RETURN_ON_FALSE( WriteAPACKPayload( outStream, assetStream.GetBuffer( ), entry, writtenBlobs ) );
+
+        toc.push_back( entry );
+    }
+
+    VERIFY_TRUE_RETURN_ON_FALSE( FinishAPACK( outStream, toc ) );
+    int64 fileEnd = outStream.GetPosition( );
+
+    outStream.Close( );
+    m_apackStorage.Close();
+    m_storageMode = StorageMode::APACK;
+
+    // all in sync with the file now
+    for( size_t index = 0; index < assets.size( ); index++ )
+    {
+        assets[index]->m_storedPayload  = toc[index];
+        assets[index]->m_dirty          = false;
+    }
+    m_apackFilePath = fileName;
+    m_apackFileEnd  = fileEnd;
+
+    return true;
+}
+
+bool vaAssetPack::CanSaveIncrementalNoLock( const wstring & fileName )
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    if( m_storageMode != StorageMode::APACK || m_apackFilePath == L"" || vaStringTools::CompareNoCase( m_apackFilePath, fileName ) != 0 )
+        return false;
+
+    // make sure no one else has written to it since
+    vaFileStream file;
+    int64 size = 0;
+    int32 fileVersion = 0;
+    return file.Open( fileName, FileCreationMode::Open, FileAccessMode::Read ) && file.ReadValue<int64>( size ) && file.ReadValue<int32>( fileVersion )
+        && size == m_apackFileEnd && fileVersion == c_packFileVersion && file.GetLength( ) >= size;
+}
+
+bool vaAssetPack::SaveAPACKIncrementalNoLock( const wstring & fileName )
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    // Not loaded assets could still be getting read from this file through m_lazyStorage, but nothing that's referenced gets 
+    // overwritten - all new data goes after the current end. Payloads and the table of contents that are no longer referenced
+    // become dead space until the next full save or CompactAPACK.
+    if( !m_apackStorage.Open( fileName, FileCreationMode::Open, FileAccessMode::ReadWrite ) )
     {
-        int64 posOfSubSize = outStreamInner.GetPosition( );
-        VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteValue<int64>( 0 ) );
+        VA_LOG_ERROR( L"vaAssetPack::SaveAPACK(%s) - unable to open file for appending", fileName.c_str() );
+        return false;
+    }
 
-        // write type
-        VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteValue<int32>( (int32)it->second->Type ) );
+    vaBufferedStream outStream( &m_apackStorage );
+    VERIFY_TRUE_RETURN_ON_FALSE( outStream.CanSeek( ) );
 
-        // write name
-        VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteString( it->first ) );
-        assert( vaStringTools::CompareNoCase( it->first, it->second->Name() ) == 0 );
+    // anything past the end (left over from an interrupted save for ex.) is garbage
+    outStream.Seek( m_apackFileEnd );
 
-        // write asset resource ID
-        VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteValue<vaGUID>( it->second->GetResourceObjectUID() ) );
+    BlobMap writtenBlobs;
+    vector<LazyEntry> toc;
+    vector<vaAsset *> tocAssets;    // nullptr for ones not loaded
 
-        // write asset
-        VERIFY_TRUE_RETURN_ON_FALSE( it->second->SaveAPACK( outStreamInner ) );
+    auto addExistingBlob = [ &writtenBlobs ]( const LazyEntry & entry )
+    {
+        writtenBlobs.insert( std::make_pair( std::make_tuple( entry.Type, entry.Hash, entry.UncompressedSize ), static_cast<const vaAsset::StoredPayload &>( entry ) ) );
+    };
 
-        int64 calculatedSubSize = outStreamInner.GetPosition() - posOfSubSize;
-        // auto aaaa = outStreamInner.GetPosition();
-        outStreamInner.Seek( posOfSubSize );
-        VERIFY_TRUE_RETURN_ON_FALSE( outStreamInner.WriteValue<int64>( calculatedSubSize ) );
-        outStreamInner.Seek( posOfSubSize + calculatedSubSize );
+    // the ones not loaded can't have changed
+    for( auto it = m_lazyByUID.begin( ); it != m_lazyByUID.end( ); it++ )
+    {
+        const LazyEntry & entry = m_lazyEntries[it->second];
+        addExistingBlob( entry );
+        toc.push_back( entry );
+        tocAssets.push_back( nullptr );
     }
 
-    if( useWholeFileCompression )
+    int rewrittenCount = 0;
+    for( const shared_ptr<vaAsset> & assetPtr : GetAssetsSortedByNameNoLock( ) )
     {
-        vaCompressionStream outCompressionStream( false, &outStream );
-        // just dump the whole buffer and we're done!
-        VERIFY_TRUE_RETURN_ON_FALSE( outCompressionStream.Write( memStream.GetBuffer(), memStream.GetLength() ) );
+        vaAsset & asset = *assetPtr;
+
+        LazyEntry entry;
+        static_cast<vaAsset::StoredPayload &>( entry ) = asset.m_storedPayload;
+        entry.UID   = asset.GetResourceObjectUID();
+        entry.Type  = asset.Type;
+        entry.Name  = asset.Name();
+
+        if( asset.m_dirty || entry.Offset < 0 )
+        {
+            vaMemoryStream assetStream( (int64)0, 16 * 1024 );
+            VERIFY_TRUE_RETURN_ON_FALSE( asset.SaveAPACK( assetStream ) );
+
+            int64 size  = assetStream.GetLength( );
+            uint64 hash = vaXXHash64::Compute( assetStream.GetBuffer( ), size );
+
+            // dirty doesn't necessarily mean changed
+            if( entry.Offset < 0 || entry.UncompressedSize != size || entry.Hash != hash )
+            {
+                entry.UncompressedSize  = size;
+                entry.Hash              = hash;
+                VERIFY_TRUE_RETURN_ON_FALSE( WriteAPACKPayload( outStream, assetStream.GetBuffer( ), entry, writtenBlobs ) );
+                rewrittenCount++;
+            }
+        }
+        addExistingBlob( entry );
+
+        toc.push_back( entry );
+        tocAssets.push_back( &asset );
     }
 
-    int64 calculatedSize = outStream.GetPosition( ) - posOfSize;
-    outStream.Seek( posOfSize );
-    VERIFY_TRUE_RETURN_ON_FALSE( outStream.WriteValue<int64>( calculatedSize ) );
-    outStream.Seek( posOfSize + calculatedSize );
+    int64 appendedSize = outStream.GetPosition( ) - m_apackFileEnd;
 
+    VERIFY_TRUE_RETURN_ON_FALSE( FinishAPACK( outStream, toc ) );
+    int64 fileEnd = outStream.GetPosition( );
+
+    outStream.Close( );
     m_apackStorage.Close();
-    m_storageMode = StorageMode::APACK;
 
+    for( size_t i = 0; i < toc.size( ); i++ )
+    {
+        if( tocAssets[i] == nullptr )
+            continue;
+        tocAssets[i]->m_storedPayload   = toc[i];
+        tocAssets[i]->m_dirty           = false;
+    }
+    m_apackFileEnd = fileEnd;
+
+    VA_LOG( L"vaAssetPack::SaveAPACK(%s) - incremental: %d of %d assets written (%.2f MB)", fileName.c_str(), rewrittenCount, (int)toc.size(), (float)appendedSize / (1024.0f * 1024.0f) );
+
+    return true;
+}
+
+bool vaAssetPack::CompactAPACK( const wstring & fileName )
+{
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
+    wstring tempFileName = fileName + L".compacting";
+    int64 oldSize = 0;
+    int64 newSize = 0;
+    {
+        vaMappedFileStream inStream;
+        if( !inStream.Open( fileName ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::CompactAPACK(%s) - unable to open file", fileName.c_str() );
+            return false;
+        }
+
+        int32 fileVersion = 0;
+        vector<LazyEntry> toc;
+        if( !ReadAPACKTableOfContents( inStream, fileVersion, oldSize, toc ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::CompactAPACK(%s) - not an .apack or an unsupported version", fileName.c_str() );
+            return false;
+        }
+        if( fileVersion < 6 )
+        {
+            // older versions were always written in one go
+            VA_LOG( L"vaAssetPack::CompactAPACK(%s) - old file version, nothing to do", fileName.c_str() );
+            return true;
+        }
+
+        // don't carry corrupted payloads over into a file with fresh checksums
+        vector<VerifyTarget> verifyTargets( 1 );
+        verifyTargets[0].FileName       = fileName;
+        verifyTargets[0].Storage        = &inStream;
+        verifyTargets[0].FileVersion    = fileVersion;
+        verifyTargets[0].Entries        = &toc;
+        if( !VerifyAPACKPayloads( verifyTargets, true ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::CompactAPACK(%s) - file is corrupted, not compacting", fileName.c_str() );
+            return false;
+        }
+
+        vaFileStream outFile;
+        if( !outFile.Open( tempFileName, FileCreationMode::Create ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::CompactAPACK(%s) - unable to create '%s'", fileName.c_str(), tempFileName.c_str() );
+            return false;
+        }
+        vaBufferedStream outStream( &outFile );
+        VERIFY_TRUE_RETURN_ON_FALSE( WriteAPACKHeader( outStream, 0, 0, 0, 0 ) );
+
+        // copy every referenced blob once, in the order they're in the file
+        std::map< int64, std::pair<int64, int64> > blobs;     // old offset -> ( size, new offset )
+        for( const LazyEntry & entry : toc )
+            blobs.insert( std::make_pair( entry.Offset, std::make_pair( entry.CompressedSize, (int64)-1 ) ) );
+        for( auto it = blobs.begin( ); it != blobs.end( ); it++ )
+        {
+            const uint8 * blob = inStream.GetView( it->first, it->second.first );
+            VERIFY_TRUE_RETURN_ON_FALSE( blob != nullptr || it->second.first == 0 );
+            it->second.second = outStream.GetPosition( );
+            VERIFY_TRUE_RETURN_ON_FALSE( outStream.Write( blob, it->second.first ) );
+        }
+        for( LazyEntry & entry : toc )
+        {
+            // version 6 has no stored hashes; it's the same as Hash for blobs stored uncompressed
+            if( fileVersion < 7 )
+                entry.StoredHash = ( entry.CompressedSize == entry.UncompressedSize ) ? ( entry.Hash ) : ( vaXXHash64::Compute( inStream.GetView( entry.Offset, entry.CompressedSize ), entry.CompressedSize ) );
+            entry.Offset = blobs[entry.Offset].second;
+        }
+
+        VERIFY_TRUE_RETURN_ON_FALSE( FinishAPACK( outStream, toc ) );
+        newSize = outStream.GetPosition( );
+        outStream.Close( );
+        outFile.Close( );
+    }
+
+    if( !vaFileTools::DeleteFile( fileName ) || !vaFileTools::MoveFile( tempFileName, fileName ) )
+    {
+        VA_LOG_ERROR( L"vaAssetPack::CompactAPACK(%s) - unable to replace the file (is it in use?), compacted version left in '%s'", fileName.c_str(), tempFileName.c_str() );
+        return false;
+    }
+
+    VA_LOG( L"vaAssetPack::CompactAPACK(%s) - %.2f MB -> %.2f MB", fileName.c_str(), (float)oldSize / (1024.0f * 1024.0f), (float)newSize / (1024.0f * 1024.0f) );
+    return true;
+}
+
+bool vaAssetPack::VerifyAPACKEntry( const uint8 * blob, int32 fileVersion, const LazyEntry & entry, string & outError )
+{
+    if( blob == nullptr )
+    {
+        outError = "out of the file's bounds";
+        return false;
+    }
+
+    if( fileVersion >= 7 )
+    {
+        uint64 storedHash = vaXXHash64::Compute( blob, entry.CompressedSize );
+        if( storedHash != entry.StoredHash )
+        {
+            outError = vaStringTools::Format( "checksum mismatch (expected 0x%016llx, got 0x%016llx)", entry.StoredHash, storedHash );
+            return false;
+        }
+        return true;
+    }
+
+    // older versions only have the hash of the uncompressed payload
+    vector<uint8> decompressed;
+    const uint8 * data = blob;
+    if( entry.CompressedSize != entry.UncompressedSize )
+    {
+        decompressed.resize( (size_t)entry.UncompressedSize );
+        if( !vaLZCodec::Decompress( blob, entry.CompressedSize, decompressed.data( ), entry.UncompressedSize ) )
+        {
+            outError = "unable to decompress";
+            return false;
+        }
+        data = decompressed.data( );
+    }
+    uint64 hash = vaXXHash64::Compute( data, entry.UncompressedSize );
+    if( hash != entry.Hash )
+    {
+        outError = vaStringTools::Format( "checksum mismatch (expected 0x%016llx, got 0x%016llx)", entry.Hash, hash );
+        return false;
+    }
     return true;
 }
 
+bool vaAssetPack::VerifyAPACKPayloads( vector<VerifyTarget> & targets, bool stopOnFirstFailure )
+{
+    // one job per unique blob of every file, biggest first so that the last ones to finish are small
+    struct Job
+    {
+        int                         Target;
+        int                         Entry;
+        int64                       Size;
+    };
+    vector<Job> jobs;
+    for( int t = 0; t < (int)targets.size( ); t++ )
+    {
+        std::set<int64> seenBlobs;
+        const vector<LazyEntry> & entries = *targets[t].Entries;
+        for( int e = 0; e < (int)entries.size( ); e++ )
+            if( seenBlobs.insert( entries[e].Offset ).second )
+                jobs.push_back( { t, e, entries[e].CompressedSize } );
+    }
+    std::sort( jobs.begin( ), jobs.end( ), [ ]( const Job & a, const Job & b ) { return a.Size > b.Size; } );
+
+    std::atomic_bool anyFailed( false );
+    mutex failureMutex;
+    vaThreading::ParallelFor( (int)jobs.size( ), [ &targets, &jobs, &anyFailed, &failureMutex, stopOnFirstFailure ]( int i )
+    {
+        if( stopOnFirstFailure && anyFailed.load( std::memory_order_relaxed ) )
+            return;
+
+        VerifyTarget & target   = targets[ jobs[i].Target ];
+        const LazyEntry & entry = (*target.Entries)[ jobs[i].Entry ];
+        string error;
+        if( VerifyAPACKEntry( target.Storage->GetView( entry.Offset, entry.CompressedSize ), target.FileVersion, entry, error ) )
+            return;
+
+        anyFailed.store( true, std::memory_order_relaxed );
+
+        // report the first one in the file, regardless of which got checked first
+        std::unique_lock<mutex> failureLock( failureMutex );
+        if( target.FailureOffset < 0 || entry.Offset < target.FailureOffset )
+        {
+            target.FailureOffset    = entry.Offset;
+            target.Failure          = vaStringTools::Format( "asset '%s' at offset %lld (%lld bytes): %s", entry.Name.c_str(), entry.Offset, entry.CompressedSize, error.c_str() );
+        }
+    } );
+
+    for( const VerifyTarget & target : targets )
+        if( target.FailureOffset >= 0 )
+            VA_LOG_ERROR( L"vaAssetPack::VerifyAPACK(%s) - corrupted payload of %s", target.FileName.c_str(), vaStringTools::SimpleWiden( target.Failure ).c_str() );
+
+    return !anyFailed;
+}
+
+bool vaAssetPack::VerifyAPACK( const vector<wstring> & fileNames, bool stopOnFirstFailure, vector<wstring> * outFailedFiles )
+{
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
+    vaSimpleScopeTimerLog timerLog( vaStringTools::Format( L"Verifying %d .apack file(s)", (int)fileNames.size( ) ) );
+
+    if( outFailedFiles != nullptr )
+        outFailedFiles->clear( );
+
+    // open all and read their tables of contents first; the payloads of all of them then get verified in one go, which 
+    // keeps all threads busy even with many small files
+    vector<shared_ptr<vaMappedFileStream>>  storages;
+    vector<vector<LazyEntry>>               tocs( fileNames.size( ) );
+    vector<VerifyTarget>                    targets;
+    int failedCount = 0;
+    int64 totalSize = 0;
+    for( int i = 0; i < (int)fileNames.size( ); i++ )
+    {
+        const wstring & fileName = fileNames[i];
+        shared_ptr<vaMappedFileStream> storage = std::make_shared<vaMappedFileStream>( );
+
+        int64 size = 0;
+        int32 fileVersion = 0;
+        bool opened = storage->Open( fileName );
+        if( opened && storage->ReadValue<int64>( size ) && storage->ReadValue<int32>( fileVersion ) && fileVersion >= 1 && fileVersion < 4 )
+        {
+            VA_LOG_WARNING( L"vaAssetPack::VerifyAPACK(%s) - file version %d can't be verified without loading it, skipping", fileName.c_str(), fileVersion );
+            continue;
+        }
+        storage->Seek( 0 );
+
+        if( !opened || !ReadAPACKTableOfContents( *storage, fileVersion, size, tocs[i] ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::VerifyAPACK(%s) - %s", fileName.c_str(), (opened)?(L"unable to read the table of contents (see above)"):(L"unable to open file") );
+            if( outFailedFiles != nullptr )
+                outFailedFiles->push_back( fileName );
+            failedCount++;
+            if( stopOnFirstFailure )
+                return false;
+            continue;
+        }
+
+        VerifyTarget target;
+        target.FileName     = fileName;
+        target.Storage      = storage.get( );
+        target.FileVersion  = fileVersion;
+        target.Entries      = &tocs[i];
+        targets.push_back( target );
+        storages.push_back( storage );
+        totalSize += size;
+    }
+
+    if( !VerifyAPACKPayloads( targets, stopOnFirstFailure ) )
+    {
+        for( const VerifyTarget & target : targets )
+        {
+            if( target.FailureOffset < 0 )
+                continue;
+            if( outFailedFiles != nullptr )
+                outFailedFiles->push_back( target.FileName );
+            failedCount++;
+        }
+    }
+
+    if( failedCount == 0 )
+        VA_LOG( L"vaAssetPack::VerifyAPACK - %d file(s), %.2f MB, all OK", (int)targets.size( ), (float)totalSize / (1024.0f * 1024.0f) );
+    else if( stopOnFirstFailure )
+        VA_LOG_ERROR( L"vaAssetPack::VerifyAPACK - stopped at the first corrupted file" );
+    else
+        VA_LOG_ERROR( L"vaAssetPack::VerifyAPACK - %d of %d file(s) corrupted", failedCount, (int)fileNames.size( ) );
+
+    return failedCount == 0;
+}
+
+shared_ptr<vaAsset> vaAssetPack::CreateAndLoadAPACK( vaAssetType assetType, const string & name, const vaGUID & uid, const uint8 * data, int64 dataSize, uint64 contentHash )
+{
+    // Materials are not shared: they're small and they get edited in place; textures and meshes only ever get replaced.
+    bool shareable = ( assetType == vaAssetType::Texture ) || ( assetType == vaAssetType::RenderMesh );
+
+    if( shareable )
+    {
+        shared_ptr<vaAssetResource> original = m_assetPackManager.FindSharedContent( assetType, contentHash, dataSize );
+        if( original != nullptr )
+        {
+            shared_ptr<vaAsset> newAsset;
+            if( assetType == vaAssetType::Texture )
+                newAsset = shared_ptr<vaAsset>( vaAssetTexture::CreateSharingContent( *this, name, uid, std::dynamic_pointer_cast<vaTexture>( original ) ) );
+            else
+                newAsset = shared_ptr<vaAsset>( vaAssetRenderMesh::CreateSharingContent( *this, name, uid, std::dynamic_pointer_cast<vaRenderMesh>( original ) ) );
+            if( newAsset != nullptr )
+                return newAsset;
+            // if that failed for whatever reason, just load it
+        }
+    }
+
+    vaMemoryStream inStream( (void*)data, dataSize );
+    shared_ptr<vaAsset> newAsset;
+    switch( assetType )
+    {
+    case VertexAsylum::vaAssetType::Texture:
+        newAsset = shared_ptr<vaAsset>( vaAssetTexture::CreateAndLoadAPACK( *this, name, uid, inStream ) );                   break;
+    case VertexAsylum::vaAssetType::RenderMesh:
+        newAsset = shared_ptr<vaAsset>( vaAssetRenderMesh::CreateAndLoadAPACK( *this, name, uid, inStream ) );                break;
+    case VertexAsylum::vaAssetType::RenderMaterial:
+        newAsset = shared_ptr<vaAsset>( vaAssetRenderMaterial::CreateAndLoadAPACK( *this, name, uid, inStream ) );            break;
+    default:
+        return nullptr;
+    }
+
+    if( shareable && newAsset != nullptr )
+        m_assetPackManager.RegisterSharedContent( assetType, contentHash, dataSize, newAsset->GetResource( ) );
+
+    return newAsset;
+}
+
 bool vaAssetPack::LoadAPACKInner( vaStream & inStream, vector< shared_ptr<vaAsset> > & loadedAssets, vaBackgroundTaskManager::TaskContext & taskContext )
 {
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
     m_assetStorageMutex.assert_locked_by_caller();
 
+    // progress: reading/inflating records is a small part, deserializing (resource creation) is the bulk of the work
+    const float readProgressShare = 0.2f;
+
     int32 numberOfAssets = 0;
     VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( numberOfAssets ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( numberOfAssets >= 0 );
+
+    // Each asset is prefixed by its size so the stream gets sliced up into per-asset buffers (the stream is forward only so
+    // this part has to be sequential) which are then deserialized in parallel. Done in windows of up to c_windowBytes so that
+    // peak memory doesn't include a copy of the whole (multi-GB) uncompressed pack.
+    const int64 c_windowBytes   = 256 * 1024 * 1024;
+    const int64 c_readStepBytes = 64 * 1024 * 1024;
+    vector< shared_ptr<vaAsset> > newAssets;      // grown per window as numberOfAssets comes from the data too
+    vector< vector<uint8> > records;
+    std::atomic_int doneCount = 0;
+    const bool concurrentCreation = m_assetPackManager.GetRenderDevice( ).IsConcurrentResourceCreationSupported( );
+    assert( concurrentCreation ); // all current backends support it - if this fires, loading still works but is serial
+    for( int windowStart = 0; windowStart < numberOfAssets; )
+    {
+        records.clear( );
+        int64 windowBytes = 0;
+        while( windowStart + (int)records.size( ) < numberOfAssets && windowBytes < c_windowBytes )
+        {
+            int64 subSize = 0;
+            VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( subSize ) );
+            subSize -= sizeof(int64);   // includes itself
+            VERIFY_TRUE_RETURN_ON_FALSE( subSize > 0 );
+
+            // the size comes from the data: check it against what's left when that's known, otherwise read in steps so that
+            // a corrupted size fails at the end of the stream instead of getting allocated up front
+            if( inStream.CanSeek( ) )
+                VERIFY_TRUE_RETURN_ON_FALSE( subSize <= inStream.GetLength( ) - inStream.GetPosition( ) );
+            records.push_back( vector<uint8>( ) );
+            vector<uint8> & record = records.back( );
+            for( int64 readSoFar = 0; readSoFar < subSize; )
+            {
+                int64 step = vaMath::Min( c_readStepBytes, subSize - readSoFar );
+                record.resize( (size_t)( readSoFar + step ) );
+                VERIFY_TRUE_RETURN_ON_FALSE( inStream.Read( record.data( ) + readSoFar, step ) );
+                readSoFar += step;
+            }
+            windowBytes += subSize;
 
-    for( int i = 0; i < numberOfAssets; i++ )
-    {
-        taskContext.Progress = float(i) / float(numberOfAssets-1);
+            taskContext.Progress = readProgressShare * float(windowStart + records.size( )) / float(numberOfAssets) + ( 1.0f - readProgressShare ) * float(doneCount) / float(numberOfAssets);
+        }
+
+        newAssets.resize( windowStart + records.size( ) );
 
-        int64 subSize = 0;
-        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( subSize ) );
+        // Resource creation from worker threads relies on the render device's threading contract (see 
+        // vaRenderDevice::IsConcurrentResourceCreationSupported); nothing touches the pack here, names get fixed up and
+        // assets inserted below in the original order.
+        auto loadRecord = [ this, &records, &newAssets, &doneCount, &taskContext, windowStart, numberOfAssets, readProgressShare ]( int i )
+        {
+            VA_MEMORY_TAG_SCOPE( AssetPack );
+
+            vaMemoryStream recordStream( records[i].data(), (int64)records[i].size() );
 
-        // read type
-        vaAssetType assetType;
-        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( (int32&)assetType ) );
+            vaAssetType assetType;
+            string assetName;
+            vaGUID uid;
+            if( recordStream.ReadValue<int32>( (int32&)assetType ) && recordStream.ReadString( assetName ) && recordStream.ReadValue<vaGUID>( uid ) )
+            {
+                // old formats have no content hashes stored, so compute them here
+                const uint8 * data  = records[i].data() + recordStream.GetPosition( );
+                int64 dataSize      = recordStream.GetLength( ) - recordStream.GetPosition( );
+                newAssets[windowStart + i] = CreateAndLoadAPACK( assetType, assetName, uid, data, dataSize, vaXXHash64::Compute( data, dataSize ) );
+            }
 
-        // read name
-        string newAssetName;
-        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadString( newAssetName ) );
+            // no longer needed, free as we go
+            vector<uint8>( ).swap( records[i] );
 
-        string suitableName = FindSuitableAssetName( newAssetName, false );
-        if( suitableName != newAssetName )
+            taskContext.Progress = readProgressShare * float(windowStart + records.size( )) / float(numberOfAssets) + ( 1.0f - readProgressShare ) * float(++doneCount) / float(numberOfAssets);
+        };
+        if( concurrentCreation )
+            vaThreading::ParallelFor( (int)records.size( ), loadRecord );
+        else
         {
-            VA_LOG_WARNING( "There's already an asset with the name '%s' - renaming the new one to '%s'", newAssetName.c_str(), suitableName.c_str() );
-            newAssetName = suitableName;
+            for( int i = 0; i < (int)records.size( ); i++ )
+                loadRecord( i );
         }
-        if( Find( newAssetName, false ) != nullptr )
+        windowStart += (int)records.size( );
+    }
+
+    for( int i = 0; i < numberOfAssets; i++ )
+    {
+        if( newAssets[i] == nullptr )
         {
-            VA_LOG_ERROR( L"vaAssetPack::Load(): duplicated asset name, stopping loading." );
-            assert( false );
+            VA_LOG_ERROR( "Error while loading an asset - see log file above for more info - aborting loading." );
             return false;
         }
+    }
 
-        shared_ptr<vaAsset> newAsset = nullptr;
+    // inserted in order, then all tracked at once
+    for( int i = 0; i < numberOfAssets; i++ )
+    {
+        shared_ptr<vaAsset> & newAsset = newAssets[i];
 
-        switch( assetType )
+        string suitableName = FindSuitableAssetName( newAsset->Name(), false );
+        if( suitableName != newAsset->Name() )
         {
-        case VertexAsylum::vaAssetType::Texture:
-            newAsset = shared_ptr<vaAsset>( vaAssetTexture::CreateAndLoadAPACK( *this, newAssetName, inStream ) );
-            break;
-        case VertexAsylum::vaAssetType::RenderMesh:
-            newAsset = shared_ptr<vaAsset>( vaAssetRenderMesh::CreateAndLoadAPACK( *this, newAssetName, inStream ) );
-            break;
-        case VertexAsylum::vaAssetType::RenderMaterial:
-            newAsset = shared_ptr<vaAsset>( vaAssetRenderMaterial::CreateAndLoadAPACK( *this, newAssetName, inStream ) );
-            break;
-        default:
-            break;
+            VA_LOG_WARNING( "There's already an asset with the name '%s' - renaming the new one to '%s'", newAsset->Name().c_str(), suitableName.c_str() );
+            newAsset->m_name = suitableName;
         }
-
-        if( newAsset == nullptr )
+        if( IsNameInUseNoLock( newAsset->Name() ) )
         {
-            VA_LOG_ERROR( "Error while loading an asset - see log file above for more info - aborting loading." );
+            VA_LOG_ERROR( L"vaAssetPack::Load(): duplicated asset name, stopping loading." );
+            assert( false );
+            newAssets.resize( i );
+            TrackAssets( newAssets );
             return false;
         }
-        else
-        {
-            VERIFY_TRUE_RETURN_ON_FALSE( newAsset != nullptr );
 
-            InsertAndTrackMe( newAsset, false );
+        InsertAndTrackMe( newAsset, false, false );
 
-            loadedAssets.push_back( newAsset );
-        }
+        loadedAssets.push_back( newAsset );
     }
+    TrackAssets( newAssets );
     return true;
 }
 
@@ -469,7 +1047,7 @@ bool vaAssetPack::LoadAPACK( const wstring & fileName, bool async, bool lockMute
 
     vaStream & inStream = m_apackStorage;
 
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     RemoveAll( false );
 
@@ -478,12 +1056,26 @@ bool vaAssetPack::LoadAPACK( const wstring & fileName, bool async, bool lockMute
 
     int32 fileVersion = 0;
     VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( fileVersion ) );
-    if( fileVersion < 1 || fileVersion > 3 )
+    if( fileVersion < 1 || fileVersion > c_packFileVersion )
     {
         VA_LOG_ERROR( L"vaAssetPack::Load(): unsupported file version" );
         return false;
     }
 
+    // new format: just read the table of contents, assets get loaded when first needed
+    if( fileVersion >= 4 )
+    {
+        m_apackStorage.Close( );
+        if( !LoadAPACKTableOfContents( fileName ) )
+        {
+            VA_LOG_ERROR( L"vaAssetPack::LoadAPACK(%s) - error reading the table of contents", fileName.c_str() );
+            RemoveAll( false );
+            return false;
+        }
+        m_storageMode = StorageMode::APACK;
+        return true;
+    }
+
     m_storageMode = StorageMode::APACK;
 
     bool useWholeFileCompression = false;
@@ -499,20 +1091,28 @@ bool vaAssetPack::LoadAPACK( const wstring & fileName, bool async, bool lockMute
     // async stuff here. 
     auto loadingLambda = [this, &inStream, useWholeFileCompression]( vaBackgroundTaskManager::TaskContext & context ) 
     {
+        VA_MEMORY_TAG_SCOPE( AssetPack );
+
         vector< shared_ptr<vaAsset> > loadedAssets;
 
         std::unique_lock<mutex> apackStorageLock(m_apackStorageMutex);
-        std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex);
+        std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex);
 
+        // The file is read ahead on a separate thread so disk I/O overlaps with decompression and parsing.
+        // LoadAPACKInner does lots of small reads; buffer them so they don't each go through zlib.
         bool success;
-        if( useWholeFileCompression )
-        {
-            vaCompressionStream decompressor( true, &inStream );
-            success = LoadAPACKInner( decompressor, loadedAssets, context );
-        }
-        else
         {
-            success = LoadAPACKInner( inStream, loadedAssets, context );
+            vaPrefetchStream prefetchStream( &inStream );
+            if( useWholeFileCompression )
+            {
+                vaCompressionStream decompressor( true, &prefetchStream );
+                vaBufferedStream bufferedStream( &decompressor );
+                success = LoadAPACKInner( bufferedStream, loadedAssets, context );
+            }
+            else
+            {
+                success = LoadAPACKInner( prefetchStream, loadedAssets, context );
+            }
         }
 
         m_apackStorage.Close();
@@ -539,12 +1139,364 @@ bool vaAssetPack::LoadAPACK( const wstring & fileName, bool async, bool lockMute
     return true;
 }
 
+bool vaAssetPack::ReadAPACKTableOfContents( vaStream & inStream, int32 & outFileVersion, int64 & outSize, vector<LazyEntry> & outEntries )
+{
+    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( outSize ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( outFileVersion ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( outFileVersion >= 4 && outFileVersion <= c_packFileVersion );
+
+    // most likely an interrupted copy - not a reason to assert
+    if( outSize > inStream.GetLength( ) )
+    {
+        VA_LOG_ERROR( "vaAssetPack::ReadAPACKTableOfContents(): file is truncated (%lld bytes, header says %lld)", inStream.GetLength( ), outSize );
+        return false;
+    }
+
+    int32 numberOfAssets = 0;
+    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( numberOfAssets ) );
+    VERIFY_TRUE_RETURN_ON_FALSE( numberOfAssets >= 0 );
+
+    // before version 6 it directly follows the header
+    if( outFileVersion >= 6 )
+    {
+        int64 posOfTOC = 0;
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( posOfTOC ) );
+        uint64 tocHash = 0;
+        if( outFileVersion >= 7 )
+            VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<uint64>( tocHash ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( posOfTOC >= inStream.GetPosition( ) && posOfTOC <= outSize );
+        inStream.Seek( posOfTOC );
+
+        // from version 7 on, the whole table of contents gets checked before any of it is used
+        if( outFileVersion >= 7 )
+        {
+            vector<uint8> tocData( (size_t)( outSize - posOfTOC ) );
+            VERIFY_TRUE_RETURN_ON_FALSE( tocData.size( ) == 0 || inStream.Read( tocData.data( ), (int64)tocData.size( ) ) );
+            if( vaXXHash64::Compute( tocData.data( ), (int64)tocData.size( ) ) != tocHash )
+            {
+                VA_LOG_ERROR( "vaAssetPack::ReadAPACKTableOfContents(): table of contents (offset %lld, %lld bytes) is corrupted", posOfTOC, (int64)tocData.size( ) );
+                return false;
+            }
+            vaMemoryStream tocStream( tocData.data( ), (int64)tocData.size( ) );
+            return ReadAPACKTableOfContentsEntries( tocStream, outFileVersion, outSize, numberOfAssets, outEntries );
+        }
+    }
+
+    return ReadAPACKTableOfContentsEntries( inStream, outFileVersion, outSize, numberOfAssets, outEntries );
+}
+
+bool vaAssetPack::ReadAPACKTableOfContentsEntries( vaStream & inStream, int32 fileVersion, int64 fileSize, int32 numberOfAssets, vector<LazyEntry> & outEntries )
+{
+    outEntries.resize( numberOfAssets );
+    for( int i = 0; i < numberOfAssets; i++ )
+    {
+        LazyEntry & entry = outEntries[i];
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<vaGUID>( entry.UID ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int32>( (int32&)entry.Type ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadString( entry.Name ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( entry.Offset ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( entry.CompressedSize ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<int64>( entry.UncompressedSize ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<uint64>( entry.Hash ) );
+        if( fileVersion >= 7 )
+            VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<uint64>( entry.StoredHash ) );
+
+        if( entry.Type < (vaAssetType)0 || entry.Type >= vaAssetType::MaxVal || entry.Offset < 0 || entry.CompressedSize < 0 
+            || entry.UncompressedSize < 0 || entry.CompressedSize > entry.UncompressedSize || entry.Offset + entry.CompressedSize > fileSize )
+        {
+            VA_LOG_ERROR( "vaAssetPack::ReadAPACKTableOfContents(): invalid entry for asset '%s'", entry.Name.c_str() );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool vaAssetPack::LoadAPACKTableOfContents( const wstring & fileName )
+{
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
+    m_assetStorageMutex.assert_locked_by_caller();
+    assert( m_lazyEntries.size() == 0 && !m_lazyStorage.IsOpen() );
+
+    if( !m_lazyStorage.Open( fileName ) )
+        return false;
+
+    int64 size = 0;
+    int32 fileVersion = 0;
+    if( !ReadAPACKTableOfContents( m_lazyStorage, fileVersion, size, m_lazyEntries ) )
+        return false;
+    m_lazyFileVersion = fileVersion;
+
+    if( m_assetPackManager.GetVerifyPacksOnLoad( ) )
+    {
+        vector<VerifyTarget> verifyTargets( 1 );
+        verifyTargets[0].FileName       = fileName;
+        verifyTargets[0].Storage        = &m_lazyStorage;
+        verifyTargets[0].FileVersion    = fileVersion;
+        verifyTargets[0].Entries        = &m_lazyEntries;
+        if( !VerifyAPACKPayloads( verifyTargets, true ) )
+            return false;
+        m_lazyVerified = true;
+    }
+
+    for( int i = 0; i < (int)m_lazyEntries.size( ); i++ )
+    {
+        LazyEntry & entry = m_lazyEntries[i];
+
+        string suitableName = FindSuitableAssetName( entry.Name, false );
+        if( suitableName != entry.Name )
+        {
+            VA_LOG_WARNING( "There's already an asset with the name '%s' - renaming the new one to '%s'", entry.Name.c_str(), suitableName.c_str() );
+            entry.Name = suitableName;
+        }
+        if( m_lazyByUID.find( entry.UID ) != m_lazyByUID.end( ) )
+        {
+            VA_LOG_ERROR( "vaAssetPack::LoadAPACKTableOfContents(): duplicated asset UID for '%s'", entry.Name.c_str() );
+            return false;
+        }
+
+        m_lazyByName.insert( std::make_pair( LookupName( entry.Name, true ), i ) );
+        m_lazyByUID.insert( std::make_pair( entry.UID, i ) );
+    }
+
+    // only the current version can be appended to (see SaveAPACK)
+    if( fileVersion == c_packFileVersion )
+    {
+        m_apackFilePath = fileName;
+        m_apackFileEnd  = size;
+    }
+
+    if( m_lazyEntries.size( ) == 0 )
+        ReleaseLazyStorageNoLock( );
+
+    return true;
+}
+
+bool vaAssetPack::IsNameInUseNoLock( const string & name ) const
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    vaStringID lookupName = LookupName( name, false );
+    if( lookupName.Empty( ) && !name.empty( ) )
+        return false;
+    return ( m_assetMap.find( lookupName ) != m_assetMap.end( ) ) || ( m_lazyByName.find( lookupName ) != m_lazyByName.end( ) );
+}
+
+vaStringID vaAssetPack::LookupName( const string & name, bool intern )
+{
+    // most names are short enough for this to not allocate
+    vaSmallString<128> lowerName( name );
+    for( size_t i = 0; i < lowerName.length( ); i++ )
+        lowerName[i] = (char)::tolower( (unsigned char)lowerName[i] );
+    return ( intern ) ? ( vaStringID( lowerName.c_str( ), lowerName.length( ) ) ) : ( vaStringID::Find( lowerName.c_str( ), lowerName.length( ) ) );
+}
+
+vector< shared_ptr<vaAsset> > vaAssetPack::GetAssetsSortedByNameNoLock( ) const
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    vector< shared_ptr<vaAsset> > assets;
+    assets.reserve( m_assetMap.size( ) );
+    for( auto it = m_assetMap.begin( ); it != m_assetMap.end( ); it++ )
+        assets.push_back( it->second );
+    std::sort( assets.begin( ), assets.end( ), [ ]( const shared_ptr<vaAsset> & left, const shared_ptr<vaAsset> & right ) { return vaStringID::CompareText( left->m_lookupName, right->m_lookupName ) < 0; } );
+    return assets;
+}
+
+shared_ptr<vaAsset> vaAssetPack::LoadLazyEntry( const LazyEntry & entry )
+{
+    VA_MEMORY_TAG_SCOPE( AssetPack );
+
+    // only reads from the mapping, which stays alive for as long as the caller holds m_assetStorageMutex, so safe to be
+    // called from multiple threads at once
+    const uint8 * payload = m_lazyStorage.GetView( entry.Offset, entry.CompressedSize );
+
+    // from version 7 on the stored blob gets checked before it goes anywhere near the decompressor, otherwise the 
+    // decompressed data gets checked (unless it was all checked on load already)
+    bool verified = m_lazyVerified;
+    if( payload != nullptr && !verified && m_lazyFileVersion >= 7 )
+    {
+        if( vaXXHash64::Compute( payload, entry.CompressedSize ) != entry.StoredHash )
+        {
+            VA_LOG_ERROR( "vaAssetPack::Materialize(): data for asset '%s' is corrupted (offset %lld, %lld bytes)", entry.Name.c_str(), entry.Offset, entry.CompressedSize );
+            return nullptr;
+        }
+        verified = true;
+    }
+
+    vector<uint8> decompressed;
+    const uint8 * data = payload;
+    if( payload != nullptr && entry.CompressedSize != entry.UncompressedSize )
+    {
+        decompressed.resize( (size_t)entry.UncompressedSize );
+        data = ( vaLZCodec::Decompress( payload, entry.CompressedSize, decompressed.data( ), entry.UncompressedSize ) ) ? ( decompressed.data( ) ) : ( nullptr );
+    }
+
+    if( data == nullptr || ( !verified && vaXXHash64::Compute( data, entry.UncompressedSize ) != entry.Hash ) )
+    {
+        VA_LOG_ERROR( "vaAssetPack::Materialize(): data for asset '%s' is missing or corrupted (offset %lld, %lld bytes)", entry.Name.c_str(), entry.Offset, entry.CompressedSize );
+        return nullptr;
+    }
+
+    int64 dataSize      = entry.UncompressedSize;
+    uint64 contentHash  = entry.Hash;
+
+    // version 4 payloads start with the UID, so the stored hash can't be used to identify identical contents
+    if( m_lazyFileVersion < 5 )
+    {
+        vaMemoryStream uidStream( (void*)data, dataSize );
+        vaGUID uid;
+        if( !uidStream.ReadValue<vaGUID>( uid ) || uid != entry.UID )
+        {
+            VA_LOG_ERROR( "vaAssetPack::Materialize(): UID mismatch for asset '%s'", entry.Name.c_str() );
+            return nullptr;
+        }
+        data        += sizeof(vaGUID);
+        dataSize    -= sizeof(vaGUID);
+        contentHash = vaXXHash64::Compute( data, dataSize );
+    }
+
+    // stored payloads are read straight from the mapping
+    shared_ptr<vaAsset> newAsset = CreateAndLoadAPACK( entry.Type, entry.Name, entry.UID, data, dataSize, contentHash );
+    if( newAsset == nullptr )
+        VA_LOG_ERROR( "vaAssetPack::Materialize(): error while loading asset '%s' - see log file above for more info", entry.Name.c_str() );
+    return newAsset;
+}
+
+shared_ptr<vaAsset> vaAssetPack::MaterializeNoLock( int lazyIndex )
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+    assert( lazyIndex >= 0 && lazyIndex < (int)m_lazyEntries.size() );
+
+    // copy, as the entries get released with the last one materialized
+    const LazyEntry entry = m_lazyEntries[lazyIndex];
+
+    // no longer pending even if loading fails below - no point retrying on every lookup
+    m_lazyByName.erase( LookupName( entry.Name, false ) );
+    m_lazyByUID.erase( entry.UID );
+
+    shared_ptr<vaAsset> newAsset = LoadLazyEntry( entry );
+    if( newAsset != nullptr )
+    {
+        InsertAndTrackMe( newAsset, false );
+        assert( newAsset->GetResourceObjectUID( ) == entry.UID );
+        if( m_apackFilePath != L"" )
+        {
+            newAsset->m_storedPayload   = entry;
+            newAsset->m_dirty           = false;
+        }
+    }
+
+    if( m_lazyByUID.size() == 0 )
+        ReleaseLazyStorageNoLock( );
+
+    return newAsset;
+}
+
+void vaAssetPack::MaterializeAll( bool lockMutex )
+{
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    MaterializeAllNoLock( );
+}
+
+void vaAssetPack::MaterializeAllNoLock( )
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    if( m_lazyByUID.size() == 0 )
+        return;
+
+    // in file order
+    vector<int> pending;
+    for( int i = 0; i < (int)m_lazyEntries.size( ); i++ )
+    {
+        auto it = m_lazyByUID.find( m_lazyEntries[i].UID );
+        if( it != m_lazyByUID.end( ) && it->second == i )
+            pending.push_back( i );
+    }
+
+    // Load in parallel (see LoadAPACKInner), insert in order. Entries pointing to an already seen blob go in a second
+    // pass, so that they find the first one in vaAssetPackManager's shared content registry instead of racing it.
+    vector<int> firstPass, secondPass;
+    std::set<int64> seenBlobs;
+    for( int i = 0; i < (int)pending.size( ); i++ )
+    {
+        if( seenBlobs.insert( m_lazyEntries[ pending[i] ].Offset ).second )
+            firstPass.push_back( i );
+        else
+            secondPass.push_back( i );
+    }
+
+    vector< shared_ptr<vaAsset> > newAssets( pending.size() );
+    for( const vector<int> * pass : { &firstPass, &secondPass } )
+    {
+        vaThreading::ParallelFor( (int)pass->size(), [ this, &pending, &newAssets, pass ]( int i )
+        {
+            int index = (*pass)[i];
+            newAssets[index] = LoadLazyEntry( m_lazyEntries[ pending[index] ] );
+        } );
+    }
+
+    for( size_t i = 0; i < pending.size(); i++ )
+    {
+        if( newAssets[i] != nullptr )
+        {
+            const LazyEntry & entry = m_lazyEntries[ pending[i] ];
+            InsertAndTrackMe( newAssets[i], false, false );
+            if( m_apackFilePath != L"" )
+            {
+                newAssets[i]->m_storedPayload   = entry;
+                newAssets[i]->m_dirty           = false;
+            }
+        }
+    }
+    TrackAssets( newAssets );
+#ifdef _DEBUG
+    for( size_t i = 0; i < pending.size(); i++ )
+        assert( newAssets[i] == nullptr || newAssets[i]->GetResourceObjectUID( ) == m_lazyEntries[ pending[i] ].UID );
+#endif
+
+    ReleaseLazyStorageNoLock( );
+}
+
+void vaAssetPack::ReleaseLazyStorageNoLock( )
+{
+    m_assetStorageMutex.assert_locked_by_caller();
+
+    m_lazyByName.clear( );
+    m_lazyByUID.clear( );
+    m_lazyEntries.clear( );
+    m_lazyStorage.Close( );
+    m_lazyFileVersion = 0;
+    m_lazyVerified = false;
+}
+
+bool vaAssetPack::TryMaterialize( const vaGUID & uid )
+{
+    // The caller could be further up the stack holding the lock (UI for ex. - it could also be iterating the storage so can't
+    // materialize from under it), or someone else is busy with the pack; either way report not found instead of (dead)locking
+    // - the lookup will be retried next time.
+    if( m_assetStorageMutex.IsOwnedByCurrentThread( ) )
+        return false;
+    std::unique_lock<StorageMutex> assetStorageMutexLock( m_assetStorageMutex, std::try_to_lock );
+    if( !assetStorageMutexLock.owns_lock( ) )
+        return false;
+
+    auto it = m_lazyByUID.find( uid );
+    if( it == m_lazyByUID.end( ) )
+        return false;
+
+    return MaterializeNoLock( it->second ) != nullptr;
+}
+
 bool vaAssetPack::SaveUnpacked( const wstring & folderRoot, bool lockMutex )
 {
     assert(vaThreading::IsMainThread()); 
     WaitUntilIOTaskFinished( );
 
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+
+    MaterializeAllNoLock( );
 
     if( vaFileTools::DirectoryExists(folderRoot) && !vaFileTools::DeleteDirectory( folderRoot ) )
     {
@@ -581,9 +1533,8 @@ bool vaAssetPack::SaveUnpacked( const wstring & folderRoot, bool lockMutex )
             hadError = true;
         }
 
-        for( auto it = m_assetMap.begin( ); it != m_assetMap.end( ); it++ )
+        for( const shared_ptr<vaAsset> & asset : GetAssetsSortedByNameNoLock( ) )
         {
-            shared_ptr<vaAsset> & asset = it->second;
             if( asset->Type != assetType ) continue;
             if( asset->GetResourceObjectUID( ) == vaCore::GUIDNull( ) )
             {
@@ -610,7 +1561,7 @@ bool vaAssetPack::SaveUnpacked( const wstring & folderRoot, bool lockMutex )
             vaXMLSerializer assetSerializer;
             string storageName = string("Asset_") + assetTypeName;
             assetSerializer.SerializeOpenChildElement( storageName.c_str() );
-            if( !it->second->SerializeUnpacked( assetSerializer, assetFolder ) )
+            if( !asset->SerializeUnpacked( assetSerializer, assetFolder ) )
             {
                 assert( false );
                 hadError = true;
@@ -634,7 +1585,7 @@ bool vaAssetPack::SaveUnpacked( const wstring & folderRoot, bool lockMutex )
 
 bool vaAssetPack::LoadUnpacked( const wstring & folderRoot, bool lockMutex )
 {
-    std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+    std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
 
     RemoveAll( false );
 
@@ -779,6 +1730,8 @@ void vaAsset::ReplaceAsset( const shared_ptr<vaAssetResource> & newResource )
     m_resource = newResource;
     m_resource->SetParentAsset( this );
 
+    m_dirty = true;
+
     assert( m_resource->UIDObject_IsTracked() );
 }
 
@@ -800,11 +1753,8 @@ bool vaAsset::SerializeUnpacked( vaXMLSerializer & serializer, const wstring & a
     return m_resource->SerializeUnpacked( serializer, assetFolder );
 }
 
-vaAssetRenderMesh * vaAssetRenderMesh::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream )
+vaAssetRenderMesh * vaAssetRenderMesh::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream )
 {
-    vaGUID uid;
-    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<vaGUID>( uid ) );
-
     shared_ptr<vaRenderMesh> newResource = pack.GetRenderDevice().GetMeshManager().CreateRenderMesh( uid );
 
     if( newResource == nullptr )
@@ -821,11 +1771,8 @@ vaAssetRenderMesh * vaAssetRenderMesh::CreateAndLoadAPACK( vaAssetPack & pack, c
     }
 }
 
-vaAssetRenderMaterial * vaAssetRenderMaterial::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream )
+vaAssetRenderMaterial * vaAssetRenderMaterial::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream )
 {
-    vaGUID uid;
-    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<vaGUID>( uid ) );
-
     shared_ptr<vaRenderMaterial> newResource = pack.GetRenderDevice().GetMaterialManager().CreateRenderMaterial( uid );
 
     if( newResource == nullptr )
@@ -841,11 +1788,8 @@ vaAssetRenderMaterial * vaAssetRenderMaterial::CreateAndLoadAPACK( vaAssetPack &
     }
 }
 
-vaAssetTexture * vaAssetTexture::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream )
+vaAssetTexture * vaAssetTexture::CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream )
 {
-    vaGUID uid;
-    VERIFY_TRUE_RETURN_ON_FALSE( inStream.ReadValue<vaGUID>( uid ) );
-
     shared_ptr<vaTexture> newResource = VA_RENDERING_MODULE_CREATE_SHARED( vaTexture, vaTextureConstructorParams( pack.GetRenderDevice(), uid ) );
 
     if( newResource == nullptr )
@@ -861,6 +1805,41 @@ vaAssetTexture * vaAssetTexture::CreateAndLoadAPACK( vaAssetPack & pack, const s
     }
 }
 
+vaAssetTexture * vaAssetTexture::CreateSharingContent( vaAssetPack & pack, const string & name, const vaGUID & uid, const shared_ptr<vaTexture> & original )
+{
+    assert( original != nullptr && original->GetViewedOriginal( ) == nullptr );
+    if( original == nullptr )
+        return nullptr;
+
+    // a view of the whole thing - same GPU resource, different UID
+    shared_ptr<vaTexture> newResource = vaTexture::CreateView( original, original->GetBindSupportFlags( ), original->GetSRVFormat( ), original->GetRTVFormat( ), original->GetDSVFormat( ), original->GetUAVFormat( ), original->GetFlags( ), 0, -1, 0, -1, uid );
+
+    if( newResource == nullptr )
+        return nullptr;
+
+    return new vaAssetTexture( pack, newResource, name );
+}
+
+vaAssetRenderMesh * vaAssetRenderMesh::CreateSharingContent( vaAssetPack & pack, const string & name, const vaGUID & uid, const shared_ptr<vaRenderMesh> & original )
+{
+    assert( original != nullptr );
+    if( original == nullptr )
+        return nullptr;
+
+    shared_ptr<vaRenderMesh> newResource = pack.GetRenderDevice().GetMeshManager().CreateRenderMesh( uid );
+
+    if( newResource == nullptr )
+        return nullptr;
+
+    // same as what vaRenderMesh::LoadAPACK would have read, except the vertex/index buffers are shared
+    newResource->SetFrontFaceWindingOrder( original->GetFrontFaceWindingOrder( ) );
+    newResource->SetTriangleMesh( original->GetTriangleMesh( ) );
+    newResource->SetPart( original->GetPart( ) );
+    newResource->SetAABB( original->GetAABB( ) );
+
+    return new vaAssetRenderMesh( pack, newResource, name );
+}
+
 vaAssetRenderMesh * vaAssetRenderMesh::CreateAndLoadUnpacked( vaAssetPack & pack, const string & name, const vaGUID & uid, vaXMLSerializer & serializer, const wstring & assetFolder )
 {
     shared_ptr<vaRenderMesh> newResource = pack.GetRenderDevice().GetMeshManager().CreateRenderMesh( uid );
@@ -917,6 +1896,24 @@ void vaAssetTexture::ReplaceTexture( const shared_ptr<vaTexture> & newTexture )
     ReplaceAsset( newTexture ); 
 }
 
+bool vaAssetTexture::SaveAPACK( vaStream & outStream )
+{
+    // textures sharing contents (see CreateSharingContent) are views of the whole original, so save that instead
+    shared_ptr<vaTexture> texture = GetTexture( );
+    if( texture != nullptr && texture->GetViewedOriginal( ) != nullptr )
+        return texture->GetViewedOriginal( )->SaveAPACK( outStream );
+    return vaAsset::SaveAPACK( outStream );
+}
+
+bool vaAssetTexture::SerializeUnpacked( vaXMLSerializer & serializer, const wstring & assetFolder )
+{
+    // see SaveAPACK
+    shared_ptr<vaTexture> texture = GetTexture( );
+    if( !serializer.IsReading( ) && texture != nullptr && texture->GetViewedOriginal( ) != nullptr )
+        return texture->GetViewedOriginal( )->SerializeUnpacked( serializer, assetFolder );
+    return vaAsset::SerializeUnpacked( serializer, assetFolder );
+}
+
 void vaAssetRenderMesh::ReplaceRenderMesh( const shared_ptr<vaRenderMesh> & newRenderMesh ) 
 { 
     ReplaceAsset( newRenderMesh );
@@ -966,6 +1963,7 @@ void vaAssetRenderMesh::UIPropertiesItemDraw( )
     if( ImGui::Button( "Rebuild normals" ) )
     {
         mesh->RebuildNormals();
+        SetDirty( );
     }
     //mesh->GetFrontFaceWindingOrder()
 #endif
@@ -1060,7 +2058,10 @@ void vaAssetRenderMaterial::UIPropertiesItemDraw( )
             UIDrawMaterialInputValueInfo( materialInput );
         }
         if( materialInput != renderMaterial->GetInputs( )[i] )
+        {
             renderMaterial->SetInput( i, materialInput );
+            SetDirty( );
+        }
     }
     ImGui::PopStyleVar();
 
@@ -1078,7 +2079,10 @@ void vaAssetRenderMaterial::UIPropertiesItemDraw( )
     ImGui::Checkbox( "SpecialEmissiveLight", &settings.SpecialEmissiveLight );
     
     if( renderMaterial->GetMaterialSettings() != settings )
+    {
         renderMaterial->SetMaterialSettings( settings );
+        SetDirty( );
+    }
 
     //ImGui::Unindent();
     
@@ -1132,7 +2136,7 @@ void vaAssetPack::UIPanelDraw( )
 
     if( !disableEdit )
     {
-        std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex );
+        std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex );
 
         // rename UI
         if( ImGui::Button( "Rename" ) )
@@ -1166,6 +2170,14 @@ void vaAssetPack::UIPanelDraw( )
         default: assert( false );  break;
         }
 
+        if( m_lazyByUID.size() > 0 )
+        {
+            ImGui::Text( "%d assets not loaded yet (loaded on first use)", (int)m_lazyByUID.size() );
+            ImGui::SameLine( );
+            if( ImGui::Button( "Load all" ) )
+                MaterializeAllNoLock( );
+        }
+
         wstring packedStoragePath = m_assetPackManager.GetAssetFolderPath( ) + vaStringTools::SimpleWiden( m_name ) + L".apack";
 
         ImGui::Text( ".apack storage:" );
@@ -1197,11 +2209,20 @@ void vaAssetPack::UIPanelDraw( )
         ImGui::SameLine( );
         if( ImGui::Button( " Save " ) )
         {
-            if( !SaveAPACK( packedStoragePath, false ) )
+            if( !SaveAPACK( packedStoragePath, false, false ) )
             {
                 VA_WARN( L"Unable to open file '%s' for writing", packedStoragePath.c_str() );
             }
         }
+        ImGui::SameLine( );
+        if( ImGui::Button( " Save changes " ) )
+        {
+            if( !SaveAPACK( packedStoragePath, true, false ) )
+            {
+                VA_WARN( L"Unable to save changes to '%s'", packedStoragePath.c_str() );
+            }
+        }
+        if( ImGui::IsItemHovered( ) ) ImGui::SetTooltip( "Only append new & modified assets to the .apack; full Save or APACK_COMPACT console command reclaim the unused space" );
         ImGui::PopID( );
 
         ImGui::Separator();
@@ -1452,6 +2473,36 @@ vaAssetPackManager::vaAssetPackManager( vaRenderDevice & renderDevice ) : m_rend
 
     m_assetImporter = shared_ptr<vaAssetImporter>( new vaAssetImporter(m_renderDevice) );
 
+    vaUIDObjectRegistrar::GetInstance( ).SetMissResolver( [this]( const vaGUID & uid ) { return ResolveUID( uid ); } );
+
+    if( vaUIConsole::GetInstancePtr( ) != nullptr )
+    {
+        vaUIConsole::GetInstance( ).AddCommand( "APACK_COMPACT", [this]( const string & packName )
+        {
+            if( packName == "" )
+                VA_LOG( "Usage: APACK_COMPACT <pack name> - rewrites the pack's .apack without the space left unused by incremental saving" );
+            else if( FindLoadedPack( packName ) != nullptr )
+                VA_LOG_WARNING( "APACK_COMPACT: pack '%s' is loaded - unload it first (or just do a full save)", packName.c_str() );
+            else
+                vaAssetPack::CompactAPACK( GetAssetFolderPath( ) + vaStringTools::SimpleWiden( packName ) + L".apack" );
+        } );
+        vaUIConsole::GetInstance( ).AddCommand( "APACK_VERIFY", [this]( const string & nameOrWildcard )
+        {
+            if( nameOrWildcard == "" )
+                VA_LOG( "Usage: APACK_VERIFY <pack name or *> - checks the .apack file(s) in the asset folder for corruption" );
+            else
+                VerifyPacks( nameOrWildcard );
+        } );
+        vaUIConsole::GetInstance( ).AddCommand( "APACK_VERIFY_ON_LOAD", [this]( const string & onOff )
+        {
+            if( onOff == "0" || onOff == "1" )
+                SetVerifyPacksOnLoad( onOff == "1" );
+            else if( onOff != "" )
+                VA_LOG( "Usage: APACK_VERIFY_ON_LOAD <0|1> - whether all payloads get verified when a pack is loaded (instead of on first use)" );
+            VA_LOG( "APACK_VERIFY_ON_LOAD is %s", GetVerifyPacksOnLoad( ) ? "on" : "off" );
+        } );
+    }
+
     shared_ptr<vaAssetPack> defaultPack = CreatePack( "default" );
     m_defaultPack = defaultPack;
 
@@ -1483,6 +2534,15 @@ vaAssetPackManager::~vaAssetPackManager( )
 { 
     assert( vaThreading::IsMainThread() );
 
+    vaUIDObjectRegistrar::GetInstance( ).SetMissResolver( nullptr );
+
+    if( vaUIConsole::GetInstancePtr( ) != nullptr )
+    {
+        vaUIConsole::GetInstance( ).RemoveCommand( "APACK_COMPACT" );
+        vaUIConsole::GetInstance( ).RemoveCommand( "APACK_VERIFY" );
+        vaUIConsole::GetInstance( ).RemoveCommand( "APACK_VERIFY_ON_LOAD" );
+    }
+
     UnloadAllPacks( );
 }
 
@@ -1599,7 +2659,7 @@ shared_ptr<vaAssetPack> vaAssetPackManager::FindOrLoadPack( const string & _asse
     string assetPackName = vaStringTools::ToLower( _assetPackName );
 
     shared_ptr<vaAssetPack> found = FindLoadedPack(assetPackName);
-    if( found = nullptr )
+    if( found == nullptr )
     {
         LoadPacks( assetPackName, allowAsync );
         found = FindLoadedPack(assetPackName);
@@ -1632,6 +2692,7 @@ void vaAssetPackManager::UnloadPack( shared_ptr<vaAssetPack> & pack )
             if( i != (m_assetPacks.size()-1) )
                 m_assetPacks[m_assetPacks.size()-1] = m_assetPacks[i];
             m_assetPacks.pop_back();
+            PruneSharedContent( );
             return;
         }
     }
@@ -1649,6 +2710,26 @@ void vaAssetPackManager::UnloadAllPacks( )
         m_assetPacks[i] = nullptr;
     }
     m_assetPacks.clear();
+    PruneSharedContent( );
+}
+
+bool vaAssetPackManager::VerifyPacks( const string & _nameOrWildcard, bool stopOnFirstFailure )
+{
+    string nameOrWildcard = vaStringTools::ToLower( _nameOrWildcard );
+    wstring assetPackFolder = GetAssetFolderPath( );
+
+    vector<wstring> fileNames;
+    if( nameOrWildcard == "*" )
+        fileNames = vaFileTools::FindFiles( assetPackFolder, L"*.apack", false );
+    else
+        fileNames.push_back( assetPackFolder + vaStringTools::SimpleWiden( nameOrWildcard ) + L".apack" );
+
+    if( fileNames.size( ) == 0 )
+    {
+        VA_LOG_WARNING( L"vaAssetPackManager::VerifyPacks - no .apack files found in '%s'", assetPackFolder.c_str( ) );
+        return true;
+    }
+    return vaAssetPack::VerifyAPACK( fileNames, stopOnFirstFailure );
 }
 
 bool vaAssetPackManager::AnyAsyncOpExecuting( )
@@ -1665,6 +2746,50 @@ void vaAssetPackManager::OnRenderingAPIAboutToShutdown( )
     UnloadAllPacks();
 }
 
+bool vaAssetPackManager::ResolveUID( const vaGUID & uid )
+{
+    // m_assetPacks is only ever touched from the main thread; lookups from other threads will only see what's already loaded
+    if( !vaThreading::IsMainThread() )
+        return false;
+
+    for( int i = 0; i < m_assetPacks.size(); i++ )
+        if( m_assetPacks[i]->TryMaterialize( uid ) )
+            return true;
+    return false;
+}
+
+shared_ptr<vaAssetResource> vaAssetPackManager::FindSharedContent( vaAssetType type, uint64 hash, int64 size )
+{
+    std::unique_lock<mutex> sharedContentLock( m_sharedContentMutex );
+    auto it = m_sharedContent.find( SharedContentKey{ type, hash, size } );
+    if( it == m_sharedContent.end( ) )
+        return nullptr;
+    return it->second.lock( );
+}
+
+void vaAssetPackManager::RegisterSharedContent( vaAssetType type, uint64 hash, int64 size, const shared_ptr<vaAssetResource> & resource )
+{
+    assert( resource != nullptr );
+    std::unique_lock<mutex> sharedContentLock( m_sharedContentMutex );
+
+    // if two identical ones got loaded at the same time, the first one registered stays (the other one just doesn't get shared)
+    weak_ptr<vaAssetResource> & entry = m_sharedContent[ SharedContentKey{ type, hash, size } ];
+    if( entry.expired( ) )
+        entry = resource;
+}
+
+void vaAssetPackManager::PruneSharedContent( )
+{
+    std::unique_lock<mutex> sharedContentLock( m_sharedContentMutex );
+    for( auto it = m_sharedContent.begin( ); it != m_sharedContent.end( ); )
+    {
+        if( it->second.expired( ) )
+            it = m_sharedContent.erase( it );
+        else
+            it++;
+    }
+}
+
 // void vaAssetPackManager::UIPanelDraw( )
 // { 
 //     assert( vaThreading::IsMainThread() );
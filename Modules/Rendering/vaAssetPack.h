@@ -21,6 +21,9 @@
 
 #include "Core/vaCoreIncludes.h"
 #include "Core/vaUI.h"
+#include "Core/vaStringID.h"
+
+#include "Core/System/vaMappedFileStream.h"
 
 #include "vaRendering.h"
 
@@ -54,9 +57,23 @@ namespace VertexAsylum
         friend class vaAssetPack;
         shared_ptr<vaAssetResource>                     m_resource;
         string                                          m_name;                     // warning, never change this except by using Rename
+        vaStringID                                      m_lookupName;               // interned lowercase m_name - the key in vaAssetPack::m_assetMap (set by the pack)
         vaAssetPack &                                   m_parentPack;
         int                                             m_parentPackStorageIndex;   // referring to vaAssetPack::m_assetList
 
+        // Where this asset's payload is in the parent pack's .apack file and its hash (see vaAssetPack::LazyEntry); Offset 
+        // is -1 if it's not stored there (new asset, or loaded from an older format or unpacked storage).
+        struct StoredPayload
+        {
+            int64                                       Offset                  = -1;
+            int64                                       CompressedSize          = 0;
+            int64                                       UncompressedSize        = 0;
+            uint64                                      Hash                    = 0;
+            uint64                                      StoredHash              = 0;        // of the CompressedSize bytes at Offset, as they are in the file
+        };
+        StoredPayload                                   m_storedPayload;
+        bool                                            m_dirty                 = true;     // contents possibly changed since m_storedPayload was written
+
     protected:
         vaAsset( vaAssetPack & pack, const vaAssetType type, const string & name, const shared_ptr<vaAssetResource> & resourceBasePtr ) : m_parentPack( pack ), Type( type ), m_name( name ), m_resource( resourceBasePtr ), m_parentPackStorageIndex( -1 )
                                                         { assert( m_resource != nullptr ); m_resource->SetParentAsset( this ); }
@@ -77,6 +94,11 @@ namespace VertexAsylum
 
         bool                                            Rename( const string & newName );
 
+        // Call after modifying the resource in place so that an incremental vaAssetPack::SaveAPACK picks it up (Replace* 
+        // does it automatically); clean assets get saved by reusing their previously written payload.
+        void                                            SetDirty( )                             { m_dirty = true; }
+        bool                                            IsDirty( ) const                        { return m_dirty; }
+
         virtual bool                                    SaveAPACK( vaStream & outStream );
         virtual bool                                    SerializeUnpacked( vaXMLSerializer & serializer, const wstring & assetFolder );
 
@@ -99,7 +121,12 @@ namespace VertexAsylum
         shared_ptr<vaTexture>                           GetTexture( ) const                                                     { return std::dynamic_pointer_cast<vaTexture>(m_resource); }
         void                                            ReplaceTexture( const shared_ptr<vaTexture> & newTexture );
 
-        static vaAssetTexture *                         CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream );
+        virtual bool                                    SaveAPACK( vaStream & outStream ) override;
+        virtual bool                                    SerializeUnpacked( vaXMLSerializer & serializer, const wstring & assetFolder ) override;
+
+        static vaAssetTexture *                         CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream );
+        // new asset (with its own UID) that is a view of an already loaded texture with identical contents (see vaAssetPackManager::FindSharedContent)
+        static vaAssetTexture *                         CreateSharingContent( vaAssetPack & pack, const string & name, const vaGUID & uid, const shared_ptr<vaTexture> & original );
         static vaAssetTexture *                         CreateAndLoadUnpacked( vaAssetPack & pack, const string & name, const vaGUID & uid, vaXMLSerializer & serializer, const wstring & assetFolder );
 
         static shared_ptr<vaAssetTexture>               SafeCast( const shared_ptr<vaAsset> & asset ) { assert( asset->Type == vaAssetType::RenderMesh ); return std::dynamic_pointer_cast<vaAssetTexture, vaAsset>( asset ); }
@@ -119,7 +146,9 @@ namespace VertexAsylum
         shared_ptr<vaRenderMesh>                        GetRenderMesh( ) const                                                     { return std::dynamic_pointer_cast<vaRenderMesh>(m_resource); }
         void                                            ReplaceRenderMesh( const shared_ptr<vaRenderMesh> & newRenderMesh );
 
-        static vaAssetRenderMesh *                      CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream );
+        static vaAssetRenderMesh *                      CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream );
+        // new asset (with its own UID) sharing the triangle mesh of an already loaded one with identical contents (see vaAssetPackManager::FindSharedContent)
+        static vaAssetRenderMesh *                      CreateSharingContent( vaAssetPack & pack, const string & name, const vaGUID & uid, const shared_ptr<vaRenderMesh> & original );
         static vaAssetRenderMesh *                      CreateAndLoadUnpacked( vaAssetPack & pack, const string & name, const vaGUID & uid, vaXMLSerializer & serializer, const wstring & assetFolder );
 
         static shared_ptr<vaAssetRenderMesh>            SafeCast( const shared_ptr<vaAsset> & asset ) { assert( asset->Type == vaAssetType::RenderMesh ); return std::dynamic_pointer_cast<vaAssetRenderMesh, vaAsset>( asset ); }
@@ -139,7 +168,7 @@ namespace VertexAsylum
         shared_ptr<vaRenderMaterial>                    GetRenderMaterial( ) const { return std::dynamic_pointer_cast<vaRenderMaterial>( m_resource ); }
         void                                            ReplaceRenderMaterial( const shared_ptr<vaRenderMaterial> & newRenderMaterial );
 
-        static vaAssetRenderMaterial *                  CreateAndLoadAPACK( vaAssetPack & pack, const string & name, vaStream & inStream );
+        static vaAssetRenderMaterial *                  CreateAndLoadAPACK( vaAssetPack & pack, const string & name, const vaGUID & uid, vaStream & inStream );
         static vaAssetRenderMaterial *                  CreateAndLoadUnpacked( vaAssetPack & pack, const string & name, const vaGUID & uid, vaXMLSerializer & serializer, const wstring & assetFolder );
 
         static shared_ptr<vaAssetRenderMaterial>        SafeCast( const shared_ptr<vaAsset> & asset ) { assert( asset->Type == vaAssetType::RenderMaterial ); return std::dynamic_pointer_cast<vaAssetRenderMaterial, vaAsset>( asset ); }
@@ -159,11 +188,53 @@ namespace VertexAsylum
             //APACKStreamable,
         };
 
+        // Table of contents entry of an asset from a (version 4+) .apack that hasn't been loaded yet; the payload is what
+        // vaAsset::SaveAPACK writes (in version 4 prefixed with the resource UID), stored either raw or as a single vaLZCodec
+        // block (when CompressedSize != UncompressedSize), and Hash is the xxHash64 of it uncompressed. From version 5 on, 
+        // entries with identical payloads (same Type, Hash and UncompressedSize) point to the same blob in the file. From 
+        // version 7 on, StoredHash (of the blob as stored) lets the blobs be verified without decompressing them and the 
+        // table of contents itself is checksummed in the header.
+        struct LazyEntry : vaAsset::StoredPayload
+        {
+            vaGUID                                          UID;
+            vaAssetType                                     Type;
+            string                                          Name;
+        };
+
+        // (Type, Hash, UncompressedSize) -> where the payloads already in the file being written are
+        typedef std::map< std::tuple<vaAssetType, uint64, int64>, vaAsset::StoredPayload >  BlobMap;
+
+        // one .apack (with its table of contents already read) to be checked by VerifyAPACKPayloads
+        struct VerifyTarget
+        {
+            wstring                                         FileName;
+            const vaMappedFileStream *                      Storage;
+            int32                                           FileVersion;
+            const vector<LazyEntry> *                       Entries;
+            string                                          Failure;                // description of the first (by offset) corrupted payload, if any
+            int64                                           FailureOffset           = -1;
+        };
+
+    public:
+        // m_assetStorageMutex also knows its owner in release builds: TryMaterialize can get reached (through the UID miss 
+        // resolver) from code further up the stack that already holds it, and try_lock on a std::mutex already owned by the
+        // calling thread is undefined behaviour
+        class StorageMutex : public mutex
+        {
+            std::atomic<std::thread::id>                    m_owner;
+        public:
+            void                                            lock( )                     { mutex::lock( ); m_owner.store( std::this_thread::get_id( ), std::memory_order_relaxed ); }
+            bool                                            try_lock( )                 { if( !mutex::try_lock( ) ) return false; m_owner.store( std::this_thread::get_id( ), std::memory_order_relaxed ); return true; }
+            void                                            unlock( )                   { m_owner.store( std::thread::id( ), std::memory_order_relaxed ); mutex::unlock( ); }
+            bool                                            IsOwnedByCurrentThread( ) const { return m_owner.load( std::memory_order_relaxed ) == std::this_thread::get_id( ); }
+        };
+
     protected:
         string                                              m_name;                 // warning - not protected by the mutex and can only be accessed by the main thread
-        std::map< string, shared_ptr<vaAsset> >             m_assetMap;
+        std::unordered_map< vaStringID, shared_ptr<vaAsset>, vaStringID::Hasher >
+                                                            m_assetMap;             // LookupName( asset name ) -> asset
         vector< shared_ptr<vaAsset> >                       m_assetList;
-        mutable mutex                                       m_assetStorageMutex;
+        mutable StorageMutex                                m_assetStorageMutex;
 
         vaAssetPackManager &                                m_assetPackManager;
 
@@ -175,6 +246,21 @@ namespace VertexAsylum
 
         shared_ptr<vaBackgroundTaskManager::Task>           m_ioTask;
 
+        // the current version .apack that the assets' vaAsset::m_storedPayload refer to (empty if none) and the end of its 
+        // used part - incremental saving appends to it; protected by m_assetStorageMutex
+        wstring                                             m_apackFilePath;
+        int64                                               m_apackFileEnd          = 0;
+
+        // assets that are in the loaded .apack but not yet materialized; all protected by m_assetStorageMutex and the file stays
+        // mapped for as long as there's any left
+        vector<LazyEntry>                                   m_lazyEntries;
+        std::unordered_map< vaStringID, int, vaStringID::Hasher >
+                                                            m_lazyByName;           // LookupName( name ) -> m_lazyEntries index
+        std::map< vaGUID, int, vaGUIDComparer >             m_lazyByUID;            // resource UID -> m_lazyEntries index
+        vaMappedFileStream                                  m_lazyStorage;
+        int32                                               m_lazyFileVersion       = 0;
+        bool                                                m_lazyVerified          = false;    // all payloads already verified (see vaAssetPackManager::SetVerifyPacksOnLoad)
+
     private:
         friend class vaAssetPackManager;
         explicit vaAssetPack( vaAssetPackManager & assetPackManager, const string & name );
@@ -184,7 +270,7 @@ namespace VertexAsylum
         virtual ~vaAssetPack( );
 
     public:
-        mutex &                                             GetAssetStorageMutex( ) { return m_assetStorageMutex; }
+        StorageMutex &                                      GetAssetStorageMutex( ) { return m_assetStorageMutex; }
 
         string                                              FindSuitableAssetName( const string & nameSuggestion, bool lockMutex );
 
@@ -193,11 +279,27 @@ namespace VertexAsylum
         void                                                Remove( const shared_ptr<vaAsset> & asset, bool lockMutex );
         void                                                RemoveAll( bool lockMutex );
         
-        // save current contents
-        bool                                                SaveAPACK( const wstring & fileName, bool lockMutex );
-        // load contents (current contents are not deleted)
+        // Save current contents. With 'incremental', if fileName is the .apack the pack was loaded from or last saved to, only
+        // payloads of new and changed (see vaAsset::SetDirty) assets get appended, followed by a new table of contents - assets
+        // not loaded yet don't even get loaded; otherwise (or without 'incremental') the whole file is rewritten.
+        bool                                                SaveAPACK( const wstring & fileName, bool incremental, bool lockMutex );
+        // Rewrites a (not currently loaded) .apack without the dead space left behind by incremental saves; payloads are 
+        // copied as they are so this doesn't need to load (or even understand) any of the assets.
+        static bool                                         CompactAPACK( const wstring & fileName );
+        // Checks the integrity of .apack files (loaded or not): tables of contents first, then all payloads of all files get 
+        // hashed together, in parallel, without decompressing anything (for version 7+; older ones need decompressing). Each
+        // corrupted file is logged with the asset name and offset of its first bad payload. With 'stopOnFirstFailure' the
+        // remaining work is skipped as soon as any problem is found. Files older than version 4 can't be verified without 
+        // loading them and are skipped with a warning.
+        static bool                                         VerifyAPACK( const vector<wstring> & fileNames, bool stopOnFirstFailure, vector<wstring> * outFailedFiles = nullptr );
+        // load contents (current contents are not deleted); for the current file version this only reads the table of contents
+        // (regardless of 'async') and individual assets get loaded on first use - through Find( ), AssetAt( ) or when their
+        // resource gets looked up by UID through vaUIDObjectRegistrar
         bool                                                LoadAPACK( const wstring & fileName, bool async, bool lockMutex );
 
+        // load all assets that were deferred by LoadAPACK
+        void                                                MaterializeAll( bool lockMutex );
+
         // save current contents as XML & folder structure
         bool                                                SaveUnpacked( const wstring & folderRoot, bool lockMutex );
         // load contents as XML & folder structure (current contents are not deleted)
@@ -214,9 +316,10 @@ namespace VertexAsylum
 
         bool                                                RenameAsset( vaAsset & asset, const string & newName, bool lockMutex );
 
-        size_t                                              Count( bool lockMutex ) const               { std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock ); if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller(); assert( m_assetList.size() == m_assetMap.size() ); return m_assetList.size(); }
+        // includes assets not yet materialized; AssetAt( ) past the already materialized ones will materialize all of them
+        size_t                                              Count( bool lockMutex ) const               { std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock ); if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller(); assert( m_assetList.size() == m_assetMap.size() ); return m_assetList.size() + m_lazyByUID.size(); }
 
-        shared_ptr<vaAsset>                                 AssetAt( size_t index, bool lockMutex )     { std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock ); if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller(); if( index >= m_assetList.size() ) return nullptr; else return m_assetList[index]; }
+        shared_ptr<vaAsset>                                 AssetAt( size_t index, bool lockMutex )     { std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock ); if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller(); if( index >= m_assetList.size() ) MaterializeAllNoLock( ); if( index >= m_assetList.size() ) return nullptr; else return m_assetList[index]; }
 
         const shared_ptr<vaBackgroundTaskManager::Task> &   GetCurrentIOTask( )                         { return m_ioTask; }
         void                                                WaitUntilIOTaskFinished( bool breakIfSafe = false );
@@ -230,9 +333,40 @@ namespace VertexAsylum
         virtual void                                        UIPanelDraw( ) override;
 
     private:
-        void                                                InsertAndTrackMe( shared_ptr<vaAsset> newAsset, bool lockMutex );
+        // 'track' false leaves tracking to the caller, for inserting many assets and then tracking them with one TrackAssets call
+        void                                                InsertAndTrackMe( shared_ptr<vaAsset> newAsset, bool lockMutex, bool track = true );
+        static void                                         TrackAssets( const vector< shared_ptr<vaAsset> > & assets );
 
         bool                                                LoadAPACKInner( vaStream & inStream, vector< shared_ptr<vaAsset> > & loadedAssets, vaBackgroundTaskManager::TaskContext & taskContext );
+        // 'data' is the asset's payload without the UID and 'contentHash' its xxHash64; if an asset with the same contents was
+        // already loaded (from any pack) its resource contents get shared instead of loading another copy
+        shared_ptr<vaAsset>                                 CreateAndLoadAPACK( vaAssetType assetType, const string & name, const vaGUID & uid, const uint8 * data, int64 dataSize, uint64 contentHash );
+
+        bool                                                LoadAPACKTableOfContents( const wstring & fileName );
+        bool                                                CanSaveIncrementalNoLock( const wstring & fileName );
+        bool                                                SaveAPACKIncrementalNoLock( const wstring & fileName );
+
+        static bool                                         ReadAPACKTableOfContents( vaStream & inStream, int32 & outFileVersion, int64 & outSize, vector<LazyEntry> & outEntries );
+        static bool                                         ReadAPACKTableOfContentsEntries( vaStream & inStream, int32 fileVersion, int64 fileSize, int32 numberOfAssets, vector<LazyEntry> & outEntries );
+        static bool                                         WriteAPACKHeader( vaStream & outStream, int64 size, int32 numberOfAssets, int64 posOfTOC, uint64 tocHash );
+        static bool                                         WriteAPACKPayload( vaStream & outStream, const void * payload, LazyEntry & entry, BlobMap & writtenBlobs );
+        static bool                                         FinishAPACK( vaStream & outStream, const vector<LazyEntry> & toc );
+        static bool                                         VerifyAPACKEntry( const uint8 * blob, int32 fileVersion, const LazyEntry & entry, string & outError );
+        static bool                                         VerifyAPACKPayloads( vector<VerifyTarget> & targets, bool stopOnFirstFailure );
+        bool                                                IsNameInUseNoLock( const string & name ) const;
+
+        // Asset names are case insensitive: maps are keyed by the interned lowercase name. With 'intern' false, a name that
+        // was never interned returns an empty ID (it can't be in any of the maps then).
+        static vaStringID                                   LookupName( const string & name, bool intern );
+
+        // m_assetMap is unordered; saving goes through this so that the file layout stays deterministic (sorted by lowercase name)
+        vector< shared_ptr<vaAsset> >                       GetAssetsSortedByNameNoLock( ) const;
+        shared_ptr<vaAsset>                                 LoadLazyEntry( const LazyEntry & entry );
+        shared_ptr<vaAsset>                                 MaterializeNoLock( int lazyIndex );
+        void                                                MaterializeAllNoLock( );
+        void                                                ReleaseLazyStorageNoLock( );
+        // for vaAssetPackManager's vaUIDObjectRegistrar miss resolver
+        bool                                                TryMaterialize( const vaGUID & uid );
     };
 
     class vaAssetImporter;
@@ -246,6 +380,24 @@ namespace VertexAsylum
 
         vaRenderDevice &                                    m_renderDevice;
 
+        // Content-addressed registry of loaded textures and meshes, keyed by the xxHash64 & size of their .apack payload (the
+        // UID not included): identical assets, loaded from any pack, end up sharing the contents of the first one loaded 
+        // instead of each loading and uploading their own copy. Only weak references are held; shared contents are treated 
+        // as immutable - editing tools replace resources (vaAsset::ReplaceAsset) rather than modify them in place.
+        struct SharedContentKey
+        {
+            vaAssetType                                     Type;
+            uint64                                          Hash;
+            int64                                           Size;
+
+            bool                                            operator < ( const SharedContentKey & other ) const     { if( Type != other.Type ) return Type < other.Type; if( Hash != other.Hash ) return Hash < other.Hash; return Size < other.Size; }
+        };
+        std::map< SharedContentKey, weak_ptr<vaAssetResource> >
+                                                            m_sharedContent;
+        mutex                                               m_sharedContentMutex;
+
+        bool                                                m_verifyPacksOnLoad     = false;
+
     protected:
         vector<shared_ptr<vaAssetPack>>                     m_assetPacks;           // tracks all vaAssetPacks that belong to this vaAssetPackManager
         int                                                 m_UIAssetPackIndex      = 0;
@@ -268,6 +420,16 @@ namespace VertexAsylum
 
         bool                                                AnyAsyncOpExecuting( );
 
+        // Verify .apack files in the asset folder (see vaAssetPack::VerifyAPACK); also available as the APACK_VERIFY console command and, 
+        // headless, through the '-verifyapack <pack name or *>' command line switch (see vaApplicationWin::Run)
+        static bool                                         VerifyPacks( const string & nameOrWildcard, bool stopOnFirstFailure = false );
+
+        // By default a payload gets verified when its asset is first used; with this, all of them get verified (in parallel) 
+        // when the pack is loaded and the load fails if any is corrupted. Also set with the APACK_VERIFY_ON_LOAD console
+        // command or the '-verifyapacksonload' command line switch.
+        void                                                SetVerifyPacksOnLoad( bool verifyOnLoad )               { m_verifyPacksOnLoad = verifyOnLoad; }
+        bool                                                GetVerifyPacksOnLoad( ) const                           { return m_verifyPacksOnLoad; }
+
         // // this searches all packs by name <error - not yet ensured that names will never overlap - needs to be done before this makes any sense>
         // shared_ptr<vaAssetPack>                             FindAsset( )
 
@@ -275,7 +437,7 @@ namespace VertexAsylum
 
         vaRenderDevice &                                    GetRenderDevice( )                                      { return m_renderDevice; }
 
-        wstring                                             GetAssetFolderPath( )                                   { return vaCore::GetExecutableDirectory() + L"Media\\AssetPacks\\"; }
+        static wstring                                      GetAssetFolderPath( )                                   { return vaCore::GetExecutableDirectory() + L"Media\\AssetPacks\\"; }
 
     protected:
 
@@ -283,6 +445,15 @@ namespace VertexAsylum
         friend class vaDirectXCore; // <- these should be reorganized so that this is not called from anything that is API-specific
         void                                                OnRenderingAPIAboutToShutdown( );
 
+        // hooked up to vaUIDObjectRegistrar so that UID lookups of assets from lazily loaded packs load them
+        bool                                                ResolveUID( const vaGUID & uid );
+
+        // content deduplication (see m_sharedContent); both thread safe, called by vaAssetPack from its loading threads
+        friend class vaAssetPack;
+        shared_ptr<vaAssetResource>                         FindSharedContent( vaAssetType type, uint64 hash, int64 size );
+        void                                                RegisterSharedContent( vaAssetType type, uint64 hash, int64 size, const shared_ptr<vaAssetResource> & resource );
+        void                                                PruneSharedContent( );
+
     //public:
     //    virtual void                                        UIPanelDraw( ) override;
     };
@@ -292,12 +463,19 @@ namespace VertexAsylum
 
     inline shared_ptr<vaAsset> vaAssetPack::Find( const string & _name, bool lockMutex ) 
     { 
-        std::unique_lock<mutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
-        auto it = m_assetMap.find( vaStringTools::ToLower( _name ) );                        
-        if( it == m_assetMap.end( ) ) 
-            return nullptr; 
-        else 
+        std::unique_lock<StorageMutex> assetStorageMutexLock(m_assetStorageMutex, std::defer_lock );    if( lockMutex ) assetStorageMutexLock.lock(); else m_assetStorageMutex.assert_locked_by_caller();
+        vaStringID name = LookupName( _name, false );
+        if( name.Empty( ) && !_name.empty( ) )
+            return nullptr;
+        auto it = m_assetMap.find( name );
+        if( it != m_assetMap.end( ) ) 
             return it->second; 
+
+        auto lazyIt = m_lazyByName.find( name );
+        if( lazyIt != m_lazyByName.end( ) )
+            return MaterializeNoLock( lazyIt->second );
+
+        return nullptr; 
     }
     //inline shared_ptr<vaAsset> vaAssetPack::FindByStoragePath( const wstring & _storagePath ) 
     //{ 
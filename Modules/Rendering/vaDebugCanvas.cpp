@@ -73,37 +73,37 @@ vaDebugCanvas2D::~vaDebugCanvas2D( )
 void vaDebugCanvas2D::DrawString( int x, int y, const wchar_t * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_WSTR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, 0xFF000000, 0x00000000, szBuffer ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, 0xFF000000, 0x00000000, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawString( int x, int y, unsigned int penColor, const wchar_t * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_WSTR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, 0x00000000, szBuffer ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, 0x00000000, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawString( int x, int y, unsigned int penColor, unsigned int shadowColor, const wchar_t * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_WSTR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, shadowColor, szBuffer ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, shadowColor, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawString( int x, int y, const char * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_STR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, 0xFF000000, 0x00000000, vaStringTools::SimpleWiden( std::string( szBuffer ) ).c_str( ) ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, 0xFF000000, 0x00000000, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawString( int x, int y, unsigned int penColor, const char * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_STR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, 0x00000000, vaStringTools::SimpleWiden( std::string( szBuffer ) ).c_str( ) ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, 0x00000000, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawString( int x, int y, unsigned int penColor, unsigned int shadowColor, const char * text, ... )
 {
     vaDirectXCanvas2D_FORMAT_STR( );
-    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, shadowColor, vaStringTools::SimpleWiden( std::string( szBuffer ) ).c_str( ) ) );
+    m_drawStringLines.push_back( DrawStringItem( x, y, penColor, shadowColor, CopyText( szBuffer ) ) );
 }
 //
 void vaDebugCanvas2D::DrawLine( float x0, float y0, float x1, float y1, unsigned int penColor )
@@ -148,11 +148,30 @@ void vaDebugCanvas2D::DrawCircle( float x, float y, float radius, unsigned int p
     }
 }
 
+const wchar_t * vaDebugCanvas2D::CopyText( const wchar_t * text )
+{
+    size_t length = wcslen( text );
+    wchar_t * copy = (wchar_t *)m_textArena.Allocate( ( length + 1 ) * sizeof(wchar_t), alignof(wchar_t) );
+    memcpy( copy, text, ( length + 1 ) * sizeof(wchar_t) );
+    return copy;
+}
+
+const wchar_t * vaDebugCanvas2D::CopyText( const char * text )
+{
+    // same as vaStringTools::SimpleWiden but without the temporaries
+    size_t length = strlen( text );
+    wchar_t * copy = (wchar_t *)m_textArena.Allocate( ( length + 1 ) * sizeof(wchar_t), alignof(wchar_t) );
+    for( size_t i = 0; i <= length; i++ )
+        copy[i] = text[i];
+    return copy;
+}
+
 void vaDebugCanvas2D::CleanQueued( )
 {
     m_drawRectangles.clear( );
     m_drawLines.clear( );
     m_drawStringLines.clear( );
+    m_textArena.Reset( );
 }
 
 void vaDebugCanvas2D::Render( vaRenderDeviceContext & renderContext, int canvasWidth, int canvasHeight, bool bJustClearData )
@@ -72,7 +72,7 @@ namespace VertexAsylum
             int            x, y;
             unsigned int   penColor;
             unsigned int   shadowColor;
-            std::wstring   text;
+            const wchar_t *text;       // points into m_textArena
             DrawStringItem( int x, int y, unsigned int penColor, unsigned int shadowColor, const wchar_t * text )
                 : x( x ), y( y ), penColor( penColor ), shadowColor( shadowColor ), text( text ) {}
         };
@@ -90,10 +90,12 @@ namespace VertexAsylum
         };
 
     protected:
-        // buffers for queued render calls
+        // buffers for queued render calls; CleanQueued( ) only clear( )-s them so their capacity is reused and they don't 
+        // allocate in steady state - that's why they're not on vaFrameAllocator
         std::vector<DrawStringItem>     m_drawStringLines;
         std::vector<DrawLineItem>       m_drawLines;
         std::vector<DrawRectangleItem>  m_drawRectangles;
+        vaLinearArena                   m_textArena;        // storage for DrawStringItem::text; reset in CleanQueued( )
 
         // GPU buffers
         vaTypedVertexBufferWrapper< CanvasVertex2D >
@@ -113,6 +115,10 @@ namespace VertexAsylum
         void operator = ( const vaDebugCanvas2D & )    = delete; 
         //
         void                 CleanQueued( );
+    private:
+        const wchar_t *      CopyText( const wchar_t * text );
+        const wchar_t *      CopyText( const char * text );
+    public:
         void                 Render( vaRenderDeviceContext & renderContext, int canvasWidth, int canvasHeight, bool bJustClearData = false );
         //
     public:
@@ -226,7 +232,7 @@ namespace VertexAsylum
         //int                              m_width;
         //int                              m_height;
 
-        // buffers for queued render calls
+        // buffers for queued render calls (same as in vaDebugCanvas2D, capacity is reused across frames)
         vector<DrawItem>                  m_drawItems;
         vector<vaMatrix4x4>               m_drawItemsTransforms;
         vector<DrawLineItem>              m_drawLines;
@@ -190,6 +190,8 @@ vaRenderGlobals & vaRenderDevice::GetRenderGlobals( )
 
 void vaRenderDevice::BeginFrame( float deltaTime )
 {
+    VA_MEMORY_TAG_SCOPE( Rendering );
+
     assert( !m_disabled );
     assert( IsRenderThread() );
     m_totalTime += deltaTime;
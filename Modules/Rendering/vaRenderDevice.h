@@ -145,6 +145,14 @@ namespace VertexAsylum
         virtual void                        EndAndPresentFrame( int vsyncInterval = 0 );
 
         bool                                IsRenderThread( ) const                                                     { return m_threadID == std::this_thread::get_id(); }
+
+        // Threading contract: resources (vaTexture, vertex/index/constant buffers, shaders) and the render meshes & materials 
+        // built on them can be created from any thread, also from several at once - the API devices are free-threaded, and
+        // whatever needs a context (initial data uploads, transitions) gets deferred to the render thread (see 
+        // vaRenderDeviceDX12::ExecuteAtBeginFrame) or is asserted against. Contexts, frames and resource destruction stay on
+        // the render (main) thread. A backend that can't do this must return false and callers that create resources from 
+        // worker threads (vaAssetPack loading, for ex.) have to check it and do it serially instead.
+        virtual bool                        IsConcurrentResourceCreationSupported( ) const                              { return true; }
         bool                                IsFrameStarted( ) const                                                     { return m_frameStarted; }
 
         double                              GetTotalTime( ) const                                                       { return m_totalTime; }
@@ -78,9 +78,10 @@ void vaRenderMaterial::UpdateShaderMacros( )
     if( !m_shaderMacrosDirty )
         return;
 
-    vector< pair< string, string > > prevShaderMacros = m_shaderMacros;
-
-    m_shaderMacros.clear();
+    // swap instead of copy: the old list is only needed for the "did anything change" comparison at the end
+    vector< pair< string, string > > prevShaderMacros;
+    prevShaderMacros.swap( m_shaderMacros );
+    m_shaderMacros.reserve( prevShaderMacros.size( ) );
 
     // start from base macros and add up from there
 
@@ -408,16 +408,23 @@ namespace VertexAsylum
             Key( bool alphaTest, const vaRenderMaterial::ShaderSettings & shaderSettings, const vector< pair< string, string > > & shaderMacros )
             {
                 //WStringPart = fileName;
-                AStringPart = "";
-                AStringPart += "&" + shaderSettings.VS_Standard.first     + "&" + shaderSettings.VS_Standard.second;
-                AStringPart += "&" + shaderSettings.PS_DepthOnly.first    + "&" + shaderSettings.PS_DepthOnly.second;
-                AStringPart += "&" + shaderSettings.PS_Forward.first      + "&" + shaderSettings.PS_Forward.second;
-                AStringPart += "&" + shaderSettings.PS_Deferred.first     + "&" + shaderSettings.PS_Deferred.second;
-                AStringPart += "&" + shaderSettings.PS_CustomShadow.first + "&" + shaderSettings.PS_CustomShadow.second;
+                const pair< string, string > * shaders[] = { &shaderSettings.VS_Standard, &shaderSettings.PS_DepthOnly, &shaderSettings.PS_Forward, &shaderSettings.PS_Deferred, &shaderSettings.PS_CustomShadow };
+
+                // size it up front - this used to be a chain of temporaries and a dozen reallocations per key
+                size_t length = 2;
+                for( auto shader : shaders )
+                    length += shader->first.length( ) + shader->second.length( ) + 2;
+                for( auto & macro : shaderMacros )
+                    length += macro.first.length( ) + macro.second.length( ) + 2;
+
+                AStringPart.clear( );
+                AStringPart.reserve( length );
+                for( auto shader : shaders )
+                    AStringPart.append( "&" ).append( shader->first ).append( "&" ).append( shader->second );
 
                 AStringPart += ((alphaTest)?("a&"):("b&"));
-                for( int i = 0; i < shaderMacros.size(); i++ )
-                    AStringPart += shaderMacros[i].first + "&" + shaderMacros[i].second + "&";
+                for( auto & macro : shaderMacros )
+                    AStringPart.append( macro.first ).append( "&" ).append( macro.second ).append( "&" );
             }
         };
 
@@ -143,6 +143,7 @@ namespace VertexAsylum
         int                                             GetListIndex( ) const                               { return m_trackee.GetIndex( ); }
 
         const vaBoundingBox &                           GetAABB( ) const                                    { return m_boundingBox; }
+        void                                            SetAABB( const vaBoundingBox & aabb )               { m_boundingBox = aabb; }
 
         // Legacy from when we had the multiple part option - no longer the case, but this struct seems useful so let's just keep it!
         // Note: if ever desperately needing vertex/index buffer reuse (the main reason for multiple parts), add "alternate vertex buffer source" reference mesh ID and simply reuse that way
@@ -208,7 +209,11 @@ namespace VertexAsylum
         };
 
     private:
-        vector< Entry >                                 m_drawList;
+        // storage comes from vaFrameArena so lists must be Reset( ) within a frame of being filled (Count( ) of the previous
+        // fill is used to reserve on first Insert( ) to avoid growing)
+        vector< Entry, vaFrameAllocator<Entry> >        m_drawList;
+        int                                             m_lastCount             = 0;
+        uint64                                          m_storageFrameIndex     = 0;
         //vaRenderSelectionCullFlags                      m_usedFilter;
 
     public:
@@ -220,7 +225,7 @@ namespace VertexAsylum
         ~vaRenderMeshDrawList( )                        { Reset( ); }
 
     public:
-        void                                            Reset( )                            { Event_PreReset.Invoke( *this ); Event_PreReset.RemoveAll(); m_drawList.clear(); }
+        inline void                                     Reset( );
         int                                             Count( ) const                      { return (int)m_drawList.size(); }
         
         void                                            Insert( const std::shared_ptr<vaRenderMesh> & mesh, const vaMatrix4x4 & transform, const vaVector3 & sortFromReference, vaSortType sortType = vaSortType::FrontToBack, vaRenderMeshCustomHandler * customHandler = nullptr, uint64 customPayload = 0 );
@@ -293,6 +298,13 @@ namespace VertexAsylum
             VA_WARN( "vaRenderMeshDrawList::Insert - trying to add nullptr mesh, ignoring" );
             return;
         }
+        if( m_drawList.capacity( ) == 0 )
+        {
+            m_drawList.reserve( m_lastCount );
+            m_storageFrameIndex = vaFrameArena::GetFrameIndex( );
+        }
+        assert( vaFrameArena::IsFrameAlive( m_storageFrameIndex ) );    // see m_drawList comment
+
         float distance = ( vaVector3::TransformCoord( mesh->GetAABB().Center(), transform ) - sortFromReference ).Length();
         
         Entry newEntry( mesh, transform, distance, customHandler, customPayload );
@@ -300,7 +312,7 @@ namespace VertexAsylum
         if( sortType != vaSortType::None )
         {
             // find proper position in descending/ascending order            
-            vector< Entry >::iterator it = (sortType == vaSortType::FrontToBack) ? 
+            auto it = (sortType == vaSortType::FrontToBack) ? 
                 std::lower_bound( m_drawList.begin( ), m_drawList.end( ), newEntry, ( [ this ]( const Entry & a, const Entry & b ) { return a.SortDistance > b.SortDistance; } ) ) :
                 std::lower_bound( m_drawList.begin( ), m_drawList.end( ), newEntry, ( [ this ]( const Entry & a, const Entry & b ) { return a.SortDistance < b.SortDistance; } ) );
             m_drawList.insert( it, newEntry ); // insert before iterator it
@@ -311,4 +323,18 @@ namespace VertexAsylum
         }
     }
 
+    inline void vaRenderMeshDrawList::Reset( )
+    {
+        Event_PreReset.Invoke( *this );
+        Event_PreReset.RemoveAll( );
+
+        if( m_drawList.capacity( ) == 0 )
+            return;
+        assert( vaFrameArena::IsFrameAlive( m_storageFrameIndex ) );    // see m_drawList comment
+        if( m_drawList.size( ) > 0 )
+            m_lastCount = (int)m_drawList.size( );
+        // release the storage too - it'll be gone after the next frame
+        vector< Entry, vaFrameAllocator<Entry> >( ).swap( m_drawList );
+    }
+
 }
\ No newline at end of file
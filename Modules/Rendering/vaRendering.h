@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Core/vaCoreIncludes.h"
+#include "Core/Containers/vaSmallVector.h"
 
 #include "Scene/vaCameraBase.h"
 
@@ -298,7 +299,7 @@ namespace VertexAsylum
     {
         vaBoundingSphere                BoundingSphereFrom  = vaBoundingSphere::Degenerate; //( { 0, 0, 0 }, 0.0f );
         vaBoundingSphere                BoundingSphereTo    = vaBoundingSphere::Degenerate; //( { 0, 0, 0 }, 0.0f );
-        vector<vaPlane>                 FrustumPlanes;
+        vaSmallVector<vaPlane, 6>       FrustumPlanes;      // inline, no heap traffic when filters get rebuilt every frame (and fine to keep across frames)
 
         vaRenderSelectionCullFlags      CullFlags;
 
@@ -580,14 +581,14 @@ namespace VertexAsylum
 #if defined( VA_REMOTERY_INTEGRATION_ENABLED )
 
     //#if defined( VA_REMOTERY_INTEGRATION_USE_D3D11 )
-    //    #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( #name, &apiContext ); rmt_ScopedCPUSample( name, 0 ); rmt_ScopedD3D11Sample( name )
+    //    #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( VA_STRING_ID( #name ), &apiContext ); rmt_ScopedCPUSample( name, 0 ); rmt_ScopedD3D11Sample( name )
     //#else
-        #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( #name, &apiContext ); rmt_ScopedCPUSample( name, 0 )
+        #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( VA_STRING_ID( #name ), &apiContext ); rmt_ScopedCPUSample( name, 0 )
     //#endif
 
 #else
 
-    #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( #name, &apiContext )
+    #define VA_SCOPE_CPUGPU_TIMER( name, apiContext )                                       vaScopeTimer scope_##name( VA_STRING_ID( #name ), &apiContext )
 
 #endif
 
@@ -23,6 +23,8 @@
 
 #include "Core/Misc/vaResourceFormats.h"
 
+#include "Core/Containers/vaSmallString.h"
+
 #include "Rendering/Shaders/vaSharedTypes.h"
 
 #include "vaRendering.h"
@@ -40,6 +42,24 @@ namespace VertexAsylum
 {
     typedef std::vector<std::pair<std::string, std::string>> vaShaderMacroContaner;
 
+    // For building the per-frame "what macros would the shaders need now" list without heap allocations; only when it
+    // differs from the current vaShaderMacroContaner (rare - settings change) does it get copied over with vaShaderMacrosUpdate.
+    typedef vaSmallVector< std::pair< vaSmallString<96>, vaSmallString<32> >, 8 > vaShaderMacroScratchList;
+
+    // Returns true (and updates inOut) if newMacros differ from inOut
+    inline bool vaShaderMacrosUpdate( vaShaderMacroContaner & inOut, const vaShaderMacroScratchList & newMacros )
+    {
+        bool same = inOut.size( ) == newMacros.size( );
+        for( size_t i = 0; same && i < newMacros.size( ); i++ )
+            same = ( newMacros[i].first == inOut[i].first ) && ( newMacros[i].second == inOut[i].second );
+        if( same )
+            return false;
+        inOut.resize( newMacros.size( ) );
+        for( size_t i = 0; i < newMacros.size( ); i++ )
+            inOut[i] = std::make_pair( newMacros[i].first.str( ), newMacros[i].second.str( ) );
+        return true;
+    }
+
     // There are 3 states that the shader can be in (+transitions): 
     //  - "clean" state:                    when created or after a call to Clear()
     //  - "initialized with data" state:    just after a call to Create* functions but before they finished compiling or if the Create* compilation failed or if DestroyShader() was called after Create
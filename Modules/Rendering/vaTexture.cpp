@@ -179,9 +179,9 @@ shared_ptr<vaTexture> vaTexture::Create3D( vaRenderDevice & device, vaResourceFo
     return texture;
 }
 
-shared_ptr<vaTexture> vaTexture::CreateView( const shared_ptr<vaTexture> & texture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount )
+shared_ptr<vaTexture> vaTexture::CreateView( const shared_ptr<vaTexture> & texture, vaResourceBindSupportFlags bindFlags, vaResourceFormat srvFormat, vaResourceFormat rtvFormat, vaResourceFormat dsvFormat, vaResourceFormat uavFormat, vaTextureFlags flags, int viewedMipSliceMin, int viewedMipSliceCount, int viewedArraySliceMin, int viewedArraySliceCount, const vaGUID & uid )
 {
-    return texture->CreateViewInternal( texture, bindFlags, srvFormat, rtvFormat, dsvFormat, uavFormat, flags, viewedMipSliceMin, viewedMipSliceCount, viewedArraySliceMin, viewedArraySliceCount );
+    return texture->CreateViewInternal( texture, bindFlags, srvFormat, rtvFormat, dsvFormat, uavFormat, flags, viewedMipSliceMin, viewedMipSliceCount, viewedArraySliceMin, viewedArraySliceCount, uid );
 }
 
 static vaResourceFormat ConvertBCFormatToUncompressedCounterpart( vaResourceFormat format )
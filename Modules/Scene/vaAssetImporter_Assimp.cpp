@@ -870,10 +870,10 @@ static bool ProcessSceneNodes( const aiScene* loadedScene, LoadingTempStorage &
         
         switch( light.mType )
         {
-        case( aiLightSource_DIRECTIONAL ):  outScene.Lights().push_back( std::make_shared<vaLight>( vaLight::MakeDirectional(  light.mName.C_Str(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mDirection ) ) ) ); break;
-        case( aiLightSource_POINT ):        outScene.Lights().push_back( std::make_shared<vaLight>( vaLight::MakePoint(        light.mName.C_Str(), light.mSize.Length(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mPosition ) ) ) ); break;
-        case( aiLightSource_SPOT ):         outScene.Lights().push_back( std::make_shared<vaLight>( vaLight::MakeSpot(         light.mName.C_Str(), light.mSize.Length(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mPosition ), VAFromAI( light.mDirection ), light.mAngleInnerCone, light.mAngleOuterCone ) ) ); break;
-        case( aiLightSource_AMBIENT ):      outScene.Lights().push_back( std::make_shared<vaLight>( vaLight::MakeAmbient(      light.mName.C_Str(), VAFromAI( light.mColorDiffuse ) ) ) ); break;
+        case( aiLightSource_DIRECTIONAL ):  outScene.Lights().push_back( outScene.CreateLight( vaLight::MakeDirectional(  light.mName.C_Str(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mDirection ) ) ) ); break;
+        case( aiLightSource_POINT ):        outScene.Lights().push_back( outScene.CreateLight( vaLight::MakePoint(        light.mName.C_Str(), light.mSize.Length(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mPosition ) ) ) ); break;
+        case( aiLightSource_SPOT ):         outScene.Lights().push_back( outScene.CreateLight( vaLight::MakeSpot(         light.mName.C_Str(), light.mSize.Length(), VAFromAI( light.mColorDiffuse ), VAFromAI( light.mPosition ), VAFromAI( light.mDirection ), light.mAngleInnerCone, light.mAngleOuterCone ) ) ); break;
+        case( aiLightSource_AMBIENT ):      outScene.Lights().push_back( outScene.CreateLight( vaLight::MakeAmbient(      light.mName.C_Str(), VAFromAI( light.mColorDiffuse ) ) ) ); break;
 
         case( aiLightSource_UNDEFINED ): 
         case( aiLightSource_AREA ): 
@@ -175,10 +175,14 @@ bool vaSceneObject::Serialize( vaXMLSerializer & serializer )
     // VERIFY_TRUE_RETURN_ON_FALSE( serializer.Serialize<vaVector3>( "AABBMin", m_boundingBox.Min ) );
     // VERIFY_TRUE_RETURN_ON_FALSE( serializer.Serialize<vaVector3>( "AABBSize", m_boundingBox.Size ) );
 
+    // the serializer only knows about std::vector
+    vector<vaGUID> renderMeshes( m_renderMeshes.begin( ), m_renderMeshes.end( ) );
     if( serializer.GetVersion() > 0 )
-        serializer.SerializeArray( "RenderMeshes", "RenderMesh", m_renderMeshes );
+        serializer.SerializeArray( "RenderMeshes", "RenderMesh", renderMeshes );
     else
-        VERIFY_TRUE_RETURN_ON_FALSE( serializer.OldSerializeValueVector( "RenderMeshes", m_renderMeshes ) );
+        VERIFY_TRUE_RETURN_ON_FALSE( serializer.OldSerializeValueVector( "RenderMeshes", renderMeshes ) );
+    if( serializer.IsReading( ) )
+        m_renderMeshes.assign( renderMeshes.begin( ), renderMeshes.end( ) );
 
     VERIFY_TRUE_RETURN_ON_FALSE( scene->SerializeObjectsRecursive( serializer, "ChildObjects", m_children, this->shared_from_this() ) );
 
@@ -474,7 +478,9 @@ shared_ptr<vaSceneObject> vaScene::CreateObject( const shared_ptr<vaSceneObject>
 
 shared_ptr<vaSceneObject> vaScene::CreateObject( const string & name, const vaMatrix4x4 & localTransform, const shared_ptr<vaSceneObject> & parent )
 {
-    m_deferredObjectActions.push_back( DeferredObjectAction( std::make_shared<vaSceneObject>( ), parent, vaScene::DeferredObjectAction::AddObject ) );
+    VA_MEMORY_TAG_SCOPE( Scene );
+
+    m_deferredObjectActions.push_back( DeferredObjectAction( std::allocate_shared<vaSceneObject>( vaPoolAllocator<vaSceneObject>( m_objectPool ) ), parent, vaScene::DeferredObjectAction::AddObject ) );
 
     m_deferredObjectActions.back().Object->SetName( name );
     m_deferredObjectActions.back().Object->SetScene( this->shared_from_this() );
@@ -510,7 +516,7 @@ void vaScene::DestroyObject( const shared_ptr<vaSceneObject> & ptr, bool destroy
         if( applyOwnTransformToChildren )
         {
             const vaMatrix4x4 & parentTransform = ptr->GetLocalTransform();
-            const vector<shared_ptr<vaSceneObject>> & children = ptr->GetChildren();
+            const vaSceneObject::ChildList & children = ptr->GetChildren();
             for( int i = 0; i < (int)children.size(); i++ )
             {
                 const vaMatrix4x4 newTransform = parentTransform * children[i]->GetLocalTransform();
@@ -598,7 +604,7 @@ void vaScene::ApplyDeferredObjectActions( )
             // they should automatically remove themselves from the list as they get deleted or reattached to this object's parent
             if( !destroyChildrenRecursively )
             {
-                const vector<shared_ptr<vaSceneObject>> & children = mod.Object->GetChildren();
+                const vaSceneObject::ChildList & children = mod.Object->GetChildren();
 
                 while( children.size() > 0 )
                 {
@@ -630,7 +636,7 @@ void vaScene::DestroyObjectImmediate( const shared_ptr<vaSceneObject> & obj, boo
 
     if( recursive )
     {
-        const vector<shared_ptr<vaSceneObject>> & children = obj->GetChildren();
+        const vaSceneObject::ChildList & children = obj->GetChildren();
         while( obj->GetChildren().size( ) > 0 )
         {
             // we >have< to make this a temp, as the DestroyObject modifies both the provided reference and the containing array!!
@@ -647,6 +653,8 @@ void vaScene::DestroyObjectImmediate( const shared_ptr<vaSceneObject> & obj, boo
 
 void vaScene::Tick( float deltaTime )
 {
+    VA_MEMORY_TAG_SCOPE( Scene );
+
     ApplyDeferredObjectActions();
 
     if( deltaTime > 0 )
@@ -676,7 +684,8 @@ void vaScene::ApplyLighting( vaLighting & lighting )
     lighting.FogSettings() = m_fog;
 }
 
-bool vaScene::SerializeObjectsRecursive( vaXMLSerializer & serializer, const string & name, vector<shared_ptr<vaSceneObject>> & objectList, const shared_ptr<vaSceneObject> & parent )
+template< class ObjectListType >
+bool vaScene::SerializeObjectsRecursive( vaXMLSerializer & serializer, const string & name, ObjectListType & objectList, const shared_ptr<vaSceneObject> & parent )
 {
     if( m_isInTick )
     {
@@ -760,7 +769,8 @@ bool vaScene::Serialize( vaXMLSerializer & serializer, bool mergeToExistingIfLoa
             else
                 VERIFY_TRUE_RETURN_ON_FALSE( serializer.OldSerializeObjectVector( "Lights", mergingLights ) );
             
-            m_lights.insert( m_lights.end(), mergingLights.begin(), mergingLights.end() );
+            for( const shared_ptr<vaLight> & light : mergingLights )
+                m_lights.push_back( CreateLight( *light ) );
         }
         else
         {
@@ -771,6 +781,11 @@ bool vaScene::Serialize( vaXMLSerializer & serializer, bool mergeToExistingIfLoa
             else
                 VERIFY_TRUE_RETURN_ON_FALSE( serializer.OldSerializeObjectVector( "Lights", m_lights ) );
             //serializer.SerializeArray( "Inputs", "Item", m_lights );
+
+            // serializer creates them with make_shared; move them into our pool
+            if( serializer.IsReading( ) )
+                for( shared_ptr<vaLight> & light : m_lights )
+                    light = CreateLight( *light );
         }
 
         VERIFY_TRUE_RETURN_ON_FALSE( SerializeObjectsRecursive( serializer, "RootObjects", m_rootObjects, nullptr ) );
@@ -832,7 +847,8 @@ void vaScene::RegisterUsedAssetPackNameCallback( const vaAssetPack & assetPack )
 
 #ifdef VA_IMGUI_INTEGRATION_ENABLED
 
-static shared_ptr<vaSceneObject> ImGuiDisplaySceneObjectTreeRecursive( const vector<shared_ptr<vaSceneObject>> & elements, const shared_ptr<vaSceneObject> & selectedObject )
+template< class ObjectListType >
+static shared_ptr<vaSceneObject> ImGuiDisplaySceneObjectTreeRecursive( const ObjectListType & elements, const shared_ptr<vaSceneObject> & selectedObject )
 {
     ImGuiTreeNodeFlags defaultFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
 
@@ -866,6 +882,8 @@ static shared_ptr<vaSceneObject> ImGuiDisplaySceneObjectTreeRecursive( const vec
 
 bool vaScene::Save( const wstring & fileName )
 {
+    VA_MEMORY_TAG_SCOPE( Scene );
+
     // calling Save with non-applied changes? probably a bug somewhere (if not, just call ApplyDeferredObjectActions() before getting here)
     assert( m_deferredObjectActions.size() == 0 );
 
@@ -897,6 +915,8 @@ bool vaScene::Save( const wstring & fileName )
 
 bool vaScene::Load( const wstring & fileName, bool mergeToExisting )
 {
+    VA_MEMORY_TAG_SCOPE( Scene );
+
     // calling Load with non-applied changes? probably a bug somewhere (if not, just call ApplyDeferredObjectActions() before getting here)
     assert( m_deferredObjectActions.size() == 0 );
 
@@ -1074,7 +1094,7 @@ void vaScene::UIPanelDraw( )
 
         if( ImGui::Button( "Duplicate" ) )
         {
-            m_lights.push_back( std::make_shared<vaLight>( *m_lights[currentLight] ) );
+            m_lights.push_back( CreateLight( *m_lights[currentLight] ) );
             m_lights.back()->Name += "_new";
             m_UI_SelectedLight = m_lights.back();
         }
@@ -1090,7 +1110,7 @@ void vaScene::UIPanelDraw( )
     }
     if( ImGui::Button( "Add light" ) )
     {
-        m_lights.push_back( std::make_shared<vaLight>( vaLight::MakePoint( "NewLight", 0.2f, vaVector3( 0, 0, 0 ), vaVector3( 0, 0, 0 ) ) ) );
+        m_lights.push_back( CreateLight( vaLight::MakePoint( "NewLight", 0.2f, vaVector3( 0, 0, 0 ), vaVector3( 0, 0, 0 ) ) ) );
     }
     ImGui::Checkbox( "Debug draw scene lights", &m_UI_ShowLights );
     
@@ -1334,7 +1354,7 @@ vector<shared_ptr<vaSceneObject>> vaScene::InsertAllPackMeshesToSceneAsObjects(
     vector<shared_ptr<vaSceneObject>> addedObjects;
     
     assert( !pack.IsBackgroundTaskActive() );
-    std::unique_lock<mutex> assetStorageMutexLock( pack.GetAssetStorageMutex() );
+    std::unique_lock<vaAssetPack::StorageMutex> assetStorageMutexLock( pack.GetAssetStorageMutex() );
 
     for( size_t i = 0; i < pack.Count( false ); i++ )
     {
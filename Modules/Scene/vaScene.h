@@ -20,6 +20,7 @@
 
 #include "Core/vaCoreIncludes.h"
 #include "Core/vaXMLSerialization.h"
+#include "Core/Containers/vaSmallVector.h"
 
 #include "Rendering/vaRendering.h"
 #include "Rendering/vaLighting.h"
@@ -34,6 +35,11 @@ namespace VertexAsylum
 
     class vaSceneObject : public std::enable_shared_from_this<vaSceneObject>, public vaXMLSerializable, public vaUIPropertiesItem//, public vaUIDObject
     {
+    public:
+        // most objects have only a few children and one or two meshes; keeping those inline saves an allocation per list
+        // per object and the pointer chase when walking the graph in TickRecursive/SelectForRendering
+        typedef vaSmallVector<shared_ptr<vaSceneObject>, 4>     ChildList;
+
     protected:
         string                                      m_name                                  = "Unnamed";
 
@@ -42,9 +48,9 @@ namespace VertexAsylum
         vaMatrix4x4                                 m_localTransform                        = vaMatrix4x4::Identity;
 
         shared_ptr<vaSceneObject>                   m_parent;
-        vector<shared_ptr<vaSceneObject>>           m_children;
+        ChildList                                   m_children;
 
-        vector<vaGUID>                              m_renderMeshes;
+        vaSmallVector<vaGUID, 2>                    m_renderMeshes;
 
         bool                                        m_createdButNotYetAddedToScene          = true;
         bool                                        m_destroyedButNotYetRemovedFromScene    = false;
@@ -55,7 +61,7 @@ namespace VertexAsylum
         mutable vaBoundingBox                       m_computedLocalBoundingBox              = vaBoundingBox::Degenerate;    // Updated in UpdateLocalBoundingBox from RenderMesh-es and other stuff
         mutable vaBoundingBox                       m_computedGlobalBoundingBox             = vaBoundingBox::Degenerate;    // Updated each frame in TickRecursive
 
-        mutable vector<weak_ptr<vaRenderMesh>>      m_cachedRenderMeshes;
+        mutable vaSmallVector<weak_ptr<vaRenderMesh>, 2>  m_cachedRenderMeshes;
     
     public:
         vaSceneObject( );
@@ -86,7 +92,7 @@ namespace VertexAsylum
 
         const shared_ptr<vaSceneObject> &           GetParent( ) const                                          { return m_parent; }
 
-        const vector<shared_ptr<vaSceneObject>> &   GetChildren( ) const                                        { return m_children; }
+        const ChildList &                           GetChildren( ) const                                        { return m_children; }
     
         const vaMatrix4x4 &                         GetLocalTransform( ) const                                  { return m_localTransform; }
         void                                        SetLocalTransform( const vaMatrix4x4 & newTransform )       { m_localTransform = newTransform; }
@@ -179,6 +185,11 @@ namespace VertexAsylum
 
         vector<DeferredObjectAction>                m_deferredObjectActions;
 
+        // scene objects and lights are allocated (together with their shared_ptr control blocks) from these so that they're
+        // packed together in memory instead of scattered around the heap
+        shared_ptr<vaFixedSizePool>                 m_objectPool            = std::make_shared<vaFixedSizePool>( );
+        shared_ptr<vaFixedSizePool>                 m_lightPool             = std::make_shared<vaFixedSizePool>( );
+
         vaFogSphere                                 m_fog;
 
 
@@ -232,6 +243,8 @@ namespace VertexAsylum
 
         // temporary - should be SceneObject components in the future
         vector<shared_ptr<vaLight>> &               Lights( )                   { return m_lights; }
+        // creates a light from the scene's pool; does not add it to Lights( )
+        shared_ptr<vaLight>                         CreateLight( const vaLight & light )    { return std::allocate_shared<vaLight>( vaPoolAllocator<vaLight>( m_lightPool ), light ); }
 
         int64                                       GetTickIndex( ) const       { return m_tickIndex; }
 
@@ -266,7 +279,9 @@ namespace VertexAsylum
         void                                        RegisterRootObjectAdded( const shared_ptr<vaSceneObject> & object );
         void                                        RegisterRootObjectRemoved( const shared_ptr<vaSceneObject> & object );
 
-        bool                                        SerializeObjectsRecursive( vaXMLSerializer & serializer, const string & name, vector<shared_ptr<vaSceneObject>> & objectList, const shared_ptr<vaSceneObject> & parent );
+        // ObjectListType is either m_rootObjects or vaSceneObject::ChildList
+        template< class ObjectListType >
+        bool                                        SerializeObjectsRecursive( vaXMLSerializer & serializer, const string & name, ObjectListType & objectList, const shared_ptr<vaSceneObject> & parent );
 
         void                                        DestroyObjectImmediate( const shared_ptr<vaSceneObject> & obj, bool recursive );
 
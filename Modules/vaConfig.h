@@ -30,3 +30,7 @@
 #define VA_ZLIB_INTEGRATION_ENABLED
 
 //#define VA_USE_PIX3
+
+// Replaces global operator new/delete with tracking versions that keep per-tag (see vaMemoryTag) live/peak/per-frame
+// statistics; adds a 16 byte header and a few atomic ops to every allocation so it's off by default
+// #define VA_MEMORY_TRACKING_ENABLED
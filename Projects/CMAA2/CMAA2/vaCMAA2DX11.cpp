@@ -568,6 +568,8 @@ vaDrawResultFlags vaCMAA2DX11::DrawMS( vaRenderDeviceContext & deviceContext, co
 
 vaDrawResultFlags vaCMAA2DX11::Draw( vaRenderDeviceContext & deviceContext, const shared_ptr<vaTexture> & inoutColor, const shared_ptr<vaTexture> & optionalInLuma )
 {
+    VA_MEMORY_TAG_SCOPE( CMAA2 );
+
     vaRenderDeviceContext::RenderOutputsState rtState = deviceContext.GetOutputs( );
 
     deviceContext.SetRenderTarget( nullptr, nullptr, false );
@@ -1203,6 +1203,8 @@ vaDrawResultFlags vaCMAA2DX12::DrawMS( vaRenderDeviceContext & deviceContext, co
 // (except shader compilation and the safely freeing of DX12 objects).
 vaDrawResultFlags vaCMAA2DX12::Draw( vaRenderDeviceContext & deviceContext, const shared_ptr<vaTexture> & inoutColor, const shared_ptr<vaTexture> & optionalInLuma )
 {
+    VA_MEMORY_TAG_SCOPE( CMAA2 );
+
     // Track the external inputs so we can re-create if they change - even if formats and sizes are the same we'll have to update view descriptors.
     // This one is a bit tricky: just by looking at whether input texture ID3D12Resource ptr and/or ID3D12Resource::GetDesc changed we cannot determine for 
     // certain that the texture was not re-created (as it could get the same ptr), which would invalidate all our view descriptors looking into it. So we 
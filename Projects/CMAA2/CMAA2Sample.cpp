@@ -54,6 +54,7 @@ int APIENTRY _tWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpC
 {
     hInstance; hPrevInstance; // unreferenced
 
+    int exitCode = 0;
     {
         vaCoreInitDeinit core;
         vaApplicationWin::Settings settings( L"CMAA2 DX11/DX12 sample", lpCmdLine, nCmdShow );
@@ -66,9 +67,9 @@ int APIENTRY _tWinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpC
         void InitializeProjectAPIParts( );
         InitializeProjectAPIParts( );
 
-        vaApplicationWin::Run( settings, CMAA2StartStopCallback );
+        exitCode = vaApplicationWin::Run( settings, CMAA2StartStopCallback );
     }
-    return 0;
+    return exitCode;
 }
 
 
@@ -538,7 +539,11 @@ void CMAA2Sample::OnTick( float deltaTime )
             m_currentDrawResults |= m_currentScene->SelectForRendering( m_queuedShadowmapRenderSelection );
         }
         if( m_currentDrawResults != vaDrawResultFlags::None )
+        {
+            // the selected list's storage is in the frame arena so it can't wait for the next shadowmap - drop it too
             m_queuedShadowmap = nullptr;
+            m_queuedShadowmapRenderSelection.Reset( );
+        }
     }
 
     if( !freezeMotionAndInput && m_application.HasFocus( ) && !vaInputMouseBase::GetCurrent( )->IsCaptured( ) 
@@ -880,6 +885,8 @@ vaDrawResultFlags CMAA2Sample::DrawScene( vaCameraBase & camera, vaGBuffer & gbu
 
 vaDrawResultFlags CMAA2Sample::RenderTick( )
 {
+    VA_MEMORY_TAG_SCOPE( Rendering );
+
     vaRenderDeviceContext & mainContext = *GetRenderDevice().GetMainContext( );
 
     // this is "comparer stuff" and the main render target stuff